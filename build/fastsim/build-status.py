@@ -0,0 +1,8 @@
+#! /usr/bin/env python
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build/fastsim/src/clove/examples/ns3-dev-clove-example-fastsim', 'build/fastsim/src/config-store/examples/ns3-dev-config-store-save-fastsim', 'build/fastsim/src/core/examples/ns3-dev-main-callback-fastsim', 'build/fastsim/src/core/examples/ns3-dev-sample-simulator-fastsim', 'build/fastsim/src/core/examples/ns3-dev-main-ptr-fastsim', 'build/fastsim/src/core/examples/ns3-dev-main-random-variable-fastsim', 'build/fastsim/src/core/examples/ns3-dev-main-random-variable-stream-fastsim', 'build/fastsim/src/core/examples/ns3-dev-sample-random-variable-fastsim', 'build/fastsim/src/core/examples/ns3-dev-sample-random-variable-stream-fastsim', 'build/fastsim/src/core/examples/ns3-dev-command-line-example-fastsim', 'build/fastsim/src/core/examples/ns3-dev-hash-example-fastsim', 'build/fastsim/src/core/examples/ns3-dev-main-test-sync-fastsim', 'build/fastsim/src/internet/examples/ns3-dev-main-simple-fastsim', 'build/fastsim/src/link-monitor/examples/ns3-dev-link-monitor-example-fastsim', 'build/fastsim/src/link-monitor/examples/ns3-dev-link-stats-dump-fastsim', 'build/fastsim/src/network/examples/ns3-dev-main-packet-header-fastsim', 'build/fastsim/src/network/examples/ns3-dev-main-packet-tag-fastsim', 'build/fastsim/src/network/examples/ns3-dev-packet-socket-apps-fastsim', 'build/fastsim/src/point-to-point/examples/ns3-dev-main-attribute-value-fastsim', 'build/fastsim/src/stats/examples/ns3-dev-gnuplot-example-fastsim', 'build/fastsim/src/stats/examples/ns3-dev-double-probe-example-fastsim', 'build/fastsim/src/stats/examples/ns3-dev-time-probe-example-fastsim', 'build/fastsim/src/stats/examples/ns3-dev-gnuplot-aggregator-example-fastsim', 'build/fastsim/src/stats/examples/ns3-dev-gnuplot-helper-example-fastsim', 'build/fastsim/src/stats/examples/ns3-dev-file-aggregator-example-fastsim', 'build/fastsim/src/stats/examples/ns3-dev-file-helper-example-fastsim', 'build/fastsim/src/tlb/examples/ns3-dev-tlb-example-fastsim', 'build/fastsim/src/traffic-control/examples/ns3-dev-red-tests-fastsim', 'build/fastsim/src/traffic-control/examples/ns3-dev-adaptive-red-tests-fastsim', 'build/fastsim/src/traffic-control/examples/ns3-dev-codel-vs-pfifo-basic-test-fastsim', 'build/fastsim/src/traffic-control/examples/ns3-dev-codel-vs-pfifo-asymmetric-fastsim', 'build/fastsim/examples/tcp/ns3-dev-tcp-large-transfer-fastsim', 'build/fastsim/examples/tcp/ns3-dev-tcp-nsc-lfn-fastsim', 'build/fastsim/examples/tcp/ns3-dev-tcp-star-server-fastsim', 'build/fastsim/examples/tcp/ns3-dev-tcp-bulk-send-fastsim', 'build/fastsim/examples/tcp/ns3-dev-tcp-pcap-nanosec-example-fastsim', 'build/fastsim/examples/tcp/ns3-dev-tcp-nsc-comparison-fastsim', 'build/fastsim/examples/tcp/ns3-dev-tcp-variants-comparison-fastsim', 'build/fastsim/examples/routing/ns3-dev-simple-global-routing-fastsim', 'build/fastsim/examples/routing/ns3-dev-simple-alternate-routing-fastsim', 'build/fastsim/examples/routing/ns3-dev-per-flow-ecmp-routing-fastsim', 'build/fastsim/examples/routing/ns3-dev-drb-routing-fastsim', 'build/fastsim/examples/error-model/ns3-dev-simple-error-model-fastsim', 'build/fastsim/examples/rtt-variations/ns3-dev-mq-fastsim', 'build/fastsim/examples/rtt-variations/ns3-dev-large-scale-fastsim', 'build/fastsim/examples/rtt-variations/ns3-dev-queue-track-fastsim', 'build/fastsim/examples/tutorial/ns3-dev-hello-simulator-fastsim', 'build/fastsim/examples/tutorial/ns3-dev-first-fastsim', 'build/fastsim/examples/tutorial/ns3-dev-fourth-fastsim', 'build/fastsim/examples/tutorial/ns3-dev-fifth-fastsim', 'build/fastsim/examples/tutorial/ns3-dev-sixth-fastsim', 'build/fastsim/examples/tutorial/ns3-dev-seventh-fastsim', 'build/fastsim/examples/ipv6/ns3-dev-test-ipv6-fastsim', 'build/fastsim/examples/traffic-control/ns3-dev-traffic-control-fastsim', 'build/fastsim/scratch/subdir/ns3-dev-subdir-fastsim', 'build/fastsim/scratch/ns3-dev-scratch-simulator-fastsim']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = ['sample-simulator.py', 'first.py']
+
@@ -0,0 +1,14 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef CLOVE_HELPER_H
+#define CLOVE_HELPER_H
+
+#include "ns3/ipv4-clove.h"
+
+namespace ns3 {
+
+/* ... */
+
+}
+
+#endif /* CLOVE_HELPER_H */
+
@@ -0,0 +1,19 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_FLOW_MONITOR
+    
+
+// Module headers:
+#include "flow-classifier.h"
+#include "flow-monitor-helper.h"
+#include "flow-monitor.h"
+#include "flow-probe.h"
+#include "histogram.h"
+#include "ipv4-flow-classifier.h"
+#include "ipv4-flow-probe.h"
+#include "ipv6-flow-classifier.h"
+#include "ipv6-flow-probe.h"
+#endif
@@ -0,0 +1,18 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_HULA
+    
+
+// Module headers:
+#include "flowlet.h"
+#include "hula-generator-helper.h"
+#include "hula-routing-helper.h"
+#include "hula-routing.h"
+#include "hulaProbeGenerator.h"
+#include "hula_hdr.h"
+#include "rpc-application.h"
+#include "rpc-generator-helper.h"
+#endif
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef IPV4_CLOVE_H
+#define IPV4_CLOVE_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/counter-rng.h"
+
+#include <vector>
+#include <map>
+#include <utility>
+
+#define CLOVE_RUNMODE_EDGE_FLOWLET 0
+#define CLOVE_RUNMODE_ECN 1
+#define CLOVE_RUNMODE_INT 2
+
+namespace ns3 {
+
+struct CloveFlowlet {
+    Time lastSeen;
+    uint32_t path;
+};
+
+class Ipv4Clove : public Object {
+
+public:
+    Ipv4Clove ();
+    Ipv4Clove (const Ipv4Clove&);
+
+    static TypeId GetTypeId (void);
+
+    void AddAddressWithTor (Ipv4Address address, uint32_t torId);
+    void AddAvailPath (uint32_t destTor, uint32_t path);
+
+    uint32_t GetPath (uint32_t flowId, Ipv4Address saddr, Ipv4Address daddr);
+
+    void FlowRecv (uint32_t path, Ipv4Address daddr, bool withECN);
+
+    bool FindTorId (Ipv4Address daddr, uint32_t &torId);
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams (int64_t stream);
+
+private:
+    uint32_t CalPath (uint32_t destTor);
+
+    Time m_flowletTimeout;
+    uint32_t m_runMode;
+
+    std::map<uint32_t, std::vector<uint32_t> > m_availablePath;
+    std::map<Ipv4Address, uint32_t> m_ipTorMap;
+    std::map<uint32_t, CloveFlowlet> m_flowletMap;
+
+    // Clove ECN
+    Time m_halfRTT;
+    bool m_disToUncongestedPath;
+    std::map<std::pair<uint32_t, uint32_t>, double> m_pathWeight;
+    std::map<std::pair<uint32_t, uint32_t>, Time> m_pathECNSeen;
+
+    CounterRng m_rng; // Used to pick the path of a new flowlet
+};
+
+}
+
+#endif /* IPV4_CLOVE_H */
+
@@ -0,0 +1,57 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef LINK_MONITOR_H
+#define LINK_MONITOR_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "link-probe.h"
+#include "link-stats-file.h"
+
+#include <vector>
+#include <string>
+
+namespace ns3 {
+
+class LinkMonitor : public Object
+{
+public:
+
+  static TypeId GetTypeId (void);
+
+  static std::string DefaultFormat (struct LinkProbe::LinkStats stat);
+
+  LinkMonitor ();
+
+  void AddLinkProbe (Ptr<LinkProbe> probe);
+
+  void Start (Time startTime);
+
+  void Stop (Time stopTime);
+
+  void OutputToFile (std::string filename, std::string (*formatFunc)(struct LinkProbe::LinkStats));
+
+  // Stream the samples of all the probes to a binary file while the
+  // simulation runs, instead of keeping them in memory for OutputToFile.
+  // Every port buffers chunkSize samples between two writes.  The file is
+  // read back with LinkStatsReader.
+  void SetOutputFile (std::string filename, uint32_t chunkSize = 1024);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+
+  void DoStart (void);
+
+  void DoStop (void);
+
+  std::vector<Ptr<LinkProbe> > m_linkProbes;
+
+  Ptr<LinkStatsWriter> m_writer;
+
+};
+
+}
+
+#endif /* LINK_MONITOR_H */
+
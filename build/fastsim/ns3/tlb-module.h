@@ -0,0 +1,15 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_TLB
+    
+
+// Module headers:
+#include "ipv4-tlb-helper.h"
+#include "ipv4-tlb.h"
+#include "tcp-tlb-tag.h"
+#include "tlb-flow-info.h"
+#include "tlb-path-info.h"
+#endif
@@ -0,0 +1,8 @@
+#! /usr/bin/env python
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build/optimized/src/clove/examples/ns3-dev-clove-example-optimized', 'build/optimized/src/config-store/examples/ns3-dev-config-store-save-optimized', 'build/optimized/src/core/examples/ns3-dev-main-callback-optimized', 'build/optimized/src/core/examples/ns3-dev-sample-simulator-optimized', 'build/optimized/src/core/examples/ns3-dev-main-ptr-optimized', 'build/optimized/src/core/examples/ns3-dev-main-random-variable-optimized', 'build/optimized/src/core/examples/ns3-dev-main-random-variable-stream-optimized', 'build/optimized/src/core/examples/ns3-dev-sample-random-variable-optimized', 'build/optimized/src/core/examples/ns3-dev-sample-random-variable-stream-optimized', 'build/optimized/src/core/examples/ns3-dev-command-line-example-optimized', 'build/optimized/src/core/examples/ns3-dev-hash-example-optimized', 'build/optimized/src/core/examples/ns3-dev-main-test-sync-optimized', 'build/optimized/src/internet/examples/ns3-dev-main-simple-optimized', 'build/optimized/src/link-monitor/examples/ns3-dev-link-monitor-example-optimized', 'build/optimized/src/link-monitor/examples/ns3-dev-link-stats-dump-optimized', 'build/optimized/src/network/examples/ns3-dev-main-packet-header-optimized', 'build/optimized/src/network/examples/ns3-dev-main-packet-tag-optimized', 'build/optimized/src/network/examples/ns3-dev-packet-socket-apps-optimized', 'build/optimized/src/point-to-point/examples/ns3-dev-main-attribute-value-optimized', 'build/optimized/src/stats/examples/ns3-dev-gnuplot-example-optimized', 'build/optimized/src/stats/examples/ns3-dev-double-probe-example-optimized', 'build/optimized/src/stats/examples/ns3-dev-time-probe-example-optimized', 'build/optimized/src/stats/examples/ns3-dev-gnuplot-aggregator-example-optimized', 'build/optimized/src/stats/examples/ns3-dev-gnuplot-helper-example-optimized', 'build/optimized/src/stats/examples/ns3-dev-file-aggregator-example-optimized', 'build/optimized/src/stats/examples/ns3-dev-file-helper-example-optimized', 'build/optimized/src/tlb/examples/ns3-dev-tlb-example-optimized', 'build/optimized/src/traffic-control/examples/ns3-dev-red-tests-optimized', 'build/optimized/src/traffic-control/examples/ns3-dev-adaptive-red-tests-optimized', 'build/optimized/src/traffic-control/examples/ns3-dev-codel-vs-pfifo-basic-test-optimized', 'build/optimized/src/traffic-control/examples/ns3-dev-codel-vs-pfifo-asymmetric-optimized', 'build/optimized/examples/tcp/ns3-dev-tcp-large-transfer-optimized', 'build/optimized/examples/tcp/ns3-dev-tcp-nsc-lfn-optimized', 'build/optimized/examples/tcp/ns3-dev-tcp-star-server-optimized', 'build/optimized/examples/tcp/ns3-dev-tcp-bulk-send-optimized', 'build/optimized/examples/tcp/ns3-dev-tcp-pcap-nanosec-example-optimized', 'build/optimized/examples/tcp/ns3-dev-tcp-nsc-comparison-optimized', 'build/optimized/examples/tcp/ns3-dev-tcp-variants-comparison-optimized', 'build/optimized/examples/routing/ns3-dev-simple-global-routing-optimized', 'build/optimized/examples/routing/ns3-dev-simple-alternate-routing-optimized', 'build/optimized/examples/routing/ns3-dev-per-flow-ecmp-routing-optimized', 'build/optimized/examples/routing/ns3-dev-drb-routing-optimized', 'build/optimized/examples/error-model/ns3-dev-simple-error-model-optimized', 'build/optimized/examples/rtt-variations/ns3-dev-mq-optimized', 'build/optimized/examples/rtt-variations/ns3-dev-large-scale-optimized', 'build/optimized/examples/rtt-variations/ns3-dev-queue-track-optimized', 'build/optimized/examples/tutorial/ns3-dev-hello-simulator-optimized', 'build/optimized/examples/tutorial/ns3-dev-first-optimized', 'build/optimized/examples/tutorial/ns3-dev-fourth-optimized', 'build/optimized/examples/tutorial/ns3-dev-fifth-optimized', 'build/optimized/examples/tutorial/ns3-dev-sixth-optimized', 'build/optimized/examples/tutorial/ns3-dev-seventh-optimized', 'build/optimized/examples/ipv6/ns3-dev-test-ipv6-optimized', 'build/optimized/examples/traffic-control/ns3-dev-traffic-control-optimized', 'build/optimized/scratch/subdir/ns3-dev-subdir-optimized', 'build/optimized/scratch/ns3-dev-scratch-simulator-optimized']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = ['sample-simulator.py', 'first.py']
+
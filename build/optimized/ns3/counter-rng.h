@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup randomvariable
+ * ns3::CounterRng declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup randomvariable
+ *
+ * A lightweight random stream for the decisions taken on the fast path,
+ * such as picking a path in a load balancer.
+ *
+ * The numbers are the output of the Philox4x32-10 counter-based
+ * generator (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+ * 3", SC'11) keyed by the seed and the run number of RngSeedManager,
+ * applied to a counter made of the stream number and the index of the
+ * draw.  Like a RandomVariableStream, a CounterRng is thus reproducible
+ * under a given seed and run, independent of the other streams, and gets
+ * its stream number either automatically or from AssignStreams().  Unlike
+ * it, it is a plain value member with inline, non-virtual draws, which
+ * only pays for the generator once every four 32 bit numbers.
+ *
+ * The key is read from RngSeedManager at the first draw after the
+ * stream is set, so objects created before RngSeedManager::SetSeed or
+ * SetRun still follow the seed and the run of the simulation.
+ */
+class CounterRng
+{
+public:
+  /** Create a stream with an automatically assigned stream number. */
+  CounterRng ();
+
+  /**
+   * Set the stream number, and restart the stream.
+   * \param [in] stream The stream number, or -1 to assign one
+   *             automatically, like RandomVariableStream::SetStream.
+   */
+  void SetStream (int64_t stream);
+  /**
+   * \returns The stream number set by SetStream, or -1 if it was
+   *          automatically assigned.
+   */
+  int64_t GetStream (void) const;
+
+  /** \returns A uniformly distributed 32 bit integer. */
+  uint32_t GetU32 (void);
+  /** \returns A uniformly distributed 64 bit integer. */
+  uint64_t GetU64 (void);
+  /** \returns A uniformly distributed real in [0, 1). */
+  double GetDouble (void);
+  /**
+   * \param [in] n The number of values, greater than 0.
+   * \returns A uniformly distributed integer in [0, n).
+   */
+  uint32_t GetInteger (uint32_t n);
+
+  /**
+   * The Philox4x32-10 bijection.
+   * \param [in] counter The counter.
+   * \param [in] key The key.
+   * \param [out] out The random numbers of the counter.
+   */
+  static void Philox (const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+private:
+  /** Compute the next four numbers, keying the stream if needed. */
+  void Refill (void);
+
+  int64_t m_stream;           //!< Stream number set by SetStream, or -1.
+  uint64_t m_streamIndex;     //!< Stream number, upper half of the counter.
+  uint64_t m_counter;         //!< Index of the next block, lower half of the counter.
+  bool m_keyed;               //!< Whether m_key holds the current seed and run.
+  uint32_t m_key[2];          //!< Key, from the seed and the run.
+  uint32_t m_block[4];        //!< Numbers of the current block.
+  uint32_t m_next;            //!< Index of the next unused number in the block.
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the inline methods
+ ********************************************************************/
+
+namespace ns3 {
+
+inline uint32_t
+CounterRng::GetU32 (void)
+{
+  if (m_next == 4)
+    {
+      Refill ();
+    }
+  return m_block[m_next++];
+}
+
+inline uint64_t
+CounterRng::GetU64 (void)
+{
+  uint64_t hi = GetU32 ();
+  return (hi << 32) | GetU32 ();
+}
+
+inline double
+CounterRng::GetDouble (void)
+{
+  // 53 random bits, the precision of a double
+  return (GetU64 () >> 11) * (1.0 / 9007199254740992.0);
+}
+
+inline uint32_t
+CounterRng::GetInteger (uint32_t n)
+{
+  // Lemire's multiply and shift, rejecting the few values which would
+  // make the result biased
+  uint64_t m = (uint64_t) GetU32 () * n;
+  uint32_t low = (uint32_t) m;
+  if (low < n)
+    {
+      uint32_t threshold = -n % n;
+      while (low < threshold)
+        {
+          m = (uint64_t) GetU32 () * n;
+          low = (uint32_t) m;
+        }
+    }
+  return m >> 32;
+}
+
+} // namespace ns3
+
+#endif /* COUNTER_RNG_H */
@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005,2006 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+#ifndef EVENT_IMPL_H
+#define EVENT_IMPL_H
+
+#include <stdint.h>
+#include "simple-ref-count.h"
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventImpl declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief A simulation event.
+ *
+ * Each subclass of this base class represents a simulation event. The
+ * Invoke() method will be called by the simulation engine
+ * when it reaches the time associated to this event. Most subclasses
+ * are usually created by one of the many Simulator::Schedule
+ * methods.
+ */
+class EventImpl : public SimpleRefCount<EventImpl>
+{
+public:
+  /** Default constructor. */
+  EventImpl ();
+  /** Destructor. */
+  virtual ~EventImpl () = 0;
+  /**
+   * Called by the simulation engine to notify the event that it is time
+   * to execute.
+   */
+  void Invoke (void);
+  /**
+   * Marks the event as 'canceled'. The event is not removed from
+   * the event list but the simulation engine will check its canceled status
+   * before calling Invoke().
+   */
+  void Cancel (void);
+  /**
+   * \returns true if the event has been canceled.
+   *
+   * Checked by the simulation engine before calling Invoke().
+   */
+  bool IsCancelled (void);
+  /**
+   * Attach a label to the event, reported by the simulator profiler in
+   * place of the name of the function the event calls.
+   *
+   * \param [in] label The label, which must outlive the event,
+   *             typically a string literal.
+   */
+  void SetLabel (const char *label);
+  /**
+   * \returns The label of the event, or 0 if it has none.
+   */
+  const char *GetLabel (void) const;
+  /**
+   * Identify the function or method the event calls, so the simulator
+   * profiler can tell apart events of the same type.
+   *
+   * \param [out] size The size of the function pointer.
+   * \returns The address of the function pointer held by the event,
+   *          or 0 if the event does not hold one.
+   */
+  virtual const void *GetFunction (uint32_t &size) const;
+
+protected:
+  /**
+   * Implementation for Invoke().
+   *
+   * This typically calls a method or function pointer with the
+   * arguments bound by a call to one of the MakeEvent() functions.
+   */
+  virtual void Notify (void) = 0;
+
+private:
+  bool m_cancel;  /**< Has this event been cancelled. */
+  const char *m_label;  /**< Label reported by the profiler. */
+};
+
+} // namespace ns3
+
+#endif /* EVENT_IMPL_H */
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_GENERATOR_HELPER_H
+#define FLOW_GENERATOR_HELPER_H
+
+#include <stdint.h>
+#include <string>
+#include "ns3/object-factory.h"
+#include "ns3/attribute.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup flowgenerator
+ * \brief A helper to make it easier to instantiate an ns3::FlowGenerator
+ * on a set of nodes.
+ */
+class FlowGeneratorHelper
+{
+public:
+  /**
+   * Create a FlowGeneratorHelper to make it easier to work with FlowGenerators
+   *
+   * \param protocol the name of the protocol to use to send traffic
+   *        by the applications. This string identifies the socket
+   *        factory type used to create sockets for the applications.
+   *        A typical value would be ns3::TcpSocketFactory.
+   * \param port the port every FlowGenerator listens on
+   */
+  FlowGeneratorHelper (std::string protocol, uint16_t port);
+
+  /**
+   * Helper function used to set the underlying application attributes, 
+   * _not_ the socket attributes.
+   *
+   * \param name the name of the application attribute to set
+   * \param value the value of the application attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * Install an ns3::FlowGenerator on each node of the input container
+   * configured with all the attributes set with SetAttribute.
+   *
+   * \param c NodeContainer of the set of nodes on which a FlowGenerator
+   * will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (NodeContainer c) const;
+
+  /**
+   * Install an ns3::FlowGenerator on the node configured with all the
+   * attributes set with SetAttribute.
+   *
+   * \param node The node on which a FlowGenerator will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (Ptr<Node> node) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by the FlowGenerators on the nodes.  Return the number of streams
+   * (possibly zero) that have been assigned.
+   *
+   * \param c NodeContainer of the set of nodes for which the FlowGenerators
+   *          should be modified to use a fixed stream
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this helper
+   */
+  int64_t AssignStreams (NodeContainer c, int64_t stream);
+
+  /**
+   * \brief Read a flow size distribution.
+   *
+   * The file holds one "size cdf" pair per line, with both columns non
+   * decreasing, as in the TrafficGenerator CDF files.  Sizes below the first
+   * point are interpolated from zero.
+   *
+   * \param fileName the CDF file
+   * \returns a random variable drawing flow sizes, to be used as FlowSize
+   */
+  static Ptr<EmpiricalRandomVariable> LoadFlowSizeCdf (std::string fileName);
+
+  /**
+   * \brief Get the mean of a flow size distribution read by LoadFlowSizeCdf.
+   * \param fileName the CDF file
+   * \returns the mean flow size in bytes
+   */
+  static double GetMeanFlowSize (std::string fileName);
+
+private:
+  /**
+   * Install an ns3::FlowGenerator on the node configured with all the
+   * attributes set with SetAttribute.
+   *
+   * \param node The node on which a FlowGenerator will be installed.
+   * \returns Ptr to the application installed.
+   */
+  Ptr<Application> InstallPriv (Ptr<Node> node) const;
+
+  ObjectFactory m_factory; //!< Object factory.
+};
+
+} // namespace ns3
+
+#endif /* FLOW_GENERATOR_HELPER_H */
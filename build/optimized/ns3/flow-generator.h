@@ -0,0 +1,303 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_GENERATOR_H
+#define FLOW_GENERATOR_H
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+class Socket;
+class FluidBackground;
+class RandomVariableStream;
+class UniformRandomVariable;
+
+/**
+ * \ingroup applications
+ * \defgroup flowgenerator FlowGenerator
+ *
+ * A per-host traffic engine that stands in for one BulkSendApplication and
+ * one PacketSink per flow in large data center workloads.
+ */
+
+/**
+ * \ingroup flowgenerator
+ *
+ * \brief Start TCP flows on demand and serve the flows of other hosts.
+ *
+ * Every host runs a single FlowGenerator.  It listens on one socket for the
+ * flows sent to the host, and opens a connection for each flow it starts
+ * itself, when the flow starts.  Flows are either given up front with
+ * AddFlow, or drawn at run time: the InterArrival, FlowSize and Tos random
+ * variables pick when the next flow starts, how many bytes it carries and
+ * its class, and the peer is picked uniformly among the destinations added
+ * with AddDestination.  Flows are launched until FlowLaunchEnd.
+ *
+ * A flow completes when all its bytes have been acknowledged; its sender
+ * socket is then closed and forgotten, and only a FlowRecord is kept.  The
+ * receiver closes its side when the peer does.
+ *
+ * If the Fluid attribute is set, the generated flows to IPv4 peers are
+ * background flows, given to the FluidBackground model instead of being
+ * sent packet by packet; their bytes are not counted by the peer.  The
+ * flows given with AddFlow are always sent as packets.
+ */
+class FlowGenerator : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  FlowGenerator ();
+
+  virtual ~FlowGenerator ();
+
+  /**
+   * \brief What is kept of a flow started by this host.
+   */
+  struct FlowRecord
+  {
+    Time m_start;    //!< Time the flow was started
+    Time m_fct;      //!< Flow completion time, zero while not completed
+    uint32_t m_size; //!< Flow size in bytes
+    bool m_fluid;    //!< True for a fluid background flow
+  };
+
+  /**
+   * \brief Container of flow records, in the order the flows started.
+   */
+  typedef std::vector<FlowRecord> FlowRecords;
+
+  /**
+   * TracedCallback signature for flow completion.
+   *
+   * \param [in] size The flow size in bytes.
+   * \param [in] fct The flow completion time.
+   */
+  typedef void (* FlowCompleteTracedCallback)(uint32_t size, Time fct);
+
+  /**
+   * \brief Add a peer that generated flows may be sent to.
+   * \param address the address and port of the peer FlowGenerator
+   */
+  void AddDestination (const Address &address);
+
+  /**
+   * \brief Schedule a flow.
+   * \param start the absolute time the flow starts at
+   * \param address the address and port of the peer FlowGenerator
+   * \param size the flow size in bytes, which must not be zero
+   * \param tos the simple TOS of the flow
+   */
+  void AddFlow (Time start, const Address &address, uint32_t size, uint8_t tos);
+
+  /**
+   * \brief Get the records of the flows started so far.
+   * \return the flow records
+   */
+  const FlowRecords &GetFlowRecords (void) const;
+
+  /**
+   * \brief Get the number of flows started and not completed yet.
+   * \return the number of active flows
+   */
+  uint32_t GetActiveFlows (void) const;
+
+  /**
+   * \brief Get the total bytes received from the flows of other hosts.
+   * \return the number of bytes received
+   */
+  uint64_t GetTotalRx (void) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  // inherited from Application base class.
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * \brief A flow given with AddFlow, not started yet.
+   */
+  struct PendingFlow
+  {
+    Time m_start;      //!< Start time
+    Address m_peer;    //!< Peer address
+    uint32_t m_size;   //!< Flow size in bytes
+    uint8_t m_tos;     //!< Simple TOS
+  };
+
+  /**
+   * \brief Sender state of a flow in progress.
+   */
+  struct ActiveFlow
+  {
+    uint32_t m_record;  //!< Index of the flow record
+    uint32_t m_sent;    //!< Bytes handed to the socket so far
+    uint32_t m_txSpace; //!< Send buffer space when nothing is outstanding
+    uint8_t m_tos;      //!< Simple TOS
+  };
+
+  /**
+   * \brief Order pending flows by start time.
+   * \param a a pending flow
+   * \param b another pending flow
+   * \return true if a starts before b
+   */
+  static bool StartsBefore (const PendingFlow &a, const PendingFlow &b);
+
+  /**
+   * \brief Start the next flow given with AddFlow and schedule the one after.
+   */
+  void LaunchPendingFlow (void);
+
+  /**
+   * \brief Start a generated flow and schedule the next arrival.
+   */
+  void LaunchRandomFlow (void);
+
+  /**
+   * \brief Schedule the next generated flow, if it starts before FlowLaunchEnd.
+   */
+  void ScheduleNextArrival (void);
+
+  /**
+   * \brief Open a connection for a new flow.
+   * \param peer the peer address
+   * \param size the flow size in bytes
+   * \param tos the simple TOS of the flow
+   */
+  void StartFlow (const Address &peer, uint32_t size, uint8_t tos);
+
+  /**
+   * \brief Give a new flow to the fluid background model.
+   * \param peer the peer address
+   * \param size the flow size in bytes
+   * \return false if the fluid model cannot carry the flow
+   */
+  bool StartFluidFlow (const Address &peer, uint32_t size);
+
+  /**
+   * \brief A fluid flow completed (called by FluidBackground through a callback)
+   * \param id the fluid flow id
+   */
+  void FluidFlowCompleted (uint32_t id);
+
+  /**
+   * \brief Fill the send buffer of a flow.
+   * \param socket the flow socket
+   * \param flow the flow state
+   */
+  void SendData (Ptr<Socket> socket, ActiveFlow &flow);
+
+  /**
+   * \brief Forget a flow, closing its socket.
+   * \param socket the flow socket
+   * \param completed true if all the flow bytes were acknowledged
+   */
+  void EndFlow (Ptr<Socket> socket, bool completed);
+
+  /**
+   * \brief Connection succeeded (called by Socket through a callback)
+   * \param socket the connected socket
+   */
+  void ConnectionSucceeded (Ptr<Socket> socket);
+  /**
+   * \brief Connection failed (called by Socket through a callback)
+   * \param socket the socket
+   */
+  void ConnectionFailed (Ptr<Socket> socket);
+  /**
+   * \brief Send more data, or complete the flow, when buffer space is freed
+   * \param socket the socket
+   * \param available the free buffer space
+   */
+  void DataSend (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Handle a new connection from a peer
+   * \param socket the accepted socket
+   * \param from the peer address
+   */
+  void HandleAccept (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief Read and discard the data of a peer flow
+   * \param socket the accepted socket
+   */
+  void HandleRead (Ptr<Socket> socket);
+  /**
+   * \brief Close our side of a connection the peer has closed
+   * \param socket the accepted socket
+   */
+  void HandlePeerClose (Ptr<Socket> socket);
+  /**
+   * \brief Forget a connection that failed
+   * \param socket the socket
+   */
+  void HandlePeerError (Ptr<Socket> socket);
+
+  TypeId          m_tid;          //!< The type of protocol to use
+  uint16_t        m_port;         //!< Listening port
+  uint32_t        m_sendSize;     //!< Size of data to send each time
+  Time            m_launchEnd;    //!< No flow is generated after this time
+  Ptr<RandomVariableStream> m_interArrival; //!< Time between generated flows
+  Ptr<RandomVariableStream> m_flowSize;     //!< Size of generated flows
+  Ptr<RandomVariableStream> m_tos;          //!< Simple TOS of generated flows
+  Ptr<UniformRandomVariable> m_peerChooser; //!< Picks generated flow peers
+  Ptr<FluidBackground> m_fluid;             //!< Fluid model of generated flows
+
+  Ptr<Socket>     m_listenSocket; //!< Listening socket
+  std::set<Ptr<Socket> > m_accepted;              //!< Connections from peers
+  std::map<Ptr<Socket>, ActiveFlow> m_active;     //!< Flows in progress
+  std::map<uint32_t, uint32_t> m_fluidActive;     //!< Fluid flow records by fluid id
+  std::vector<Address> m_destinations;            //!< Generated flow peers
+  std::vector<PendingFlow> m_pending;             //!< Flows given with AddFlow
+  uint32_t        m_nextPending;  //!< Next pending flow to start
+  EventId         m_pendingEvent; //!< Start of the next pending flow
+  EventId         m_arrivalEvent; //!< Start of the next generated flow
+  FlowRecords     m_records;      //!< Records of the flows started
+  uint64_t        m_totalRx;      //!< Bytes received from peers
+
+  /// Traced Callback: flow completed
+  TracedCallback<uint32_t, Time> m_flowCompleteTrace;
+};
+
+} // namespace ns3
+
+#endif /* FLOW_GENERATOR_H */
@@ -0,0 +1,258 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLUID_BACKGROUND_H
+#define FLUID_BACKGROUND_H
+
+#include "ns3/object.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+class Node;
+class NetDevice;
+
+/**
+ * \ingroup flowgenerator
+ *
+ * \brief Rate-based model of background flows, sharing the links with the
+ * packet-level traffic.
+ *
+ * A fluid flow follows the route the IPv4 routing protocols of the nodes
+ * give to its destination, and is only described by its rate: no packet
+ * is sent and no event is scheduled per packet.  The rates are computed
+ * in one of two ways:
+ *
+ *  - MAX_MIN: the max-min fair share of the flows, computed again when a
+ *    flow starts or completes.  A flow costs about two events.
+ *  - DCTCP: every UpdateInterval, standing for a round trip time, each
+ *    flow increases its rate by one segment per interval, or cuts it like
+ *    DCTCP if a link of its path has a fluid backlog above
+ *    MarkingThreshold.  The links keep the backlog of the fluid sent
+ *    beyond their share.
+ *
+ * The fluid flows may take at most MaxShare of the capacity of each link.
+ * The rest, and whatever the fluid flows do not use, is left to the
+ * packets: the DataRate attribute of the devices along the paths is
+ * lowered to the capacity the fluid flows leave, so that the packet
+ * flows queue in the queue discs as they would behind the background
+ * load.  The original rates are restored when the model is disposed.
+ *
+ * Only the devices with a non-zero DataRate attribute, such as the point
+ * to point devices, limit the fluid flows.
+ *
+ * The model has the following limits:
+ *
+ *  - The fluid backlog is not put in the queue discs: it delays no packet
+ *    and is not seen by the AQMs, which mark and drop on the packets
+ *    alone.  While a link drains it, the packets only get the capacity
+ *    left beyond MaxShare.
+ *  - In MAX_MIN mode the fluid flows never offer more than MaxShare of a
+ *    link, so no backlog ever builds: the background load only shows as
+ *    a slower link.
+ *  - The DataRate of the devices changes at run time.  The estimators
+ *    configured with the link capacity, such as the DREs of the CONGA
+ *    and TLB routing and the Ipv4LinkProbe utilisation, count the packet
+ *    bytes against the full capacity, and thus see the links as less
+ *    loaded than they are; GetFluidRate gives what they miss.
+ */
+class FluidBackground : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  FluidBackground ();
+
+  virtual ~FluidBackground ();
+
+  /**
+   * \brief How the rates of the fluid flows are computed.
+   */
+  enum Mode
+  {
+    MAX_MIN,   //!< Max-min fair share
+    DCTCP      //!< DCTCP-like additive increase, multiplicative decrease
+  };
+
+  /**
+   * TracedCallback signature for fluid flow completion.
+   *
+   * \param [in] size The flow size in bytes.
+   * \param [in] fct The flow completion time.
+   */
+  typedef void (* FlowCompleteTracedCallback)(uint32_t size, Time fct);
+
+  /**
+   * \brief Start a fluid flow.
+   * \param source the node the flow is sent from
+   * \param destination the address the flow is sent to
+   * \param size the flow size in bytes
+   * \param completed called with the flow id when the flow completes
+   * \return the flow id, or 0 if there is no route to the destination
+   */
+  uint32_t StartFlow (Ptr<Node> source, Ipv4Address destination, uint32_t size,
+                      Callback<void, uint32_t> completed);
+
+  /**
+   * \brief Stop a fluid flow before it completes.
+   * \param id the flow id
+   */
+  void StopFlow (uint32_t id);
+
+  /**
+   * \brief Get the number of fluid flows in progress.
+   * \return the number of active flows
+   */
+  uint32_t GetActiveFlows (void) const;
+
+  /**
+   * \brief Get the rate the fluid flows take on a device.
+   * \param device the device
+   * \return the rate in bits per second
+   */
+  double GetFluidRate (Ptr<NetDevice> device) const;
+
+  /**
+   * \brief Get the fluid backlog of a device.
+   * \param device the device
+   * \return the backlog in bytes
+   */
+  double GetBacklog (Ptr<NetDevice> device) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief A link used by fluid flows: the device sending on it.
+   */
+  struct Link
+  {
+    Ptr<NetDevice> m_device; //!< The sending device
+    double m_capacity;       //!< Capacity in bits per second
+    double m_offered;        //!< Sum of the rates of the flows, in bits per second
+    double m_served;         //!< Rate of fluid served, in bits per second
+    double m_backlog;        //!< Fluid backlog in bits
+    double m_packetRate;     //!< DataRate left to the packets, in bits per second
+  };
+
+  /**
+   * \brief A fluid flow in progress.
+   */
+  struct Flow
+  {
+    uint32_t m_id;                  //!< Flow id
+    std::vector<uint32_t> m_links;  //!< Links of the path
+    double m_remaining;             //!< Bits not delivered yet
+    double m_rate;                  //!< Sending rate in bits per second
+    double m_goodput;               //!< Delivery rate in bits per second
+    double m_maxRate;               //!< Rate of the slowest link of the path
+    double m_alpha;                 //!< DCTCP estimate of the marked fraction
+    Time m_start;                   //!< Start time
+    uint32_t m_size;                //!< Size in bytes
+    Callback<void, uint32_t> m_completed; //!< Completion callback
+  };
+
+  /**
+   * \brief Find the links from a node to an address.
+   * \param source the source node
+   * \param destination the destination address
+   * \param id the flow id, picking the path among equal cost ones
+   * \param links the links of the path
+   * \return true if the destination is reachable
+   */
+  bool FindPath (Ptr<Node> source, Ipv4Address destination, uint32_t id,
+                 std::vector<uint32_t> &links);
+
+  /**
+   * \brief Get the link of a device, adding it if needed.
+   * \param device the sending device
+   * \param link the index of the link
+   * \return false if the device does not limit the fluid flows
+   */
+  bool GetLink (Ptr<NetDevice> device, uint32_t &link);
+
+  /**
+   * \brief Deliver the fluid sent since the last update.
+   */
+  void Advance (void);
+
+  /**
+   * \brief Compute the served rates of the links and the goodput of the
+   * flows from the flow rates, and update the devices.
+   */
+  void UpdateLinks (void);
+
+  /**
+   * \brief Set the max-min fair rates of the flows.
+   */
+  void ComputeMaxMin (void);
+
+  /**
+   * \brief Remove the flows which delivered all their bits.
+   * \param done the flows removed
+   */
+  void RemoveCompletedFlows (std::vector<Flow> &done);
+
+  /**
+   * \brief Update the DCTCP rates of the flows, once per interval.
+   */
+  void UpdateDctcpRates (void);
+
+  /**
+   * \brief Schedule the next rate update or completion.
+   */
+  void ScheduleUpdate (void);
+
+  /**
+   * \brief Update the flows at the scheduled time.
+   */
+  void Update (void);
+
+  Mode     m_mode;                //!< How the rates are computed
+  double   m_maxShare;            //!< Maximum fraction of a link for fluid flows
+  Time     m_interval;            //!< DCTCP rate update interval
+  uint32_t m_segmentSize;         //!< DCTCP segment size
+  uint32_t m_initialWindow;       //!< DCTCP initial window in segments
+  uint32_t m_markingThreshold;    //!< DCTCP marking backlog in bytes
+  double   m_g;                   //!< DCTCP estimation gain
+
+  std::vector<Link> m_links;                       //!< The links used
+  std::map<Ptr<NetDevice>, uint32_t> m_linkIndex;  //!< Links by device
+  std::vector<Flow> m_flows;                       //!< The flows in progress
+  uint32_t m_nextId;              //!< Id of the next flow
+  Time     m_lastUpdate;          //!< When the fluid was last delivered
+  EventId  m_event;               //!< Next update or completion
+
+  /// Traced Callback: fluid flow completed
+  TracedCallback<uint32_t, Time> m_flowCompleteTrace;
+};
+
+} // namespace ns3
+
+#endif /* FLUID_BACKGROUND_H */
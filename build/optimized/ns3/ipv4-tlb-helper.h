@@ -0,0 +1,11 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef TLB_HELPER_H
+#define TLB_HELPER_H
+
+namespace ns3 {
+
+
+}
+
+#endif /* TLB_HELPER_H */
+
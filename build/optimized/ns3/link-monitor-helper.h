@@ -0,0 +1,14 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef LINK_MONITOR_HELPER_H
+#define LINK_MONITOR_HELPER_H
+
+#include "ns3/link-monitor.h"
+
+namespace ns3 {
+
+/* ... */
+
+}
+
+#endif /* LINK_MONITOR_HELPER_H */
+
@@ -0,0 +1,16 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_LINK_MONITOR
+    
+
+// Module headers:
+#include "ipv4-link-probe.h"
+#include "ipv4-queue-probe.h"
+#include "link-monitor-helper.h"
+#include "link-monitor.h"
+#include "link-probe.h"
+#include "link-stats-file.h"
+#endif
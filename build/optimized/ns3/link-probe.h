@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef LINK_PROBE_H
+#define LINK_PROBE_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <vector>
+#include <string>
+
+namespace ns3 {
+
+class LinkMonitor;
+class LinkStatsWriter;
+
+class LinkProbe : public Object
+{
+public:
+
+  struct LinkStats
+  {
+    // The check time
+    Time        checkTime;
+
+    // The accumulated bytes transmitted on this link
+    uint64_t    accumulatedTxBytes;
+
+    // The utility of this link based on TX
+    double      txLinkUtility;
+
+    // The accumulated bytes dequeued on this link
+    uint64_t    accumulatedDequeueBytes;
+
+    // The utility of this link based on dequeue
+    double      dequeueLinkUtility;
+
+    uint32_t    packetsInQueue;
+
+    uint32_t    bytesInQueue;
+
+    uint32_t    packetsInQueueDisc;
+
+    uint32_t    bytesInQueueDisc;
+  };
+
+  static TypeId GetTypeId (void);
+
+  LinkProbe (Ptr<LinkMonitor> linkMonitor);
+
+  virtual ~LinkProbe ();
+
+  // The samples kept in memory, empty when they are streamed to a file
+  const std::map<uint32_t, std::vector<struct LinkStats> > &GetLinkStats (void) const;
+
+  // Stream the samples to a writer instead of keeping them in memory
+  void SetWriter (Ptr<LinkStatsWriter> writer, uint32_t probeIndex);
+
+  void SetProbeName (std::string name);
+
+  std::string GetProbeName (void);
+
+  virtual void Start () = 0;
+
+  virtual void Stop () = 0;
+
+protected:
+  // Keep or stream a new sample of an interface
+  void RecordStats (uint32_t interface, const struct LinkStats &stats);
+
+  // map <interface, the last link stats collected>
+  std::map<uint32_t, struct LinkStats> m_lastStats;
+
+  // map <interface, list of link stats collected at different time point>
+  // The later ones are inserted at the tail of the list
+  std::map<uint32_t, std::vector<struct LinkStats> > m_stats;
+
+  // Used to help identifying the probe
+  std::string m_probeName;
+
+  // Writer the samples are streamed to, if any
+  Ptr<LinkStatsWriter> m_writer;
+
+  // Index of the probe in the file of the writer
+  uint32_t m_probeIndex;
+};
+
+}
+
+#endif /* LINK_PROBE_H */
+
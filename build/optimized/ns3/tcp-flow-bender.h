@@ -0,0 +1,48 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef TCP_FLOW_BENDER
+#define TCP_FLOW_BENDER
+
+#include "ns3/object.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+
+class TcpFlowBender : public Object
+{
+public:
+    static TypeId GetTypeId (void);
+
+    TcpFlowBender ();
+    TcpFlowBender (const TcpFlowBender &other);
+    ~TcpFlowBender ();
+
+    virtual void DoDispose (void);
+
+    /**
+     * \brief Check the congestion at the end of an observation window
+     * \param markedFraction the fraction of the bytes acknowledged with
+     *        ECE in the window, from the ECN accounting of the socket
+     */
+    void WindowEnded (double markedFraction);
+
+    uint32_t GetV ();
+
+    Time GetPauseTime ();
+
+private:
+
+    // Variables
+    uint32_t m_numCongestionRtt;
+    uint32_t m_V;
+
+    // Parameters
+    Time m_rtt;
+    double m_T;
+    uint32_t m_N;
+};
+
+}
+
+#endif
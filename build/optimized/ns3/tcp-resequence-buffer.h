@@ -0,0 +1,152 @@
+#ifndef TCP_RESEQUENCE_BUFFER_H
+#define TCP_RESEQUENCE_BUFFER_H
+
+#include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/sequence-number.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+#include "ns3/traced-value.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+enum TcpRBPopReason
+{
+  IN_ORDER_FULL = 0,
+  IN_ORDER_TIMEOUT,
+  OUT_ORDER_TIMEOUT,
+  RE_TRANS,
+  OUT_OF_WINDOW
+};
+
+class TcpSocketBase;
+
+class TcpResequenceBufferElement
+{
+
+public:
+  SequenceNumber32 m_seq;
+
+  bool m_isSyn;
+
+  bool m_isFin;
+
+  uint32_t m_dataSize; // In bytes
+
+  Ptr<Packet> m_packet;
+};
+
+/**
+ * \brief Receive side resequencing buffer for packet spraying schemes
+ *
+ * Segments are held in a circular window indexed by (seq - firstSeq) / MSS,
+ * with one occupancy bit per slot. The window holds an in-order run
+ * [firstSeq, nextSeq) that is released as a batch when it grows beyond
+ * SizeLimit or gets older than InOrderQueueTimerLimit, followed by
+ * out-of-order segments that are released when no progress is made for
+ * OutOrderQueueTimerLimit. Both deadlines share a single timer, which is
+ * only scheduled while the buffer holds data.
+ *
+ * Segments that do not fit the window (SYN/FIN, segments not aligned on the
+ * MSS or too far ahead) release everything held and are forwarded right away,
+ * leaving the reassembly to the TcpRxBuffer.
+ *
+ * The MSS is the largest data segment received so far, not the segment size
+ * of the receiving socket, so that the sender may use another one.
+ */
+class TcpResequenceBuffer : public Object
+{
+
+public:
+
+  static TypeId GetTypeId (void);
+
+  TcpResequenceBuffer ();
+  //TcpResequenceBuffer (const TcpResequenceBuffer &);
+  ~TcpResequenceBuffer ();
+
+  virtual void DoDispose (void);
+
+  void BufferPacket (Ptr<Packet> packet, const Address& fromAddress, const Address& toAddress);
+
+  void SetTcp (TcpSocketBase *tcp);
+
+  void Stop (void);
+
+  TracedCallback <uint32_t, Time, SequenceNumber32, SequenceNumber32> m_tcpRBBuffer;
+  TracedCallback <uint32_t, Time, SequenceNumber32, uint32_t, uint32_t, TcpRBPopReason> m_tcpRBFlush;
+
+private:
+
+  SequenceNumber32 CalculateNextSeq (const TcpResequenceBufferElement &element);
+
+  /**
+   * \brief Get the window slot of a sequence number
+   * \param seq the sequence number
+   * \param slot the slot index, if any
+   * \returns false if the sequence number cannot be held in the window
+   */
+  bool GetSlot (SequenceNumber32 seq, uint32_t &slot) const;
+  bool IsOccupied (uint32_t slot) const;
+  void SetOccupied (uint32_t slot);
+  void ClearOccupied (uint32_t slot);
+
+  void PutInTheInOrderQueue (uint32_t slot, const TcpResequenceBufferElement &element);
+
+  void ArmDeadline (void);
+  void DeadlineExpired (void);
+
+  void FlushOneElement (const TcpResequenceBufferElement &element, TcpRBPopReason reason);
+  void FlushInOrderQueue (TcpRBPopReason reason);
+  void FlushOutOrderQueue (TcpRBPopReason reason);
+
+  // Parameters
+  uint32_t m_sizeLimit;
+
+  Time m_inOrderQueueTimerLimit;
+  Time m_outOrderQueueTimerLimit;
+
+  uint32_t m_windowSize;            //!< Number of segments the window can hold
+  Time m_periodicalCheckTime;       //!< Deprecated, ignored
+
+  uint32_t m_traceFlowId;
+
+  // Variables
+  uint32_t m_size;                  //!< Bytes in the in order run
+  Time m_inOrderQueueTimer;
+  Time m_outOrderQueueTimer;
+
+  EventId m_deadlineEvent;
+  bool m_hasStopped;
+  bool m_hasStarted;                //!< Whether the first data segment has been seen
+
+  SequenceNumber32 m_firstSeq;
+  SequenceNumber32 m_nextSeq;
+
+  uint32_t m_segmentSize;           //!< Stride of the window, in bytes
+  uint32_t m_slots;                 //!< m_windowSize rounded up to a multiple of 32
+  uint32_t m_headSlot;              //!< Slot of m_firstSeq
+  uint32_t m_inOrderCount;          //!< Segments in the in order run
+  uint32_t m_outOrderCount;         //!< Segments held beyond m_nextSeq
+
+  std::vector<TcpResequenceBufferElement> m_window; //!< Held segments
+  std::vector<uint32_t> m_occupancy;                //!< One bit per slot
+
+  Address m_fromAddress;            //!< Peer address of the connection
+  Address m_toAddress;              //!< Local address of the connection
+
+  TcpSocketBase *m_tcp;
+
+  typedef void (* TcpRBBuffer) (uint32_t flowId, Time time, SequenceNumber32 recSeq,
+          SequenceNumber32 nextSeq);
+  typedef void (* TcpRBFlush) (uint32_t flowId, Time time, SequenceNumber32 popSeq,
+          uint32_t inOrderLength, uint32_t outOrderLength, TcpRBPopReason reason);
+};
+
+}
+
+#endif
@@ -120,14 +120,22 @@ double rand_range(double min, double max)
 
 /* generate a random value based on CDF distribution */
 double gen_random_cdf(struct cdf_table *table)
+{
+    return gen_cdf_value(table, (double)rand() / RAND_MAX);
+}
+
+/* get the value of CDF distribution for a uniform number u in [0, 1) */
+double gen_cdf_value(struct cdf_table *table, double u)
 {
     int i = 0;
-    double x = rand_range(table->min_cdf, table->max_cdf);
-    /* printf("%f %f %f\n", x, table->min_cdf, table->max_cdf); */
+    double x;
 
     if (!table)
         return 0;
 
+    x = table->min_cdf + u * (table->max_cdf - table->min_cdf);
+    /* printf("%f %f %f\n", x, table->min_cdf, table->max_cdf); */
+
     for (i = 0; i < table->num_entry; i++)
     {
         if (x <= table->entries[i].cdf)
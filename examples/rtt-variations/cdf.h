@@ -40,4 +40,7 @@ double avg_cdf(struct cdf_table *table);
 /* Generate a random value based on CDF distribution */
 double gen_random_cdf(struct cdf_table *table);
 
+/* Get the value of CDF distribution for a uniform number u in [0, 1) */
+double gen_cdf_value(struct cdf_table *table, double u);
+
 #endif
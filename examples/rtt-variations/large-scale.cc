@@ -6,22 +6,20 @@
 #include "ns3/flow-monitor-module.h"
 #include "ns3/ipv4-global-routing-helper.h"
 #include "ns3/traffic-control-module.h"
+#include "ns3/simulator-fork.h"
 
 #include <vector>
 #include <map>
 #include <utility>
 #include <set>
-
-// The CDF in TrafficGenerator
-extern "C"
-{
-#include "cdf.h"
-}
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
 
 #define LINK_CAPACITY_BASE    1000000000          // 1Gbps
 #define BUFFER_SIZE 250                           // 250 packets
 
-// The flow port range, each flow will be assigned a random port number within this range
+// The port every flow generator listens on
 
 static uint16_t PORT = 1000;
 
@@ -36,24 +34,10 @@ enum AQM {
   ECNSharp
 };
 
-// Acknowledged to https://github.com/HKUST-SING/TrafficGenerator/blob/master/src/common/common.c
-double poission_gen_interval(double avg_rate)
-{
-  if (avg_rate > 0)
-    return -logf(1.0 - (double)rand() / RAND_MAX) / avg_rate;
-  else
-    return 0;
-}
-
-template<typename T>
-T rand_range (T min, T max)
-{
-  return min + ((double)max - min) * rand () / RAND_MAX;
-}
-
-void install_incast_applications (NodeContainer servers, long &flowCount, int SERVER_COUNT, int LEAF_COUNT, double START_TIME, double END_TIME, double FLOW_LAUNCH_END_TIME)
+void install_incast_applications (NodeContainer servers, ApplicationContainer generators, int SERVER_COUNT, double START_TIME, double FLOW_LAUNCH_END_TIME)
 {
   NS_LOG_INFO ("Install incast applications:");
+  CounterRng rng;
   for (int i = 0; i < SERVER_COUNT; i++)
     {
       Ptr<Node> destServer = servers.Get (i);
@@ -61,37 +45,21 @@ void install_incast_applications (NodeContainer servers, long &flowCount, int SE
       Ipv4InterfaceAddress destInterface = ipv4->GetAddress (1,0);
       Ipv4Address destAddress = destInterface.GetLocal ();
 
-      uint32_t fanout = rand () % 50 + 100;
+      uint32_t fanout = rng.GetInteger (50) + 100;
       for (uint32_t j = 0; j < fanout; j++)
         {
-          double startTime = START_TIME + static_cast<double> (rand () % 100) / 1000000;
+          double startTime = START_TIME + static_cast<double> (rng.GetInteger (100)) / 1000000;
           while (startTime < FLOW_LAUNCH_END_TIME)
             {
-              flowCount ++;
-              uint32_t fromServerIndex = rand () % SERVER_COUNT;
-              uint16_t port = PORT++;
-
-              BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (destAddress, port));
-              uint32_t flowSize = rand () % 10000;
-              uint32_t tos = rand() % 5;
-
-              source.SetAttribute ("SendSize", UintegerValue (PACKET_SIZE));
-              source.SetAttribute ("MaxBytes", UintegerValue(flowSize));
-              source.SetAttribute ("SimpleTOS", UintegerValue (tos));
-
-              // Install apps
-              ApplicationContainer sourceApp = source.Install (servers.Get (fromServerIndex));
-              sourceApp.Start (Seconds (startTime));
-              sourceApp.Stop (Seconds (END_TIME));
-
-              // Install packet sinks
-              PacketSinkHelper sink ("ns3::TcpSocketFactory",
-                                     InetSocketAddress (Ipv4Address::GetAny (), port));
-              ApplicationContainer sinkApp = sink.Install (servers. Get (i));
-              sinkApp.Start (Seconds (START_TIME));
-              sinkApp.Stop (Seconds (END_TIME));
-
-              startTime += static_cast<double> (rand () % 1000) / 1000000;
+              uint32_t fromServerIndex = rng.GetInteger (SERVER_COUNT);
+              uint32_t flowSize = rng.GetInteger (10000) + 1;
+              uint32_t tos = rng.GetInteger (5);
+
+              // The flow is started on demand by the generator of the source
+              Ptr<FlowGenerator> generator = DynamicCast<FlowGenerator> (generators.Get (fromServerIndex));
+              generator->AddFlow (Seconds (startTime), InetSocketAddress (destAddress, PORT), flowSize, tos);
+
+              startTime += static_cast<double> (rng.GetInteger (1000)) / 1000000;
             }
 
         }
@@ -99,54 +67,38 @@ void install_incast_applications (NodeContainer servers, long &flowCount, int SE
     }
 }
 
-void install_applications (int fromLeafId, NodeContainer servers, double requestRate, struct cdf_table *cdfTable,
-                           long &flowCount, long &totalFlowSize, int SERVER_COUNT, int LEAF_COUNT, double START_TIME, double END_TIME, double FLOW_LAUNCH_END_TIME)
+void install_applications (int fromLeafId, NodeContainer servers, ApplicationContainer generators, double requestRate,
+                           std::string cdfFileName, int SERVER_COUNT, int LEAF_COUNT)
 {
   NS_LOG_INFO ("Install applications:");
   for (int i = 0; i < SERVER_COUNT; i++)
     {
       int fromServerIndex = fromLeafId * SERVER_COUNT + i;
 
-      double startTime = START_TIME + poission_gen_interval (requestRate);
-      while (startTime < FLOW_LAUNCH_END_TIME)
+      // Poisson arrivals of flows to servers under the other leaves
+      Ptr<FlowGenerator> generator = DynamicCast<FlowGenerator> (generators.Get (fromServerIndex));
+      Ptr<ExponentialRandomVariable> interArrival = CreateObject<ExponentialRandomVariable> ();
+      interArrival->SetAttribute ("Mean", DoubleValue (1 / requestRate));
+      Ptr<UniformRandomVariable> tos = CreateObject<UniformRandomVariable> ();
+      tos->SetAttribute ("Min", DoubleValue (0));
+      tos->SetAttribute ("Max", DoubleValue (5));
+      generator->SetAttribute ("InterArrival", PointerValue (interArrival));
+      // Each generator assigns the stream of its own flow size variable
+      generator->SetAttribute ("FlowSize", PointerValue (FlowGeneratorHelper::LoadFlowSizeCdf (cdfFileName)));
+      generator->SetAttribute ("Tos", PointerValue (tos));
+
+      for (int destServerIndex = 0; destServerIndex < SERVER_COUNT * LEAF_COUNT; destServerIndex++)
         {
-          flowCount ++;
-          uint16_t port = PORT++;
-
-          int destServerIndex = fromServerIndex;
-          while (destServerIndex >= fromLeafId * SERVER_COUNT && destServerIndex < fromLeafId * SERVER_COUNT + SERVER_COUNT)
+          if (destServerIndex >= fromLeafId * SERVER_COUNT && destServerIndex < fromLeafId * SERVER_COUNT + SERVER_COUNT)
             {
-              destServerIndex = rand_range (0, SERVER_COUNT * LEAF_COUNT);
+              continue;
             }
-
           Ptr<Node> destServer = servers.Get (destServerIndex);
           Ptr<Ipv4> ipv4 = destServer->GetObject<Ipv4> ();
           Ipv4InterfaceAddress destInterface = ipv4->GetAddress (1,0);
           Ipv4Address destAddress = destInterface.GetLocal ();
 
-          BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (destAddress, port));
-          uint32_t flowSize = gen_random_cdf (cdfTable);
-          uint32_t tos = rand() % 5;
-
-          totalFlowSize += flowSize;
-
-          source.SetAttribute ("SendSize", UintegerValue (PACKET_SIZE));
-          source.SetAttribute ("MaxBytes", UintegerValue(flowSize));
-          source.SetAttribute ("SimpleTOS", UintegerValue (tos));
-
-          // Install apps
-          ApplicationContainer sourceApp = source.Install (servers.Get (fromServerIndex));
-          sourceApp.Start (Seconds (startTime));
-          sourceApp.Stop (Seconds (END_TIME));
-
-          // Install packet sinks
-          PacketSinkHelper sink ("ns3::TcpSocketFactory",
-                                 InetSocketAddress (Ipv4Address::GetAny (), port));
-          ApplicationContainer sinkApp = sink.Install (servers. Get (destServerIndex));
-          sinkApp.Start (Seconds (START_TIME));
-          sinkApp.Stop (Seconds (END_TIME));
-
-          startTime += poission_gen_interval (requestRate);
+          generator->AddDestination (InetSocketAddress (destAddress, PORT));
         }
     }
 }
@@ -188,6 +140,14 @@ int main (int argc, char *argv[])
   uint32_t ECNSharpTarget = 10;
   uint32_t ECNSharpMarkingThreshold = 80;
 
+  // Sweep of marking thresholds sharing the set up and the warm up
+  std::string sweepThresholds = "";
+  double FORK_TIME = 0.1;
+
+  // Background flows modelled as fluid flows
+  bool fluidBackground = false;
+  std::string fluidMode = "MaxMin";
+
   CommandLine cmd;
   cmd.AddValue ("ID", "Running ID", id);
   cmd.AddValue ("StartTime", "Start time of the simulation", START_TIME);
@@ -215,6 +175,12 @@ int main (int argc, char *argv[])
   cmd.AddValue ("ECNSharpTarget", "The persistent target for ECNShapr", ECNSharpTarget);
   cmd.AddValue ("ECNShaprMarkingThreshold", "The instantaneous marking threshold for ECNSharp", ECNSharpMarkingThreshold);
 
+  cmd.AddValue ("SweepThresholds", "Comma separated marking thresholds (TCN or ECNSharp instantaneous) to run from the fork time on", sweepThresholds);
+  cmd.AddValue ("ForkTime", "When the sweep forks the simulation", FORK_TIME);
+
+  cmd.AddValue ("fluidBackground", "Model the generated background flows as fluid flows", fluidBackground);
+  cmd.AddValue ("fluidMode", "Rates of the fluid flows: MaxMin or Dctcp", fluidMode);
+
 
   cmd.Parse (argc, argv);
 
@@ -239,7 +205,7 @@ int main (int argc, char *argv[])
     }
   else
     {
-      return 0;
+      NS_FATAL_ERROR ("Unknown AQM " << aqmStr << ", use TCN or ECNSharp");
     }
 
   if (transportProt.compare ("DcTcp") == 0)
@@ -272,8 +238,6 @@ int main (int argc, char *argv[])
   Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (160000000));
   Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (160000000));
 
-  Config::SetDefault ("ns3::Ipv4GlobalRouting::PerflowEcmpRouting", BooleanValue(true));
-
   NodeContainer spines;
   spines.Create (SPINE_COUNT);
   NodeContainer leaves;
@@ -416,39 +380,40 @@ int main (int argc, char *argv[])
   double oversubRatio = static_cast<double>(SERVER_COUNT * LEAF_SERVER_CAPACITY) / (SPINE_LEAF_CAPACITY * SPINE_COUNT * LINK_COUNT);
   NS_LOG_INFO ("Over-subscription ratio: " << oversubRatio);
 
-  NS_LOG_INFO ("Initialize CDF table");
-  struct cdf_table* cdfTable = new cdf_table ();
-  init_cdf (cdfTable);
-  load_cdf (cdfTable, cdfFileName.c_str ());
-
   NS_LOG_INFO ("Calculating request rate");
-  double requestRate = load * LEAF_SERVER_CAPACITY * SERVER_COUNT / oversubRatio / (8 * avg_cdf (cdfTable)) / SERVER_COUNT;
+  double requestRate = load * LEAF_SERVER_CAPACITY * SERVER_COUNT / oversubRatio / (8 * FlowGeneratorHelper::GetMeanFlowSize (cdfFileName)) / SERVER_COUNT;
   NS_LOG_INFO ("Average request rate: " << requestRate << " per second");
 
   NS_LOG_INFO ("Initialize random seed: " << randomSeed);
   if (randomSeed == 0)
     {
-      srand ((unsigned)time (NULL));
-    }
-  else
-    {
-      srand (randomSeed);
+      randomSeed = (unsigned)time (NULL);
     }
+  RngSeedManager::SetSeed (randomSeed);
 
   NS_LOG_INFO ("Create applications");
 
-  long flowCount = 0;
-  long totalFlowSize = 0;
+  // A single flow generator per server starts its flows on demand
+  FlowGeneratorHelper flowGenerator ("ns3::TcpSocketFactory", PORT);
+  flowGenerator.SetAttribute ("SendSize", UintegerValue (PACKET_SIZE));
+  flowGenerator.SetAttribute ("FlowLaunchEnd", TimeValue (Seconds (FLOW_LAUNCH_END_TIME)));
+  Ptr<FluidBackground> fluid;
+  if (fluidBackground)
+    {
+      NS_LOG_INFO ("Background flows are fluid flows, mode: " << fluidMode);
+      fluid = CreateObject<FluidBackground> ();
+      fluid->SetAttribute ("Mode", StringValue (fluidMode));
+      flowGenerator.SetAttribute ("Fluid", PointerValue (fluid));
+    }
+  ApplicationContainer generators = flowGenerator.Install (servers);
+  generators.Start (Seconds (START_TIME));
+  generators.Stop (Seconds (END_TIME));
 
   for (int fromLeafId = 0; fromLeafId < LEAF_COUNT; fromLeafId ++)
     {
-      install_applications(fromLeafId, servers, requestRate, cdfTable, flowCount, totalFlowSize, SERVER_COUNT, LEAF_COUNT, START_TIME, END_TIME, FLOW_LAUNCH_END_TIME);
+      install_applications(fromLeafId, servers, generators, requestRate, cdfFileName, SERVER_COUNT, LEAF_COUNT);
     }
 
-  NS_LOG_INFO ("Total flow: " << flowCount);
-
-  NS_LOG_INFO ("Actual average flow size: " << static_cast<double> (totalFlowSize) / flowCount);
-
   NS_LOG_INFO ("Enabling flow monitor");
 
   Ptr<FlowMonitor> flowMonitor;
@@ -463,13 +428,119 @@ int main (int argc, char *argv[])
   flowMonitorFilename << "Large_Scale_" <<id << "_" << LEAF_COUNT << "X" << SPINE_COUNT << "_" << aqmStr << "_"  << transportProt << "_" << load << ".xml";
 
 
+  SimulatorFork fork;
+  if (!sweepThresholds.empty ())
+    {
+      std::string queueDiscs = "/NodeList/*/$ns3::TrafficControlLayer/RootQueueDiscList/*";
+      std::string path;
+      switch (aqm)
+        {
+        case TCN:
+          queueDiscs += "/$ns3::TCNQueueDisc";
+          path = queueDiscs + "/Threshold";
+          break;
+        case ECNSharp:
+          queueDiscs += "/$ns3::ECNSharpQueueDisc";
+          path = queueDiscs + "/InstantaneousMarkingThreshold";
+          break;
+        default:
+          NS_FATAL_ERROR ("No marking threshold to sweep for the AQM " << aqmStr);
+        }
+      // Config::Set silently ignores a path without match
+      if (Config::LookupMatches (queueDiscs).GetN () == 0)
+        {
+          NS_FATAL_ERROR ("No queue disc of the AQM " << aqmStr << " to sweep the threshold of");
+        }
+      std::istringstream thresholds (sweepThresholds);
+      std::string threshold;
+      while (std::getline (thresholds, threshold, ','))
+        {
+          uint32_t variant = fork.AddVariant (threshold);
+          fork.Set (variant, path, TimeValue (MicroSeconds (std::atoi (threshold.c_str ()))));
+        }
+      NS_LOG_INFO ("Forking " << fork.GetNVariants () << " thresholds at " << FORK_TIME << " s");
+      fork.ForkAt (Seconds (FORK_TIME));
+    }
+
   NS_LOG_INFO ("Start simulation");
   Simulator::Stop (Seconds (END_TIME));
   Simulator::Run ();
 
+  if (fork.IsCollected ())
+    {
+      for (uint32_t i = 0; i < fork.GetNVariants (); i++)
+        {
+          std::cout << "Threshold " << fork.GetVariantName (i) << ": ";
+          if (fork.GetExitStatus (i) == 0)
+            {
+              std::cout << fork.GetResult (i) << std::endl;
+            }
+          else
+            {
+              std::cout << "failed with status " << fork.GetExitStatus (i) << std::endl;
+            }
+        }
+      Simulator::Destroy ();
+      return 0;
+    }
+  if (fork.IsChild ())
+    {
+      flowMonitorFilename.str ("");
+      flowMonitorFilename << "Large_Scale_" <<id << "_" << LEAF_COUNT << "X" << SPINE_COUNT << "_" << aqmStr << "_"  << transportProt << "_" << load
+                          << "_" << fork.GetVariantName (fork.GetVariant ()) << ".xml";
+    }
+
   flowMonitor->SerializeToXmlFile(flowMonitorFilename.str (), true, true);
 
+  long flowCount = 0;
+  long completedFlowCount = 0;
+  long totalFlowSize = 0;
+  double totalFct = 0;
+  long fluidFlowCount = 0;
+  for (uint32_t i = 0; i < generators.GetN (); i++)
+    {
+      const FlowGenerator::FlowRecords &records = DynamicCast<FlowGenerator> (generators.Get (i))->GetFlowRecords ();
+      for (uint32_t j = 0; j < records.size (); j++)
+        {
+          flowCount++;
+          totalFlowSize += records[j].m_size;
+          if (records[j].m_fluid)
+            {
+              fluidFlowCount++;
+            }
+          if (records[j].m_fct.IsStrictlyPositive ())
+            {
+              completedFlowCount++;
+              totalFct += records[j].m_fct.GetSeconds ();
+            }
+        }
+    }
+
+  NS_LOG_INFO ("Total flow: " << flowCount << ", completed: " << completedFlowCount);
+  if (fluidFlowCount > 0)
+    {
+      NS_LOG_INFO ("Fluid background flow: " << fluidFlowCount);
+    }
+  if (flowCount > 0)
+    {
+      NS_LOG_INFO ("Actual average flow size: " << static_cast<double> (totalFlowSize) / flowCount);
+    }
+  if (completedFlowCount > 0)
+    {
+      NS_LOG_INFO ("Average FCT: " << totalFct / completedFlowCount << " s");
+    }
+
+  if (fork.IsChild ())
+    {
+      std::ostringstream summary;
+      summary << "completed " << completedFlowCount << "/" << flowCount << " flows";
+      if (completedFlowCount > 0)
+        {
+          summary << ", average FCT " << totalFct / completedFlowCount << " s";
+        }
+      fork.Finish (summary.str ());
+    }
+
   Simulator::Destroy ();
-  free_cdf (cdfTable);
   NS_LOG_INFO ("Stop simulation");
 }
@@ -24,10 +24,19 @@ enum AQM {
 };
 
 // Port from Traffic Generator // Acknowledged to https://github.com/HKUST-SING/TrafficGenerator/blob/master/src/common/common.c
+// The stream of the flow generators, keyed by the seed and the run of
+// RngSeedManager at the first draw
+static CounterRng &
+GetFlowRng (void)
+{
+    static CounterRng rng;
+    return rng;
+}
+
 double
 poission_gen_interval(double avg_rate) {
     if (avg_rate > 0)
-        return -logf(1.0 - (double)rand() / RAND_MAX) / avg_rate;
+        return -logf(1.0 - GetFlowRng ().GetDouble ()) / avg_rate;
     else
         return 0;
 }
@@ -44,7 +53,7 @@ void CheckThroughput (Ptr<PacketSink> sink, uint32_t senderID) {
 template<typename T> T
 rand_range (T min, T max)
 {
-    return min + ((double)max - min) * rand () / RAND_MAX;
+    return min + ((double)max - min) * GetFlowRng ().GetDouble ();
 }
 
 std::string
@@ -249,12 +258,9 @@ int main (int argc, char *argv[])
     NS_LOG_INFO ("Initialize random seed: " << randomSeed);
     if (randomSeed == 0)
     {
-        srand ((unsigned)time (NULL));
-    }
-    else
-    {
-        srand (randomSeed);
+        randomSeed = (unsigned)time (NULL);
     }
+    RngSeedManager::SetSeed (randomSeed);
 
     uint16_t basePort = 8080;
 
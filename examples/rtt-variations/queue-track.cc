@@ -32,10 +32,19 @@ enum AQM {
 };
 
 // Port from Traffic Generator // Acknowledged to https://github.com/HKUST-SING/TrafficGenerator/blob/master/src/common/common.c
+// The stream of the flow generators, keyed by the seed and the run of
+// RngSeedManager at the first draw
+static CounterRng &
+GetFlowRng (void)
+{
+    static CounterRng rng;
+    return rng;
+}
+
 double
 poission_gen_interval(double avg_rate) {
     if (avg_rate > 0)
-        return -logf(1.0 - (double)rand() / RAND_MAX) / avg_rate;
+        return -logf(1.0 - GetFlowRng ().GetDouble ()) / avg_rate;
     else
         return 0;
 }
@@ -43,7 +52,7 @@ poission_gen_interval(double avg_rate) {
 template<typename T> T
 rand_range (T min, T max)
 {
-    return min + ((double)max - min) * rand () / RAND_MAX;
+    return min + ((double)max - min) * GetFlowRng ().GetDouble ();
 }
 
 std::string
@@ -287,12 +296,9 @@ int main (int argc, char *argv[])
     NS_LOG_INFO ("Initialize random seed: " << randomSeed);
     if (randomSeed == 0)
     {
-        srand ((unsigned)time (NULL));
-    }
-    else
-    {
-        srand (randomSeed);
+        randomSeed = (unsigned)time (NULL);
     }
+    RngSeedManager::SetSeed (randomSeed);
 
     NS_LOG_INFO ("Install background application");
 
@@ -304,7 +310,7 @@ int main (int argc, char *argv[])
         double startTime = 0.0 + poission_gen_interval (requestRate);
         while (startTime < endTime && totalFlow < (flowNum / numOfSenders))
         {
-            uint32_t flowSize = gen_random_cdf (cdfTable);
+            uint32_t flowSize = gen_cdf_value (cdfTable, GetFlowRng ().GetDouble ());
             BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (switchToRecvIpv4Container.GetAddress (1), basePort));
             source.SetAttribute ("MaxBytes", UintegerValue (flowSize));
             source.SetAttribute ("SendSize", UintegerValue (1400));
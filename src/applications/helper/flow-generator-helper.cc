@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-generator-helper.h"
+#include "ns3/flow-generator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+
+#include <fstream>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowGeneratorHelper");
+
+/**
+ * \brief Read the (size, cdf) points of a CDF file.
+ * \param fileName the CDF file
+ * \returns the points, starting at (0, 0)
+ */
+static std::vector<std::pair<double, double> >
+ReadCdf (std::string fileName)
+{
+  std::ifstream file (fileName.c_str ());
+  if (!file.good ())
+    {
+      NS_FATAL_ERROR ("Cannot open CDF file " << fileName);
+    }
+  std::vector<std::pair<double, double> > points;
+  points.push_back (std::make_pair (0.0, 0.0));
+  double value, cdf;
+  while (file >> value >> cdf)
+    {
+      if (value == 0.0 && cdf == 0.0)
+        {
+          continue;
+        }
+      points.push_back (std::make_pair (value, cdf));
+    }
+  return points;
+}
+
+FlowGeneratorHelper::FlowGeneratorHelper (std::string protocol, uint16_t port)
+{
+  m_factory.SetTypeId ("ns3::FlowGenerator");
+  m_factory.Set ("Protocol", StringValue (protocol));
+  m_factory.Set ("Port", UintegerValue (port));
+}
+
+void
+FlowGeneratorHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+ApplicationContainer
+FlowGeneratorHelper::Install (Ptr<Node> node) const
+{
+  return ApplicationContainer (InstallPriv (node));
+}
+
+ApplicationContainer
+FlowGeneratorHelper::Install (NodeContainer c) const
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      apps.Add (InstallPriv (*i));
+    }
+
+  return apps;
+}
+
+Ptr<Application>
+FlowGeneratorHelper::InstallPriv (Ptr<Node> node) const
+{
+  Ptr<Application> app = m_factory.Create<Application> ();
+  node->AddApplication (app);
+
+  return app;
+}
+
+int64_t
+FlowGeneratorHelper::AssignStreams (NodeContainer c, int64_t stream)
+{
+  int64_t currentStream = stream;
+  Ptr<Node> node;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      node = (*i);
+      for (uint32_t j = 0; j < node->GetNApplications (); j++)
+        {
+          Ptr<FlowGenerator> generator = DynamicCast<FlowGenerator> (node->GetApplication (j));
+          if (generator)
+            {
+              currentStream += generator->AssignStreams (currentStream);
+            }
+        }
+    }
+  return (currentStream - stream);
+}
+
+Ptr<EmpiricalRandomVariable>
+FlowGeneratorHelper::LoadFlowSizeCdf (std::string fileName)
+{
+  std::vector<std::pair<double, double> > points = ReadCdf (fileName);
+  Ptr<EmpiricalRandomVariable> flowSize = CreateObject<EmpiricalRandomVariable> ();
+  for (uint32_t i = 0; i < points.size (); i++)
+    {
+      flowSize->CDF (points[i].first, points[i].second);
+    }
+  return flowSize;
+}
+
+double
+FlowGeneratorHelper::GetMeanFlowSize (std::string fileName)
+{
+  std::vector<std::pair<double, double> > points = ReadCdf (fileName);
+  double mean = 0;
+  for (uint32_t i = 1; i < points.size (); i++)
+    {
+      double value = (points[i].first + points[i - 1].first) / 2;
+      mean += value * (points[i].second - points[i - 1].second);
+    }
+  return mean;
+}
+
+} // namespace ns3
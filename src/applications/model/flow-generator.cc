@@ -0,0 +1,516 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/address.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/tcp-socket-factory.h"
+#include "fluid-background.h"
+#include "flow-generator.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED (FlowGenerator);
+
+TypeId
+FlowGenerator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FlowGenerator")
+    .SetParent<Application> ()
+    .SetGroupName("Applications")
+    .AddConstructor<FlowGenerator> ()
+    .AddAttribute ("Protocol", "The type of protocol to use.",
+                   TypeIdValue (TcpSocketFactory::GetTypeId ()),
+                   MakeTypeIdAccessor (&FlowGenerator::m_tid),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("Port", "The port the flows of other hosts are received on.",
+                   UintegerValue (5000),
+                   MakeUintegerAccessor (&FlowGenerator::m_port),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("SendSize", "The amount of data to send each time.",
+                   UintegerValue (512),
+                   MakeUintegerAccessor (&FlowGenerator::m_sendSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("FlowLaunchEnd",
+                   "No flow is generated after this time. "
+                   "The value zero means until the application stops.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&FlowGenerator::m_launchEnd),
+                   MakeTimeChecker ())
+    .AddAttribute ("InterArrival",
+                   "A RandomVariableStream used to pick the time in seconds "
+                   "between two generated flows.",
+                   StringValue ("ns3::ExponentialRandomVariable[Mean=0.001]"),
+                   MakePointerAccessor (&FlowGenerator::m_interArrival),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddAttribute ("FlowSize",
+                   "A RandomVariableStream used to pick the size in bytes "
+                   "of generated flows. Each generator needs its own, since "
+                   "AssignStreams sets its stream.",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=100000]"),
+                   MakePointerAccessor (&FlowGenerator::m_flowSize),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddAttribute ("Tos",
+                   "A RandomVariableStream used to pick the simple TOS "
+                   "of generated flows.",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=0]"),
+                   MakePointerAccessor (&FlowGenerator::m_tos),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddAttribute ("Fluid",
+                   "The fluid model the generated flows are given to, "
+                   "or none to send them as packets.",
+                   PointerValue (),
+                   MakePointerAccessor (&FlowGenerator::m_fluid),
+                   MakePointerChecker <FluidBackground>())
+    .AddTraceSource ("FlowComplete",
+                     "All the bytes of a flow have been acknowledged",
+                     MakeTraceSourceAccessor (&FlowGenerator::m_flowCompleteTrace),
+                     "ns3::FlowGenerator::FlowCompleteTracedCallback")
+  ;
+  return tid;
+}
+
+FlowGenerator::FlowGenerator ()
+  : m_listenSocket (0),
+    m_nextPending (0),
+    m_totalRx (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_peerChooser = CreateObject<UniformRandomVariable> ();
+}
+
+FlowGenerator::~FlowGenerator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FlowGenerator::AddDestination (const Address &address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_destinations.push_back (address);
+}
+
+void
+FlowGenerator::AddFlow (Time start, const Address &address, uint32_t size, uint8_t tos)
+{
+  NS_LOG_FUNCTION (this << start << address << size << static_cast<uint32_t> (tos));
+  NS_ABORT_MSG_IF (size == 0, "A flow would never complete without any byte to send");
+  PendingFlow flow;
+  flow.m_start = start;
+  flow.m_peer = address;
+  flow.m_size = size;
+  flow.m_tos = tos;
+  m_pending.push_back (flow);
+}
+
+const FlowGenerator::FlowRecords &
+FlowGenerator::GetFlowRecords (void) const
+{
+  return m_records;
+}
+
+uint32_t
+FlowGenerator::GetActiveFlows (void) const
+{
+  return m_active.size () + m_fluidActive.size ();
+}
+
+uint64_t
+FlowGenerator::GetTotalRx (void) const
+{
+  return m_totalRx;
+}
+
+int64_t
+FlowGenerator::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_interArrival->SetStream (stream);
+  m_flowSize->SetStream (stream + 1);
+  m_tos->SetStream (stream + 2);
+  m_peerChooser->SetStream (stream + 3);
+  return 4;
+}
+
+void
+FlowGenerator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_listenSocket = 0;
+  m_accepted.clear ();
+  m_active.clear ();
+  m_fluidActive.clear ();
+  m_fluid = 0;
+  m_pending.clear ();
+  m_destinations.clear ();
+  // chain up
+  Application::DoDispose ();
+}
+
+// Application Methods
+void
+FlowGenerator::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_listenSocket)
+    {
+      m_listenSocket = Socket::CreateSocket (GetNode (), m_tid);
+      if (m_listenSocket->GetSocketType () != Socket::NS3_SOCK_STREAM &&
+          m_listenSocket->GetSocketType () != Socket::NS3_SOCK_SEQPACKET)
+        {
+          NS_FATAL_ERROR ("Using FlowGenerator with an incompatible socket type. "
+                          "FlowGenerator requires SOCK_STREAM or SOCK_SEQPACKET. "
+                          "In other words, use TCP instead of UDP.");
+        }
+      m_listenSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_port));
+      m_listenSocket->Listen ();
+      m_listenSocket->ShutdownSend ();
+    }
+  m_listenSocket->SetAcceptCallback (
+    MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+    MakeCallback (&FlowGenerator::HandleAccept, this));
+
+  // The flows given up front are started one after the other, so that only
+  // the next one holds an event
+  std::stable_sort (m_pending.begin (), m_pending.end (), &FlowGenerator::StartsBefore);
+  m_nextPending = 0;
+  if (!m_pending.empty ())
+    {
+      m_pendingEvent = Simulator::Schedule (Max (m_pending.front ().m_start - Simulator::Now (), Time (0)),
+                                            &FlowGenerator::LaunchPendingFlow, this);
+    }
+  if (!m_destinations.empty ())
+    {
+      ScheduleNextArrival ();
+    }
+}
+
+void
+FlowGenerator::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_pendingEvent.Cancel ();
+  m_arrivalEvent.Cancel ();
+  while (!m_active.empty ())
+    {
+      EndFlow (m_active.begin ()->first, false);
+    }
+  for (std::map<uint32_t, uint32_t>::iterator it = m_fluidActive.begin (); it != m_fluidActive.end (); ++it)
+    {
+      m_fluid->StopFlow (it->first);
+    }
+  m_fluidActive.clear ();
+  for (std::set<Ptr<Socket> >::iterator it = m_accepted.begin (); it != m_accepted.end (); ++it)
+    {
+      (*it)->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+      (*it)->Close ();
+    }
+  m_accepted.clear ();
+  if (m_listenSocket)
+    {
+      m_listenSocket->Close ();
+    }
+}
+
+bool
+FlowGenerator::StartsBefore (const PendingFlow &a, const PendingFlow &b)
+{
+  return a.m_start < b.m_start;
+}
+
+void
+FlowGenerator::LaunchPendingFlow (void)
+{
+  NS_LOG_FUNCTION (this);
+  const PendingFlow &flow = m_pending[m_nextPending++];
+  StartFlow (flow.m_peer, flow.m_size, flow.m_tos);
+  if (m_nextPending < m_pending.size ())
+    {
+      m_pendingEvent = Simulator::Schedule (Max (m_pending[m_nextPending].m_start - Simulator::Now (), Time (0)),
+                                            &FlowGenerator::LaunchPendingFlow, this);
+    }
+  else
+    {
+      // Every flow given up front has started, release them
+      std::vector<PendingFlow> ().swap (m_pending);
+      m_nextPending = 0;
+    }
+}
+
+void
+FlowGenerator::LaunchRandomFlow (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t peer = m_peerChooser->GetInteger (0, m_destinations.size () - 1);
+  uint32_t size = std::max (m_flowSize->GetInteger (), 1u);
+  uint8_t tos = m_tos->GetInteger ();
+  if (m_fluid == 0 || !StartFluidFlow (m_destinations[peer], size))
+    {
+      StartFlow (m_destinations[peer], size, tos);
+    }
+  ScheduleNextArrival ();
+}
+
+void
+FlowGenerator::ScheduleNextArrival (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time next = Seconds (m_interArrival->GetValue ());
+  if (!m_launchEnd.IsZero () && Simulator::Now () + next >= m_launchEnd)
+    {
+      NS_LOG_LOGIC ("No more flows generated");
+      return;
+    }
+  m_arrivalEvent = Simulator::Schedule (next, &FlowGenerator::LaunchRandomFlow, this);
+}
+
+void
+FlowGenerator::StartFlow (const Address &peer, uint32_t size, uint8_t tos)
+{
+  NS_LOG_FUNCTION (this << peer << size << static_cast<uint32_t> (tos));
+  Ptr<Socket> socket = Socket::CreateSocket (GetNode (), m_tid);
+  if (Inet6SocketAddress::IsMatchingType (peer))
+    {
+      socket->Bind6 ();
+    }
+  else if (InetSocketAddress::IsMatchingType (peer))
+    {
+      socket->Bind ();
+    }
+  socket->Connect (peer);
+  socket->ShutdownRecv ();
+  socket->SetConnectCallback (
+    MakeCallback (&FlowGenerator::ConnectionSucceeded, this),
+    MakeCallback (&FlowGenerator::ConnectionFailed, this));
+  socket->SetSendCallback (
+    MakeCallback (&FlowGenerator::DataSend, this));
+  socket->SetCloseCallbacks (
+    MakeNullCallback<void, Ptr<Socket> > (),
+    MakeCallback (&FlowGenerator::HandlePeerError, this));
+
+  FlowRecord record;
+  record.m_start = Simulator::Now ();
+  record.m_size = size;
+  record.m_fluid = false;
+  m_records.push_back (record);
+
+  ActiveFlow flow;
+  flow.m_record = m_records.size () - 1;
+  flow.m_sent = 0;
+  flow.m_txSpace = 0;
+  flow.m_tos = tos;
+  m_active[socket] = flow;
+}
+
+bool
+FlowGenerator::StartFluidFlow (const Address &peer, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << peer << size);
+  if (!InetSocketAddress::IsMatchingType (peer))
+    {
+      return false;
+    }
+  uint32_t id = m_fluid->StartFlow (GetNode (), InetSocketAddress::ConvertFrom (peer).GetIpv4 (), size,
+                                    MakeCallback (&FlowGenerator::FluidFlowCompleted, this));
+  if (id == 0)
+    {
+      return false;
+    }
+
+  FlowRecord record;
+  record.m_start = Simulator::Now ();
+  record.m_size = size;
+  record.m_fluid = true;
+  m_records.push_back (record);
+  m_fluidActive[id] = m_records.size () - 1;
+  return true;
+}
+
+void
+FlowGenerator::FluidFlowCompleted (uint32_t id)
+{
+  NS_LOG_FUNCTION (this << id);
+  std::map<uint32_t, uint32_t>::iterator it = m_fluidActive.find (id);
+  if (it == m_fluidActive.end ())
+    {
+      return;
+    }
+  FlowRecord &record = m_records[it->second];
+  record.m_fct = Simulator::Now () - record.m_start;
+  NS_LOG_LOGIC ("Fluid flow of " << record.m_size << " bytes completed in " << record.m_fct);
+  m_flowCompleteTrace (record.m_size, record.m_fct);
+  m_fluidActive.erase (it);
+}
+
+void
+FlowGenerator::SendData (Ptr<Socket> socket, ActiveFlow &flow)
+{
+  NS_LOG_FUNCTION (this << socket);
+  uint32_t size = m_records[flow.m_record].m_size;
+  while (flow.m_sent < size)
+    {
+      uint32_t toSend = std::min (m_sendSize, size - flow.m_sent);
+      Ptr<Packet> packet = Create<Packet> (toSend);
+      SocketIpTosTag tosTag;
+      tosTag.SetTos (flow.m_tos << 2);
+      packet->AddPacketTag (tosTag);
+      int actual = socket->Send (packet);
+      if (actual > 0)
+        {
+          flow.m_sent += actual;
+        }
+      // The send buffer is full, DataSend pops when space is freed
+      if ((unsigned)actual != toSend)
+        {
+          break;
+        }
+    }
+}
+
+void
+FlowGenerator::EndFlow (Ptr<Socket> socket, bool completed)
+{
+  NS_LOG_FUNCTION (this << socket << completed);
+  std::map<Ptr<Socket>, ActiveFlow>::iterator it = m_active.find (socket);
+  if (it == m_active.end ())
+    {
+      return;
+    }
+  FlowRecord &record = m_records[it->second.m_record];
+  if (completed)
+    {
+      record.m_fct = Simulator::Now () - record.m_start;
+      NS_LOG_LOGIC ("Flow of " << record.m_size << " bytes completed in " << record.m_fct);
+      m_flowCompleteTrace (record.m_size, record.m_fct);
+    }
+  m_active.erase (it);
+
+  socket->SetConnectCallback (MakeNullCallback<void, Ptr<Socket> > (),
+                              MakeNullCallback<void, Ptr<Socket> > ());
+  socket->SetSendCallback (MakeNullCallback<void, Ptr<Socket>, uint32_t> ());
+  socket->SetCloseCallbacks (MakeNullCallback<void, Ptr<Socket> > (),
+                             MakeNullCallback<void, Ptr<Socket> > ());
+  socket->Close ();
+}
+
+void
+FlowGenerator::ConnectionSucceeded (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  std::map<Ptr<Socket>, ActiveFlow>::iterator it = m_active.find (socket);
+  if (it == m_active.end ())
+    {
+      return;
+    }
+  // Nothing is buffered yet: all the data is acknowledged when the
+  // send buffer is this empty again
+  it->second.m_txSpace = socket->GetTxAvailable ();
+  SendData (socket, it->second);
+}
+
+void
+FlowGenerator::ConnectionFailed (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  EndFlow (socket, false);
+}
+
+void
+FlowGenerator::DataSend (Ptr<Socket> socket, uint32_t available)
+{
+  NS_LOG_FUNCTION (this << socket << available);
+  std::map<Ptr<Socket>, ActiveFlow>::iterator it = m_active.find (socket);
+  if (it == m_active.end () || it->second.m_txSpace == 0)
+    {
+      // Not connected yet
+      return;
+    }
+  ActiveFlow &flow = it->second;
+  if (flow.m_sent < m_records[flow.m_record].m_size)
+    {
+      SendData (socket, flow);
+    }
+  else if (available >= flow.m_txSpace)
+    {
+      EndFlow (socket, true);
+    }
+}
+
+void
+FlowGenerator::HandleAccept (Ptr<Socket> socket, const Address &from)
+{
+  NS_LOG_FUNCTION (this << socket << from);
+  socket->SetRecvCallback (MakeCallback (&FlowGenerator::HandleRead, this));
+  socket->SetCloseCallbacks (
+    MakeCallback (&FlowGenerator::HandlePeerClose, this),
+    MakeCallback (&FlowGenerator::HandlePeerError, this));
+  m_accepted.insert (socket);
+}
+
+void
+FlowGenerator::HandleRead (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      if (packet->GetSize () == 0)
+        { //EOF
+          break;
+        }
+      m_totalRx += packet->GetSize ();
+    }
+}
+
+void
+FlowGenerator::HandlePeerClose (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  if (m_accepted.erase (socket) > 0)
+    {
+      socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+      socket->Close ();
+    }
+}
+
+void
+FlowGenerator::HandlePeerError (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  if (m_accepted.erase (socket) == 0)
+    {
+      EndFlow (socket, false);
+    }
+}
+
+} // Namespace ns3
@@ -0,0 +1,552 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/data-rate.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/channel.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/tcp-header.h"
+#include "ns3/trace-source-accessor.h"
+#include "fluid-background.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FluidBackground");
+
+NS_OBJECT_ENSURE_REGISTERED (FluidBackground);
+
+/** The longest path a fluid flow may follow, in hops. */
+static const uint32_t MAX_HOPS = 64;
+
+TypeId
+FluidBackground::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FluidBackground")
+    .SetParent<Object> ()
+    .SetGroupName("Applications")
+    .AddConstructor<FluidBackground> ()
+    .AddAttribute ("Mode", "How the rates of the fluid flows are computed.",
+                   EnumValue (MAX_MIN),
+                   MakeEnumAccessor (&FluidBackground::m_mode),
+                   MakeEnumChecker (MAX_MIN, "MaxMin",
+                                    DCTCP, "Dctcp"))
+    .AddAttribute ("MaxShare",
+                   "The largest fraction of the capacity of a link the fluid "
+                   "flows may take.",
+                   DoubleValue (0.9),
+                   MakeDoubleAccessor (&FluidBackground::m_maxShare),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("UpdateInterval",
+                   "How often the DCTCP rates are updated, standing for the "
+                   "round trip time of the flows.",
+                   TimeValue (MicroSeconds (100)),
+                   MakeTimeAccessor (&FluidBackground::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("SegmentSize",
+                   "The DCTCP additive increase, in bytes per interval.",
+                   UintegerValue (1400),
+                   MakeUintegerAccessor (&FluidBackground::m_segmentSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("InitialWindow",
+                   "The segments per interval a DCTCP flow starts with.",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&FluidBackground::m_initialWindow),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MarkingThreshold",
+                   "The fluid backlog of a link, in bytes, above which the "
+                   "DCTCP flows crossing it are marked.",
+                   UintegerValue (97500),
+                   MakeUintegerAccessor (&FluidBackground::m_markingThreshold),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Gain",
+                   "The DCTCP gain in the estimation of the marked fraction.",
+                   DoubleValue (1.0 / 16),
+                   MakeDoubleAccessor (&FluidBackground::m_g),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddTraceSource ("FlowComplete",
+                     "All the bytes of a fluid flow have been delivered",
+                     MakeTraceSourceAccessor (&FluidBackground::m_flowCompleteTrace),
+                     "ns3::FluidBackground::FlowCompleteTracedCallback")
+  ;
+  return tid;
+}
+
+FluidBackground::FluidBackground ()
+  : m_nextId (1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FluidBackground::~FluidBackground ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FluidBackground::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  for (std::vector<Link>::iterator it = m_links.begin (); it != m_links.end (); ++it)
+    {
+      if (it->m_packetRate != it->m_capacity)
+        {
+          it->m_device->SetAttribute ("DataRate", DataRateValue (DataRate (static_cast<uint64_t> (it->m_capacity))));
+        }
+    }
+  m_links.clear ();
+  m_linkIndex.clear ();
+  m_flows.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+FluidBackground::StartFlow (Ptr<Node> source, Ipv4Address destination, uint32_t size,
+                            Callback<void, uint32_t> completed)
+{
+  NS_LOG_FUNCTION (this << source << destination << size);
+  Flow flow;
+  flow.m_id = m_nextId++;
+  if (!FindPath (source, destination, flow.m_id, flow.m_links) || flow.m_links.empty ())
+    {
+      NS_LOG_WARN ("No link with a DataRate from node " << source->GetId () << " to " << destination);
+      return 0;
+    }
+  Advance ();
+
+  flow.m_remaining = 8.0 * std::max (size, 1u);
+  flow.m_maxRate = std::numeric_limits<double>::max ();
+  for (std::vector<uint32_t>::const_iterator it = flow.m_links.begin (); it != flow.m_links.end (); ++it)
+    {
+      flow.m_maxRate = std::min (flow.m_maxRate, m_links[*it].m_capacity);
+    }
+  flow.m_rate = std::min (8.0 * m_segmentSize * m_initialWindow / m_interval.GetSeconds (), flow.m_maxRate);
+  flow.m_goodput = 0;
+  flow.m_alpha = 1;
+  flow.m_start = Simulator::Now ();
+  flow.m_size = size;
+  flow.m_completed = completed;
+  m_flows.push_back (flow);
+  NS_LOG_LOGIC ("Fluid flow " << flow.m_id << " over " << flow.m_links.size () << " links");
+
+  if (m_mode == MAX_MIN)
+    {
+      ComputeMaxMin ();
+    }
+  UpdateLinks ();
+  ScheduleUpdate ();
+  return flow.m_id;
+}
+
+void
+FluidBackground::StopFlow (uint32_t id)
+{
+  NS_LOG_FUNCTION (this << id);
+  Advance ();
+  for (std::vector<Flow>::iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      if (it->m_id == id)
+        {
+          *it = m_flows.back ();
+          m_flows.pop_back ();
+          break;
+        }
+    }
+  if (m_mode == MAX_MIN)
+    {
+      ComputeMaxMin ();
+    }
+  UpdateLinks ();
+  ScheduleUpdate ();
+}
+
+uint32_t
+FluidBackground::GetActiveFlows (void) const
+{
+  return m_flows.size ();
+}
+
+double
+FluidBackground::GetFluidRate (Ptr<NetDevice> device) const
+{
+  std::map<Ptr<NetDevice>, uint32_t>::const_iterator it = m_linkIndex.find (device);
+  if (it == m_linkIndex.end ())
+    {
+      return 0;
+    }
+  return m_links[it->second].m_served;
+}
+
+double
+FluidBackground::GetBacklog (Ptr<NetDevice> device) const
+{
+  std::map<Ptr<NetDevice>, uint32_t>::const_iterator it = m_linkIndex.find (device);
+  if (it == m_linkIndex.end ())
+    {
+      return 0;
+    }
+  return m_links[it->second].m_backlog / 8;
+}
+
+bool
+FluidBackground::GetLink (Ptr<NetDevice> device, uint32_t &link)
+{
+  std::map<Ptr<NetDevice>, uint32_t>::const_iterator it = m_linkIndex.find (device);
+  if (it != m_linkIndex.end ())
+    {
+      link = it->second;
+      return true;
+    }
+  DataRateValue rate;
+  if (!device->GetAttributeFailSafe ("DataRate", rate) || rate.Get ().GetBitRate () == 0)
+    {
+      return false;
+    }
+  Link l;
+  l.m_device = device;
+  l.m_capacity = rate.Get ().GetBitRate ();
+  l.m_offered = 0;
+  l.m_served = 0;
+  l.m_backlog = 0;
+  l.m_packetRate = l.m_capacity;
+  link = m_links.size ();
+  m_links.push_back (l);
+  m_linkIndex[device] = link;
+  return true;
+}
+
+bool
+FluidBackground::FindPath (Ptr<Node> source, Ipv4Address destination, uint32_t id,
+                           std::vector<uint32_t> &links)
+{
+  NS_LOG_FUNCTION (this << source << destination << id);
+  // The routing protocols which hash flows over equal cost paths look at
+  // the addresses and the TCP ports: give each flow its own source port
+  Ipv4Header header;
+  header.SetDestination (destination);
+  header.SetProtocol (6);
+  Ptr<Ipv4> sourceIpv4 = source->GetObject<Ipv4> ();
+  if (sourceIpv4 != 0 && sourceIpv4->GetNInterfaces () > 1 && sourceIpv4->GetNAddresses (1) > 0)
+    {
+      header.SetSource (sourceIpv4->GetAddress (1, 0).GetLocal ());
+    }
+  TcpHeader tcpHeader;
+  tcpHeader.SetSourcePort (49152 + id % 16384);
+  tcpHeader.SetDestinationPort (0);
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (tcpHeader);
+
+  Ptr<Node> node = source;
+  for (uint32_t hop = 0; hop < MAX_HOPS; hop++)
+    {
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      if (ipv4 == 0)
+        {
+          return false;
+        }
+      if (ipv4->GetInterfaceForAddress (destination) >= 0)
+        {
+          return true;
+        }
+      Ptr<Ipv4RoutingProtocol> routing = ipv4->GetRoutingProtocol ();
+      if (routing == 0)
+        {
+          return false;
+        }
+      Socket::SocketErrno error;
+      Ptr<Ipv4Route> route = routing->RouteOutput (packet, header, 0, error);
+      if (route == 0)
+        {
+          return false;
+        }
+      Ptr<NetDevice> device = route->GetOutputDevice ();
+      uint32_t link;
+      if (GetLink (device, link))
+        {
+          links.push_back (link);
+        }
+
+      // The next node is the one on the channel which owns the gateway
+      Ipv4Address next = route->GetGateway ();
+      if (next == Ipv4Address::GetAny ())
+        {
+          next = destination;
+        }
+      Ptr<Channel> channel = device->GetChannel ();
+      if (channel == 0)
+        {
+          return false;
+        }
+      Ptr<Node> peer = 0;
+      for (uint32_t i = 0; i < channel->GetNDevices () && peer == 0; i++)
+        {
+          Ptr<NetDevice> other = channel->GetDevice (i);
+          if (other == device)
+            {
+              continue;
+            }
+          Ptr<Ipv4> otherIpv4 = other->GetNode ()->GetObject<Ipv4> ();
+          if (otherIpv4 != 0 && otherIpv4->GetInterfaceForAddress (next) >= 0)
+            {
+              peer = other->GetNode ();
+            }
+        }
+      if (peer == 0)
+        {
+          return false;
+        }
+      node = peer;
+    }
+  return false;
+}
+
+void
+FluidBackground::Advance (void)
+{
+  double dt = (Simulator::Now () - m_lastUpdate).GetSeconds ();
+  m_lastUpdate = Simulator::Now ();
+  if (dt <= 0)
+    {
+      return;
+    }
+  for (std::vector<Flow>::iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      it->m_remaining -= it->m_goodput * dt;
+    }
+  for (std::vector<Link>::iterator it = m_links.begin (); it != m_links.end (); ++it)
+    {
+      it->m_backlog = std::max (it->m_backlog + (it->m_offered - it->m_served) * dt, 0.0);
+    }
+}
+
+void
+FluidBackground::UpdateLinks (void)
+{
+  for (std::vector<Link>::iterator it = m_links.begin (); it != m_links.end (); ++it)
+    {
+      it->m_offered = 0;
+    }
+  for (std::vector<Flow>::const_iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      for (std::vector<uint32_t>::const_iterator l = it->m_links.begin (); l != it->m_links.end (); ++l)
+        {
+          m_links[*l].m_offered += it->m_rate;
+        }
+    }
+  for (std::vector<Link>::iterator it = m_links.begin (); it != m_links.end (); ++it)
+    {
+      double share = m_maxShare * it->m_capacity;
+      // A link with a backlog serves its whole share until it is drained
+      it->m_served = (it->m_offered > share || it->m_backlog > 0) ? share : it->m_offered;
+      // Some devices take a zero rate as an infinite one
+      double packetRate = std::max (std::floor (it->m_capacity - it->m_served), 1.0);
+      if (packetRate != it->m_packetRate)
+        {
+          it->m_packetRate = packetRate;
+          it->m_device->SetAttribute ("DataRate", DataRateValue (DataRate (static_cast<uint64_t> (packetRate))));
+        }
+    }
+  for (std::vector<Flow>::iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      double fraction = 1;
+      for (std::vector<uint32_t>::const_iterator l = it->m_links.begin (); l != it->m_links.end (); ++l)
+        {
+          const Link &link = m_links[*l];
+          if (link.m_offered > link.m_served)
+            {
+              fraction = std::min (fraction, link.m_served / link.m_offered);
+            }
+        }
+      it->m_goodput = it->m_rate * fraction;
+    }
+}
+
+void
+FluidBackground::ComputeMaxMin (void)
+{
+  // Progressive filling: the flows of the link with the smallest fair
+  // share are given that share, and leave the rest to the other flows
+  std::vector<double> residual (m_links.size ());
+  std::vector<std::vector<uint32_t> > flowsOfLink (m_links.size ());
+  std::vector<uint32_t> count (m_links.size (), 0);
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      residual[l] = m_maxShare * m_links[l].m_capacity;
+    }
+  for (uint32_t f = 0; f < m_flows.size (); f++)
+    {
+      for (std::vector<uint32_t>::const_iterator l = m_flows[f].m_links.begin (); l != m_flows[f].m_links.end (); ++l)
+        {
+          flowsOfLink[*l].push_back (f);
+          count[*l]++;
+        }
+    }
+  std::vector<bool> fixed (m_flows.size (), false);
+  uint32_t left = m_flows.size ();
+  while (left > 0)
+    {
+      uint32_t bottleneck = m_links.size ();
+      double fairShare = std::numeric_limits<double>::max ();
+      for (uint32_t l = 0; l < m_links.size (); l++)
+        {
+          if (count[l] > 0 && residual[l] / count[l] < fairShare)
+            {
+              bottleneck = l;
+              fairShare = residual[l] / count[l];
+            }
+        }
+      NS_ASSERT (bottleneck < m_links.size ());
+      for (std::vector<uint32_t>::const_iterator f = flowsOfLink[bottleneck].begin ();
+           f != flowsOfLink[bottleneck].end (); ++f)
+        {
+          if (fixed[*f])
+            {
+              continue;
+            }
+          fixed[*f] = true;
+          left--;
+          m_flows[*f].m_rate = fairShare;
+          for (std::vector<uint32_t>::const_iterator l = m_flows[*f].m_links.begin ();
+               l != m_flows[*f].m_links.end (); ++l)
+            {
+              residual[*l] = std::max (residual[*l] - fairShare, 0.0);
+              count[*l]--;
+            }
+        }
+    }
+}
+
+void
+FluidBackground::UpdateDctcpRates (void)
+{
+  double increase = 8.0 * m_segmentSize / m_interval.GetSeconds ();
+  double threshold = 8.0 * m_markingThreshold;
+  for (std::vector<Flow>::iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      bool marked = false;
+      for (std::vector<uint32_t>::const_iterator l = it->m_links.begin (); l != it->m_links.end () && !marked; ++l)
+        {
+          marked = m_links[*l].m_backlog > threshold;
+        }
+      it->m_alpha = (1 - m_g) * it->m_alpha + (marked ? m_g : 0);
+      if (marked)
+        {
+          it->m_rate *= 1 - it->m_alpha / 2;
+        }
+      else
+        {
+          it->m_rate += increase;
+        }
+      it->m_rate = std::min (std::max (it->m_rate, increase), it->m_maxRate);
+    }
+}
+
+void
+FluidBackground::RemoveCompletedFlows (std::vector<Flow> &done)
+{
+  // Less than a bit left
+  for (uint32_t i = 0; i < m_flows.size (); )
+    {
+      if (m_flows[i].m_remaining < 1)
+        {
+          done.push_back (m_flows[i]);
+          m_flows[i] = m_flows.back ();
+          m_flows.pop_back ();
+        }
+      else
+        {
+          i++;
+        }
+    }
+}
+
+void
+FluidBackground::ScheduleUpdate (void)
+{
+  if (m_mode == DCTCP)
+    {
+      bool backlogged = false;
+      for (std::vector<Link>::const_iterator it = m_links.begin (); it != m_links.end () && !backlogged; ++it)
+        {
+          backlogged = it->m_backlog > 0;
+        }
+      if (!m_event.IsRunning () && (!m_flows.empty () || backlogged))
+        {
+          m_event = Simulator::Schedule (m_interval, &FluidBackground::Update, this);
+        }
+      return;
+    }
+
+  m_event.Cancel ();
+  double next = std::numeric_limits<double>::max ();
+  for (std::vector<Flow>::const_iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      if (it->m_goodput > 0)
+        {
+          next = std::min (next, it->m_remaining / it->m_goodput);
+        }
+    }
+  if (next != std::numeric_limits<double>::max ())
+    {
+      m_event = Simulator::Schedule (NanoSeconds (std::ceil (next * 1e9)), &FluidBackground::Update, this);
+    }
+}
+
+void
+FluidBackground::Update (void)
+{
+  NS_LOG_FUNCTION (this);
+  Advance ();
+  std::vector<Flow> done;
+  RemoveCompletedFlows (done);
+  if (m_mode == DCTCP)
+    {
+      UpdateDctcpRates ();
+    }
+  else
+    {
+      ComputeMaxMin ();
+    }
+  UpdateLinks ();
+  ScheduleUpdate ();
+
+  for (std::vector<Flow>::iterator it = done.begin (); it != done.end (); ++it)
+    {
+      Time fct = Simulator::Now () - it->m_start;
+      NS_LOG_LOGIC ("Fluid flow " << it->m_id << " of " << it->m_size << " bytes completed in " << fct);
+      m_flowCompleteTrace (it->m_size, fct);
+      if (!it->m_completed.IsNull ())
+        {
+          it->m_completed (it->m_id);
+        }
+    }
+}
+
+} // namespace ns3
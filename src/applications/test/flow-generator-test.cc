@@ -0,0 +1,275 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/flow-generator.h"
+#include "ns3/flow-generator-helper.h"
+#include "ns3/fluid-background.h"
+#include "ns3/data-rate.h"
+#include "ns3/enum.h"
+#include "ns3/pointer.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup applications
+ * \defgroup applications-test applications module tests
+ */
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Flows given up front and generated flows are all completed, and only
+ * their records are kept.
+ */
+class FlowGeneratorTestCase : public TestCase
+{
+public:
+  FlowGeneratorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FlowGeneratorTestCase::FlowGeneratorTestCase ()
+  : TestCase ("Test that a FlowGenerator completes its flows")
+{
+}
+
+void
+FlowGeneratorTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (2);
+
+  InternetStackHelper internet;
+  internet.Install (n);
+
+  // link the two nodes
+  Ptr<SimpleNetDevice> dev0 = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> dev1 = CreateObject<SimpleNetDevice> ();
+  n.Get (0)->AddDevice (dev0);
+  n.Get (1)->AddDevice (dev1);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  dev0->SetChannel (channel);
+  dev1->SetChannel (channel);
+  NetDeviceContainer d;
+  d.Add (dev0);
+  d.Add (dev1);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  uint16_t port = 4000;
+  FlowGeneratorHelper helper ("ns3::TcpSocketFactory", port);
+  helper.SetAttribute ("SendSize", UintegerValue (1000));
+  helper.SetAttribute ("FlowLaunchEnd", TimeValue (Seconds (0.05)));
+  helper.SetAttribute ("InterArrival", StringValue ("ns3::ConstantRandomVariable[Constant=0.01]"));
+  helper.SetAttribute ("FlowSize", StringValue ("ns3::ConstantRandomVariable[Constant=3000]"));
+  ApplicationContainer apps = helper.Install (n);
+  apps.Start (Seconds (0.0));
+  apps.Stop (Seconds (10.0));
+
+  // Node 0 sends three flows given up front, out of order
+  Ptr<FlowGenerator> sender = DynamicCast<FlowGenerator> (apps.Get (0));
+  sender->AddFlow (Seconds (0.2), InetSocketAddress (i.GetAddress (1), port), 50000, 0);
+  sender->AddFlow (Seconds (0.1), InetSocketAddress (i.GetAddress (1), port), 10000, 0);
+  sender->AddFlow (Seconds (0.1), InetSocketAddress (i.GetAddress (1), port), 1, 0);
+
+  // Node 1 generates a flow every 10 ms until 50 ms
+  Ptr<FlowGenerator> generator = DynamicCast<FlowGenerator> (apps.Get (1));
+  generator->AddDestination (InetSocketAddress (i.GetAddress (0), port));
+
+  Simulator::Run ();
+
+  const FlowGenerator::FlowRecords &records = sender->GetFlowRecords ();
+  NS_TEST_ASSERT_MSG_EQ (records.size (), 3, "All the flows should have started");
+  NS_TEST_EXPECT_MSG_EQ (records[0].m_size, 10000, "Flows start in time order");
+  NS_TEST_EXPECT_MSG_EQ (records[1].m_size, 1, "Flows with the same start time keep their order");
+  NS_TEST_EXPECT_MSG_EQ (records[2].m_start, Seconds (0.2), "Wrong start time");
+  for (uint32_t j = 0; j < records.size (); j++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (records[j].m_fct.IsStrictlyPositive (), true, "Flow should be completed");
+    }
+  NS_TEST_EXPECT_MSG_EQ (sender->GetActiveFlows (), 0, "No flow should be left");
+  NS_TEST_EXPECT_MSG_EQ (DynamicCast<FlowGenerator> (apps.Get (1))->GetTotalRx (), 60001, "Wrong bytes received");
+
+  const FlowGenerator::FlowRecords &generated = generator->GetFlowRecords ();
+  NS_TEST_ASSERT_MSG_EQ (generated.size (), 4, "Flows are generated until FlowLaunchEnd");
+  for (uint32_t j = 0; j < generated.size (); j++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (generated[j].m_start, MilliSeconds (10 * (j + 1)), "Wrong start time");
+      NS_TEST_EXPECT_MSG_EQ (generated[j].m_size, 3000, "Wrong flow size");
+      NS_TEST_EXPECT_MSG_EQ (generated[j].m_fct.IsStrictlyPositive (), true, "Flow should be completed");
+    }
+  NS_TEST_EXPECT_MSG_EQ (sender->GetTotalRx (), 12000, "Wrong bytes received");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Fluid flows share the links max-min fairly and leave the rest of the
+ * capacity to the packets, and a FlowGenerator gives its generated flows
+ * to the fluid model.
+ */
+class FluidBackgroundTestCase : public TestCase
+{
+public:
+  FluidBackgroundTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record a fluid flow completion.
+   * \param id the fluid flow id
+   */
+  void Completed (uint32_t id);
+  /**
+   * Check the rate left to the packets on a device.
+   * \param device the device
+   * \param expected the expected rate
+   */
+  void CheckRate (Ptr<SimpleNetDevice> device, DataRate expected);
+
+  std::vector<Time> m_completed; //!< Completion times of the fluid flows
+};
+
+FluidBackgroundTestCase::FluidBackgroundTestCase ()
+  : TestCase ("Test that fluid flows share the links and complete")
+{
+}
+
+void
+FluidBackgroundTestCase::Completed (uint32_t id)
+{
+  m_completed.push_back (Simulator::Now ());
+}
+
+void
+FluidBackgroundTestCase::CheckRate (Ptr<SimpleNetDevice> device, DataRate expected)
+{
+  DataRateValue rate;
+  device->GetAttribute ("DataRate", rate);
+  NS_TEST_EXPECT_MSG_EQ (rate.Get (), expected, "Wrong rate left to the packets at " << Simulator::Now ());
+}
+
+void
+FluidBackgroundTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (2);
+
+  InternetStackHelper internet;
+  internet.Install (n);
+
+  Ptr<SimpleNetDevice> dev0 = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> dev1 = CreateObject<SimpleNetDevice> ();
+  dev0->SetAttribute ("DataRate", DataRateValue (DataRate ("10Mbps")));
+  dev1->SetAttribute ("DataRate", DataRateValue (DataRate ("10Mbps")));
+  n.Get (0)->AddDevice (dev0);
+  n.Get (1)->AddDevice (dev1);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  dev0->SetChannel (channel);
+  dev1->SetChannel (channel);
+  NetDeviceContainer d;
+  d.Add (dev0);
+  d.Add (dev1);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  // Two flows of 1 Mbit share 90% of 10 Mbps, and complete together
+  Ptr<FluidBackground> fluid = CreateObject<FluidBackground> ();
+  fluid->SetAttribute ("Mode", EnumValue (FluidBackground::MAX_MIN));
+  uint32_t id = fluid->StartFlow (n.Get (0), i.GetAddress (1), 125000,
+                                  MakeCallback (&FluidBackgroundTestCase::Completed, this));
+  NS_TEST_EXPECT_MSG_NE (id, 0, "The destination should be reachable");
+  fluid->StartFlow (n.Get (0), i.GetAddress (1), 125000,
+                    MakeCallback (&FluidBackgroundTestCase::Completed, this));
+  NS_TEST_EXPECT_MSG_EQ (fluid->StartFlow (n.Get (0), Ipv4Address ("10.2.2.2"), 1000,
+                                           MakeCallback (&FluidBackgroundTestCase::Completed, this)),
+                         0, "The destination should not be reachable");
+  NS_TEST_EXPECT_MSG_EQ (fluid->GetActiveFlows (), 2, "Two flows should be active");
+  NS_TEST_EXPECT_MSG_EQ_TOL (fluid->GetFluidRate (dev0), 9e6, 1, "The flows should take their share");
+  Simulator::Schedule (Seconds (0.1), &FluidBackgroundTestCase::CheckRate, this, dev0, DataRate ("1Mbps"));
+  Simulator::Schedule (Seconds (0.1), &FluidBackgroundTestCase::CheckRate, this, dev1, DataRate ("10Mbps"));
+  Simulator::Schedule (Seconds (0.3), &FluidBackgroundTestCase::CheckRate, this, dev0, DataRate ("10Mbps"));
+
+  // The generated flows of node 1 are fluid flows
+  uint16_t port = 4000;
+  FlowGeneratorHelper helper ("ns3::TcpSocketFactory", port);
+  helper.SetAttribute ("FlowLaunchEnd", TimeValue (Seconds (0.05)));
+  helper.SetAttribute ("InterArrival", StringValue ("ns3::ConstantRandomVariable[Constant=0.01]"));
+  helper.SetAttribute ("FlowSize", StringValue ("ns3::ConstantRandomVariable[Constant=3000]"));
+  helper.SetAttribute ("Fluid", PointerValue (fluid));
+  ApplicationContainer apps = helper.Install (n);
+  apps.Start (Seconds (0.0));
+  apps.Stop (Seconds (10.0));
+  Ptr<FlowGenerator> generator = DynamicCast<FlowGenerator> (apps.Get (1));
+  generator->AddDestination (InetSocketAddress (i.GetAddress (0), port));
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_completed.size (), 2, "Both flows should complete");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_completed[0].GetSeconds (), 1.0 / 4.5, 1e-6, "Wrong completion time");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_completed[1].GetSeconds (), 1.0 / 4.5, 1e-6, "Wrong completion time");
+  NS_TEST_EXPECT_MSG_EQ (fluid->GetActiveFlows (), 0, "No flow should be left");
+
+  const FlowGenerator::FlowRecords &generated = generator->GetFlowRecords ();
+  NS_TEST_ASSERT_MSG_EQ (generated.size (), 4, "Flows are generated until FlowLaunchEnd");
+  for (uint32_t j = 0; j < generated.size (); j++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (generated[j].m_fluid, true, "Generated flows should be fluid");
+      NS_TEST_EXPECT_MSG_EQ_TOL (generated[j].m_fct.GetSeconds (), 3000 * 8 / 9e6, 1e-6, "Wrong completion time");
+    }
+  NS_TEST_EXPECT_MSG_EQ (DynamicCast<FlowGenerator> (apps.Get (0))->GetTotalRx (), 0, "Fluid flows send no packet");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief FlowGenerator TestSuite
+ */
+class FlowGeneratorTestSuite : public TestSuite
+{
+public:
+  FlowGeneratorTestSuite ()
+    : TestSuite ("flow-generator", UNIT)
+  {
+    AddTestCase (new FlowGeneratorTestCase, TestCase::QUICK);
+    AddTestCase (new FluidBackgroundTestCase, TestCase::QUICK);
+  }
+};
+
+static FlowGeneratorTestSuite flowGeneratorTestSuite; //!< Static variable for test initialization
@@ -25,8 +25,12 @@
 #include "ns3/config.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "building-list.h"
 #include "building.h"
+#include <cmath>
+#include <map>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -47,6 +51,8 @@ public:
   BuildingList::Iterator End (void) const;
   Ptr<Building> GetBuilding (uint32_t n);
   uint32_t GetNBuildings (void);
+  Ptr<Building> FindBuilding (Vector position);
+  void NotifyBoundariesChanged (void);
 
   static Ptr<BuildingListPriv> Get (void);
 
@@ -54,7 +60,15 @@ private:
   virtual void DoDispose (void);
   static Ptr<BuildingListPriv> *DoGet (void);
   static void Delete (void);
+  void BuildGrid (void);
+  std::pair<int64_t, int64_t> GetCell (double x, double y) const;
+
   std::vector<Ptr<Building> > m_buildings;
+  /// Indices of the buildings whose boundaries overlap each grid cell
+  typedef std::map<std::pair<int64_t, int64_t>, std::vector<uint32_t> > Grid;
+  Grid m_grid;
+  double m_cellSize;
+  bool m_gridDirty;
 };
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv);
@@ -100,6 +114,8 @@ BuildingListPriv::Delete (void)
 
 
 BuildingListPriv::BuildingListPriv ()
+  : m_cellSize (1.0),
+    m_gridDirty (true)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -118,6 +134,7 @@ BuildingListPriv::DoDispose (void)
       *i = 0;
     }
   m_buildings.erase (m_buildings.begin (), m_buildings.end ());
+  m_grid.clear ();
   Object::DoDispose ();
 }
 
@@ -127,6 +144,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  m_gridDirty = true;
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -155,6 +173,82 @@ BuildingListPriv::GetBuilding (uint32_t n)
   return m_buildings.at (n);
 }
 
+void
+BuildingListPriv::NotifyBoundariesChanged (void)
+{
+  m_gridDirty = true;
+}
+
+std::pair<int64_t, int64_t>
+BuildingListPriv::GetCell (double x, double y) const
+{
+  return std::make_pair ((int64_t) std::floor (x / m_cellSize),
+                         (int64_t) std::floor (y / m_cellSize));
+}
+
+void
+BuildingListPriv::BuildGrid (void)
+{
+  NS_LOG_FUNCTION (this << m_buildings.size ());
+  m_grid.clear ();
+  // cells as large as the average building, so that a building covers
+  // a few cells and a cell holds a few buildings
+  double sum = 0;
+  for (std::vector<Ptr<Building> >::const_iterator it = m_buildings.begin ();
+       it != m_buildings.end (); ++it)
+    {
+      Box box = (*it)->GetBoundaries ();
+      sum += std::max (box.xMax - box.xMin, box.yMax - box.yMin);
+    }
+  m_cellSize = m_buildings.empty () ? 1.0 : sum / m_buildings.size ();
+  if (!(m_cellSize > 0))
+    {
+      m_cellSize = 1.0;
+    }
+  for (uint32_t i = 0; i < m_buildings.size (); i++)
+    {
+      Box box = m_buildings[i]->GetBoundaries ();
+      std::pair<int64_t, int64_t> lo = GetCell (box.xMin, box.yMin);
+      std::pair<int64_t, int64_t> hi = GetCell (box.xMax, box.yMax);
+      for (int64_t x = lo.first; x <= hi.first; x++)
+        {
+          for (int64_t y = lo.second; y <= hi.second; y++)
+            {
+              m_grid[std::make_pair (x, y)].push_back (i);
+            }
+        }
+    }
+  m_gridDirty = false;
+  NS_LOG_LOGIC ("cell size " << m_cellSize << ", " << m_grid.size () << " cells");
+}
+
+Ptr<Building>
+BuildingListPriv::FindBuilding (Vector position)
+{
+  if (m_gridDirty)
+    {
+      BuildGrid ();
+    }
+  Grid::const_iterator cell = m_grid.find (GetCell (position.x, position.y));
+  if (cell == m_grid.end ())
+    {
+      return 0;
+    }
+  Ptr<Building> found = 0;
+  for (std::vector<uint32_t>::const_iterator it = cell->second.begin ();
+       it != cell->second.end (); ++it)
+    {
+      Ptr<Building> building = m_buildings[*it];
+      if (building->IsInside (position))
+        {
+          NS_ABORT_MSG_UNLESS (found == 0, "position " << position << " is inside both building "
+                               << found->GetId () << " and building " << building->GetId ());
+          found = building;
+        }
+    }
+  return found;
+}
+
 }
 
 /**
@@ -189,5 +283,15 @@ BuildingList::GetNBuildings (void)
 {
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
+Ptr<Building>
+BuildingList::FindBuilding (Vector position)
+{
+  return BuildingListPriv::Get ()->FindBuilding (position);
+}
+void
+BuildingList::NotifyBoundariesChanged (void)
+{
+  BuildingListPriv::Get ()->NotifyBoundariesChanged ();
+}
 
 } // namespace ns3
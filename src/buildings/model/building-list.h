@@ -25,6 +25,7 @@
 
 #include <vector>
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -62,6 +63,24 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+  /**
+   * \param position a position
+   * \returns the Building inside which the position is, or 0 if the
+   *          position is outdoor.
+   *
+   * The buildings are looked up in a uniform grid over their
+   * boundaries in the x-y plane, so the cost of a lookup does not grow
+   * with the number of buildings. The position must not be inside
+   * more than one building.
+   */
+  static Ptr<Building> FindBuilding (Vector position);
+  /**
+   * Invalidate the index of the buildings by position.
+   *
+   * This method is called automatically from Building::SetBoundaries so
+   * the user has little reason to call it himself.
+   */
+  static void NotifyBoundariesChanged (void);
 };
 
 } // namespace ns3
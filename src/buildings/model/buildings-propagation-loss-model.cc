@@ -152,6 +152,8 @@ const
     Ptr<MobilityBuildingInfo> a1 = a->GetObject <MobilityBuildingInfo> ();
     Ptr<MobilityBuildingInfo> b1 = b->GetObject <MobilityBuildingInfo> ();
     NS_ASSERT_MSG ((a1 != 0) && (b1 != 0), "BuildingsPropagationLossModel only works with MobilityBuildingInfo");
+    a1->Update (a);
+    b1->Update (b);
   
   std::map<Ptr<MobilityModel>,  std::map<Ptr<MobilityModel>, ShadowingLoss> >::iterator ait = m_shadowingLossMap.find (a);
   if (ait != m_shadowingLossMap.end ())
@@ -59,6 +59,8 @@ ItuR1238PropagationLossModel::GetLoss (Ptr<MobilityModel> a1, Ptr<MobilityModel>
   Ptr<MobilityBuildingInfo> a = a1->GetObject<MobilityBuildingInfo> ();
   Ptr<MobilityBuildingInfo> b = b1->GetObject<MobilityBuildingInfo> ();
   NS_ASSERT_MSG ((a != 0) && (b != 0), "ItuR1238PropagationLossModel only works with MobilityBuildingInfo");
+  a->Update (a1);
+  b->Update (b1);
   NS_ASSERT_MSG (a->GetBuilding ()->GetId () == b->GetBuilding ()->GetId (), "ITU-R 1238 applies only to nodes that are in the same building");
   double N = 0.0;
   int n = std::abs (a->GetFloorNumber () - b->GetFloorNumber ());
@@ -22,6 +22,8 @@
 #include <ns3/simulator.h>
 #include <ns3/position-allocator.h>
 #include <ns3/mobility-building-info.h>
+#include <ns3/mobility-model.h>
+#include <ns3/building-list.h>
 #include <ns3/pointer.h>
 #include <ns3/log.h>
 #include <ns3/assert.h>
@@ -47,6 +49,7 @@ MobilityBuildingInfo::GetTypeId (void)
 MobilityBuildingInfo::MobilityBuildingInfo ()
 {
   NS_LOG_FUNCTION (this);
+  m_consistent = false;
   m_indoor = false;
   m_nFloor = 1;
   m_roomX = 1;
@@ -58,6 +61,7 @@ MobilityBuildingInfo::MobilityBuildingInfo (Ptr<Building> building)
   : m_myBuilding (building)
 {
   NS_LOG_FUNCTION (this);
+  m_consistent = false;
   m_indoor = false;
   m_nFloor = 1;
   m_roomX = 1;
@@ -82,6 +86,7 @@ void
 MobilityBuildingInfo::SetIndoor (Ptr<Building> building, uint8_t nfloor, uint8_t nroomx, uint8_t nroomy)
 {
   NS_LOG_FUNCTION (this);
+  m_consistent = false;
   m_indoor = true;
   m_myBuilding = building;
   m_nFloor = nfloor;
@@ -103,6 +108,7 @@ void
 MobilityBuildingInfo::SetIndoor (uint8_t nfloor, uint8_t nroomx, uint8_t nroomy)
 {
   NS_LOG_FUNCTION (this);
+  m_consistent = false;
   m_indoor = true;
   m_nFloor = nfloor;
   m_roomX = nroomx;
@@ -123,6 +129,7 @@ void
 MobilityBuildingInfo::SetOutdoor (void)
 {
   NS_LOG_FUNCTION (this);
+  m_consistent = false;
   m_indoor = false;
 }
 
@@ -155,5 +162,38 @@ MobilityBuildingInfo::GetBuilding ()
   return (m_myBuilding);
 }
 
+void
+MobilityBuildingInfo::MakeConsistent (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  Vector pos = mobility->GetPosition ();
+  Ptr<Building> building = BuildingList::FindBuilding (pos);
+  if (building != 0)
+    {
+      NS_LOG_LOGIC ("pos " << pos << " falls inside building " << building->GetId ());
+      SetIndoor (building, building->GetFloor (pos), building->GetRoomX (pos), building->GetRoomY (pos));
+    }
+  else
+    {
+      NS_LOG_LOGIC ("pos " << pos << " is outdoor");
+      SetOutdoor ();
+    }
+  m_consistent = true;
+  m_consistentPosition = pos;
+}
+
+void
+MobilityBuildingInfo::Update (Ptr<MobilityModel> mobility)
+{
+  if (m_consistent)
+    {
+      Vector pos = mobility->GetPosition ();
+      if (pos.x != m_consistentPosition.x || pos.y != m_consistentPosition.y || pos.z != m_consistentPosition.z)
+        {
+          MakeConsistent (mobility);
+        }
+    }
+}
+
   
 } // namespace
@@ -30,11 +30,13 @@
 #include <map>
 #include <ns3/building.h>
 #include <ns3/constant-velocity-helper.h>
+#include <ns3/vector.h>
 
 
 
 namespace ns3 {
 
+class MobilityModel;
 
 /**
  * \ingroup buildings
@@ -107,7 +109,24 @@ public:
    */
   Ptr<Building> GetBuilding ();
 
-
+  /**
+   * Mark this MobilityBuildingInfo instance as indoor or outdoor,
+   * according to the building, looked up in the BuildingList, inside
+   * which the current position of the mobility model is, and remember
+   * that position.
+   *
+   * \param mobility the mobility model this instance is aggregated to
+   */
+  void MakeConsistent (Ptr<MobilityModel> mobility);
+
+  /**
+   * Make this MobilityBuildingInfo instance consistent again if it was
+   * made consistent by MakeConsistent and the mobility model moved
+   * since.  Instances marked indoor or outdoor by hand are not changed.
+   *
+   * \param mobility the mobility model this instance is aggregated to
+   */
+  void Update (Ptr<MobilityModel> mobility);
 
 private:
 
@@ -116,6 +135,8 @@ private:
   uint8_t m_nFloor;
   uint8_t m_roomX;
   uint8_t m_roomY;
+  bool m_consistent;             //!< Whether set by MakeConsistent rather than by hand
+  Vector m_consistentPosition;   //!< Position at the last MakeConsistent
 
 };
 
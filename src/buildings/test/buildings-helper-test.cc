@@ -25,6 +25,7 @@
 #include <ns3/mobility-building-info.h>
 #include <ns3/constant-position-mobility-model.h>
 #include <ns3/building.h>
+#include <ns3/building-list.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/mobility-helper.h>
 #include <ns3/simulator.h>
@@ -168,6 +169,103 @@ BuildingsHelperOneTestCase::DoRun ()
 }
 
 
+/**
+ * Check that the buildings found by position with the index of the
+ * BuildingList are the ones found by checking every building, and that
+ * MobilityBuildingInfo follows a node moving in and out of buildings.
+ */
+class BuildingsHelperIndexTestCase : public TestCase
+{
+public:
+  BuildingsHelperIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+  Ptr<Building> FindBuildingSlow (Vector pos);
+  void CheckAll (void);
+};
+
+BuildingsHelperIndexTestCase::BuildingsHelperIndexTestCase ()
+  : TestCase ("index of the buildings by position")
+{
+}
+
+Ptr<Building>
+BuildingsHelperIndexTestCase::FindBuildingSlow (Vector pos)
+{
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      if ((*bit)->IsInside (pos))
+        {
+          return *bit;
+        }
+    }
+  return 0;
+}
+
+void
+BuildingsHelperIndexTestCase::CheckAll (void)
+{
+  for (double x = -7.5; x < 160; x += 2.5)
+    {
+      for (double y = -7.5; y < 160; y += 2.5)
+        {
+          Vector pos (x, y, 1.5);
+          NS_TEST_ASSERT_MSG_EQ (BuildingList::FindBuilding (pos), FindBuildingSlow (pos),
+                                 "wrong building at " << pos);
+        }
+    }
+}
+
+void
+BuildingsHelperIndexTestCase::DoRun ()
+{
+  // 10 x 10 buildings of different sizes
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      for (uint32_t j = 0; j < 10; j++)
+        {
+          double side = 5 + (i * 10 + j) % 7;
+          Ptr<Building> b = CreateObject<Building> ();
+          b->SetBoundaries (Box (i * 15, i * 15 + side, j * 15, j * 15 + side, 0, 10));
+        }
+    }
+  // one building larger than the others
+  Ptr<Building> large = CreateObject<Building> ();
+  large->SetBoundaries (Box (151, 200, -50, 200, 0, 30));
+  CheckAll ();
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::FindBuilding (Vector (152, 10, 40)), 0, "above the roof is outdoor");
+
+  // moving a building invalidates the index
+  large->SetBoundaries (Box (-10, -1, -10, -1, 0, 30));
+  CheckAll ();
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::FindBuilding (Vector (-5, -5, 1)), large, "moved building not found");
+
+  Ptr<ConstantPositionMobilityModel> mm = CreateObject<ConstantPositionMobilityModel> ();
+  mm->SetPosition (Vector (1, 1, 1));
+  Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+  mm->AggregateObject (buildingInfo);
+  BuildingsHelper::MakeConsistent (mm);
+  NS_TEST_ASSERT_MSG_EQ (buildingInfo->IsIndoor (), true, "node should be indoor");
+  NS_TEST_ASSERT_MSG_EQ (buildingInfo->GetBuilding ()->GetId (), 0, "node should be in building 0");
+  mm->SetPosition (Vector (16, 16, 1));
+  buildingInfo->Update (mm);
+  NS_TEST_ASSERT_MSG_EQ (buildingInfo->IsIndoor (), true, "node should be indoor");
+  NS_TEST_ASSERT_MSG_EQ (buildingInfo->GetBuilding ()->GetId (), 11, "node should be in building 11");
+  mm->SetPosition (Vector (13, 13, 1));
+  buildingInfo->Update (mm);
+  NS_TEST_ASSERT_MSG_EQ (buildingInfo->IsOutdoor (), true, "node should be outdoor");
+
+  // a node marked by hand is left alone
+  buildingInfo->SetIndoor (large, 1, 1, 1);
+  mm->SetPosition (Vector (14, 14, 1));
+  buildingInfo->Update (mm);
+  NS_TEST_ASSERT_MSG_EQ (buildingInfo->GetBuilding (), large, "node marked by hand was moved");
+
+  Simulator::Destroy ();
+}
+
+
 
 
 
@@ -321,6 +419,8 @@ BuildingsHelperTestSuite::BuildingsHelperTestSuite ()
   q7.pos = vq7;
   q7.indoor = false;
   AddTestCase (new BuildingsHelperOneTestCase (q7, b2), TestCase::QUICK);     
+
+  AddTestCase (new BuildingsHelperIndexTestCase, TestCase::QUICK);
 }
 
 static BuildingsHelperTestSuite buildingsHelperAntennaTestSuiteInstance;
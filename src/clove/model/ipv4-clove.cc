@@ -64,6 +64,14 @@ Ipv4Clove::AddAddressWithTor (Ipv4Address address, uint32_t torId)
     m_ipTorMap[address] = torId;
 }
 
+int64_t
+Ipv4Clove::AssignStreams (int64_t stream)
+{
+    NS_LOG_FUNCTION (this << stream);
+    m_rng.SetStream (stream);
+    return 1;
+}
+
 void
 Ipv4Clove::AddAvailPath (uint32_t destTor, uint32_t path)
 {
@@ -143,11 +151,11 @@ Ipv4Clove::CalPath (uint32_t destTor)
     std::vector<uint32_t> paths = itr->second;
     if (m_runMode == CLOVE_RUNMODE_EDGE_FLOWLET)
     {
-        return paths[rand() % paths.size ()];
+        return paths[m_rng.GetInteger (paths.size ())];
     }
     else if (m_runMode == CLOVE_RUNMODE_ECN)
     {
-        double r = ((double) rand () / RAND_MAX);
+        double r = m_rng.GetDouble ();
         std::vector<uint32_t>::iterator itr = paths.begin ();
         double weightSum = 0.0;
         for ( ; itr != paths.end (); ++itr)
@@ -5,6 +5,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/counter-rng.h"
 
 #include <vector>
 #include <map>
@@ -38,6 +39,16 @@ public:
 
     bool FindTorId (Ipv4Address daddr, uint32_t &torId);
 
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams (int64_t stream);
+
 private:
     uint32_t CalPath (uint32_t destTor);
 
@@ -53,6 +64,8 @@ private:
     bool m_disToUncongestedPath;
     std::map<std::pair<uint32_t, uint32_t>, double> m_pathWeight;
     std::map<std::pair<uint32_t, uint32_t>, Time> m_pathECNSeen;
+
+    CounterRng m_rng; // Used to pick the path of a new flowlet
 };
 
 }
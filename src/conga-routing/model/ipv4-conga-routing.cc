@@ -111,6 +111,14 @@ Ipv4CongaRouting::EnableEcmpMode ()
   m_ecmpMode = true;
 }
 
+int64_t
+Ipv4CongaRouting::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_rng.SetStream (stream);
+  return 1;
+}
+
 void
 Ipv4CongaRouting::InitCongestion (uint32_t leafId, uint32_t port, uint32_t congestion)
 {
@@ -420,7 +428,7 @@ Ipv4CongaRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr
       else
       {
         // If there are no cached ports, we randomly choose a good port
-        selectedPort = portCandidates[rand() % portCandidates.size ()];
+        selectedPort = portCandidates[m_rng.GetInteger (portCandidates.size ())];
         if (flowlet == NULL)
         {
           struct Flowlet *newFlowlet = new Flowlet;
@@ -10,6 +10,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/counter-rng.h"
 
 #include <map>
 #include <vector>
@@ -63,6 +64,16 @@ public:
 
   void EnableEcmpMode ();
 
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
   /* Inherit From Ipv4RoutingProtocol */
   virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
   virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
@@ -110,6 +121,9 @@ private:
   // Used to maintain the round robin
   unsigned long m_feedbackIndex;
 
+  // Used to choose among equally good ports
+  CounterRng m_rng;
+
   // Dre Event ID
   EventId m_dreEvent;
 
@@ -25,7 +25,10 @@
 #include "names.h"
 #include "pointer.h"
 #include "log.h"
+#include "simple-ref-count.h"
 
+#include <algorithm>
+#include <map>
 #include <sstream>
 
 /**
@@ -166,7 +169,21 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (uint32_t i) const;
+  /**
+   * Get the indices which match the Config path, if there are few.
+   *
+   * \param [in] limit The maximum number of indices.
+   * \param [out] indices The matching indices, in increasing order.
+   * \returns \c true if at most \p limit indices match.
+   */
+  bool GetIndices (uint32_t limit, std::vector<uint32_t> *indices) const;
 private:
+  /**
+   * Parse one alternative of the Config path specification.
+   *
+   * \param [in] element The alternative.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -177,77 +194,115 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** Whether the element matches all the indices. */
+  bool m_all;
+  /** The ranges of matching indices, bounds included. */
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 };
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (uint32_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      m_all = true;
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      Parse (element.substr (0, tmp-0));
+      Parse (element.substr (tmp+1, element.size () - (tmp + 1)));
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min) && 
-          StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
+          StringToUint32 (upperBound, &max))
         {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+      NS_LOG_DEBUG ("Array "<<i<<" matches *");
       return true;
     }
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator it = m_ranges.begin ();
+       it != m_ranges.end (); ++it)
+    {
+      if (i >= it->first && i <= it->second)
+        {
+          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+          return true;
+        }
+    }
   NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
   return false;
 }
+bool
+ArrayMatcher::GetIndices (uint32_t limit, std::vector<uint32_t> *indices) const
+{
+  NS_LOG_FUNCTION (this << limit << indices);
+  if (m_all)
+    {
+      return false;
+    }
+  uint64_t n = 0;
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator it = m_ranges.begin ();
+       it != m_ranges.end (); ++it)
+    {
+      if (it->first <= it->second)
+        {
+          n += (uint64_t)it->second - it->first + 1;
+        }
+    }
+  if (n > limit)
+    {
+      return false;
+    }
+  indices->clear ();
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator it = m_ranges.begin ();
+       it != m_ranges.end (); ++it)
+    {
+      for (uint64_t i = it->first; i <= it->second; i++)
+        {
+          indices->push_back (i);
+        }
+    }
+  std::sort (indices->begin (), indices->end ());
+  indices->erase (std::unique (indices->begin (), indices->end ()), indices->end ());
+  return true;
+}
 
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
@@ -259,12 +314,178 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * An element of a Config path, parsed once for all the paths it
+ * appears in.
+ */
+struct PathElement : public SimpleRefCount<PathElement>
+{
+  /**
+   * Parse a Config path element.
+   *
+   * \param [in] element The element, between two slashes.
+   */
+  PathElement (std::string element);
+
+  std::string item;       //!< The element.
+  bool names;             //!< Whether the element starts the "/Names" name space.
+  bool getObject;         //!< Whether the element is a call to GetObject.
+  std::string tidName;    //!< The name of the TypeId to get.
+  bool tidFound;          //!< Whether the TypeId was registered when parsed.
+  TypeId tid;             //!< The TypeId to get, if registered.
+  ArrayMatcher matcher;   //!< The element as an array index.
+};
+
+PathElement::PathElement (std::string element)
+  : item (element),
+    names (element.find ("Names") == 0),
+    getObject (element.find ("$") == 0),
+    tidFound (false),
+    matcher (element)
+{
+  if (getObject)
+    {
+      tidName = element.substr (1, element.size () - 1);
+      tidFound = TypeId::LookupByNameFailSafe (tidName, &tid);
+    }
+}
+
+/**
+ * Get the parsed form of a Config path element.
+ *
+ * \param [in] element The element, between two slashes.
+ * \returns The parsed element.
+ */
+static Ptr<const PathElement>
+GetPathElement (const std::string &element)
+{
+  // Never freed, paths may still be resolved by static destructors
+  static std::map<std::string, Ptr<const PathElement> > *elements =
+    new std::map<std::string, Ptr<const PathElement> > ();
+  std::map<std::string, Ptr<const PathElement> >::iterator it = elements->find (element);
+  if (it == elements->end ())
+    {
+      it = elements->insert (std::make_pair (element, Create<PathElement> (element))).first;
+    }
+  return it->second;
+}
+
+/** An attribute which a Config path element can walk through. */
+struct PathAttribute
+{
+  std::string name;                                //!< The attribute name.
+  Ptr<const AttributeAccessor> accessor;           //!< The attribute accessor.
+  bool container;                                  //!< Whether it holds several objects.
+  const ObjectPtrContainerAccessor *items;         //!< The accessor, if it gives access to the items.
+};
+
+/**
+ * The attributes of a TypeId and its parents which a Config path
+ * element can walk through, in the order Config has always matched them.
+ */
+struct PathAttributes : public SimpleRefCount<PathAttributes>
+{
+  uint32_t generation;                     //!< TypeId::GetAttributeGeneration when built.
+  std::vector<PathAttribute> attributes;   //!< The matching attributes.
+};
+
+/**
+ * Get the pointer and container attributes matching a Config path
+ * element, from a per-TypeId table.
+ *
+ * \param [in] tid The TypeId of the object.
+ * \param [in] item The Config path element, an attribute name or "*".
+ * \returns The matching attributes.
+ */
+static Ptr<const PathAttributes>
+GetPathAttributes (TypeId tid, const std::string &item)
+{
+  typedef std::map<std::string, Ptr<PathAttributes> > Items;
+  // Never freed, paths may still be resolved by static destructors
+  static std::vector<Items> *tables = new std::vector<Items> ();
+  uint16_t uid = tid.GetUid ();
+  if (tables->size () <= uid)
+    {
+      tables->resize (uid + 1);
+    }
+  Ptr<PathAttributes> &cached = (*tables)[uid][item];
+  if (cached != 0 && cached->generation == TypeId::GetAttributeGeneration ())
+    {
+      return cached;
+    }
+
+  Ptr<PathAttributes> attributes = Create<PathAttributes> ();
+  attributes->generation = TypeId::GetAttributeGeneration ();
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          PathAttribute attribute;
+          attribute.name = info.name;
+          attribute.accessor = info.accessor;
+          attribute.items = 0;
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.container = false;
+              attributes->attributes.push_back (attribute);
+            }
+          if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.container = true;
+              attribute.items = dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (info.accessor));
+              attributes->attributes.push_back (attribute);
+            }
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+        }
+      nextTid = tid.GetParent ();
+    } while (nextTid != tid);
+  cached = attributes;
+  return attributes;
+}
+
+/**
+ * Order the items of a container by index.
+ * \param [in] a An item.
+ * \param [in] b Another item.
+ * \returns \c true if the index of a is less than the index of b.
+ */
+static bool
+IndexLess (const std::pair<uint32_t, Ptr<Object> > &a, const std::pair<uint32_t, Ptr<Object> > &b)
+{
+  return a.first < b.first;
+}
+
+/**
+ * Compare the indices of the items of a container.
+ * \param [in] a An item.
+ * \param [in] b Another item.
+ * \returns \c true if a and b have the same index.
+ */
+static bool
+IndexEqual (const std::pair<uint32_t, Ptr<Object> > &a, const std::pair<uint32_t, Ptr<Object> > &b)
+{
+  return a.first == b.first;
+}
+
 /**
  * Abstract class to parse Config paths into object references.
+ *
+ * The paths are kept in a tree of their elements, so that the elements
+ * several paths have in common are resolved once.
  */
 class Resolver
 {
 public:
+  /** Construct without any Config path. */
+  Resolver ();
   /**
    * Construct from a base Config path.
    *
@@ -275,7 +496,15 @@ public:
   virtual ~Resolver ();
 
   /**
-   * Parse the stored Config path into an object reference,
+   * Add a Config path to resolve.
+   *
+   * \param [in] path The Config path.
+   * \returns The index of the path, passed to DoOne().
+   */
+  uint32_t AddPath (std::string path);
+
+  /**
+   * Parse the stored Config paths into object references,
    * beginning at the indicated root object.
    *
    * \param [in] root The object corresponding to the current position in
@@ -284,29 +513,46 @@ public:
   void Resolve (Ptr<Object> root);
   
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
+  /** A node of the tree of the Config path elements. */
+  struct Node
+  {
+    Ptr<const PathElement> element;    //!< The path element, null at the top.
+    std::vector<uint32_t> children;    //!< The nodes of the next elements.
+    std::map<std::string, uint32_t> items;     //!< The nodes of the next elements, by element.
+    std::vector<uint32_t> paths;       //!< The paths which end here.
+  };
+
+  /**
+   * Ensure the Config path starts and ends with a '/'.
+   *
+   * \param [in] path The Config path.
+   * \returns The canonical Config path.
+   */
+  static std::string Canonicalize (std::string path);
   /**
-   * Parse the next element in the Config path.
+   * Resolve the elements following a node of the tree.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] node The node of the last element resolved.
    * \param [in] root The object corresponding to the current positon
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (uint32_t node, Ptr<Object> root);
   /**
-   * Parse an index on the Config path.
+   * Resolve the element of a node of the tree.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] node The node of the element.
+   * \param [in] root The object corresponding to the current positon
+   *                  in the Config path.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoResolveElement (uint32_t node, Ptr<Object> root);
   /**
-   * Handle one object found on the path.
+   * Parse the indices following a container on the Config paths.
    *
-   * \param [in] object The current object on the Config path.
+   * \param [in] node The node of the container attribute.
+   * \param [in] root The object holding the container.
+   * \param [in] attribute The container attribute.
    */
-  void DoResolveOne (Ptr<Object> object);
+  void DoArrayResolve (uint32_t node, Ptr<Object> root, const PathAttribute &attribute);
   /**
    * Get the current Config path.
    *
@@ -316,45 +562,89 @@ private:
   /**
    * Handle one found object.
    *
+   * \param [in] index The index of the Config path, from AddPath().
    * \param [in] object The found object.
    * \param [in] path The matching Config path context.
    */
-  virtual void DoOne (Ptr<Object> object, std::string path) = 0;
+  virtual void DoOne (uint32_t index, Ptr<Object> object, std::string path) = 0;
 
   /** Current list of path tokens. */
   std::vector<std::string> m_workStack;
-  /** The Config path. */
-  std::string m_path;
+  /** The tree of the Config path elements, the top first. */
+  std::vector<Node> m_nodes;
+  /** The number of Config paths. */
+  uint32_t m_nPaths;
 };
 
+Resolver::Resolver ()
+  : m_nodes (1),
+    m_nPaths (0)
+{
+  NS_LOG_FUNCTION (this);
+}
 Resolver::Resolver (std::string path)
-  : m_path (path)
+  : m_nodes (1),
+    m_nPaths (0)
 {
   NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
+  AddPath (path);
 }
 Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
 }
-void
-Resolver::Canonicalize (void)
+std::string
+Resolver::Canonicalize (std::string path)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (path);
 
   // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
+  std::string::size_type tmp = path.find ("/");
   if (tmp != 0)
     {
       // no slash at start
-      m_path = "/" + m_path;
+      path = "/" + path;
     }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
+  tmp = path.find_last_of ("/");
+  if (tmp != (path.size () - 1))
     {
       // no slash at end
-      m_path = m_path + "/";
+      path = path + "/";
     }
+  return path;
+}
+
+uint32_t
+Resolver::AddPath (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+  path = Canonicalize (path);
+  uint32_t node = 0;
+  std::string::size_type start = 1;
+  std::string::size_type next = path.find ("/", start);
+  while (next != std::string::npos)
+    {
+      std::string item = path.substr (start, next - start);
+      std::map<std::string, uint32_t>::const_iterator i = m_nodes[node].items.find (item);
+      uint32_t child;
+      if (i != m_nodes[node].items.end ())
+        {
+          child = i->second;
+        }
+      else
+        {
+          child = m_nodes.size ();
+          m_nodes.push_back (Node ());
+          m_nodes[child].element = GetPathElement (item);
+          m_nodes[node].children.push_back (child);
+          m_nodes[node].items[item] = child;
+        }
+      node = child;
+      start = next + 1;
+      next = path.find ("/", start);
+    }
+  m_nodes[node].paths.push_back (m_nPaths);
+  return m_nPaths++;
 }
 
 void 
@@ -362,7 +652,7 @@ Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -378,40 +668,41 @@ Resolver::GetResolvedPath (void) const
   return fullPath;
 }
 
-void 
-Resolver::DoResolveOne (Ptr<Object> object)
+void
+Resolver::DoResolve (uint32_t node, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << object);
-
-  NS_LOG_DEBUG ("resolved="<<GetResolvedPath ());
-  DoOne (object, GetResolvedPath ());
-}
+  NS_LOG_FUNCTION (this << node << root);
 
-void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
-{
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-
-  if (next == std::string::npos)
-    {
-      //
-      // If root is zero, we're beginning to see if we can use the object name 
-      // service to resolve this path.  It is impossible to have a object name 
-      // associated with the root of the object name service since that root
-      // is not an object.  This path must be referring to something in another
-      // namespace and it will have been found already since the name service
-      // is always consulted last.
-      // 
-      if (root)
+  //
+  // If root is zero, we're beginning to see if we can use the object name 
+  // service to resolve this path.  It is impossible to have a object name 
+  // associated with the root of the object name service since that root
+  // is not an object.  This path must be referring to something in another
+  // namespace and it will have been found already since the name service
+  // is always consulted last.
+  // 
+  if (root && !m_nodes[node].paths.empty ())
+    {
+      std::string resolved = GetResolvedPath ();
+      NS_LOG_DEBUG ("resolved="<<resolved);
+      for (std::vector<uint32_t>::const_iterator i = m_nodes[node].paths.begin ();
+           i != m_nodes[node].paths.end (); ++i)
         {
-          DoResolveOne (root);
+          DoOne (*i, root, resolved);
         }
-      return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  for (std::vector<uint32_t>::const_iterator i = m_nodes[node].children.begin ();
+       i != m_nodes[node].children.end (); ++i)
+    {
+      DoResolveElement (*i, root);
+    }
+}
+
+void
+Resolver::DoResolveElement (uint32_t node, Ptr<Object> root)
+{
+  const PathElement &element = *m_nodes[node].element;
+  NS_LOG_FUNCTION (this << element.item << root);
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -420,16 +711,12 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   // the root of the "/Names" namespace, so we just ignore it and move on to 
   // the next segment.
   //
-  if (root == 0)
+  if (root == 0 && element.names)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
-        {
-          m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
-          m_workStack.pop_back ();
-          return;
-        }
+      m_workStack.push_back (element.item);
+      DoResolve (node, root);
+      m_workStack.pop_back ();
+      return;
     }
 
   //
@@ -438,12 +725,12 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   // zero, this means to look in the root of the "/Names" name space, otherwise
   // it refers to a name space context (level).
   //
-  Ptr<Object> namedObject = Names::Find<Object> (root, item);
+  Ptr<Object> namedObject = Names::Find<Object> (root, element.item);
   if (namedObject)
     {
-      NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
-      m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      NS_LOG_DEBUG ("Name system resolved item = " << element.item << " to " << namedObject);
+      m_workStack.push_back (element.item);
+      DoResolve (node, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -459,115 +746,149 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (element.getObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      NS_LOG_DEBUG ("GetObject="<<element.tidName<<" on path="<<GetResolvedPath ());
+      TypeId tid = element.tidFound ? element.tid : TypeId::LookupByName (element.tidName);
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject ("<<element.tidName<<") failed on path="<<GetResolvedPath ());
           return;
         }
-      m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      m_workStack.push_back (element.item);
+      DoResolve (node, object);
       m_workStack.pop_back ();
     }
   else 
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
-      bool foundMatch = false;
-      
-      do
+      Ptr<const PathAttributes> attributes = GetPathAttributes (root->GetInstanceTypeId (), element.item);
+      for (std::vector<PathAttribute>::const_iterator it = attributes->attributes.begin ();
+           it != attributes->attributes.end (); ++it)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          if (!it->container)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)="<<it->name<<" on path="<<GetResolvedPath ());
+              PointerValue ptr;
+              if (!it->accessor->Get (PeekPointer (root), ptr))
                 {
-                  continue;
-                }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (ptr != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue ptr;
-                  root->GetAttribute (info.name, ptr);
-                  Ptr<Object> object = ptr.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
+                  root->GetAttribute (it->name, ptr);
                 }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
+              Ptr<Object> object = ptr.Get<Object> ();
+              if (object == 0)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
+                  NS_LOG_ERROR ("Requested object name=\""<<element.item<<
+                                "\" exists on path=\""<<GetResolvedPath ()<<"\""
+                                " but is null.");
+                  continue;
                 }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              m_workStack.push_back (it->name);
+              DoResolve (node, object);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<it->name<<" on path="<<GetResolvedPath ());
+              m_workStack.push_back (it->name);
+              DoArrayResolve (node, root, *it);
+              m_workStack.pop_back ();
+            }
+        }
       
-      if (!foundMatch)
+      if (attributes->attributes.empty ())
         {
-          NS_LOG_DEBUG ("Requested item="<<item<<" does not exist on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("Requested item="<<element.item<<" does not exist on path="<<GetResolvedPath ());
           return;
         }
     }
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (uint32_t node, Ptr<Object> root, const PathAttribute &attribute)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << node << root << attribute.name);
+  if (m_nodes[node].children.empty ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
-  ObjectPtrContainerValue::Iterator it;
-  for (it = container.Begin (); it != container.End (); ++it)
+  // The items of the container, by increasing index as in an
+  // ObjectPtrContainerValue, listed only if some index is not found
+  // at its own position
+  std::vector<std::pair<uint32_t, Ptr<Object> > > items;
+  bool listed = false;
+  uint32_t n = 0;
+  if (attribute.items == 0 || !attribute.items->GetN (PeekPointer (root), &n))
+    {
+      ObjectPtrContainerValue container;
+      root->GetAttribute (attribute.name, container);
+      items.assign (container.Begin (), container.End ());
+      listed = true;
+    }
+
+  for (std::vector<uint32_t>::const_iterator child = m_nodes[node].children.begin ();
+       child != m_nodes[node].children.end (); ++child)
     {
-      if (matcher.Matches ((*it).first))
+      const ArrayMatcher &matcher = m_nodes[*child].element->matcher;
+      std::vector<uint32_t> indices;
+      if (!listed && matcher.GetIndices (n, &indices))
         {
-          std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
-          m_workStack.pop_back ();
+          // Containers are mostly indexed by position: try to avoid
+          // going through all the items for a few indices
+          std::vector<Ptr<Object> > objects;
+          for (std::vector<uint32_t>::const_iterator i = indices.begin (); i != indices.end (); ++i)
+            {
+              if (*i >= n)
+                {
+                  break;
+                }
+              uint32_t index;
+              Ptr<Object> object = attribute.items->GetItem (PeekPointer (root), *i, &index);
+              if (index != *i)
+                {
+                  break;
+                }
+              objects.push_back (object);
+            }
+          if (objects.size () == indices.size ())
+            {
+              for (uint32_t i = 0; i < indices.size (); i++)
+                {
+                  std::ostringstream oss;
+                  oss << indices[i];
+                  m_workStack.push_back (oss.str ());
+                  DoResolve (*child, objects[i]);
+                  m_workStack.pop_back ();
+                }
+              continue;
+            }
+        }
+      if (!listed)
+        {
+          for (uint32_t i = 0; i < n; i++)
+            {
+              uint32_t index;
+              Ptr<Object> object = attribute.items->GetItem (PeekPointer (root), i, &index);
+              items.push_back (std::make_pair (index, object));
+            }
+          // Keep the first item of each index, as ObjectPtrContainerValue
+          std::stable_sort (items.begin (), items.end (), IndexLess);
+          items.erase (std::unique (items.begin (), items.end (), IndexEqual), items.end ());
+          listed = true;
+        }
+      for (std::vector<std::pair<uint32_t, Ptr<Object> > >::const_iterator it = items.begin ();
+           it != items.end (); ++it)
+        {
+          if (matcher.Matches (it->first))
+            {
+              std::ostringstream oss;
+              oss << it->first;
+              m_workStack.push_back (oss.str ());
+              DoResolve (*child, it->second);
+              m_workStack.pop_back ();
+            }
         }
     }
 }
@@ -588,6 +909,13 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc Config::LookupMatches() */
   Config::MatchContainer LookupMatches (std::string path);
+  /**
+   * Find the objects matching several paths, walking the object graph
+   * once for all of them.
+   * \param [in] paths The paths to perform a match against.
+   * \returns The objects which match each path.
+   */
+  std::vector<Config::MatchContainer> LookupMatches (const std::vector<std::string> &paths);
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -599,7 +927,6 @@ public:
   /** \copydoc Config::GetRootNamespaceObject() */
   Ptr<Object> GetRootNamespaceObject (uint32_t i) const;
 
-private:
   /**
    * Break a Config path into the leading path and the last leaf token.
    * \param [in] path The Config path.
@@ -609,6 +936,8 @@ private:
    */
   void ParsePath (std::string path, std::string *root, std::string *leaf) const;
 
+private:
+
   /** Container type to hold the root Config path tokens. */
   typedef std::vector<Ptr<Object> > Roots;
 
@@ -681,19 +1010,32 @@ Config::MatchContainer
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
+  return LookupMatches (std::vector<std::string> (1, path))[0];
+}
+
+std::vector<Config::MatchContainer>
+ConfigImpl::LookupMatches (const std::vector<std::string> &paths)
+{
+  NS_LOG_FUNCTION (this << paths.size ());
   class LookupMatchesResolver : public Resolver 
   {
   public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
-    {}
-    virtual void DoOne (Ptr<Object> object, std::string path) {
-      m_objects.push_back (object);
-      m_contexts.push_back (path);
-    }
-    std::vector<Ptr<Object> > m_objects;
-    std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+    LookupMatchesResolver (const std::vector<std::string> &paths)
+      : m_objects (paths.size ()),
+        m_contexts (paths.size ())
+    {
+      for (std::vector<std::string>::const_iterator i = paths.begin (); i != paths.end (); ++i)
+        {
+          AddPath (*i);
+        }
+    }
+    virtual void DoOne (uint32_t index, Ptr<Object> object, std::string path) {
+      m_objects[index].push_back (object);
+      m_contexts[index].push_back (path);
+    }
+    std::vector<std::vector<Ptr<Object> > > m_objects;
+    std::vector<std::vector<std::string> > m_contexts;
+  } resolver = LookupMatchesResolver (paths);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -706,7 +1048,12 @@ ConfigImpl::LookupMatches (std::string path)
   //
   resolver.Resolve (0);
 
-  return Config::MatchContainer (resolver.m_objects, resolver.m_contexts, path);
+  std::vector<Config::MatchContainer> containers;
+  for (uint32_t i = 0; i < paths.size (); i++)
+    {
+      containers.push_back (Config::MatchContainer (resolver.m_objects[i], resolver.m_contexts[i], paths[i]));
+    }
+  return containers;
 }
 
 void 
@@ -873,6 +1220,107 @@ Ptr<Object> GetRootNamespaceObject (uint32_t i)
   return ConfigImpl::Get ()->GetRootNamespaceObject (i);
 }
 
+/** A call recorded in a Batch. */
+struct Batch::Operation
+{
+  /** The Config function called. */
+  enum Kind
+  {
+    SET,                       //!< Config::Set
+    CONNECT,                   //!< Config::Connect
+    CONNECT_WITHOUT_CONTEXT    //!< Config::ConnectWithoutContext
+  } kind;                      //!< The Config function called.
+  std::string path;            //!< The path.
+  Ptr<const AttributeValue> value;     //!< The value set.
+  CallbackBase cb;             //!< The callback connected.
+};
+
+Batch::Batch ()
+{
+  NS_LOG_FUNCTION (this);
+}
+Batch::~Batch ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Operation *>::iterator i = m_operations.begin (); i != m_operations.end (); ++i)
+    {
+      delete *i;
+    }
+}
+
+void
+Batch::Set (std::string path, const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (this << path << &value);
+  Operation *operation = new Operation ();
+  operation->kind = Operation::SET;
+  operation->path = path;
+  operation->value = value.Copy ();
+  m_operations.push_back (operation);
+}
+void
+Batch::Connect (std::string path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path << &cb);
+  Operation *operation = new Operation ();
+  operation->kind = Operation::CONNECT;
+  operation->path = path;
+  operation->cb = cb;
+  m_operations.push_back (operation);
+}
+void
+Batch::ConnectWithoutContext (std::string path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path << &cb);
+  Operation *operation = new Operation ();
+  operation->kind = Operation::CONNECT_WITHOUT_CONTEXT;
+  operation->path = path;
+  operation->cb = cb;
+  m_operations.push_back (operation);
+}
+
+uint32_t
+Batch::GetN (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_operations.size ();
+}
+
+void
+Batch::Apply (void)
+{
+  NS_LOG_FUNCTION (this);
+  ConfigImpl *impl = ConfigImpl::Get ();
+  std::vector<std::string> roots;
+  std::vector<std::string> leaves;
+  for (std::vector<Operation *>::const_iterator i = m_operations.begin (); i != m_operations.end (); ++i)
+    {
+      std::string root, leaf;
+      impl->ParsePath ((*i)->path, &root, &leaf);
+      roots.push_back (root);
+      leaves.push_back (leaf);
+    }
+  std::vector<MatchContainer> containers = impl->LookupMatches (roots);
+  for (uint32_t i = 0; i < m_operations.size (); i++)
+    {
+      const Operation *operation = m_operations[i];
+      switch (operation->kind)
+        {
+        case Operation::SET:
+          containers[i].Set (leaves[i], *operation->value);
+          break;
+        case Operation::CONNECT:
+          containers[i].Connect (leaves[i], operation->cb);
+          break;
+        case Operation::CONNECT_WITHOUT_CONTEXT:
+          containers[i].ConnectWithoutContext (leaves[i], operation->cb);
+          break;
+        }
+      delete operation;
+    }
+  m_operations.clear ();
+}
+
 } // namespace Config
 
 } // namespace ns3
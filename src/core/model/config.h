@@ -258,6 +258,87 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+/**
+ * \ingroup config
+ * \brief A set of Config::Set and Config::Connect calls matched together.
+ *
+ * Each call to Config::Set or Config::Connect walks the object graph from
+ * the root namespace objects to find the objects matching its path.  A
+ * Batch records the calls, and Apply() walks the graph once for all of
+ * them: the path elements the paths have in common, e.g. the nodes and
+ * the devices in "/NodeList/[0-99]/DeviceList/[1-4]/TxQueue/Enqueue" and
+ * "/NodeList/[0-99]/DeviceList/[1-4]/TxQueue/Drop", are resolved once.
+ *
+ * \code
+ *   Config::Batch batch;
+ *   for (uint32_t i = 0; i < nodes.GetN (); i++)
+ *     {
+ *       std::ostringstream oss;
+ *       oss << "/NodeList/" << nodes.Get (i)->GetId () << "/DeviceList/1/TxQueue/";
+ *       batch.Connect (oss.str () + "Drop", MakeCallback (&DropTrace));
+ *       batch.Connect (oss.str () + "Enqueue", MakeCallback (&EnqueueTrace));
+ *     }
+ *   batch.Apply ();
+ * \endcode
+ *
+ * All the paths are matched before any call is applied, and the calls
+ * are then applied in the order they were added, so a call should not
+ * depend on the objects an earlier call of the same batch changes.
+ */
+class Batch
+{
+public:
+  Batch ();
+  ~Batch ();
+
+  /**
+   * Add a call to Config::Set.
+   * \param [in] path A path to match attributes.
+   * \param [in] value The value to set in all matching attributes.
+   */
+  void Set (std::string path, const AttributeValue &value);
+  /**
+   * Add a call to Config::Connect.
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to connect to the matching trace sources.
+   */
+  void Connect (std::string path, const CallbackBase &cb);
+  /**
+   * Add a call to Config::ConnectWithoutContext.
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to connect to the matching trace sources.
+   */
+  void ConnectWithoutContext (std::string path, const CallbackBase &cb);
+
+  /**
+   * \returns The number of calls added since the last Apply().
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Match the paths of all the calls, apply the calls and clear the batch.
+   */
+  void Apply (void);
+
+private:
+  /** A recorded call. */
+  struct Operation;
+
+  /**
+   * Copy constructor, not implemented.
+   * \param [in] o The batch to copy.
+   */
+  Batch (const Batch &o);
+  /**
+   * Assignment, not implemented.
+   * \param [in] o The batch to copy.
+   * \returns This batch.
+   */
+  Batch &operator = (const Batch &o);
+
+  /** The calls, in the order they were added. */
+  std::vector<Operation *> m_operations;
+};
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "counter-rng.h"
+#include "rng-seed-manager.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup randomvariable
+ * ns3::CounterRng implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CounterRng");
+
+CounterRng::CounterRng ()
+{
+  NS_LOG_FUNCTION (this);
+  SetStream (-1);
+}
+
+void
+CounterRng::SetStream (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  NS_ASSERT (stream >= -1);
+  m_stream = stream;
+  if (stream == -1)
+    {
+      // The first 2^63 streams are reserved for automatic stream
+      // number assignment, as for RandomVariableStream.
+      m_streamIndex = RngSeedManager::GetNextStreamIndex ();
+      NS_ASSERT (m_streamIndex <= ((1ULL) << 63));
+    }
+  else
+    {
+      m_streamIndex = ((1ULL) << 63) + stream;
+    }
+  m_counter = 0;
+  m_keyed = false;
+  m_next = 4;
+}
+
+int64_t
+CounterRng::GetStream (void) const
+{
+  return m_stream;
+}
+
+void
+CounterRng::Refill (void)
+{
+  if (!m_keyed)
+    {
+      uint64_t run = RngSeedManager::GetRun ();
+      m_key[0] = RngSeedManager::GetSeed ();
+      m_key[1] = (uint32_t) run ^ (uint32_t) (run >> 32);
+      m_keyed = true;
+    }
+  uint32_t counter[4] = { (uint32_t) m_counter, (uint32_t) (m_counter >> 32),
+                          (uint32_t) m_streamIndex, (uint32_t) (m_streamIndex >> 32) };
+  Philox (counter, m_key, m_block);
+  m_counter++;
+  m_next = 0;
+}
+
+void
+CounterRng::Philox (const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+{
+  const uint32_t M0 = 0xD2511F53;
+  const uint32_t M1 = 0xCD9E8D57;
+  const uint32_t W0 = 0x9E3779B9;
+  const uint32_t W1 = 0xBB67AE85;
+
+  uint32_t c0 = counter[0];
+  uint32_t c1 = counter[1];
+  uint32_t c2 = counter[2];
+  uint32_t c3 = counter[3];
+  uint32_t k0 = key[0];
+  uint32_t k1 = key[1];
+  for (uint32_t round = 0; round < 10; round++)
+    {
+      uint64_t p0 = (uint64_t) M0 * c0;
+      uint64_t p1 = (uint64_t) M1 * c2;
+      uint32_t n0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+      uint32_t n1 = (uint32_t) p1;
+      uint32_t n2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+      uint32_t n3 = (uint32_t) p0;
+      c0 = n0;
+      c1 = n1;
+      c2 = n2;
+      c3 = n3;
+      k0 += W0;
+      k1 += W1;
+    }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+} // namespace ns3
@@ -22,13 +22,18 @@
 #include "default-simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 
 #include "ptr.h"
 #include "pointer.h"
+#include "boolean.h"
+#include "string.h"
 #include "assert.h"
 #include "log.h"
 
 #include <cmath>
+#include <fstream>
+#include <iostream>
 
 
 /**
@@ -53,6 +58,19 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("Profile",
+                   "Measure the wall clock time spent in every kind of event "
+                   "and report it at Simulator::Destroy.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::SetProfile,
+                                        &DefaultSimulatorImpl::GetProfile),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ProfileFile",
+                   "The file the event profile is written to, "
+                   "empty for the standard output.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::m_profileFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -73,11 +91,34 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_unscheduledEvents = 0;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
+  m_profiler = 0;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
+  delete m_profiler;
+}
+
+void
+DefaultSimulatorImpl::SetProfile (bool profile)
+{
+  NS_LOG_FUNCTION (this << profile);
+  if (profile && m_profiler == 0)
+    {
+      m_profiler = new EventProfiler ();
+    }
+  else if (!profile)
+    {
+      delete m_profiler;
+      m_profiler = 0;
+    }
+}
+
+bool
+DefaultSimulatorImpl::GetProfile (void) const
+{
+  return m_profiler != 0;
 }
 
 void
@@ -108,6 +149,19 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+
+  if (m_profiler != 0)
+    {
+      if (m_profileFile.empty ())
+        {
+          m_profiler->Report (std::cout);
+        }
+      else
+        {
+          std::ofstream os (m_profileFile.c_str ());
+          m_profiler->Report (os);
+        }
+    }
 }
 
 void
@@ -146,7 +200,16 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_profiler == 0 || next.impl->IsCancelled ())
+    {
+      next.impl->Invoke ();
+    }
+  else
+    {
+      m_profiler->Begin (next.impl, m_currentContext);
+      next.impl->Invoke ();
+      m_profiler->End ();
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -30,6 +30,7 @@
 #include "ptr.h"
 
 #include <list>
+#include <string>
 
 /**
  * \file
@@ -39,10 +40,22 @@
 
 namespace ns3 {
 
+class EventProfiler;
+
 /**
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * When the Profile attribute is set, the wall clock time spent in every
+ * event is attributed to the function the event calls (or to its label,
+ * see EventImpl::SetLabel) and to its execution context, and a report
+ * sorted by time is printed at Simulator::Destroy.  Set it before the
+ * simulator is used:
+ *
+ * \code
+ *   Config::SetDefault ("ns3::DefaultSimulatorImpl::Profile", BooleanValue (true));
+ * \endcode
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -81,6 +94,16 @@ public:
 private:
   virtual void DoDispose (void);
 
+  /**
+   * Turn the event profiler on or off.
+   * \param [in] profile \c true to profile the events.
+   */
+  void SetProfile (bool profile);
+  /**
+   * \returns \c true if the events are profiled.
+   */
+  bool GetProfile (void) const;
+
   /** Process the next event. */
   void ProcessOneEvent (void);
   /** Move events from a different context into the main event queue. */
@@ -132,6 +155,11 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** The event profiler, 0 unless profiling. */
+  EventProfiler *m_profiler;
+  /** The file the profile is written to, empty for the standard output. */
+  std::string m_profileFile;
 };
 
 } // namespace ns3
@@ -37,7 +37,8 @@ EventImpl::~EventImpl ()
 }
 
 EventImpl::EventImpl ()
-  : m_cancel (false)
+  : m_cancel (false),
+    m_label (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,4 +67,24 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+void
+EventImpl::SetLabel (const char *label)
+{
+  NS_LOG_FUNCTION (this << label);
+  m_label = label;
+}
+
+const char *
+EventImpl::GetLabel (void) const
+{
+  return m_label;
+}
+
+const void *
+EventImpl::GetFunction (uint32_t &size) const
+{
+  size = 0;
+  return 0;
+}
+
 } // namespace ns3
@@ -65,6 +65,27 @@ public:
    * Checked by the simulation engine before calling Invoke().
    */
   bool IsCancelled (void);
+  /**
+   * Attach a label to the event, reported by the simulator profiler in
+   * place of the name of the function the event calls.
+   *
+   * \param [in] label The label, which must outlive the event,
+   *             typically a string literal.
+   */
+  void SetLabel (const char *label);
+  /**
+   * \returns The label of the event, or 0 if it has none.
+   */
+  const char *GetLabel (void) const;
+  /**
+   * Identify the function or method the event calls, so the simulator
+   * profiler can tell apart events of the same type.
+   *
+   * \param [out] size The size of the function pointer.
+   * \returns The address of the function pointer held by the event,
+   *          or 0 if the event does not hold one.
+   */
+  virtual const void *GetFunction (uint32_t &size) const;
 
 protected:
   /**
@@ -77,6 +98,7 @@ protected:
 
 private:
   bool m_cancel;  /**< Has this event been cancelled. */
+  const char *m_label;  /**< Label reported by the profiler. */
 };
 
 } // namespace ns3
@@ -0,0 +1,268 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "event-impl.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <time.h>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::EventProfiler.
+ */
+
+namespace ns3 {
+
+/** Maximum number of contexts listed in the report. */
+static const uint32_t MAX_REPORTED_CONTEXTS = 20;
+
+bool
+EventProfiler::Key::operator < (const Key &o) const
+{
+  if (type != o.type)
+    {
+      return type < o.type;
+    }
+  if (function[0] != o.function[0])
+    {
+      return function[0] < o.function[0];
+    }
+  if (function[1] != o.function[1])
+    {
+      return function[1] < o.function[1];
+    }
+  if (label != o.label)
+    {
+      return label < o.label;
+    }
+  return context < o.context;
+}
+
+EventProfiler::EventProfiler ()
+  : m_current (0),
+    m_start (0)
+{
+}
+
+uint64_t
+EventProfiler::GetWallClockNs (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void
+EventProfiler::Begin (const EventImpl *event, uint32_t context)
+{
+  Key key;
+  key.type = typeid (*event).name ();
+  key.function[0] = 0;
+  key.function[1] = 0;
+  uint32_t size;
+  const void *function = event->GetFunction (size);
+  if (function != 0)
+    {
+      std::memcpy (key.function, function, std::min<uint32_t> (size, sizeof (key.function)));
+    }
+  key.label = event->GetLabel ();
+  key.context = context;
+
+  std::map<Key, Entry>::iterator it = m_entries.find (key);
+  if (it == m_entries.end ())
+    {
+      Entry entry = { 0, 0 };
+      it = m_entries.insert (std::make_pair (key, entry)).first;
+    }
+  m_current = &it->second;
+  m_start = GetWallClockNs ();
+}
+
+void
+EventProfiler::End (void)
+{
+  uint64_t end = GetWallClockNs ();
+  m_current->count++;
+  m_current->ns += end - m_start;
+  m_current = 0;
+}
+
+std::string
+EventProfiler::GetName (const Key &key)
+{
+  if (key.label != 0)
+    {
+      return key.label;
+    }
+  std::string name = key.type;
+#ifdef __GNUC__
+  int status;
+  char *demangled = abi::__cxa_demangle (key.type, 0, 0, &status);
+  if (status == 0 && demangled != 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+  // The implementations built by MakeEvent are local classes named
+  // after the instance of MakeEvent, whose first template (or function)
+  // argument is the signature of the function called: keep only that.
+  std::string::size_type start = name.find ("MakeEvent");
+  if (start == std::string::npos || start + 9 >= name.size ())
+    {
+      return name;
+    }
+  start += std::strlen ("MakeEvent") + 1;
+  int depth = 0;
+  for (std::string::size_type i = start; i < name.size (); i++)
+    {
+      char c = name[i];
+      if (c == '<' || c == '(')
+        {
+          depth++;
+        }
+      else if ((c == '>' || c == ')') && depth > 0)
+        {
+          depth--;
+        }
+      else if ((c == ',' || c == '>' || c == ')') && depth == 0)
+        {
+          return name.substr (start, i - start);
+        }
+    }
+  return name;
+}
+
+/**
+ * Order report rows by decreasing wall clock time.
+ * \param [in] a A row.
+ * \param [in] b Another row.
+ * \returns \c true if a took longer than b.
+ */
+template <typename T>
+static bool
+LongerFirst (const std::pair<T, std::pair<uint64_t, uint64_t> > &a,
+             const std::pair<T, std::pair<uint64_t, uint64_t> > &b)
+{
+  return a.second.second > b.second.second;
+}
+
+void
+EventProfiler::Report (std::ostream &os) const
+{
+  // Merge the contexts, and the copies of a type made in different
+  // libraries, into one row per event kind: (count, ns) by
+  // (name, function)
+  typedef std::pair<std::string, std::pair<uint64_t, uint64_t> > Kind;
+  std::map<Kind, std::pair<uint64_t, uint64_t> > kinds;
+  std::map<uint32_t, std::pair<uint64_t, uint64_t> > contexts;
+  std::map<std::string, uint32_t> functionsPerName;
+  uint64_t totalCount = 0;
+  uint64_t totalNs = 0;
+  for (std::map<Key, Entry>::const_iterator it = m_entries.begin (); it != m_entries.end (); ++it)
+    {
+      Kind kind (GetName (it->first), std::make_pair (0, 0));
+      if (it->first.label == 0)
+        {
+          kind.second = std::make_pair (it->first.function[0], it->first.function[1]);
+        }
+      std::map<Kind, std::pair<uint64_t, uint64_t> >::iterator k = kinds.find (kind);
+      if (k == kinds.end ())
+        {
+          k = kinds.insert (std::make_pair (kind, std::make_pair (0, 0))).first;
+          functionsPerName[kind.first]++;
+        }
+      k->second.first += it->second.count;
+      k->second.second += it->second.ns;
+      std::pair<uint64_t, uint64_t> &context = contexts[it->first.context];
+      context.first += it->second.count;
+      context.second += it->second.ns;
+      totalCount += it->second.count;
+      totalNs += it->second.ns;
+    }
+
+  std::vector<std::pair<std::string, std::pair<uint64_t, uint64_t> > > kindRows;
+  for (std::map<Kind, std::pair<uint64_t, uint64_t> >::const_iterator it = kinds.begin (); it != kinds.end (); ++it)
+    {
+      std::ostringstream name;
+      name << it->first.first;
+      // Tell apart functions of the same signature by their address
+      if (functionsPerName[it->first.first] > 1)
+        {
+          name << " [0x" << std::hex << it->first.second.first << std::dec << "]";
+        }
+      kindRows.push_back (std::make_pair (name.str (), it->second));
+    }
+  std::sort (kindRows.begin (), kindRows.end (), LongerFirst<std::string>);
+
+  std::vector<std::pair<uint32_t, std::pair<uint64_t, uint64_t> > > contextRows (contexts.begin (), contexts.end ());
+  std::sort (contextRows.begin (), contextRows.end (), LongerFirst<uint32_t>);
+
+  std::ios::fmtflags flags = os.flags ();
+  os << std::fixed;
+  os << "Event profile: " << totalCount << " events, "
+     << std::setprecision (3) << totalNs / 1e6 << " ms of wall clock time" << std::endl;
+  os << std::setw (12) << "Wall ms" << std::setw (8) << "%" << std::setw (12) << "Events"
+     << std::setw (10) << "ns/event" << "  Event" << std::endl;
+  for (uint32_t i = 0; i < kindRows.size (); i++)
+    {
+      uint64_t count = kindRows[i].second.first;
+      uint64_t ns = kindRows[i].second.second;
+      os << std::setw (12) << std::setprecision (3) << ns / 1e6
+         << std::setw (8) << std::setprecision (1) << (totalNs ? 100.0 * ns / totalNs : 0.0)
+         << std::setw (12) << count
+         << std::setw (10) << std::setprecision (0) << (count ? (double) ns / count : 0.0)
+         << "  " << kindRows[i].first << std::endl;
+    }
+  os << std::setw (12) << "Wall ms" << std::setw (8) << "%" << std::setw (12) << "Events"
+     << "  Context" << std::endl;
+  for (uint32_t i = 0; i < contextRows.size () && i < MAX_REPORTED_CONTEXTS; i++)
+    {
+      uint64_t ns = contextRows[i].second.second;
+      os << std::setw (12) << std::setprecision (3) << ns / 1e6
+         << std::setw (8) << std::setprecision (1) << (totalNs ? 100.0 * ns / totalNs : 0.0)
+         << std::setw (12) << contextRows[i].second.first << "  ";
+      if (contextRows[i].first == 0xffffffff)
+        {
+          os << "none";
+        }
+      else
+        {
+          os << contextRows[i].first;
+        }
+      os << std::endl;
+    }
+  if (contextRows.size () > MAX_REPORTED_CONTEXTS)
+    {
+      os << "  and " << contextRows.size () - MAX_REPORTED_CONTEXTS << " more contexts" << std::endl;
+    }
+  os.flags (flags);
+}
+
+} // namespace ns3
@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::EventProfiler.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ *
+ * Attributes the wall clock time spent in events to the function the
+ * events call and to their execution context.
+ *
+ * Events are told apart by the type of their implementation, which
+ * MakeEvent derives from the signature of the function, by the function
+ * pointer they hold and by their label, if EventImpl::SetLabel gave them
+ * one.  The report lists the event kinds and the contexts by decreasing
+ * wall clock time.
+ */
+class EventProfiler
+{
+public:
+  EventProfiler ();
+
+  /**
+   * Start timing an event.
+   * \param [in] event The event about to be invoked.
+   * \param [in] context The execution context of the event.
+   */
+  void Begin (const EventImpl *event, uint32_t context);
+  /** Stop timing the event started by Begin(). */
+  void End (void);
+  /**
+   * Print the report.
+   * \param [in] os The output stream.
+   */
+  void Report (std::ostream &os) const;
+
+private:
+  /** The identity of an event kind in a context. */
+  struct Key
+  {
+    const char *type;       /**< Mangled name of the event implementation. */
+    uint64_t function[2];   /**< Bytes of the function pointer. */
+    const char *label;      /**< Label of the event. */
+    uint32_t context;       /**< Execution context. */
+    /**
+     * Order keys.
+     * \param [in] o The other key.
+     * \returns \c true if this key comes first.
+     */
+    bool operator < (const Key &o) const;
+  };
+  /** What was measured for an event kind in a context. */
+  struct Entry
+  {
+    uint64_t count;         /**< Number of events invoked. */
+    uint64_t ns;            /**< Wall clock nanoseconds spent in them. */
+  };
+
+  /**
+   * Get a readable name for an event kind.
+   * \param [in] key The event kind.
+   * \returns The label, or the signature of the function called.
+   */
+  static std::string GetName (const Key &key);
+  /**
+   * Get a monotonic wall clock.
+   * \returns The time in nanoseconds.
+   */
+  static uint64_t GetWallClockNs (void);
+
+  /** Measures by event kind and context. */
+  std::map<Key, Entry> m_entries;
+  /** Entry of the event being timed. */
+  Entry *m_current;
+  /** Wall clock at the start of the event being timed. */
+  uint64_t m_start;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
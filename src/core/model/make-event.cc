@@ -47,6 +47,11 @@ public:
     virtual ~EventFunctionImpl0 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 protected:
     virtual void Notify (void)
     {
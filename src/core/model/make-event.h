@@ -317,6 +317,11 @@ public:
     virtual ~EventMemberImpl0 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
@@ -347,6 +352,11 @@ protected:
     virtual ~EventMemberImpl1 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
@@ -378,6 +388,11 @@ protected:
     virtual ~EventMemberImpl2 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
@@ -411,6 +426,11 @@ protected:
     virtual ~EventMemberImpl3 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
@@ -446,6 +466,11 @@ protected:
     virtual ~EventMemberImpl4 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
@@ -484,6 +509,11 @@ protected:
     virtual ~EventMemberImpl5 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
@@ -518,6 +548,11 @@ protected:
     virtual ~EventFunctionImpl1 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
@@ -548,6 +583,11 @@ protected:
     virtual ~EventFunctionImpl2 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
@@ -581,6 +621,11 @@ protected:
     virtual ~EventFunctionImpl3 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
@@ -616,6 +661,11 @@ protected:
     virtual ~EventFunctionImpl4 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
@@ -653,6 +703,11 @@ protected:
     virtual ~EventFunctionImpl5 ()
     {
     }
+    virtual const void *GetFunction (uint32_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
 private:
     virtual void Notify (void)
     {
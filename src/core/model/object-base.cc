@@ -22,10 +22,12 @@
 #include "trace-source-accessor.h"
 #include "attribute-construction-list.h"
 #include "string.h"
+#include "simple-ref-count.h"
 #include "ns3/core-config.h"
 #ifdef HAVE_STDLIB_H
 #include <cstdlib>
 #endif
+#include <vector>
 
 /**
  * \file
@@ -76,99 +78,242 @@ ObjectBase::NotifyConstructionCompleted (void)
   NS_LOG_FUNCTION (this);
 }
 
-void
-ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
+namespace {
+
+/**
+ * \ingroup object
+ * How ObjectBase::ConstructSelf sets an attribute which is not in the
+ * AttributeConstructionList.
+ */
+struct DefaultAttribute
 {
-  // loop over the inheritance tree back to the Object base class.
-  NS_LOG_FUNCTION (this << &attributes);
-  TypeId tid = GetInstanceTypeId ();
+  TypeId tid;                               //!< The TypeId of the attribute.
+  uint32_t index;                           //!< The index of the attribute in tid.
+  Ptr<const AttributeAccessor> accessor;    //!< The accessor of the attribute.
+  Ptr<const AttributeChecker> checker;      //!< The checker of the attribute.
+  bool construct;                           //!< Whether it is set at construction.
+  /**
+   * Whether value is already valid for the checker and can be set as
+   * is, or must be converted at each construction.
+   */
+  bool checked;
+  Ptr<const AttributeValue> value;          //!< The default value.
+  /** Value to try if value cannot be converted, or 0. */
+  Ptr<const AttributeValue> fallback;
+};
+
+/**
+ * \ingroup object
+ * The default values of all the attributes of a TypeId and its parents,
+ * from the most derived to ObjectBase, as ObjectBase::ConstructSelf
+ * sets them.
+ *
+ * Images are not modified once built, so that the objects created while
+ * another one is constructed cannot change the image it iterates over.
+ */
+struct DefaultAttributeImage : public SimpleRefCount<DefaultAttributeImage>
+{
+  uint32_t generation;                      //!< TypeId::GetAttributeGeneration when built.
+  std::string env;                          //!< NS_ATTRIBUTE_DEFAULT when built.
+  std::vector<DefaultAttribute> attributes; //!< The attributes.
+};
+
+/**
+ * Get the value of the NS_ATTRIBUTE_DEFAULT environment variable.
+ * \returns The value, empty if it is not set.
+ */
+std::string
+GetAttributeDefaultEnv (void)
+{
+#ifdef HAVE_GETENV
+  char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+  if (envVar != 0)
+    {
+      return envVar;
+    }
+#endif /* HAVE_GETENV */
+  return "";
+}
+
+/**
+ * Look up an attribute in the NS_ATTRIBUTE_DEFAULT environment variable.
+ * \param [in] env The value of the variable.
+ * \param [in] fullName The full name of the attribute.
+ * \param [out] value The value of the attribute.
+ * \returns \c true if the variable has the attribute.
+ */
+bool
+FindAttributeDefaultEnv (const std::string &env, const std::string &fullName, std::string &value)
+{
+  std::string::size_type cur = 0;
+  std::string::size_type next = 0;
+  while (next != std::string::npos && !env.empty ())
+    {
+      next = env.find (";", cur);
+      std::string tmp = std::string (env, cur, next-cur);
+      std::string::size_type equal = tmp.find ("=");
+      if (equal != std::string::npos && tmp.substr (0, equal) == fullName)
+        {
+          value = tmp.substr (equal+1, tmp.size () - equal - 1);
+          return true;
+        }
+      cur = next + 1;
+    }
+  return false;
+}
+
+/**
+ * Make a default value ready to be set.
+ *
+ * Values which are not of the type of the checker are converted once
+ * here rather than at each construction, unless the conversion creates
+ * an object, which each new object must get its own of.
+ *
+ * \param [in,out] attribute The attribute.
+ * \param [in] value The default value.
+ * \returns \c false if the value is not valid for the attribute.
+ */
+bool
+PrepareDefaultAttribute (DefaultAttribute &attribute, Ptr<const AttributeValue> value)
+{
+  if (attribute.checker->Check (*value))
+    {
+      attribute.checked = true;
+      attribute.value = value;
+      return true;
+    }
+  if (attribute.checker->GetValueTypeName () == "ns3::PointerValue")
+    {
+      attribute.checked = false;
+      attribute.value = value;
+      return true;
+    }
+  Ptr<const AttributeValue> valid = attribute.checker->CreateValidValue (*value);
+  if (valid == 0)
+    {
+      return false;
+    }
+  attribute.checked = true;
+  attribute.value = valid;
+  return true;
+}
+
+/**
+ * Get the default values of the attributes of a TypeId, building them
+ * again if an initial value or NS_ATTRIBUTE_DEFAULT changed.
+ * \param [in] tid The TypeId of the object.
+ * \returns The default values.
+ */
+Ptr<const DefaultAttributeImage>
+GetDefaultAttributeImage (TypeId tid)
+{
+  // Never freed, objects may still be created by static destructors
+  static std::vector<Ptr<DefaultAttributeImage> > *images = new std::vector<Ptr<DefaultAttributeImage> > ();
+  uint16_t uid = tid.GetUid ();
+  if (images->size () <= uid)
+    {
+      images->resize (uid + 1);
+    }
+  std::string env = GetAttributeDefaultEnv ();
+  Ptr<DefaultAttributeImage> cached = (*images)[uid];
+  if (cached != 0 && cached->generation == TypeId::GetAttributeGeneration () && cached->env == env)
+    {
+      return cached;
+    }
+
+  NS_LOG_DEBUG ("build default attributes of tid=" << tid.GetName ());
+  Ptr<DefaultAttributeImage> image = Create<DefaultAttributeImage> ();
+  // Read before the GetTypeId of the attributes may add some
+  image->generation = TypeId::GetAttributeGeneration ();
+  image->env = env;
   do {
-      // loop over all attributes in object type
-      NS_LOG_DEBUG ("construct tid="<<tid.GetName ()<<", params="<<tid.GetAttributeN ());
       for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
         {
-          struct TypeId::AttributeInformation info = tid.GetAttribute(i);
-          NS_LOG_DEBUG ("try to construct \""<< tid.GetName ()<<"::"<<
-                        info.name <<"\"");
-          // is this attribute stored in this AttributeConstructionList instance ?
-          Ptr<AttributeValue> value = attributes.Find(info.checker);
-          // See if this attribute should not be set here in the
-          // constructor.
-          if (!(info.flags & TypeId::ATTR_CONSTRUCT))
-            {
-              // Handle this attribute if it should not be 
-              // set here.
-              if (value == 0)
-                {
-                  // Skip this attribute if it's not in the
-                  // AttributeConstructionList.
-                  continue;
-                }              
-              else
-                {
-                  // This is an error because this attribute is not
-                  // settable in its constructor but is present in
-                  // the AttributeConstructionList.
-                  NS_FATAL_ERROR ("Attribute name="<<info.name<<" tid="<<tid.GetName () << ": initial value cannot be set using attributes");
-                }
-            }
-          bool found = false;
-          if (value != 0)
-            {
-              // We have a matching attribute value.
-              if (DoSet (info.accessor, info.checker, *value))
-                {
-                  NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                info.name<<"\"");
-                  found = true;
-                  continue;
-                }
-            }              
-          if (!found)
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          DefaultAttribute attribute;
+          attribute.tid = tid;
+          attribute.index = i;
+          attribute.accessor = info.accessor;
+          attribute.checker = info.checker;
+          attribute.construct = info.flags & TypeId::ATTR_CONSTRUCT;
+          attribute.checked = false;
+          attribute.value = info.initialValue;
+          std::string envValue;
+          if (attribute.construct
+              && FindAttributeDefaultEnv (env, tid.GetAttributeFullName (i), envValue))
             {
-              // No matching attribute value so we try to look at the env var.
-#ifdef HAVE_GETENV
-              char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
-              if (envVar != 0)
+              NS_LOG_DEBUG ("default of \"" << tid.GetAttributeFullName (i) << "\" from env var");
+              if (PrepareDefaultAttribute (attribute, Create<StringValue> (envValue)))
                 {
-                  std::string env = std::string (envVar);
-                  std::string::size_type cur = 0;
-                  std::string::size_type next = 0;
-                  while (next != std::string::npos)
+                  if (!attribute.checked)
                     {
-                      next = env.find (";", cur);
-                      std::string tmp = std::string (env, cur, next-cur);
-                      std::string::size_type equal = tmp.find ("=");
-                      if (equal != std::string::npos)
-                        {
-                          std::string name = tmp.substr (0, equal);
-                          std::string value = tmp.substr (equal+1, tmp.size () - equal - 1);
-                          if (name == tid.GetAttributeFullName (i))
-                            {
-                              if (DoSet (info.accessor, info.checker, StringValue (value)))
-                                {
-                                  NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                                info.name <<"\" from env var");
-                                  found = true;
-                                  break;
-                                }
-                            }
-                        }
-                      cur = next + 1;
+                      attribute.fallback = info.initialValue;
                     }
+                  image->attributes.push_back (attribute);
+                  continue;
                 }
-#endif /* HAVE_GETENV */
             }
-          if (!found)
+          if (attribute.construct && !PrepareDefaultAttribute (attribute, info.initialValue))
             {
-              // No matching attribute value so we try to set the default value.
-              DoSet (info.accessor, info.checker, *info.initialValue);
-              NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                            info.name <<"\" from initial value.");
+              // Keep reporting the invalid value at each construction
+              attribute.checked = false;
+              attribute.value = info.initialValue;
             }
+          image->attributes.push_back (attribute);
         }
       tid = tid.GetParent ();
     } while (tid != ObjectBase::GetTypeId ());
+  (*images)[uid] = image;
+  return image;
+}
+
+} // anonymous namespace
+
+void
+ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
+{
+  // loop over the attributes of the inheritance tree back to the
+  // Object base class, their default values are cached by TypeId.
+  NS_LOG_FUNCTION (this << &attributes);
+  Ptr<const DefaultAttributeImage> image = GetDefaultAttributeImage (GetInstanceTypeId ());
+  for (std::vector<DefaultAttribute>::const_iterator it = image->attributes.begin ();
+       it != image->attributes.end (); ++it)
+    {
+      // is this attribute stored in this AttributeConstructionList instance ?
+      Ptr<AttributeValue> value = attributes.Find (it->checker);
+      // See if this attribute should not be set here in the
+      // constructor.
+      if (!it->construct)
+        {
+          if (value == 0)
+            {
+              // Skip this attribute if it's not in the
+              // AttributeConstructionList.
+              continue;
+            }
+          // This is an error because this attribute is not
+          // settable in its constructor but is present in
+          // the AttributeConstructionList.
+          NS_FATAL_ERROR ("Attribute name=" << it->tid.GetAttribute (it->index).name <<
+                          " tid=" << it->tid.GetName () << ": initial value cannot be set using attributes");
+        }
+      if (value != 0 && DoSet (it->accessor, it->checker, *value))
+        {
+          // We have a matching attribute value.
+          NS_LOG_DEBUG ("construct \"" << it->tid.GetAttributeFullName (it->index) << "\"");
+          continue;
+        }
+      // No matching attribute value so we set the default value,
+      // from the env var or the initial value.
+      if (it->checked)
+        {
+          it->accessor->Set (this, *it->value);
+        }
+      else if (!DoSet (it->accessor, it->checker, *it->value) && it->fallback != 0)
+        {
+          DoSet (it->accessor, it->checker, *it->fallback);
+        }
+    }
   NotifyConstructionCompleted ();
 }
 
@@ -220,6 +220,28 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+
+  /**
+   * Get the number of instances in the container, without copying
+   * them into an ObjectPtrContainerValue.
+   *
+   * \param [in] object The container object.
+   * \param [out] n The number of instances in the container.
+   * \returns true if the value could be obtained successfully.
+   */
+  bool GetN (const ObjectBase *object, uint32_t *n) const;
+  /**
+   * Get one instance from the container, without copying the others
+   * into an ObjectPtrContainerValue.
+   *
+   * \param [in] object The container object, for which GetN() succeeded.
+   * \param [in] i The position of the instance, less than the number
+   *            of instances.
+   * \param [out] index The index of the instance, as in the
+   *             ObjectPtrContainerValue.
+   * \returns The instance.
+   */
+  Ptr<Object> GetItem (const ObjectBase *object, uint32_t i, uint32_t *index) const;
 private:
   /**
    * Get the number of instances in the container.
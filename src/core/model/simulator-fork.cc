@@ -0,0 +1,335 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator-fork.h"
+#include "simulator.h"
+#include "config.h"
+#include "log.h"
+#include "fatal-error.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::SimulatorFork.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SimulatorFork");
+
+SimulatorFork::SimulatorFork ()
+  : m_maxChildren (0),
+    m_child (-1),
+    m_fd (-1),
+    m_collected (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SimulatorFork::~SimulatorFork ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_variants.size (); i++)
+    {
+      if (m_variants[i].fd >= 0)
+        {
+          close (m_variants[i].fd);
+        }
+    }
+  if (m_fd >= 0)
+    {
+      close (m_fd);
+    }
+}
+
+uint32_t
+SimulatorFork::AddVariant (std::string name)
+{
+  NS_LOG_FUNCTION (this << name);
+  NS_ASSERT_MSG (m_child < 0, "Cannot add a variant in a child");
+  Variant variant;
+  variant.name = name;
+  variant.pid = -1;
+  variant.fd = -1;
+  variant.status = 0;
+  m_variants.push_back (variant);
+  return m_variants.size () - 1;
+}
+
+void
+SimulatorFork::AddOverride (uint32_t variant, enum Override::Kind kind,
+                            std::string name, const AttributeValue &value)
+{
+  NS_ASSERT (variant < m_variants.size ());
+  Override o;
+  o.kind = kind;
+  o.name = name;
+  o.value = value.Copy ();
+  m_variants[variant].overrides.push_back (o);
+}
+
+void
+SimulatorFork::Set (uint32_t variant, std::string path, const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (this << variant << path);
+  AddOverride (variant, Override::SET, path, value);
+}
+
+void
+SimulatorFork::SetDefault (uint32_t variant, std::string name, const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (this << variant << name);
+  AddOverride (variant, Override::SET_DEFAULT, name, value);
+}
+
+void
+SimulatorFork::SetGlobal (uint32_t variant, std::string name, const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (this << variant << name);
+  AddOverride (variant, Override::SET_GLOBAL, name, value);
+}
+
+void
+SimulatorFork::SetMaxChildren (uint32_t maxChildren)
+{
+  NS_LOG_FUNCTION (this << maxChildren);
+  m_maxChildren = maxChildren;
+}
+
+void
+SimulatorFork::ForkAt (Time time)
+{
+  NS_LOG_FUNCTION (this << time);
+  NS_ASSERT_MSG (time >= Simulator::Now (), "Cannot fork in the past");
+  m_event.Cancel ();
+  m_event = Simulator::Schedule (time - Simulator::Now (), &SimulatorFork::DoFork, this);
+}
+
+uint32_t
+SimulatorFork::GetNVariants (void) const
+{
+  return m_variants.size ();
+}
+
+std::string
+SimulatorFork::GetVariantName (uint32_t variant) const
+{
+  NS_ASSERT (variant < m_variants.size ());
+  return m_variants[variant].name;
+}
+
+bool
+SimulatorFork::IsChild (void) const
+{
+  return m_child >= 0;
+}
+
+bool
+SimulatorFork::IsCollected (void) const
+{
+  return m_collected;
+}
+
+uint32_t
+SimulatorFork::GetVariant (void) const
+{
+  NS_ASSERT_MSG (m_child >= 0, "Not a child");
+  return m_child;
+}
+
+void
+SimulatorFork::DoFork (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Do not let the children write again what the parent buffered
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (0);
+
+  uint32_t n = m_variants.size ();
+  uint32_t maxChildren = m_maxChildren > 0 ? m_maxChildren : n;
+  uint32_t started = 0;
+  uint32_t collected = 0;
+  while (collected < n)
+    {
+      while (started < n && started - collected < maxChildren)
+        {
+          if (StartChild (started))
+            {
+              // Carry on with the simulation
+              return;
+            }
+          started++;
+        }
+      CollectChild (collected++);
+    }
+  m_collected = true;
+  Simulator::Stop ();
+}
+
+bool
+SimulatorFork::StartChild (uint32_t variant)
+{
+  NS_LOG_FUNCTION (this << variant);
+  int fds[2];
+  if (pipe (fds) != 0)
+    {
+      NS_FATAL_ERROR ("pipe() failed: " << std::strerror (errno));
+    }
+  pid_t pid = fork ();
+  if (pid < 0)
+    {
+      NS_FATAL_ERROR ("fork() failed: " << std::strerror (errno));
+    }
+  if (pid > 0)
+    {
+      close (fds[1]);
+      m_variants[variant].pid = pid;
+      m_variants[variant].fd = fds[0];
+      NS_LOG_LOGIC ("Started child " << pid << " for variant " << m_variants[variant].name);
+      return false;
+    }
+
+  close (fds[0]);
+  for (uint32_t i = 0; i < variant; i++)
+    {
+      if (m_variants[i].fd >= 0)
+        {
+          close (m_variants[i].fd);
+          m_variants[i].fd = -1;
+        }
+    }
+  m_child = variant;
+  m_fd = fds[1];
+  const std::vector<Override> &overrides = m_variants[variant].overrides;
+  for (std::vector<Override>::const_iterator it = overrides.begin (); it != overrides.end (); ++it)
+    {
+      switch (it->kind)
+        {
+        case Override::SET:
+          Config::Set (it->name, *it->value);
+          break;
+        case Override::SET_DEFAULT:
+          Config::SetDefault (it->name, *it->value);
+          break;
+        case Override::SET_GLOBAL:
+          Config::SetGlobal (it->name, *it->value);
+          break;
+        }
+    }
+  return true;
+}
+
+void
+SimulatorFork::CollectChild (uint32_t variant)
+{
+  NS_LOG_FUNCTION (this << variant);
+  Variant &child = m_variants[variant];
+  char buffer[4096];
+  while (true)
+    {
+      ssize_t size = read (child.fd, buffer, sizeof (buffer));
+      if (size > 0)
+        {
+          child.result.append (buffer, size);
+        }
+      else if (size == 0 || errno != EINTR)
+        {
+          break;
+        }
+    }
+  close (child.fd);
+  child.fd = -1;
+
+  int status;
+  while (waitpid (child.pid, &status, 0) < 0)
+    {
+      if (errno != EINTR)
+        {
+          NS_FATAL_ERROR ("waitpid() failed: " << std::strerror (errno));
+        }
+    }
+  if (WIFEXITED (status))
+    {
+      child.status = WEXITSTATUS (status);
+    }
+  else if (WIFSIGNALED (status))
+    {
+      child.status = -WTERMSIG (status);
+    }
+  NS_LOG_LOGIC ("Child " << child.pid << " of variant " << child.name
+                << " exited with status " << child.status);
+}
+
+void
+SimulatorFork::Finish (std::string result)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_child < 0)
+    {
+      return;
+    }
+  const char *data = result.data ();
+  std::string::size_type left = result.size ();
+  while (left > 0)
+    {
+      ssize_t size = write (m_fd, data, left);
+      if (size < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          break;
+        }
+      data += size;
+      left -= size;
+    }
+  close (m_fd);
+  m_fd = -1;
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (0);
+  _exit (0);
+}
+
+std::string
+SimulatorFork::GetResult (uint32_t variant) const
+{
+  NS_ASSERT (variant < m_variants.size ());
+  NS_ASSERT_MSG (m_collected, "The children have not been collected");
+  return m_variants[variant].result;
+}
+
+int
+SimulatorFork::GetExitStatus (uint32_t variant) const
+{
+  NS_ASSERT (variant < m_variants.size ());
+  NS_ASSERT_MSG (m_collected, "The children have not been collected");
+  return m_variants[variant].status;
+}
+
+} // namespace ns3
@@ -0,0 +1,230 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIMULATOR_FORK_H
+#define SIMULATOR_FORK_H
+
+#include "nstime.h"
+#include "event-id.h"
+#include "attribute.h"
+#include "ptr.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::SimulatorFork.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * Runs a parameter sweep from one shared warm-up.
+ *
+ * The simulation is set up and run once up to the fork time.  There the
+ * process forks one child per variant: each child applies the attribute
+ * overrides of its variant and carries on with the simulation, while the
+ * parent waits for the children, collects what they report and stops.
+ * Building the topology, populating the routes and the warm-up are thus
+ * paid once for the whole sweep.
+ *
+ * \code
+ *   SimulatorFork fork;
+ *   for (uint32_t i = 0; i < thresholds.size (); i++)
+ *     {
+ *       uint32_t v = fork.AddVariant (names[i]);
+ *       // e.g. the InstantaneousMarkingThreshold of the switch queue discs
+ *       fork.Set (v, thresholdPath, TimeValue (thresholds[i]));
+ *     }
+ *   fork.ForkAt (Seconds (warmUp));
+ *   Simulator::Stop (Seconds (end));
+ *   Simulator::Run ();
+ *   if (fork.IsChild ())
+ *     {
+ *       fork.Finish (Summarize (flowMonitor));   // does not return
+ *     }
+ *   for (uint32_t i = 0; i < fork.GetNVariants (); i++)
+ *     {
+ *       std::cout << fork.GetVariantName (i) << ": " << fork.GetResult (i);
+ *     }
+ * \endcode
+ *
+ * A child behaves as if the simulation had been configured with its
+ * overrides from the fork time on, with two caveats: the random variable
+ * streams are in the state the warm-up left them in, so all the children
+ * draw the same numbers unless the overrides say otherwise, and only the
+ * objects that read an attribute after the fork see the new value, as
+ * with any Config::Set in the middle of a run.  Config::SetDefault
+ * overrides only affect the objects created after the fork, e.g. the
+ * sockets of the flows that start later.
+ *
+ * The children share the open file descriptors of the parent, so the
+ * output files of a run should be opened after Simulator::Run returns, or
+ * named after the variant.  Forking is only safe in a single threaded
+ * process: it cannot be used with the realtime or the distributed
+ * simulator implementations.  Only available on POSIX systems.
+ */
+class SimulatorFork
+{
+public:
+  SimulatorFork ();
+  ~SimulatorFork ();
+
+  /**
+   * Add a variant of the simulation.
+   * \param [in] name The name of the variant, e.g. for the output files.
+   * \returns The index of the variant.
+   */
+  uint32_t AddVariant (std::string name);
+  /**
+   * Override an attribute with Config::Set in a variant.
+   * \param [in] variant The index of the variant.
+   * \param [in] path The path of the attribute.
+   * \param [in] value The value of the attribute.
+   */
+  void Set (uint32_t variant, std::string path, const AttributeValue &value);
+  /**
+   * Override a default value with Config::SetDefault in a variant.
+   * \param [in] variant The index of the variant.
+   * \param [in] name The full name of the attribute.
+   * \param [in] value The default value of the attribute.
+   */
+  void SetDefault (uint32_t variant, std::string name, const AttributeValue &value);
+  /**
+   * Override a global value with Config::SetGlobal in a variant.
+   * \param [in] variant The index of the variant.
+   * \param [in] name The name of the global value.
+   * \param [in] value The value.
+   */
+  void SetGlobal (uint32_t variant, std::string name, const AttributeValue &value);
+  /**
+   * Limit the number of children run at the same time.
+   * \param [in] maxChildren The limit, 0 to run all the variants at once.
+   */
+  void SetMaxChildren (uint32_t maxChildren);
+
+  /**
+   * Fork the process at a simulation time.
+   * \param [in] time The absolute simulation time of the fork.
+   */
+  void ForkAt (Time time);
+
+  /** \returns The number of variants. */
+  uint32_t GetNVariants (void) const;
+  /**
+   * \param [in] variant The index of a variant.
+   * \returns The name of the variant.
+   */
+  std::string GetVariantName (uint32_t variant) const;
+  /** \returns \c true in the children. */
+  bool IsChild (void) const;
+  /** \returns \c true in the parent once the children are collected. */
+  bool IsCollected (void) const;
+  /** \returns The index of the variant run by this child. */
+  uint32_t GetVariant (void) const;
+
+  /**
+   * Report the results of a child and terminate it.
+   *
+   * The standard streams are flushed before the process exits, but the
+   * destructors do not run: the files written by the child should be
+   * closed beforehand.  Does nothing in the parent.
+   *
+   * \param [in] result What to hand to the parent.
+   */
+  void Finish (std::string result);
+
+  /**
+   * \param [in] variant The index of a variant.
+   * \returns What the child of the variant passed to Finish().
+   */
+  std::string GetResult (uint32_t variant) const;
+  /**
+   * \param [in] variant The index of a variant.
+   * \returns The exit code of the child of the variant, or minus the
+   *          number of the signal which killed it.
+   */
+  int GetExitStatus (uint32_t variant) const;
+
+private:
+  /** An attribute override. */
+  struct Override
+  {
+    /** How the override is applied. */
+    enum Kind
+    {
+      SET,         /**< Config::Set */
+      SET_DEFAULT, /**< Config::SetDefault */
+      SET_GLOBAL   /**< Config::SetGlobal */
+    } kind;        /**< How the override is applied. */
+    std::string name;                   /**< Path or name of the attribute. */
+    Ptr<const AttributeValue> value;    /**< Value of the attribute. */
+  };
+  /** A variant of the simulation. */
+  struct Variant
+  {
+    std::string name;                   /**< Name of the variant. */
+    std::vector<Override> overrides;    /**< Attribute overrides. */
+    int pid;                            /**< Process id of the child. */
+    int fd;                             /**< Read end of the result pipe. */
+    std::string result;                 /**< Result of the child. */
+    int status;                         /**< Exit status of the child. */
+  };
+
+  /**
+   * Add an override to a variant.
+   * \param [in] variant The index of the variant.
+   * \param [in] kind How the override is applied.
+   * \param [in] name Path or name of the attribute.
+   * \param [in] value Value of the attribute.
+   */
+  void AddOverride (uint32_t variant, enum Override::Kind kind,
+                    std::string name, const AttributeValue &value);
+  /** Fork the children, collect them and stop the parent. */
+  void DoFork (void);
+  /**
+   * Start the child of a variant.
+   * \param [in] variant The index of the variant.
+   * \returns \c true in the child.
+   */
+  bool StartChild (uint32_t variant);
+  /**
+   * Wait for the child of a variant and read its result.
+   * \param [in] variant The index of the variant.
+   */
+  void CollectChild (uint32_t variant);
+
+  /** The variants. */
+  std::vector<Variant> m_variants;
+  /** Maximum number of children run at the same time. */
+  uint32_t m_maxChildren;
+  /** The fork event. */
+  EventId m_event;
+  /** Variant of this child, or -1 in the parent. */
+  int32_t m_child;
+  /** Write end of the result pipe in a child. */
+  int m_fd;
+  /** Whether the parent collected the children. */
+  bool m_collected;
+};
+
+} // namespace ns3
+
+#endif /* SIMULATOR_FORK_H */
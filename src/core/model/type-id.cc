@@ -43,6 +43,13 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TypeId");
 
+/**
+ * \ingroup object
+ * The generation of the attributes of all the TypeIds,
+ * see TypeId::GetAttributeGeneration.
+ */
+static uint32_t g_attributeGeneration = 0;
+
 // IidManager needs to be in ns3 namespace for NS_ASSERT and NS_LOG
 // to find g_log
 
@@ -623,6 +630,7 @@ IidManager::AddAttribute (uint16_t uid,
   info.accessor = accessor;
   info.checker = checker;
   information->attributes.push_back (info);
+  g_attributeGeneration++;
 }
 void 
 IidManager::SetAttributeInitialValue(uint16_t uid,
@@ -633,6 +641,7 @@ IidManager::SetAttributeInitialValue(uint16_t uid,
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
+  g_attributeGeneration++;
 }
 
 
@@ -800,6 +809,12 @@ TypeId::GetRegistered (uint32_t i)
   return TypeId (IidManager::Get ()->GetRegistered (i));
 }
 
+uint32_t
+TypeId::GetAttributeGeneration (void)
+{
+  return g_attributeGeneration;
+}
+
 bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
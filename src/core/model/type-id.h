@@ -150,6 +150,17 @@ public:
    */
   static TypeId GetRegistered (uint32_t i);
 
+  /**
+   * Get the generation of the attributes of all the TypeIds.
+   *
+   * The generation changes whenever an attribute is added or its initial
+   * value is set, e.g. by Config::SetDefault, so that the caches built
+   * from the attributes can tell when they are stale.
+   *
+   * \returns The generation.
+   */
+  static uint32_t GetAttributeGeneration (void);
+
   /**
    * Constructor.
    *
@@ -721,6 +721,110 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+// ===========================================================================
+// Test for the indexed lookups and the batches of Config calls.
+// ===========================================================================
+class BatchConfigTestCase : public TestCase
+{
+public:
+  BatchConfigTestCase ();
+  virtual ~BatchConfigTestCase () {}
+
+  void Trace (int16_t oldValue, int16_t newValue) { m_newValue = newValue; }
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue) { m_newValue = newValue; m_path = path; }
+
+private:
+  virtual void DoRun (void);
+
+  int16_t m_newValue;
+  std::string m_path;
+};
+
+BatchConfigTestCase::BatchConfigTestCase ()
+  : TestCase ("Check indexed lookups and batches of Config calls")
+{
+}
+
+void
+BatchConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject> ();
+  root->SetNodeB (b);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  b->SetNodeA (a);
+  std::vector<Ptr<ConfigTestObject> > objs;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objs.push_back (CreateObject<ConfigTestObject> ());
+      b->AddNodeA (objs[i]);
+    }
+
+  //
+  // Look up single indices, which do not go through the whole vector.
+  //
+  Config::MatchContainer matches = Config::LookupMatches ("/NodeB/NodesA/2");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Index 2 not found");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objs[2], "Index 2 matched the wrong object");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodeB/NodesA/2/", "Unexpected context of index 2");
+
+  matches = Config::LookupMatches ("/NodeB/NodesA/7");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 0, "Index 7 unexpectedly found");
+
+  matches = Config::LookupMatches ("/NodeB/NodesA/3|1");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 2, "Indices 1 and 3 not found");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objs[1], "Indices not matched in increasing order");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (1), objs[3], "Indices not matched in increasing order");
+
+  //
+  // The '*' attribute goes through the pointers and the vectors.
+  //
+  matches = Config::LookupMatches ("/NodeB/*/1");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Index 1 not found through '*'");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodeB/NodesA/1/", "Unexpected context of index 1");
+
+  //
+  // Match all the paths of a batch at once, then apply the calls.
+  //
+  Config::Batch batch;
+  batch.Set ("/NodeB/NodesA/[1-2]/A", IntegerValue (-20));
+  batch.Set ("/NodeB/NodesA/*/B", IntegerValue (-21));
+  batch.Connect ("/NodeB/NodesA/0|3/Source",
+                 MakeCallback (&BatchConfigTestCase::TraceWithPath, this));
+  batch.ConnectWithoutContext ("/NodeB/NodeA/Source",
+                               MakeCallback (&BatchConfigTestCase::Trace, this));
+  NS_TEST_ASSERT_MSG_EQ (batch.GetN (), 4, "Calls not recorded");
+  batch.Apply ();
+  NS_TEST_ASSERT_MSG_EQ (batch.GetN (), 0, "Batch not cleared");
+
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objs[i]->GetAttribute ("A", iv);
+      NS_TEST_ASSERT_MSG_EQ (iv.Get (), ((i == 1 || i == 2) ? -20 : 10), "Object Attribute \"A\" of " << i << " not as expected");
+      objs[i]->GetAttribute ("B", iv);
+      NS_TEST_ASSERT_MSG_EQ (iv.Get (), -21, "Object Attribute \"B\" of " << i << " not set");
+    }
+
+  m_newValue = 0;
+  m_path = "";
+  objs[3]->SetAttribute ("Source", IntegerValue (-3));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, -3, "Trace 3 did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_path, "/NodeB/NodesA/3/Source", "Trace 3 did not provide expected context");
+
+  m_newValue = 0;
+  objs[2]->SetAttribute ("Source", IntegerValue (-2));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, 0, "Trace 2 fired unexpectedly");
+
+  m_newValue = 0;
+  a->SetAttribute ("Source", IntegerValue (-4));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, -4, "Trace of NodeA did not fire as expected");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -737,6 +841,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new BatchConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/counter-rng.h"
+#include "ns3/rng-seed-manager.h"
+
+#include <vector>
+
+using namespace ns3;
+
+// ===========================================================================
+// Known answers of Philox4x32-10, from the Random123 distribution
+// ===========================================================================
+class CounterRngKnownAnswerTestCase : public TestCase
+{
+public:
+  CounterRngKnownAnswerTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+CounterRngKnownAnswerTestCase::CounterRngKnownAnswerTestCase ()
+  : TestCase ("Check the Philox4x32-10 known answers")
+{
+}
+
+void
+CounterRngKnownAnswerTestCase::DoRun (void)
+{
+  const uint32_t counters[3][4] = {
+    { 0x00000000, 0x00000000, 0x00000000, 0x00000000 },
+    { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff },
+    { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }
+  };
+  const uint32_t keys[3][2] = {
+    { 0x00000000, 0x00000000 },
+    { 0xffffffff, 0xffffffff },
+    { 0xa4093822, 0x299f31d0 }
+  };
+  const uint32_t answers[3][4] = {
+    { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+    { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd },
+    { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }
+  };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      uint32_t out[4];
+      CounterRng::Philox (counters[i], keys[i], out);
+      for (uint32_t j = 0; j < 4; j++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (out[j], answers[i][j], "Wrong word " << j << " of vector " << i);
+        }
+    }
+}
+
+// ===========================================================================
+// Streams follow the seed, the run and the stream number
+// ===========================================================================
+class CounterRngStreamTestCase : public TestCase
+{
+public:
+  CounterRngStreamTestCase ();
+private:
+  virtual void DoRun (void);
+  std::vector<uint32_t> Draw (int64_t stream, uint32_t n);
+};
+
+CounterRngStreamTestCase::CounterRngStreamTestCase ()
+  : TestCase ("Check that the streams are reproducible and independent")
+{
+}
+
+std::vector<uint32_t>
+CounterRngStreamTestCase::Draw (int64_t stream, uint32_t n)
+{
+  CounterRng rng;
+  rng.SetStream (stream);
+  std::vector<uint32_t> values;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      values.push_back (rng.GetU32 ());
+    }
+  return values;
+}
+
+void
+CounterRngStreamTestCase::DoRun (void)
+{
+  uint32_t seed = RngSeedManager::GetSeed ();
+  uint64_t run = RngSeedManager::GetRun ();
+  RngSeedManager::SetSeed (3);
+  RngSeedManager::SetRun (1);
+
+  std::vector<uint32_t> reference = Draw (5, 10);
+  NS_TEST_EXPECT_MSG_EQ ((reference == Draw (5, 10)), true, "Same stream should give the same numbers");
+  NS_TEST_EXPECT_MSG_EQ ((reference == Draw (6, 10)), false, "Streams should differ");
+
+  // The key is taken at the first draw, not when the stream is created
+  CounterRng early;
+  early.SetStream (5);
+  RngSeedManager::SetRun (2);
+  std::vector<uint32_t> other = Draw (5, 10);
+  NS_TEST_EXPECT_MSG_EQ ((reference == other), false, "Runs should differ");
+  NS_TEST_EXPECT_MSG_EQ (early.GetU32 (), other[0], "The key should be read at the first draw");
+
+  // Restarting a stream restarts its numbers
+  RngSeedManager::SetRun (1);
+  CounterRng rng;
+  rng.SetStream (5);
+  rng.GetU32 ();
+  rng.SetStream (5);
+  NS_TEST_EXPECT_MSG_EQ (rng.GetU32 (), reference[0], "SetStream should restart the stream");
+  NS_TEST_EXPECT_MSG_EQ (rng.GetStream (), 5, "Wrong stream");
+  CounterRng automatic;
+  NS_TEST_EXPECT_MSG_EQ (automatic.GetStream (), -1, "Stream should be automatic");
+
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (run);
+}
+
+// ===========================================================================
+// Distribution of the derived draws
+// ===========================================================================
+class CounterRngDistributionTestCase : public TestCase
+{
+public:
+  CounterRngDistributionTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+CounterRngDistributionTestCase::CounterRngDistributionTestCase ()
+  : TestCase ("Check the range and the mean of the draws")
+{
+}
+
+void
+CounterRngDistributionTestCase::DoRun (void)
+{
+  const uint32_t N = 100000;
+  const uint32_t BINS = 10;
+  CounterRng rng;
+  rng.SetStream (1);
+
+  double sum = 0;
+  uint32_t counts[BINS] = { 0 };
+  for (uint32_t i = 0; i < N; i++)
+    {
+      double u = rng.GetDouble ();
+      NS_TEST_ASSERT_MSG_EQ ((u >= 0 && u < 1), true, "Real out of [0, 1): " << u);
+      sum += u;
+      uint32_t k = rng.GetInteger (BINS);
+      NS_TEST_ASSERT_MSG_LT (k, BINS, "Integer out of range");
+      counts[k]++;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (sum / N, 0.5, 0.01, "Wrong mean");
+  for (uint32_t k = 0; k < BINS; k++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (counts[k], N / BINS, N / BINS / 10, "Wrong count of " << k);
+    }
+  NS_TEST_EXPECT_MSG_EQ (rng.GetInteger (1), 0, "Only 0 is in [0, 1)");
+}
+
+class CounterRngTestSuite : public TestSuite
+{
+public:
+  CounterRngTestSuite ();
+};
+
+CounterRngTestSuite::CounterRngTestSuite ()
+  : TestSuite ("counter-rng", UNIT)
+{
+  AddTestCase (new CounterRngKnownAnswerTestCase, TestCase::QUICK);
+  AddTestCase (new CounterRngStreamTestCase, TestCase::QUICK);
+  AddTestCase (new CounterRngDistributionTestCase, TestCase::QUICK);
+}
+
+static CounterRngTestSuite counterRngTestSuite;
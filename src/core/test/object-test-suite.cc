@@ -22,6 +22,14 @@
 #include "ns3/object.h"
 #include "ns3/object-factory.h"
 #include "ns3/assert.h"
+#include "ns3/config.h"
+#include "ns3/nstime.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/core-config.h"
+
+#include <cstdlib>
 
 namespace {
 
@@ -113,10 +121,67 @@ public:
   }
 };
 
+class DefaultsA : public ns3::Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static ns3::TypeId GetTypeId (void)
+  {
+    static ns3::TypeId tid = ns3::TypeId ("ObjectTest:DefaultsA")
+      .SetParent<Object> ()
+      .SetGroupName ("Core")
+      .HideFromDocumentation ()
+      .AddConstructor<DefaultsA> ()
+      .AddAttribute ("Delay", "A time given as a string",
+                     ns3::StringValue ("20us"),
+                     ns3::MakeTimeAccessor (&DefaultsA::m_delay),
+                     ns3::MakeTimeChecker ())
+      .AddAttribute ("Peer", "An object created from a string",
+                     ns3::StringValue ("ObjectTest:BaseA"),
+                     ns3::MakePointerAccessor (&DefaultsA::m_peer),
+                     ns3::MakePointerChecker<BaseA> ());
+    return tid;
+  }
+  DefaultsA ()
+  {}
+  ns3::Time m_delay;
+  ns3::Ptr<BaseA> m_peer;
+};
+
+class DefaultsB : public DefaultsA
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static ns3::TypeId GetTypeId (void)
+  {
+    static ns3::TypeId tid = ns3::TypeId ("ObjectTest:DefaultsB")
+      .SetParent<DefaultsA> ()
+      .SetGroupName ("Core")
+      .HideFromDocumentation ()
+      .AddConstructor<DefaultsB> ()
+      .AddAttribute ("Count", "An integer",
+                     ns3::UintegerValue (3),
+                     ns3::MakeUintegerAccessor (&DefaultsB::m_count),
+                     ns3::MakeUintegerChecker<uint32_t> ());
+    return tid;
+  }
+  DefaultsB ()
+  {}
+  uint32_t m_count;
+};
+
 NS_OBJECT_ENSURE_REGISTERED (BaseA);
 NS_OBJECT_ENSURE_REGISTERED (DerivedA);
 NS_OBJECT_ENSURE_REGISTERED (BaseB);
 NS_OBJECT_ENSURE_REGISTERED (DerivedB);
+NS_OBJECT_ENSURE_REGISTERED (DefaultsA);
+NS_OBJECT_ENSURE_REGISTERED (DefaultsB);
 
 } // namespace anonymous
 
@@ -431,6 +496,63 @@ ObjectFactoryTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (a->GetObject<DerivedA> (), 0, "Unexpectedly able to work around C++ type system");
 }
 
+// ===========================================================================
+// Test case to make sure that the cached default values of the attributes
+// follow the changes of the defaults
+// ===========================================================================
+class AttributeDefaultsTestCase : public TestCase
+{
+public:
+  AttributeDefaultsTestCase ();
+  virtual ~AttributeDefaultsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+AttributeDefaultsTestCase::AttributeDefaultsTestCase ()
+  : TestCase ("Check the default values of the attributes at construction")
+{
+}
+
+AttributeDefaultsTestCase::~AttributeDefaultsTestCase ()
+{
+}
+
+void
+AttributeDefaultsTestCase::DoRun (void)
+{
+  Ptr<DefaultsB> a = CreateObject<DefaultsB> ();
+  NS_TEST_EXPECT_MSG_EQ (a->m_delay, MicroSeconds (20), "Wrong default of a parent attribute");
+  NS_TEST_EXPECT_MSG_EQ (a->m_count, 3, "Wrong default");
+  NS_TEST_ASSERT_MSG_NE (a->m_peer, 0, "The default object should be created");
+  Ptr<DefaultsB> b = CreateObject<DefaultsB> ();
+  NS_TEST_EXPECT_MSG_NE (a->m_peer, b->m_peer, "Each object should get its own default object");
+
+  Config::SetDefault ("ObjectTest:DefaultsA::Delay", TimeValue (MicroSeconds (30)));
+  b = CreateObject<DefaultsB> ();
+  NS_TEST_EXPECT_MSG_EQ (b->m_delay, MicroSeconds (30), "Config::SetDefault should apply to new objects");
+  Config::SetDefault ("ObjectTest:DefaultsA::Delay", StringValue ("20us"));
+  b = CreateObject<DefaultsB> ();
+  NS_TEST_EXPECT_MSG_EQ (b->m_delay, MicroSeconds (20), "Config::SetDefault should apply to new objects");
+
+  ObjectFactory factory;
+  factory.SetTypeId (DefaultsB::GetTypeId ());
+  factory.Set ("Delay", StringValue ("40us"));
+  b = factory.Create<DefaultsB> ();
+  NS_TEST_EXPECT_MSG_EQ (b->m_delay, MicroSeconds (40), "Construction values should override the defaults");
+  NS_TEST_EXPECT_MSG_EQ (b->m_count, 3, "Wrong default");
+
+#ifdef HAVE_GETENV
+  setenv ("NS_ATTRIBUTE_DEFAULT", "ObjectTest:DefaultsB::Count=7", 1);
+  b = CreateObject<DefaultsB> ();
+  NS_TEST_EXPECT_MSG_EQ (b->m_count, 7, "NS_ATTRIBUTE_DEFAULT should apply to new objects");
+  unsetenv ("NS_ATTRIBUTE_DEFAULT");
+  b = CreateObject<DefaultsB> ();
+  NS_TEST_EXPECT_MSG_EQ (b->m_count, 3, "NS_ATTRIBUTE_DEFAULT should not apply any more");
+#endif
+}
+
 // ===========================================================================
 // The Test Suite that glues the Test Cases together.
 // ===========================================================================
@@ -446,6 +568,7 @@ ObjectTestSuite::ObjectTestSuite ()
   AddTestCase (new CreateObjectTestCase, TestCase::QUICK);
   AddTestCase (new AggregateObjectTestCase, TestCase::QUICK);
   AddTestCase (new ObjectFactoryTestCase, TestCase::QUICK);
+  AddTestCase (new AttributeDefaultsTestCase, TestCase::QUICK);
 }
 
 static ObjectTestSuite objectTestSuite;
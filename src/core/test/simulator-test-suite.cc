@@ -23,6 +23,15 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/object.h"
+#include "ns3/simulator-fork.h"
+
+#include <fstream>
+#include <sstream>
 
 using namespace ns3;
 
@@ -459,6 +468,159 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorProfileTestCase : public TestCase
+{
+public:
+  SimulatorProfileTestCase ();
+  virtual void DoRun (void);
+  void Tick (void);
+  void Tock (void);
+};
+
+SimulatorProfileTestCase::SimulatorProfileTestCase ()
+  : TestCase ("Check the event profiler report")
+{
+}
+
+void
+SimulatorProfileTestCase::Tick (void)
+{
+}
+
+void
+SimulatorProfileTestCase::Tock (void)
+{
+}
+
+void
+SimulatorProfileTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("event-profile.txt");
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::Profile", BooleanValue (true));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileFile", StringValue (filename));
+
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Simulator::Schedule (Seconds (i), &SimulatorProfileTestCase::Tick, this);
+      Simulator::ScheduleWithContext (7, Seconds (i), &SimulatorProfileTestCase::Tock, this);
+    }
+  Simulator::Schedule (Seconds (1), &SimulatorProfileTestCase::Tick, this).PeekEventImpl ()->SetLabel ("labeled tick");
+  EventId cancelled = Simulator::Schedule (Seconds (1), &SimulatorProfileTestCase::Tock, this);
+  Simulator::Cancel (cancelled);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::Profile", BooleanValue (false));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileFile", StringValue (""));
+
+  std::ifstream is (filename.c_str ());
+  std::ostringstream report;
+  report << is.rdbuf ();
+  std::string text = report.str ();
+  NS_TEST_ASSERT_MSG_NE (text.find ("Event profile: 7 events"), std::string::npos,
+                         "Cancelled events should not be counted: " << text);
+  NS_TEST_EXPECT_MSG_NE (text.find ("labeled tick"), std::string::npos, "Label should be reported");
+  NS_TEST_EXPECT_MSG_NE (text.find ("SimulatorProfileTestCase::*"), std::string::npos,
+                         "Method signature should be reported");
+  // Tick and Tock share a signature, they are told apart by address
+  NS_TEST_EXPECT_MSG_NE (text.find (" [0x"), std::string::npos, "Methods should be told apart");
+  NS_TEST_EXPECT_MSG_NE (text.find ("3  7"), std::string::npos, "Context 7 ran 3 events");
+}
+
+class ForkTicker : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  ForkTicker ();
+  void Tick (void);
+
+  uint32_t m_step;
+  uint32_t m_sum;
+};
+
+TypeId
+ForkTicker::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ForkTicker")
+    .SetParent<Object> ()
+    .SetGroupName ("Core")
+    .AddConstructor<ForkTicker> ()
+    .AddAttribute ("Step", "Added to the sum at each tick",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&ForkTicker::m_step),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+ForkTicker::ForkTicker ()
+  : m_sum (0)
+{
+}
+
+void
+ForkTicker::Tick (void)
+{
+  m_sum += m_step;
+  Simulator::Schedule (Seconds (1), &ForkTicker::Tick, this);
+}
+
+class SimulatorForkTestCase : public TestCase
+{
+public:
+  SimulatorForkTestCase ();
+  virtual void DoRun (void);
+};
+
+SimulatorForkTestCase::SimulatorForkTestCase ()
+  : TestCase ("Check the variants forked by SimulatorFork")
+{
+}
+
+void
+SimulatorForkTestCase::DoRun (void)
+{
+  Ptr<ForkTicker> ticker = CreateObject<ForkTicker> ();
+  Config::RegisterRootNamespaceObject (ticker);
+  Simulator::Schedule (Seconds (0), &ForkTicker::Tick, ticker);
+
+  SimulatorFork fork;
+  fork.AddVariant ("unchanged");
+  for (uint32_t step = 2; step <= 4; step++)
+    {
+      std::ostringstream name;
+      name << "step" << step;
+      uint32_t v = fork.AddVariant (name.str ());
+      fork.Set (v, "/Step", UintegerValue (step));
+    }
+  fork.SetMaxChildren (2);
+  fork.ForkAt (Seconds (4.5));
+  Simulator::Stop (Seconds (9.5));
+  Simulator::Run ();
+  if (fork.IsChild ())
+    {
+      std::ostringstream result;
+      result << fork.GetVariant () << " " << ticker->m_sum;
+      fork.Finish (result.str ());
+    }
+  Time end = Simulator::Now ();
+  Config::UnregisterRootNamespaceObject (ticker);
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (fork.IsCollected (), true, "The children should have been collected");
+  NS_TEST_EXPECT_MSG_EQ (end, Seconds (4.5), "The parent should stop at the fork");
+  NS_TEST_EXPECT_MSG_EQ (ticker->m_sum, 5, "The parent should not run past the fork");
+  NS_TEST_ASSERT_MSG_EQ (fork.GetNVariants (), 4, "Wrong number of variants");
+  for (uint32_t i = 0; i < fork.GetNVariants (); i++)
+    {
+      // 5 ticks of 1 before the fork, 5 ticks of the variant step after
+      std::ostringstream expected;
+      expected << i << " " << 5 + 5 * (i + 1);
+      NS_TEST_EXPECT_MSG_EQ (fork.GetExitStatus (i), 0, "Child of " << fork.GetVariantName (i) << " failed");
+      NS_TEST_EXPECT_MSG_EQ (fork.GetResult (i), expected.str (), "Wrong result for " << fork.GetVariantName (i));
+    }
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +637,7 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorProfileTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorForkTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
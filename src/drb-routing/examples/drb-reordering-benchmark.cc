@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+// Reordering stress benchmark for the TCP receive path.
+//
+// A single bulk TCP flow is sprayed packet by packet over the spines of a
+// two-leaf fabric by Ipv4DrbRouting, and the spine links have different
+// latencies, so nearly every segment arrives out of order at the receiver.
+// The wall clock time spent in Simulator::Run is reported.
+//
+//   sender -- leaf0 == spine 0..n-1 == leaf1 -- receiver
+//
+// ./waf --run "drb-reordering-benchmark --spineCount=8 --delaySkew=5"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/ipv4-drb-routing-helper.h"
+#include "ns3/ipv4-xpath-routing-helper.h"
+#include "ns3/xpath-compiler.h"
+#include "ns3/system-wall-clock-ms.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DrbReorderingBenchmark");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t spineCount = 4;
+  uint32_t linkLatency = 10;
+  uint32_t delaySkew = 5;
+  uint64_t linkCapacity = 10;
+  double endTime = 0.1;
+
+  CommandLine cmd;
+  cmd.AddValue ("spineCount", "Number of spines the flow is sprayed over", spineCount);
+  cmd.AddValue ("linkLatency", "Base link latency in MicroSeconds", linkLatency);
+  cmd.AddValue ("delaySkew", "Extra latency per spine index in MicroSeconds", delaySkew);
+  cmd.AddValue ("linkCapacity", "Link capacity in Gbps", linkCapacity);
+  cmd.AddValue ("endTime", "Simulated time in seconds", endTime);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1400));
+  Config::SetDefault ("ns3::TcpSocket::DelAckCount", UintegerValue (0));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (160000000));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (160000000));
+  Config::SetDefault ("ns3::TcpSocketBase::MinRto", TimeValue (MilliSeconds (5)));
+
+  Ptr<Node> sender = CreateObject<Node> ();
+  Ptr<Node> receiver = CreateObject<Node> ();
+  NodeContainer leaves;
+  leaves.Create (2);
+  NodeContainer spines;
+  spines.Create (spineCount);
+
+  // The sender sprays with DRB, the switches forward along the XPath
+  // carried by the packet and fall back to global routing on the last hop
+  Ipv4GlobalRoutingHelper globalRoutingHelper;
+  Ipv4DrbRoutingHelper drbRoutingHelper;
+  Ipv4XPathRoutingHelper xpathRoutingHelper;
+
+  Ipv4ListRoutingHelper senderRoutingHelper;
+  senderRoutingHelper.Add (drbRoutingHelper, 1);
+  senderRoutingHelper.Add (globalRoutingHelper, 0);
+
+  Ipv4ListRoutingHelper switchRoutingHelper;
+  switchRoutingHelper.Add (xpathRoutingHelper, 1);
+  switchRoutingHelper.Add (globalRoutingHelper, 0);
+
+  InternetStackHelper internet;
+  internet.SetRoutingHelper (senderRoutingHelper);
+  internet.Install (sender);
+  internet.SetRoutingHelper (globalRoutingHelper);
+  internet.Install (receiver);
+  internet.SetRoutingHelper (switchRoutingHelper);
+  internet.Install (leaves);
+  internet.Install (spines);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", DataRateValue (DataRate (linkCapacity * 1000000000)));
+  p2p.SetChannelAttribute ("Delay", TimeValue (MicroSeconds (linkLatency)));
+  p2p.SetQueue ("ns3::DropTailQueue", "MaxPackets", UintegerValue (1000));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.0");
+
+  // Interface 1 of each leaf faces the host, interface 2 + j faces spine j
+  ipv4.Assign (p2p.Install (sender, leaves.Get (0)));
+  ipv4.NewNetwork ();
+  Ipv4InterfaceContainer receiverInterfaces = ipv4.Assign (p2p.Install (receiver, leaves.Get (1)));
+
+  for (uint32_t j = 0; j < spineCount; j++)
+    {
+      p2p.SetChannelAttribute ("Delay", TimeValue (MicroSeconds (linkLatency + j * delaySkew)));
+      // Interface 1 of each spine faces leaf0, interface 2 faces leaf1
+      for (uint32_t i = 0; i < 2; i++)
+        {
+          ipv4.NewNetwork ();
+          ipv4.Assign (p2p.Install (leaves.Get (i), spines.Get (j)));
+        }
+    }
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  Ptr<Ipv4ListRouting> listRouting = DynamicCast<Ipv4ListRouting> (sender->GetObject<Ipv4> ()->GetRoutingProtocol ());
+  int16_t priority;
+  Ptr<Ipv4DrbRouting> drbRouting = DynamicCast<Ipv4DrbRouting> (listRouting->GetRoutingProtocol (0, priority));
+  // Leaf0 goes up through port 2 + j, the spine goes down through port 2
+  XPathCompiler compiler;
+  std::vector<uint32_t> paths = compiler.CompilePaths (leaves.Get (0), leaves.Get (1));
+  for (uint32_t j = 0; j < paths.size (); j++)
+    {
+      drbRouting->AddPath (paths[j]);
+    }
+
+  uint16_t port = 5000;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (receiverInterfaces.GetAddress (0), port));
+  source.SetAttribute ("SendSize", UintegerValue (1400));
+  source.SetAttribute ("MaxBytes", UintegerValue (0));
+  ApplicationContainer sourceApp = source.Install (sender);
+  sourceApp.Start (Seconds (0.0));
+  sourceApp.Stop (Seconds (endTime));
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApp = sink.Install (receiver);
+  sinkApp.Start (Seconds (0.0));
+  sinkApp.Stop (Seconds (endTime));
+
+  SystemWallClockMs wallClock;
+  wallClock.Start ();
+  Simulator::Stop (Seconds (endTime));
+  Simulator::Run ();
+  int64_t elapsed = wallClock.End ();
+
+  uint64_t totalRx = DynamicCast<PacketSink> (sinkApp.Get (0))->GetTotalRx ();
+  std::cout << "Spines: " << spineCount << ", delay skew: " << delaySkew << "us" << std::endl;
+  std::cout << "Received: " << totalRx << " bytes in " << endTime << " s simulated" << std::endl;
+  std::cout << "Wall clock: " << elapsed << " ms";
+  if (elapsed > 0)
+    {
+      std::cout << ", " << totalRx / 1400 * 1000 / elapsed << " segments/s";
+    }
+  std::cout << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
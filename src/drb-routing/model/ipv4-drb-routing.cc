@@ -9,6 +9,8 @@
 #include "ns3/ipv4-xpath-tag.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4DrbRouting");
@@ -26,12 +28,23 @@ Ipv4DrbRouting::GetTypeId (void)
                     UintegerValue (1),
                     MakeUintegerAccessor (&Ipv4DrbRouting::m_mode),
                     MakeUintegerChecker<uint32_t> ())
+      .AddAttribute ("FlowAgingTime", "Idle time after which the state of a flow is forgotten",
+                    TimeValue (MilliSeconds (100)),
+                    MakeTimeAccessor (&Ipv4DrbRouting::m_agingTime),
+                    MakeTimeChecker ())
   ;
 
   return tid;
 }
 
+Ipv4DrbRouting::PathSet::PathSet ()
+  : m_totalWeight (0)
+{
+}
+
 Ipv4DrbRouting::Ipv4DrbRouting () :
+    m_pathSets (1),
+    m_agingTime (MilliSeconds (100)),
     m_mode (PER_FLOW)
 {
   NS_LOG_FUNCTION (this);
@@ -56,14 +69,10 @@ Ipv4DrbRouting::AddPath (uint32_t weight, uint32_t path)
     NS_LOG_ERROR ("You have to use the PER_FLOW mode when the weight != 1");
     return false;
   }
-  for (uint32_t i = 0; i < weight; i++)
-  {
-    m_paths.push_back (path);
-  }
+  AddToSet (m_pathSets[0], weight, path);
   return true;
 }
 
-/* Sorry for those very ugly code */
 bool
 Ipv4DrbRouting::AddWeightedPath (uint32_t weight, uint32_t path,
         const std::set<Ipv4Address>& exclusiveIPs)
@@ -72,20 +81,13 @@ Ipv4DrbRouting::AddWeightedPath (uint32_t weight, uint32_t path,
   Ipv4DrbRouting::AddPath (weight, path);
 
   // Add rules to all other tables
-  std::map<Ipv4Address, std::vector<uint32_t> >::iterator itr = m_extraPaths.begin ();
-  for (; itr != m_extraPaths.end (); ++itr)
+  for (DestSetMap::const_iterator itr = m_destSets.begin (); itr != m_destSets.end (); ++itr)
   {
-    Ipv4Address key = itr->first;
-    if (exclusiveIPs.find (key) != exclusiveIPs.end ())
+    if (exclusiveIPs.find (itr->first) != exclusiveIPs.end ())
     {
       continue;
     }
-    std::vector<uint32_t> paths = itr->second;
-    for (uint32_t i = 0; i < weight; i++)
-    {
-      paths.push_back (path);
-    }
-    m_extraPaths[key] = paths;
+    AddToSet (m_pathSets[itr->second], weight, path);
   }
   return true;
 }
@@ -93,24 +95,163 @@ Ipv4DrbRouting::AddWeightedPath (uint32_t weight, uint32_t path,
 bool
 Ipv4DrbRouting::AddWeightedPath (Ipv4Address destAddr, uint32_t weight, uint32_t path)
 {
-  std::vector<uint32_t> paths;
-  std::map<Ipv4Address, std::vector<uint32_t> >::iterator itr = m_extraPaths.find (destAddr);
-  if (itr != m_extraPaths.end ())
+  DestSetMap::const_iterator itr = m_destSets.find (destAddr);
+  uint32_t set;
+  if (itr != m_destSets.end ())
   {
-    paths = itr->second;
+    set = itr->second;
   }
   else
   {
-    paths = m_paths;
+    // A destination starts from the default paths
+    set = m_pathSets.size ();
+    m_pathSets.push_back (m_pathSets[0]);
+    m_destSets[destAddr] = set;
   }
+  AddToSet (m_pathSets[set], weight, path);
+  return true;
+}
+
+bool
+Ipv4DrbRouting::SetPathWeight (uint32_t path, uint32_t weight)
+{
+  return SetWeight (m_pathSets[0], path, weight);
+}
 
-  for (uint32_t i = 0; i < weight; i++)
+bool
+Ipv4DrbRouting::SetPathWeight (Ipv4Address destAddr, uint32_t path, uint32_t weight)
+{
+  DestSetMap::const_iterator itr = m_destSets.find (destAddr);
+  if (itr == m_destSets.end ())
   {
-    paths.push_back (path);
+    return false;
   }
+  return SetWeight (m_pathSets[itr->second], path, weight);
+}
 
-  m_extraPaths[destAddr] = paths;
-  return true;
+int64_t
+Ipv4DrbRouting::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_rng.SetStream (stream);
+  return 1;
+}
+
+void
+Ipv4DrbRouting::AddToSet (PathSet &set, uint32_t weight, uint32_t path)
+{
+  set.m_totalWeight += weight;
+  for (uint32_t i = 0; i < set.m_paths.size (); i++)
+  {
+    if (set.m_paths[i] == path)
+    {
+      set.m_weights[i] += weight;
+      return;
+    }
+  }
+  set.m_paths.push_back (path);
+  set.m_weights.push_back (weight);
+}
+
+bool
+Ipv4DrbRouting::SetWeight (PathSet &set, uint32_t path, uint32_t weight)
+{
+  for (uint32_t i = 0; i < set.m_paths.size (); i++)
+  {
+    if (set.m_paths[i] == path)
+    {
+      set.m_totalWeight += (int64_t) weight - set.m_weights[i];
+      set.m_weights[i] = weight;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32_t
+Ipv4DrbRouting::SelectPath (FlowState &flow, const PathSet &set)
+{
+  uint32_t size = set.m_paths.size ();
+  if (flow.m_size != size)
+  {
+    // New flow, or paths were added since the flow last sent: start over,
+    // giving a random path a head start of a full round
+    if (flow.m_capacity < size)
+    {
+      ReleaseSlice (flow);
+      std::vector<uint32_t> &free = m_freeSlices[size];
+      if (free.empty ())
+      {
+        flow.m_offset = m_currentWeights.size ();
+        m_currentWeights.resize (m_currentWeights.size () + size);
+      }
+      else
+      {
+        flow.m_offset = free.back ();
+        free.pop_back ();
+      }
+      flow.m_capacity = size;
+    }
+    flow.m_size = size;
+    std::fill (m_currentWeights.begin () + flow.m_offset,
+               m_currentWeights.begin () + flow.m_offset + size, 0);
+    uint32_t first = m_rng.GetInteger (size);
+    if (set.m_weights[first] > 0)
+    {
+      m_currentWeights[flow.m_offset + first] = set.m_totalWeight;
+    }
+  }
+
+  int64_t *current = &m_currentWeights[flow.m_offset];
+  uint32_t best = 0;
+  for (uint32_t i = 0; i < size; i++)
+  {
+    current[i] += set.m_weights[i];
+    if (current[i] > current[best])
+    {
+      best = i;
+    }
+  }
+  current[best] -= set.m_totalWeight;
+  return set.m_paths[best];
+}
+
+void
+Ipv4DrbRouting::ReleaseSlice (FlowState &flow)
+{
+  if (flow.m_capacity > 0)
+  {
+    m_freeSlices[flow.m_capacity].push_back (flow.m_offset);
+    flow.m_capacity = 0;
+  }
+}
+
+void
+Ipv4DrbRouting::AgingEvent (void)
+{
+  Time now = Simulator::Now ();
+  FlowStateMap::iterator itr = m_flows.begin ();
+  while (itr != m_flows.end ())
+  {
+    if (now - itr->second.m_lastUsed > m_agingTime)
+    {
+      ReleaseSlice (itr->second);
+      m_flows.erase (itr++);
+    }
+    else
+    {
+      ++itr;
+    }
+  }
+
+  if (!m_flows.empty ())
+  {
+    m_agingEvent = Simulator::Schedule (m_agingTime / 4, &Ipv4DrbRouting::AgingEvent, this);
+  }
+  else
+  {
+    NS_LOG_LOGIC (this << " Aging event goes into idle status");
+  }
 }
 
 /* Inherit From Ipv4RoutingProtocol */
@@ -148,28 +289,41 @@ Ipv4DrbRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDev
     return 0;
   }
 
-  /* Ugly code, patch to support Weighted Presto */
-  std::vector<uint32_t> paths;
-  std::map<Ipv4Address, std::vector<uint32_t> >::iterator extraItr = m_extraPaths.find (header.GetDestination ());
-  if (extraItr == m_extraPaths.end ())
+  uint32_t setIndex = 0;
+  if (!m_destSets.empty ())
   {
-    paths = m_paths;
+    DestSetMap::const_iterator setItr = m_destSets.find (header.GetDestination ());
+    if (setItr != m_destSets.end ())
+    {
+      setIndex = setItr->second;
+    }
   }
-  else
+  const PathSet &set = m_pathSets[setIndex];
+  if (set.m_totalWeight <= 0)
   {
-    paths = extraItr->second;
+    NS_LOG_ERROR ("No path toward: " << header.GetDestination ());
+    sockerr = Socket::ERROR_NOROUTETOHOST;
+    return 0;
   }
-  /* Breathe a fresh air to celebrate the end of ugly code */
 
-  uint32_t index = rand () % paths.size ();
-  std::map<uint32_t, uint32_t>::iterator itr = m_indexMap.find (flowIndentify);
-  if (itr != m_indexMap.end ())
+  std::pair<FlowStateMap::iterator, bool> inserted = m_flows.insert (std::make_pair (flowIndentify, FlowState ()));
+  FlowState &flow = inserted.first->second;
+  if (inserted.second)
+  {
+    flow.m_capacity = 0;
+  }
+  if (inserted.second || flow.m_set != setIndex)
   {
-    index = itr->second;
+    flow.m_set = setIndex;
+    flow.m_size = 0;
   }
+  flow.m_lastUsed = Simulator::Now ();
+  uint32_t path = SelectPath (flow, set);
 
-  uint32_t path = paths[index];
-  m_indexMap[flowIndentify] = (index + 1) % paths.size ();
+  if (!m_agingEvent.IsRunning ())
+  {
+    m_agingEvent = Simulator::Schedule (m_agingTime / 4, &Ipv4DrbRouting::AgingEvent, this);
+  }
 
   Ipv4XPathTag ipv4XPathTag;
   ipv4XPathTag.SetPathId (path);
@@ -223,11 +377,33 @@ Ipv4DrbRouting::SetIpv4 (Ptr<Ipv4> ipv4)
 void
 Ipv4DrbRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
 {
+  std::ostream* os = stream->GetStream ();
+  *os << "Path\tWeight" << std::endl;
+  const PathSet &set = m_pathSets[0];
+  for (uint32_t i = 0; i < set.m_paths.size (); i++)
+  {
+    *os << set.m_paths[i] << "\t" << set.m_weights[i] << std::endl;
+  }
+  for (DestSetMap::const_iterator itr = m_destSets.begin (); itr != m_destSets.end (); ++itr)
+  {
+    const PathSet &destSet = m_pathSets[itr->second];
+    *os << "To " << itr->first << ":" << std::endl;
+    for (uint32_t i = 0; i < destSet.m_paths.size (); i++)
+    {
+      *os << destSet.m_paths[i] << "\t" << destSet.m_weights[i] << std::endl;
+    }
+  }
 }
 
 void
 Ipv4DrbRouting::DoDispose (void)
 {
+  m_agingEvent.Cancel ();
+  m_flows.clear ();
+  m_currentWeights.clear ();
+  m_freeSlices.clear ();
+  m_ipv4 = 0;
+  Ipv4RoutingProtocol::DoDispose ();
 }
 
 }
@@ -8,8 +8,14 @@
 #include "ns3/packet.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/sgi-hashmap.h"
+#include "ns3/counter-rng.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
 
+#include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -19,6 +25,18 @@ enum DrbRoutingMode
     PER_FLOW
 };
 
+/**
+ * \brief Spray the packets of every flow over a set of XPaths.
+ *
+ * Paths are picked by smooth weighted round robin: a path with weight w
+ * out of a total weight W carries w out of every W packets of a flow, and
+ * its packets are spread evenly instead of being sent back to back.  The
+ * paths and weights of a path set live in flat arrays, the state of every
+ * flow is a slice of one array of current weights, and weights can be
+ * changed at run time without touching the flows.  The first path of
+ * every flow is picked at random.  Flows idle for FlowAgingTime are
+ * forgotten, and their slices of current weights are given to new flows.
+ */
 class Ipv4DrbRouting : public Ipv4RoutingProtocol
 {
 
@@ -36,6 +54,34 @@ public:
           const std::set<Ipv4Address>& exclusiveIPs = std::set<Ipv4Address> ());
   bool AddWeightedPath (Ipv4Address destAddr, uint32_t weight, uint32_t path);
 
+  /**
+   * \brief Change the weight of a path of the default path set.
+   * \param path the path ID
+   * \param weight the new weight, 0 to stop using the path
+   * \return false if the path was never added
+   */
+  bool SetPathWeight (uint32_t path, uint32_t weight);
+
+  /**
+   * \brief Change the weight of a path used toward one destination.
+   * \param destAddr the destination
+   * \param path the path ID
+   * \param weight the new weight, 0 to stop using the path
+   * \return false if the destination has no path set of its own or the
+   * path was never added to it
+   */
+  bool SetPathWeight (Ipv4Address destAddr, uint32_t path, uint32_t weight);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
   /* Inherit From Ipv4RoutingProtocol */
   virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
   virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
@@ -51,9 +97,78 @@ public:
   virtual void DoDispose (void);
 
 private:
-  std::vector<uint32_t> m_paths;
-  std::map<Ipv4Address, std::vector<uint32_t> > m_extraPaths;
-  std::map<uint32_t, uint32_t> m_indexMap;
+  /**
+   * \brief Paths and weights toward a set of destinations.
+   */
+  struct PathSet
+  {
+    PathSet ();
+
+    std::vector<uint32_t> m_paths;   //!< Path IDs
+    std::vector<int64_t> m_weights;  //!< Weight of every path
+    int64_t m_totalWeight;           //!< Sum of the weights
+  };
+
+  /**
+   * \brief Round robin state of a flow.
+   */
+  struct FlowState
+  {
+    uint32_t m_set;     //!< Index of the path set of the flow
+    uint32_t m_offset;    //!< First current weight of the flow in m_currentWeights
+    uint32_t m_size;      //!< Number of paths the current weights cover
+    uint32_t m_capacity;  //!< Length of the slice of the flow, 0 if it has none
+    Time m_lastUsed;      //!< Time the flow last sent a packet
+  };
+
+  /**
+   * \brief Add weight to a path of a path set, adding the path if needed.
+   * \param set the path set
+   * \param weight the weight to add
+   * \param path the path ID
+   */
+  static void AddToSet (PathSet &set, uint32_t weight, uint32_t path);
+
+  /**
+   * \brief Set the weight of a path of a path set.
+   * \param set the path set
+   * \param path the path ID
+   * \param weight the new weight
+   * \return false if the path is not in the set
+   */
+  static bool SetWeight (PathSet &set, uint32_t path, uint32_t weight);
+
+  /**
+   * \brief Pick the next path of a flow.
+   * \param flow the flow state
+   * \param set the path set of the flow
+   * \return the path ID
+   */
+  uint32_t SelectPath (FlowState &flow, const PathSet &set);
+
+  /**
+   * \brief Give back the slice of current weights of a flow.
+   * \param flow the flow state
+   */
+  void ReleaseSlice (FlowState &flow);
+
+  /**
+   * \brief Forget the flows idle for longer than the aging time.
+   */
+  void AgingEvent (void);
+
+  typedef sgi::hash_map<Ipv4Address, uint32_t, Ipv4AddressHash> DestSetMap;
+  typedef sgi::hash_map<uint32_t, FlowState> FlowStateMap;
+
+  std::vector<PathSet> m_pathSets;        //!< Path sets, the default one first
+  DestSetMap m_destSets;                  //!< Path set of the destinations that have their own
+  FlowStateMap m_flows;                   //!< Round robin state of every flow
+  std::vector<int64_t> m_currentWeights;  //!< Current weights of all the flows
+  /// Offsets of the unused slices of m_currentWeights, by length
+  std::map<uint32_t, std::vector<uint32_t> > m_freeSlices;
+  Time m_agingTime;                       //!< Idle time after which a flow is forgotten
+  EventId m_agingEvent;                   //!< Next check of the idle flows
+  CounterRng m_rng;                       //!< Picks the head start of new flows
   enum DrbRoutingMode m_mode;
 
   Ptr<Ipv4> m_ipv4;
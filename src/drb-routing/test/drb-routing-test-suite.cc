@@ -2,6 +2,11 @@
 
 // Include a header file from your module to test.
 #include "ns3/ipv4-drb-routing.h"
+#include "ns3/ipv4-xpath-tag.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/packet.h"
+
+#include <map>
 
 // An essential include is test.h
 #include "ns3/test.h"
@@ -46,6 +51,106 @@ DrbRoutingTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * \brief Check the share and the spread of the paths picked by weighted spraying
+ */
+class DrbWeightedSprayingTestCase : public TestCase
+{
+public:
+  DrbWeightedSprayingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Route a packet and return the path it was given
+   * \param flowId the flow of the packet
+   * \param dest the destination of the packet
+   * \return the path ID
+   */
+  uint32_t Route (uint32_t flowId, Ipv4Address dest);
+
+  Ptr<Ipv4DrbRouting> m_drb; //!< Routing under test
+};
+
+DrbWeightedSprayingTestCase::DrbWeightedSprayingTestCase ()
+  : TestCase ("DRB weighted spraying")
+{
+}
+
+uint32_t
+DrbWeightedSprayingTestCase::Route (uint32_t flowId, Ipv4Address dest)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddPacketTag (FlowIdTag (flowId));
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno sockerr;
+  m_drb->RouteOutput (p, header, 0, sockerr);
+  Ipv4XPathTag tag;
+  if (!p->PeekPacketTag (tag))
+    {
+      return 0;
+    }
+  return tag.GetPathId ();
+}
+
+void
+DrbWeightedSprayingTestCase::DoRun (void)
+{
+  m_drb = CreateObject<Ipv4DrbRouting> ();
+  Ipv4Address dest ("10.0.0.1");
+  Ipv4Address other ("10.0.0.2");
+
+  NS_TEST_EXPECT_MSG_EQ (Route (1, dest), 0, "No path should be assigned without paths");
+
+  m_drb->AddPath (3000, 101);
+  m_drb->AddPath (1000, 102);
+
+  // Every round of 4000 packets carries the weights, give or take the
+  // random head start of the flow, and the light path is never used twice
+  // in a row
+  std::map<uint32_t, uint32_t> counts;
+  uint32_t last = 0;
+  bool backToBack = false;
+  for (uint32_t i = 0; i < 8000; i++)
+    {
+      uint32_t path = Route (1, dest);
+      counts[path]++;
+      backToBack = backToBack || (path == 102 && last == 102);
+      last = path;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (counts[101], 6000, 1, "Wrong share of the heavy path");
+  NS_TEST_EXPECT_MSG_EQ_TOL (counts[102], 2000, 1, "Wrong share of the light path");
+  NS_TEST_EXPECT_MSG_EQ (backToBack, false, "Light path should be spread out");
+
+  // Weights change at run time, flows keep their state
+  NS_TEST_EXPECT_MSG_EQ (m_drb->SetPathWeight (102, 3000), true, "Path should be known");
+  NS_TEST_EXPECT_MSG_EQ (m_drb->SetPathWeight (103, 1), false, "Path should be unknown");
+  counts.clear ();
+  for (uint32_t i = 0; i < 6000; i++)
+    {
+      counts[Route (1, dest)]++;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (counts[101], 3000, 1, "Paths should be even after the update");
+  NS_TEST_EXPECT_MSG_EQ_TOL (counts[102], 3000, 1, "Paths should be even after the update");
+
+  // A destination with its own paths starts from the default ones
+  m_drb->AddWeightedPath (other, 6000, 103);
+  m_drb->SetPathWeight (other, 101, 0);
+  counts.clear ();
+  for (uint32_t i = 0; i < 9000; i++)
+    {
+      counts[Route (2, other)]++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (counts[101], 0, "Disabled path should not be used");
+  NS_TEST_EXPECT_MSG_EQ_TOL (counts[102], 3000, 1, "Wrong share of the inherited path");
+  NS_TEST_EXPECT_MSG_EQ_TOL (counts[103], 6000, 1, "Wrong share of the added path");
+
+  m_drb->Dispose ();
+  m_drb = 0;
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -61,6 +166,7 @@ DrbRoutingTestSuite::DrbRoutingTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new DrbRoutingTestCase1, TestCase::QUICK);
+  AddTestCase (new DrbWeightedSprayingTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -110,6 +110,14 @@ Ipv4DrillRouting::CalculateQueueLength (uint32_t interface)
   return totalLength;
 }
 
+int64_t
+Ipv4DrillRouting::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_rng.SetStream (stream);
+  return 1;
+}
+
 Ptr<Ipv4Route>
 Ipv4DrillRouting::ConstructIpv4Route (uint32_t port, Ipv4Address destAddress)
 {
@@ -176,7 +184,13 @@ Ipv4DrillRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr
   uint32_t leastLoadInterface = 0;
   uint32_t leastLoad = std::numeric_limits<uint32_t>::max ();
 
-  std::random_shuffle (allPorts.begin (), allPorts.end ());
+  uint32_t sampleNum = m_d < allPorts.size () ? m_d : allPorts.size ();
+
+  // Sample d ports without replacement, a partial Fisher-Yates shuffle
+  for (uint32_t samplePort = 0; samplePort < sampleNum; samplePort ++)
+  {
+    std::swap (allPorts[samplePort], allPorts[samplePort + m_rng.GetInteger (allPorts.size () - samplePort)]);
+  }
 
   std::map<Ipv4Address, uint32_t>::iterator itr = m_previousBestQueueMap.find (destAddress);
 
@@ -186,8 +200,6 @@ Ipv4DrillRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr
     leastLoad = CalculateQueueLength (itr->second);
   }
 
-  uint32_t sampleNum = m_d < allPorts.size () ? m_d : allPorts.size ();
-
   for (uint32_t samplePort = 0; samplePort < sampleNum; samplePort ++)
   {
     uint32_t sampleLoad = Ipv4DrillRouting::CalculateQueueLength (allPorts[samplePort].port);
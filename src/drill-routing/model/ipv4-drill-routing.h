@@ -8,6 +8,7 @@
 #include "ns3/packet.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/counter-rng.h"
 
 #include <vector>
 #include <map>
@@ -35,6 +36,15 @@ public:
   uint32_t CalculateQueueLength (uint32_t interface);
   Ptr<Ipv4Route> ConstructIpv4Route (uint32_t port, Ipv4Address destAddress);
 
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
 
   /* Inherit From Ipv4RoutingProtocol */
   virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
@@ -53,6 +63,7 @@ public:
 private:
   uint32_t m_d;
   std::map<Ipv4Address, uint32_t> m_previousBestQueueMap;
+  CounterRng m_rng;
 
   Ptr<Ipv4> m_ipv4;
   std::vector<DrillRouteEntry> m_routeEntryList;
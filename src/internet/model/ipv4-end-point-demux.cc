@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
 #include "ns3/log.h"
@@ -26,6 +27,41 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
+Ipv4EndPointDemux::FourTuple::FourTuple (Ipv4Address localAddress, uint16_t localPort,
+                                         Ipv4Address peerAddress, uint16_t peerPort)
+  : m_localAddress (localAddress),
+    m_peerAddress (peerAddress),
+    m_localPort (localPort),
+    m_peerPort (peerPort)
+{
+}
+
+bool
+Ipv4EndPointDemux::FourTuple::operator== (const FourTuple &other) const
+{
+  return m_localPort == other.m_localPort
+         && m_peerPort == other.m_peerPort
+         && m_localAddress == other.m_localAddress
+         && m_peerAddress == other.m_peerAddress;
+}
+
+size_t
+Ipv4EndPointDemux::FourTupleHash::operator() (const FourTuple &tuple) const
+{
+  // Fold the addresses and ports, then mix so that neighbouring peers spread
+  uint32_t h = tuple.m_peerAddress.Get () ^ tuple.m_localAddress.Get ();
+  h ^= (static_cast<uint32_t> (tuple.m_peerPort) << 16) | tuple.m_localPort;
+  h ^= h >> 16;
+  h *= 0x45d9f3b;
+  h ^= h >> 16;
+  return h;
+}
+
+Ipv4EndPointDemux::PortEntry::PortEntry ()
+  : m_connected (0)
+{
+}
+
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
   : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
 {
@@ -38,37 +74,116 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_ports.clear ();
+  m_connections.clear ();
 }
 
 bool
-Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv4EndPointDemux::IsConnected (Ipv4Address localAddress, Ipv4Address peerAddress,
+                                uint16_t peerPort)
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  return localAddress != Ipv4Address::GetAny ()
+         && peerAddress != Ipv4Address::GetAny ()
+         && peerPort != 0;
+}
+
+void
+Ipv4EndPointDemux::Hash (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  PortEntry &entry = m_ports[endPoint->m_localPort];
+  if (IsConnected (endPoint->m_localAddr, endPoint->m_peerAddr, endPoint->m_peerPort))
+    {
+      FourTuple tuple (endPoint->m_localAddr, endPoint->m_localPort,
+                       endPoint->m_peerAddr, endPoint->m_peerPort);
+      m_connections[tuple].push_back (endPoint);
+      entry.m_connected++;
+    }
+  else
     {
-      if ((*i)->GetLocalPort  () == port) 
+      entry.m_wildcard.push_back (endPoint);
+    }
+}
+
+void
+Ipv4EndPointDemux::Unhash (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  PortMap::iterator port = m_ports.find (endPoint->m_localPort);
+  NS_ASSERT (port != m_ports.end ());
+  if (IsConnected (endPoint->m_localAddr, endPoint->m_peerAddr, endPoint->m_peerPort))
+    {
+      FourTuple tuple (endPoint->m_localAddr, endPoint->m_localPort,
+                       endPoint->m_peerAddr, endPoint->m_peerPort);
+      ConnectionMap::iterator conn = m_connections.find (tuple);
+      NS_ASSERT (conn != m_connections.end ());
+      conn->second.remove (endPoint);
+      if (conn->second.empty ())
         {
-          return true;
+          m_connections.erase (conn);
         }
+      port->second.m_connected--;
+    }
+  else
+    {
+      port->second.m_wildcard.remove (endPoint);
+    }
+  if (port->second.m_wildcard.empty () && port->second.m_connected == 0)
+    {
+      m_ports.erase (port);
     }
-  return false;
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  endPoint->m_demux = this;
+  Hash (endPoint);
+  m_endPoints.push_back (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  PortMap::iterator entry = m_ports.find (port);
+  if (entry == m_ports.end ())
+    {
+      return false;
+    }
+  for (EndPointsI i = entry->second.m_wildcard.begin (); i != entry->second.m_wildcard.end (); i++) 
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr) 
+      if ((*i)->GetLocalAddress () == addr) 
         {
           return true;
         }
     }
+  if (entry->second.m_connected > 0)
+    {
+      // Connections are hashed by four-tuple; this is only done on bind
+      for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+        {
+          if ((*i)->GetLocalPort () == port &&
+              (*i)->GetLocalAddress () == addr) 
+            {
+              return true;
+            }
+        }
+    }
   return false;
 }
 
@@ -82,10 +197,7 @@ Ipv4EndPointDemux::Allocate (void)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (Ipv4Address::GetAny (), port));
 }
 
 Ipv4EndPoint *
@@ -98,10 +210,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -121,10 +230,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       NS_LOG_WARN ("Duplicate address/port; failing.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -132,25 +238,38 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  bool duplicate = false;
+  if (IsConnected (localAddress, peerAddress, peerPort))
+    {
+      FourTuple tuple (localAddress, localPort, peerAddress, peerPort);
+      duplicate = m_connections.find (tuple) != m_connections.end ();
+    }
+  else
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress) 
+      PortMap::iterator entry = m_ports.find (localPort);
+      if (entry != m_ports.end ())
         {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
+          for (EndPointsI i = entry->second.m_wildcard.begin (); i != entry->second.m_wildcard.end (); i++) 
+            {
+              if ((*i)->GetLocalAddress () == localAddress &&
+                  (*i)->GetPeerPort () == peerPort &&
+                  (*i)->GetPeerAddress () == peerAddress) 
+                {
+                  duplicate = true;
+                  break;
+                }
+            }
         }
     }
+  if (duplicate)
+    {
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      return 0;
+    }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void 
@@ -161,6 +280,8 @@ Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
     {
       if (*i == endPoint)
         {
+          Unhash (endPoint);
+          endPoint->m_demux = 0;
           delete endPoint;
           m_endPoints.erase (i);
           break;
@@ -204,7 +325,59 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  PortMap::iterator entry = m_ports.find (dport);
+  if (entry == m_ports.end ())
+    {
+      NS_LOG_LOGIC ("No endpoint bound to port " << dport);
+      return retval1;
+    }
+
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+    {
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+        {
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
+        }
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
+
+  // A connected endpoint can only be a full match: find it by four-tuple
+  if (entry->second.m_connected > 0)
+    {
+      ConnectionMap::iterator conn = m_connections.find (FourTuple (incomingInterfaceAddr, dport,
+                                                                    saddr, sport));
+      if (conn != m_connections.end ())
+        {
+          for (EndPointsI i = conn->second.begin (); i != conn->second.end (); i++)
+            {
+              Ipv4EndPoint* endP = *i;
+              if (!endP->IsRxEnabled ())
+                {
+                  NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                                << " because endpoint can not receive packets");
+                  continue;
+                }
+              if (endP->GetBoundNetDevice ()
+                  && endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+                {
+                  NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                                                     << " because endpoint is bound to specific device and"
+                                                     << endP->GetBoundNetDevice ()
+                                                     << " does not match packet device " << incomingInterface->GetDevice ());
+                  continue;
+                }
+              retval4.push_back (endP);
+            }
+        }
+    }
+
+  for (EndPointsI i = entry->second.m_wildcard.begin (); i != entry->second.m_wildcard.end (); i++) 
     {
       Ipv4EndPoint* endP = *i;
 
@@ -220,14 +393,6 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
           continue;
         }
 
-      if (endP->GetLocalPort () != dport) 
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
       if (endP->GetBoundNetDevice ())
         {
           if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
@@ -239,20 +404,6 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
               continue;
             }
         }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
-        {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
-            {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
-            }
-        }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
       bool localAddressMatchesWildCard = 
         endP->GetLocalAddress () == Ipv4Address::GetAny ();
       bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
@@ -324,16 +475,27 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  PortMap::iterator entry = m_ports.find (dport);
+  if (entry == m_ports.end ())
+    {
+      return 0;
+    }
+  if (entry->second.m_connected > 0)
+    {
+      ConnectionMap::iterator conn = m_connections.find (FourTuple (daddr, dport, saddr, sport));
+      if (conn != m_connections.end ())
+        {
+          /* this is an exact match. */
+          return conn->second.front ();
+        }
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
   uint32_t genericity = 3;
   Ipv4EndPoint *generic = 0;
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (EndPointsI i = entry->second.m_wildcard.begin (); i != entry->second.m_wildcard.end (); i++) 
     {
-      if ((*i)->GetLocalPort () != dport) 
-        {
-          continue;
-        }
       if ((*i)->GetLocalAddress () == daddr &&
           (*i)->GetPeerPort () == sport &&
           (*i)->GetPeerAddress () == saddr) 
@@ -19,6 +19,7 @@
  */
 
 #include "ipv4-end-point.h"
+#include "ipv4-end-point-demux.h"
 #include "ns3/packet.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -28,7 +29,8 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPoint");
 
 Ipv4EndPoint::Ipv4EndPoint (Ipv4Address address, uint16_t port)
-  : m_localAddr (address), 
+  : m_demux (0),
+    m_localAddr (address),
     m_localPort (port),
     m_peerAddr (Ipv4Address::GetAny ()),
     m_peerPort (0),
@@ -60,7 +62,15 @@ void
 Ipv4EndPoint::SetLocalAddress (Ipv4Address address)
 {
   NS_LOG_FUNCTION (this << address);
+  if (m_demux)
+    {
+      m_demux->Unhash (this);
+    }
   m_localAddr = address;
+  if (m_demux)
+    {
+      m_demux->Hash (this);
+    }
 }
 
 uint16_t 
@@ -88,8 +98,16 @@ void
 Ipv4EndPoint::SetPeer (Ipv4Address address, uint16_t port)
 {
   NS_LOG_FUNCTION (this << address << port);
+  if (m_demux)
+    {
+      m_demux->Unhash (this);
+    }
   m_peerAddr = address;
   m_peerPort = port;
+  if (m_demux)
+    {
+      m_demux->Hash (this);
+    }
 }
 
 void
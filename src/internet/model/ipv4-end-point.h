@@ -32,6 +32,7 @@ namespace ns3 {
 
 class Header;
 class Packet;
+class Ipv4EndPointDemux;
 
 /**
  * \brief A representation of an internet endpoint/connection
@@ -181,6 +182,16 @@ public:
   bool IsRxEnabled (void);
 
 private:
+  friend class Ipv4EndPointDemux;
+
+  /**
+   * \brief The demux indexing this endpoint (if any).
+   *
+   * The demux hashes the endpoint by its addresses and ports, so it is
+   * told whenever they change.
+   */
+  Ipv4EndPointDemux *m_demux;
+
   /**
    * \brief The local address.
    */
@@ -574,7 +574,10 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
 
   if (ipv4Interface->IsUp ())
     {
-      m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+      if (!m_rxTrace.IsEmpty ())
+        {
+          m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+        }
     }
   else
     {
@@ -693,6 +696,13 @@ void
 Ipv4L3Protocol::CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet,
                                     Ptr<Ipv4> ipv4, uint32_t interface)
 {
+  // The header travels parsed down to the queue discs and is only
+  // serialized when the packet is dequeued: do not serialize it here for
+  // nothing.
+  if (m_txTrace.IsEmpty ())
+    {
+      return;
+    }
   Ptr<Packet> packetCopy = packet->Copy ();
   packetCopy->AddHeader (ipHeader);
   m_txTrace (packetCopy, ipv4, interface);
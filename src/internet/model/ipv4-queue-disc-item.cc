@@ -67,7 +67,7 @@ void Ipv4QueueDiscItem::AddHeader(void)
   NS_ASSERT_MSG (!m_headerAdded, "The header has been already added to the packet");
   Ptr<Packet> p = GetPacket ();
   NS_ASSERT (p != 0);
-  p->AddHeader (m_header);
+  p->AddLazyHeader (m_header);
   m_headerAdded = true;
 }
 
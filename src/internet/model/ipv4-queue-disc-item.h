@@ -62,6 +62,9 @@ public:
 
   /**
    * \brief Add the header to the packet
+   *
+   * The header is added with Packet::AddLazyHeader, so that the next
+   * node can get it back without deserializing it.
    */
   virtual void AddHeader (void);
 
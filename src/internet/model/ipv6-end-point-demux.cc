@@ -18,6 +18,7 @@
  * Author: Sebastien Vincent <vincent@clarinet.u-strasbg.fr>
  */
 
+
 #include "ipv6-end-point-demux.h"
 #include "ipv6-end-point.h"
 #include "ns3/log.h"
@@ -26,6 +27,36 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv6EndPointDemux");
 
+Ipv6EndPointDemux::FourTuple::FourTuple (Ipv6Address localAddress, uint16_t localPort,
+                                         Ipv6Address peerAddress, uint16_t peerPort)
+  : m_localAddress (localAddress),
+    m_peerAddress (peerAddress),
+    m_localPort (localPort),
+    m_peerPort (peerPort)
+{
+}
+
+bool Ipv6EndPointDemux::FourTuple::operator== (const FourTuple &other) const
+{
+  return m_localPort == other.m_localPort
+         && m_peerPort == other.m_peerPort
+         && m_localAddress == other.m_localAddress
+         && m_peerAddress == other.m_peerAddress;
+}
+
+size_t Ipv6EndPointDemux::FourTupleHash::operator() (const FourTuple &tuple) const
+{
+  Ipv6AddressHash addressHash;
+  size_t h = addressHash (tuple.m_peerAddress);
+  h = h * 31 + addressHash (tuple.m_localAddress);
+  return h ^ ((static_cast<size_t> (tuple.m_peerPort) << 16) | tuple.m_localPort);
+}
+
+Ipv6EndPointDemux::PortEntry::PortEntry ()
+  : m_connected (0)
+{
+}
+
 Ipv6EndPointDemux::Ipv6EndPointDemux ()
   : m_ephemeral (49152),
     m_portFirst (49152),
@@ -40,35 +71,110 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
       Ipv6EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_ports.clear ();
+  m_connections.clear ();
 }
 
-bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+bool Ipv6EndPointDemux::IsConnected (Ipv6Address localAddress, Ipv6Address peerAddress,
+                                     uint16_t peerPort)
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  return localAddress != Ipv6Address::GetAny ()
+         && peerAddress != Ipv6Address::GetAny ()
+         && peerPort != 0;
+}
+
+void Ipv6EndPointDemux::Hash (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  PortEntry &entry = m_ports[endPoint->m_localPort];
+  if (IsConnected (endPoint->m_localAddr, endPoint->m_peerAddr, endPoint->m_peerPort))
+    {
+      FourTuple tuple (endPoint->m_localAddr, endPoint->m_localPort,
+                       endPoint->m_peerAddr, endPoint->m_peerPort);
+      m_connections[tuple].push_back (endPoint);
+      entry.m_connected++;
+    }
+  else
+    {
+      entry.m_wildcard.push_back (endPoint);
+    }
+}
+
+void Ipv6EndPointDemux::Unhash (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  PortMap::iterator port = m_ports.find (endPoint->m_localPort);
+  NS_ASSERT (port != m_ports.end ());
+  if (IsConnected (endPoint->m_localAddr, endPoint->m_peerAddr, endPoint->m_peerPort))
     {
-      if ((*i)->GetLocalPort  () == port)
+      FourTuple tuple (endPoint->m_localAddr, endPoint->m_localPort,
+                       endPoint->m_peerAddr, endPoint->m_peerPort);
+      ConnectionMap::iterator conn = m_connections.find (tuple);
+      NS_ASSERT (conn != m_connections.end ());
+      conn->second.remove (endPoint);
+      if (conn->second.empty ())
         {
-          return true;
+          m_connections.erase (conn);
         }
+      port->second.m_connected--;
     }
-  return false;
+  else
+    {
+      port->second.m_wildcard.remove (endPoint);
+    }
+  if (port->second.m_wildcard.empty () && port->second.m_connected == 0)
+    {
+      m_ports.erase (port);
+    }
+}
+
+Ipv6EndPoint* Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  endPoint->m_demux = this;
+  Hash (endPoint);
+  m_endPoints.push_back (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  PortMap::iterator entry = m_ports.find (port);
+  if (entry == m_ports.end ())
+    {
+      return false;
+    }
+  for (EndPointsI i = entry->second.m_wildcard.begin (); i != entry->second.m_wildcard.end (); i++)
     {
-      if ((*i)->GetLocalPort () == port
-          && (*i)->GetLocalAddress () == addr)
+      if ((*i)->GetLocalAddress () == addr)
         {
           return true;
         }
     }
+  if (entry->second.m_connected > 0)
+    {
+      /* Connections are hashed by four-tuple; this is only done on bind */
+      for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+        {
+          if ((*i)->GetLocalPort () == port
+              && (*i)->GetLocalAddress () == addr)
+            {
+              return true;
+            }
+        }
+    }
   return false;
 }
 
@@ -81,10 +187,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (Ipv6Address::GetAny (), port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
@@ -96,10 +199,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (uint16_t port)
@@ -117,35 +217,45 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address, uint16_t port)
       NS_LOG_WARN ("Duplicate address/port; failing.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t localPort,
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  bool duplicate = false;
+  if (IsConnected (localAddress, peerAddress, peerPort))
     {
-      if ((*i)->GetLocalPort () == localPort
-          && (*i)->GetLocalAddress () == localAddress
-          && (*i)->GetPeerPort () == peerPort
-          && (*i)->GetPeerAddress () == peerAddress)
+      FourTuple tuple (localAddress, localPort, peerAddress, peerPort);
+      duplicate = m_connections.find (tuple) != m_connections.end ();
+    }
+  else
+    {
+      PortMap::iterator entry = m_ports.find (localPort);
+      if (entry != m_ports.end ())
         {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
+          for (EndPointsI i = entry->second.m_wildcard.begin (); i != entry->second.m_wildcard.end (); i++)
+            {
+              if ((*i)->GetLocalAddress () == localAddress
+                  && (*i)->GetPeerPort () == peerPort
+                  && (*i)->GetPeerAddress () == peerAddress)
+                {
+                  duplicate = true;
+                  break;
+                }
+            }
         }
     }
+  if (duplicate)
+    {
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      return 0;
+    }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
@@ -155,6 +265,8 @@ void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
     {
       if (*i == endPoint)
         {
+          Unhash (endPoint);
+          endPoint->m_demux = 0;
           delete endPoint;
           m_endPoints.erase (i);
           break;
@@ -179,7 +291,41 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval4; /* Exact match on all 4 */
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  PortMap::iterator entry = m_ports.find (dport);
+  if (entry == m_ports.end ())
+    {
+      NS_LOG_LOGIC ("No endpoint bound to port " << dport);
+      return retval1;
+    }
+
+  /* A connected endpoint can only be a full match: find it by four-tuple */
+  if (entry->second.m_connected > 0)
+    {
+      ConnectionMap::iterator conn = m_connections.find (FourTuple (daddr, dport, saddr, sport));
+      if (conn != m_connections.end ())
+        {
+          for (EndPointsI i = conn->second.begin (); i != conn->second.end (); i++)
+            {
+              Ipv6EndPoint* endP = *i;
+              if (!endP->IsRxEnabled ())
+                {
+                  NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                                << " because endpoint can not receive packets");
+                  continue;
+                }
+              if (endP->GetBoundNetDevice ()
+                  && (!incomingInterface || endP->GetBoundNetDevice () != incomingInterface->GetDevice ()))
+                {
+                  NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                                << " because endpoint is bound to another device");
+                  continue;
+                }
+              retval4.push_back (endP);
+            }
+        }
+    }
+
+  for (EndPointsI i = entry->second.m_wildcard.begin (); i != entry->second.m_wildcard.end (); i++)
     {
       Ipv6EndPoint* endP = *i;
 
@@ -195,15 +341,6 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
           continue;
         }
 
-      if (endP->GetLocalPort () != dport)
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
-
       if (endP->GetBoundNetDevice ())
         {
           if (!incomingInterface)
@@ -296,14 +433,24 @@ Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport,
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  PortMap::iterator entry = m_ports.find (dport);
+  if (entry == m_ports.end ())
     {
-      uint32_t tmp = 0;
-
-      if ((*i)->GetLocalPort () != dport)
+      return 0;
+    }
+  if (entry->second.m_connected > 0)
+    {
+      ConnectionMap::iterator conn = m_connections.find (FourTuple (dst, dport, src, sport));
+      if (conn != m_connections.end ())
         {
-          continue;
+          /* this is an exact match. */
+          return conn->second.front ();
         }
+    }
+
+  for (EndPointsI i = entry->second.m_wildcard.begin (); i != entry->second.m_wildcard.end (); i++)
+    {
+      uint32_t tmp = 0;
 
       if ((*i)->GetLocalAddress () == dst && (*i)->GetPeerPort () == sport
           && (*i)->GetPeerAddress () == src)
@@ -311,7 +458,6 @@ Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport,
           /* this is an exact match. */
           return *i;
         }
-
       if ((*i)->GetLocalAddress () == Ipv6Address::GetAny ())
         {
           tmp++;
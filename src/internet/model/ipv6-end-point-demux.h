@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <list>
 #include "ns3/ipv6-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "ipv6-interface.h"
 
 namespace ns3 {
@@ -33,6 +34,10 @@ class Ipv6EndPoint;
 /**
  * \class Ipv6EndPointDemux
  * \brief Demultiplexor for end points.
+ *
+ * Endpoints are hashed by local port, and fully specified (connected)
+ * endpoints are additionally hashed by their four-tuple, as in
+ * Ipv4EndPointDemux.
  */
 class Ipv6EndPointDemux
 {
@@ -146,6 +151,102 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief Local address, local port, peer address and peer port.
+   */
+  struct FourTuple
+  {
+    /**
+     * \brief Constructor.
+     * \param localAddress local address
+     * \param localPort local port
+     * \param peerAddress peer address
+     * \param peerPort peer port
+     */
+    FourTuple (Ipv6Address localAddress, uint16_t localPort,
+               Ipv6Address peerAddress, uint16_t peerPort);
+    /**
+     * \brief Equality operator.
+     * \param other the four-tuple to compare to
+     * \returns true if all the fields are equal
+     */
+    bool operator== (const FourTuple &other) const;
+
+    Ipv6Address m_localAddress; //!< Local address
+    Ipv6Address m_peerAddress;  //!< Peer address
+    uint16_t m_localPort;       //!< Local port
+    uint16_t m_peerPort;        //!< Peer port
+  };
+
+  /**
+   * \brief Hash function for four-tuples.
+   */
+  struct FourTupleHash
+  {
+    /**
+     * \brief Hash a four-tuple.
+     * \param tuple the four-tuple
+     * \returns the hash
+     */
+    size_t operator() (const FourTuple &tuple) const;
+  };
+
+  /**
+   * \brief The endpoints bound to a local port.
+   */
+  struct PortEntry
+  {
+    PortEntry ();
+
+    EndPoints m_wildcard;  //!< Endpoints not hashed by four-tuple
+    uint32_t m_connected;  //!< Number of endpoints hashed by four-tuple
+  };
+
+  /**
+   * \brief Container of endpoints, by local port.
+   */
+  typedef sgi::hash_map<uint16_t, PortEntry> PortMap;
+
+  /**
+   * \brief Container of fully specified endpoints, by four-tuple.
+   */
+  typedef sgi::hash_map<FourTuple, EndPoints, FourTupleHash> ConnectionMap;
+
+  /**
+   * \brief Check whether a four-tuple is fully specified.
+   *
+   * Such an endpoint can only be a full match for a packet, so it is
+   * hashed by its four-tuple rather than scanned as a wildcard.
+   *
+   * \param localAddress local address
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \returns true if none of the fields is a wildcard
+   */
+  static bool IsConnected (Ipv6Address localAddress, Ipv6Address peerAddress,
+                           uint16_t peerPort);
+
+  /**
+   * \brief Add an endpoint to the lookup tables.
+   * \param endPoint the endpoint
+   */
+  void Hash (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an endpoint from the lookup tables.
+   * \param endPoint the endpoint
+   */
+  void Unhash (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Register a newly allocated endpoint.
+   * \param endPoint the endpoint
+   * \returns the endpoint
+   */
+  Ipv6EndPoint *Insert (Ipv6EndPoint *endPoint);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -171,6 +272,16 @@ private:
    * \brief A list of IPv6 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The endpoints, by local port.
+   */
+  PortMap m_ports;
+
+  /**
+   * \brief The fully specified endpoints, by four-tuple.
+   */
+  ConnectionMap m_connections;
 };
 
 } /* namespace ns3 */
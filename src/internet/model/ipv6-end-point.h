@@ -34,6 +34,7 @@ namespace ns3
 
 class Header;
 class Packet;
+class Ipv6EndPointDemux;
 
 /**
  * \brief A representation of an internet IPv6 endpoint/connection
@@ -190,6 +191,16 @@ public:
   bool IsRxEnabled (void);
 
 private:
+  friend class Ipv6EndPointDemux;
+
+  /**
+   * \brief The demux indexing this endpoint (if any).
+   *
+   * The demux hashes the endpoint by its addresses and ports, so it is
+   * told whenever they change.
+   */
+  Ipv6EndPointDemux *m_demux;
+
   /**
    * \brief The local address.
    */
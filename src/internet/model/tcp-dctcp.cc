@@ -29,10 +29,7 @@ TcpDCTCP::TcpDCTCP (void) :
   m_g (0.0625),
   m_alpha (1),
   m_isCE (false),
-  m_hasDelayedACK (false),
-  m_bytesAcked (0),
-  m_ecnBytesAcked (0),
-  m_highTxMark (0)
+  m_hasDelayedACK (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -42,10 +39,7 @@ TcpDCTCP::TcpDCTCP (const TcpDCTCP &sock) :
   m_g (sock.m_g),
   m_alpha (sock.m_alpha),
   m_isCE (false),
-  m_hasDelayedACK (false),
-  m_bytesAcked (sock.m_bytesAcked),
-  m_ecnBytesAcked (sock.m_ecnBytesAcked),
-  m_highTxMark (sock.m_highTxMark)
+  m_hasDelayedACK (false)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("Invoked the copy constructor");
@@ -66,30 +60,18 @@ TcpDCTCP::PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
         const Time &rtt, bool withECE, SequenceNumber32 highTxMark, SequenceNumber32 ackNumber)
 {
   NS_LOG_FUNCTION (this << tcb << segmentsAcked << rtt << withECE << highTxMark << ackNumber);
-  m_bytesAcked += segmentsAcked * tcb->m_segmentSize;
-  if (withECE) {
-    m_ecnBytesAcked += segmentsAcked * tcb->m_segmentSize;
-  }
-  if (ackNumber >= m_highTxMark)
+  // The socket counts the marked bytes of each window for us
+  if (tcb->m_ecn.m_windowEnded)
   {
-    m_highTxMark = highTxMark;
-    TcpDCTCP::UpdateAlpha ();
+    TcpDCTCP::UpdateAlpha (tcb->m_ecn.m_markedFraction);
   }
 }
 
 void
-TcpDCTCP::UpdateAlpha()
+TcpDCTCP::UpdateAlpha (double f)
 {
-  double f;
-  if (m_bytesAcked == 0) {
-      f = 0.0;
-  } else {
-      f = static_cast<double>(m_ecnBytesAcked) / static_cast<double>(m_bytesAcked);
-  }
   m_alpha = (1 - m_g) * m_alpha + m_g * f;
-  NS_LOG_LOGIC (this << Simulator::Now () << " alpha updated: " << m_alpha << " and f: " << f << " bytes: " << m_bytesAcked << " ece bytes: " << m_ecnBytesAcked);
-  m_bytesAcked = 0;
-  m_ecnBytesAcked = 0;
+  NS_LOG_LOGIC (this << Simulator::Now () << " alpha updated: " << m_alpha << " and f: " << f);
 }
 
 void
@@ -23,7 +23,7 @@ public:
 
     virtual void PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked, const Time &rtt, bool withECE,
             SequenceNumber32 headSeq, SequenceNumber32 ackNumber);
-    void UpdateAlpha();
+    void UpdateAlpha (double f);
     virtual void CwndEvent(Ptr<TcpSocketState> tcb, TcpCongEvent_t ev, Ptr<TcpSocketBase> socket);
     virtual void IncreaseWindow(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
     virtual uint32_t GetSsThresh(Ptr<TcpSocketState> tcb, uint32_t bytesInFlight);
@@ -36,11 +36,6 @@ protected:
     TracedValue<double>               m_alpha;
     bool                              m_isCE;
     bool                              m_hasDelayedACK;
-
-    uint32_t                          m_bytesAcked;
-    uint32_t                          m_ecnBytesAcked;
-
-    SequenceNumber32                  m_highTxMark;
 };
 
 }
@@ -32,11 +32,8 @@ TcpFlowBender::GetTypeId (void)
 
 TcpFlowBender::TcpFlowBender ()
     :Object (),
-     m_totalBytes (0),
-     m_markedBytes (0),
      m_numCongestionRtt (0),
      m_V (1),
-     m_highTxMark (0),
      m_T (0.05),
      m_N (1)
 {
@@ -45,11 +42,8 @@ TcpFlowBender::TcpFlowBender ()
 
 TcpFlowBender::TcpFlowBender (const TcpFlowBender &other)
      :Object (),
-     m_totalBytes (0),
-     m_markedBytes (0),
      m_numCongestionRtt (0),
      m_V (1),
-     m_highTxMark (0),
      m_T (other.m_T),
      m_N (other.m_N)
 {
@@ -67,23 +61,6 @@ TcpFlowBender::DoDispose (void)
     NS_LOG_FUNCTION (this);
 }
 
-void
-TcpFlowBender::ReceivedPacket (SequenceNumber32 highTxhMark, SequenceNumber32 ackNumber,
-        uint32_t ackedBytes, bool withECE)
-{
-    NS_LOG_INFO (this << " High TX Mark: " << m_highTxMark << ", ACK Number: " << ackNumber);
-    m_totalBytes += ackedBytes;
-    if (withECE)
-    {
-        m_markedBytes += ackedBytes;
-    }
-    if (ackNumber >= m_highTxMark)
-    {
-        m_highTxMark = highTxhMark;
-        TcpFlowBender::CheckCongestion ();
-    }
-}
-
 
 uint32_t
 TcpFlowBender::GetV ()
@@ -99,12 +76,9 @@ TcpFlowBender::GetPauseTime ()
 }
 
 void
-TcpFlowBender::CheckCongestion ()
+TcpFlowBender::WindowEnded (double f)
 {
-    double f = static_cast<double> (m_markedBytes) / m_totalBytes;
-    NS_LOG_LOGIC (this << "\tMarked packet: " << m_markedBytes
-                       << "\tTotal packet: " << m_totalBytes
-                       << "\tf: " << f);
+    NS_LOG_LOGIC (this << "\tf: " << f);
     if (f > m_T)
     {
         m_numCongestionRtt ++;
@@ -120,9 +94,6 @@ TcpFlowBender::CheckCongestion ()
     {
         m_numCongestionRtt = 0;
     }
-
-    m_markedBytes = 0;
-    m_totalBytes = 0;
 }
 
 }
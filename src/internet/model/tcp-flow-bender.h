@@ -20,7 +20,12 @@ public:
 
     virtual void DoDispose (void);
 
-    void ReceivedPacket (SequenceNumber32 higTxhMark, SequenceNumber32 ackNumber, uint32_t ackedBytes, bool withECE);
+    /**
+     * \brief Check the congestion at the end of an observation window
+     * \param markedFraction the fraction of the bytes acknowledged with
+     *        ECE in the window, from the ECN accounting of the socket
+     */
+    void WindowEnded (double markedFraction);
 
     uint32_t GetV ();
 
@@ -28,17 +33,10 @@ public:
 
 private:
 
-    void CheckCongestion ();
-
     // Variables
-    uint32_t m_totalBytes;
-    uint32_t m_markedBytes;
-
     uint32_t m_numCongestionRtt;
     uint32_t m_V;
 
-    SequenceNumber32 m_highTxMark;
-
     // Parameters
     Time m_rtt;
     double m_T;
@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#ifndef TCP_OPTION_SACK_H
+#define TCP_OPTION_SACK_H
+
+#include <list>
+
+#include "ns3/tcp-option.h"
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+
+/**
+ * \brief Defines the TCP option of kind 5 (selective acknowledgment option)
+ * as in \RFC{2018}
+ *
+ * Each block is the pair [left edge, right edge) of a contiguous range of
+ * data received above the cumulative acknowledgment. With 40 bytes of option
+ * space at most four blocks fit, three when the timestamp option is present.
+ */
+
+class TcpOptionSack : public TcpOption
+{
+public:
+  /// A SACK block, as [left edge, right edge)
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SackBlock;
+  /// The SACK blocks carried by the option, first one reported first
+  typedef std::list<SackBlock> SackList;
+
+  TcpOptionSack ();
+  virtual ~TcpOptionSack ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  virtual uint8_t GetKind (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+
+  /**
+   * \brief Append a block at the end of the option
+   * \param block the block to add
+   */
+  void AddSackBlock (SackBlock block);
+
+  /**
+   * \brief Replace the blocks carried by the option
+   * \param list the new blocks
+   */
+  void SetSackList (const SackList &list);
+
+  /**
+   * \brief Get the blocks carried by the option
+   * \return the SACK blocks
+   */
+  const SackList & GetSackList (void) const;
+
+  /**
+   * \brief Get the number of blocks carried by the option
+   * \return the number of SACK blocks
+   */
+  uint32_t GetNumSackBlocks (void) const;
+
+  /**
+   * \brief Get the serialized size of an option carrying a number of blocks
+   * \param blocks the number of SACK blocks
+   * \return the option size in bytes
+   */
+  static uint32_t GetSizeForBlocks (uint32_t blocks);
+
+protected:
+  SackList m_sackList; //!< the SACK blocks
+};
+
+} // namespace ns3
+
+#endif /* TCP_OPTION_SACK_H */
@@ -7,6 +7,8 @@
 #include "ns3/tcp-socket-base.h"
 #include "ns3/flow-id-tag.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -36,8 +38,14 @@ TcpResequenceBuffer::GetTypeId (void)
                    TimeValue (MicroSeconds (50)),
                    MakeTimeAccessor (&TcpResequenceBuffer::m_outOrderQueueTimerLimit),
                    MakeTimeChecker  ())
+    .AddAttribute ("WindowSize",
+                   "Number of segments the resequencing window can hold",
+                   UintegerValue (256),
+                   MakeUintegerAccessor (&TcpResequenceBuffer::m_windowSize),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddAttribute ("PeriodicalCheckTime",
-                   "Periodical check time",
+                   "Deprecated and ignored: the deadlines are now scheduled "
+                   "exactly instead of being polled",
                    TimeValue (MicroSeconds (10)),
                    MakeTimeAccessor (&TcpResequenceBuffer::m_periodicalCheckTime),
                    MakeTimeChecker  ())
@@ -55,20 +63,28 @@ TcpResequenceBuffer::GetTypeId (void)
 }
 
 TcpResequenceBuffer::TcpResequenceBuffer ():
-	// Parameters
+    // Parameters
     m_sizeLimit (64000),
     m_inOrderQueueTimerLimit (MicroSeconds (20)),
     m_outOrderQueueTimerLimit (MicroSeconds (50)),
+    m_windowSize (256),
     m_periodicalCheckTime (MicroSeconds (10)),
     m_traceFlowId (0),
- 	// Variables
+    // Variables
     m_size (0),
     m_inOrderQueueTimer (Simulator::Now ()),
     m_outOrderQueueTimer (Simulator::Now ()),
-    m_checkEvent (),
+    m_deadlineEvent (),
     m_hasStopped (false),
+    m_hasStarted (false),
     m_firstSeq (SequenceNumber32 (0)),
-    m_nextSeq (SequenceNumber32 (0))
+    m_nextSeq (SequenceNumber32 (0)),
+    m_segmentSize (0),
+    m_slots (0),
+    m_headSlot (0),
+    m_inOrderCount (0),
+    m_outOrderCount (0),
+    m_tcp (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -82,12 +98,11 @@ void
 TcpResequenceBuffer::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
-  m_inOrderQueue.clear ();
-  while (!m_outOrderQueue.empty ())
-  {
-    m_outOrderQueue.pop ();
-  }
-  m_outOrderSeqSet.clear ();
+  m_deadlineEvent.Cancel ();
+  m_window.clear ();
+  m_occupancy.clear ();
+  m_inOrderCount = 0;
+  m_outOrderCount = 0;
 }
 
 void
@@ -102,15 +117,6 @@ TcpResequenceBuffer::BufferPacket (Ptr<Packet> packet,
     return;
   }
 
-  // Turn on the periodical check and reset the timer
-  if (!m_checkEvent.IsRunning ())
-  {
-    NS_LOG_LOGIC ("Turn on periodical check");
-    m_checkEvent = Simulator::Schedule (m_periodicalCheckTime, &TcpResequenceBuffer::PeriodicalCheck, this);
-    m_inOrderQueueTimer = Simulator::Now ();
-    m_outOrderQueueTimer = Simulator::Now ();
-  }
-
   if (m_traceFlowId == 0)
   {
     FlowIdTag flowIdTag;
@@ -136,76 +142,149 @@ TcpResequenceBuffer::BufferPacket (Ptr<Packet> packet,
   element.m_isFin = (tcpHeader.GetFlags () & TcpHeader::FIN) == TcpHeader::FIN ? true: false;
   element.m_dataSize = packet->GetSize () - tcpHeader.GetLength () * 4;
   element.m_packet = packet;
-  element.m_fromAddress = fromAddress;
-  element.m_toAddress = toAddress;
+
+  SequenceNumber32 elementNextSeq = TcpResequenceBuffer::CalculateNextSeq (element);
 
   NS_LOG_INFO ("\tThe packet seq is: " << element.m_seq
-    << " and the expected next seq is: " << TcpResequenceBuffer::CalculateNextSeq (element));
+    << " and the expected next seq is: " << elementNextSeq);
+
+  m_tcpRBBuffer (m_traceFlowId, Simulator::Now (), element.m_seq, elementNextSeq);
 
-  m_tcpRBBuffer (m_traceFlowId, Simulator::Now (), element.m_seq, TcpResequenceBuffer::CalculateNextSeq (element));
+  // The addresses are the same for all the segments of a connection, they
+  // are only recorded when the buffer is empty
+  bool isEmpty = (m_inOrderCount == 0 && m_outOrderCount == 0);
+  if (isEmpty)
+  {
+    m_fromAddress = fromAddress;
+    m_toAddress = toAddress;
+  }
+
+  bool isData = element.m_dataSize > 0 && !element.m_isSyn && !element.m_isFin;
+
+  if (!m_hasStarted && isData)
+  {
+    // The window is anchored on the first data segment, its stride is the
+    // size of the data segments of the sender, whatever the segment size
+    // of this socket is
+    m_segmentSize = element.m_dataSize;
+    m_slots = std::max<uint32_t> ((m_windowSize + 31) / 32 * 32, 32);
+    m_window.resize (m_slots);
+    m_occupancy.assign (m_slots / 32, 0);
+    m_firstSeq = element.m_seq;
+    m_nextSeq = element.m_seq;
+    m_headSlot = 0;
+    m_hasStarted = true;
+  }
+  else if (isData && element.m_dataSize > m_segmentSize)
+  {
+    // The first segment was shorter than the segments of the sender, the
+    // window is emptied and indexed again with the larger stride
+    NS_LOG_LOGIC ("Segment size of the window raised to " << element.m_dataSize);
+    TcpResequenceBuffer::FlushInOrderQueue (OUT_OF_WINDOW);
+    TcpResequenceBuffer::FlushOutOrderQueue (OUT_OF_WINDOW);
+    m_segmentSize = element.m_dataSize;
+    isEmpty = true;
+  }
+
+  if (!isData)
+  {
+    // Connection control segments release everything held before them,
+    // pure ACKs carry no data and are never held
+    if (element.m_isSyn || element.m_isFin)
+    {
+      TcpResequenceBuffer::FlushInOrderQueue (OUT_OF_WINDOW);
+      TcpResequenceBuffer::FlushOutOrderQueue (OUT_OF_WINDOW);
+      if (m_nextSeq < elementNextSeq)
+      {
+        m_nextSeq = elementNextSeq;
+      }
+      m_firstSeq = m_nextSeq;
+    }
+    TcpResequenceBuffer::FlushOneElement (element, OUT_OF_WINDOW);
+    TcpResequenceBuffer::ArmDeadline ();
+    return;
+  }
+
+  if (isEmpty)
+  {
+    m_inOrderQueueTimer = Simulator::Now ();
+    m_outOrderQueueTimer = Simulator::Now ();
+  }
+
+  uint32_t slot = 0;
 
   // If the seq < first seq, retransmission may occur
   if (element.m_seq < m_firstSeq)
   {
     NS_LOG_LOGIC ("Receive retransmission packet with seq:" << element.m_seq
-				<< ", while the firstSeq is: " << m_firstSeq);
+        << ", while the firstSeq is: " << m_firstSeq);
+    // Its data was already forwarded up, or precedes the window.  The old
+    // buffer moved m_nextSeq back to the end of the segment, which the
+    // window can not do: its slots are indexed from m_firstSeq and it may
+    // hold segments beyond m_nextSeq.  The window stays where it is and the
+    // segment is forwarded for the TcpRxBuffer to discard or accept.
     TcpResequenceBuffer::FlushInOrderQueue (RE_TRANS);
-    // Two situation
-    // Case 1. The packet is exactly the previous one
-    // We just continue to expect packets
-    // Case 2. The packet is not exactly the previous one
-    // We need to expect the next one of this packet
-    if (TcpResequenceBuffer::CalculateNextSeq (element) != m_firstSeq)
-    {
-      m_nextSeq = TcpResequenceBuffer::CalculateNextSeq (element);
-    }
     TcpResequenceBuffer::FlushOneElement (element, RE_TRANS);
-
-    // After flush, the first and next seq would be the same
-    m_firstSeq = m_nextSeq;
   }
   // If the first seq <= seq < next seq
   // TODO check, we simply ignore/drop this packet
-  else if (m_firstSeq <= element.m_seq && element.m_seq < m_nextSeq)
+  else if (element.m_seq < m_nextSeq)
   {
     NS_LOG_LOGIC ("Ignore packet with seq: " << element.m_seq
             << ", while the firstSeq is: " << m_firstSeq
             << " and the nextSeq is: " << m_nextSeq);
   }
+  // The segment cannot be held in the window, release everything
+  else if (!TcpResequenceBuffer::GetSlot (element.m_seq, slot))
+  {
+    NS_LOG_LOGIC ("Packet with seq: " << element.m_seq << " is out of the window");
+    TcpResequenceBuffer::FlushInOrderQueue (OUT_OF_WINDOW);
+    TcpResequenceBuffer::FlushOutOrderQueue (OUT_OF_WINDOW);
+    if (m_nextSeq < elementNextSeq)
+    {
+      m_nextSeq = elementNextSeq;
+    }
+    m_firstSeq = m_nextSeq;
+    TcpResequenceBuffer::FlushOneElement (element, OUT_OF_WINDOW);
+  }
+  else if (TcpResequenceBuffer::IsOccupied (slot))
+  {
+    NS_LOG_LOGIC ("Ignore duplicated packet with seq: " << element.m_seq);
+  }
   // If the seq == next seq
-  else if (TcpResequenceBuffer::PutInTheInOrderQueue (element))
+  else if (element.m_seq == m_nextSeq)
   {
-    // Try to fill the in order queue from the out order queue
-    while (!m_outOrderQueue.empty ())
+    TcpResequenceBuffer::PutInTheInOrderQueue (slot, element);
+    // The held segments following it join the in order run where they are
+    bool progress = false;
+    while (m_outOrderCount > 0
+           && TcpResequenceBuffer::GetSlot (m_nextSeq, slot)
+           && TcpResequenceBuffer::IsOccupied (slot))
+    {
+      m_outOrderCount--;
+      TcpResequenceBuffer::PutInTheInOrderQueue (slot, m_window[slot]);
+      progress = true;
+    }
+    if (progress)
     {
-      if (TcpResequenceBuffer::PutInTheInOrderQueue (m_outOrderQueue.top ()))
-      {
-        m_outOrderSeqSet.erase (m_outOrderQueue.top ().m_seq);
-        m_outOrderQueue.pop ();
-      }
-      else
-      {
-        break;
-      }
       m_outOrderQueueTimer = Simulator::Now ();
     }
     // If the size exceeds the limit
     if (m_size >= m_sizeLimit)
     {
-		NS_LOG_LOGIC ("In order queue size exceeds the size limit");
-        TcpResequenceBuffer::FlushInOrderQueue (IN_ORDER_FULL);
-        m_firstSeq = m_nextSeq;
+      NS_LOG_LOGIC ("In order queue size exceeds the size limit");
+      TcpResequenceBuffer::FlushInOrderQueue (IN_ORDER_FULL);
     }
   }
   // If the seq > next seq
   else
   {
-    if (m_outOrderSeqSet.find (element.m_seq) == m_outOrderSeqSet.end())
-    {
-      m_outOrderQueue.push (element);
-      m_outOrderSeqSet.insert (element.m_seq);
-    }
+    m_window[slot] = element;
+    TcpResequenceBuffer::SetOccupied (slot);
+    m_outOrderCount++;
   }
+
+  TcpResequenceBuffer::ArmDeadline ();
 }
 
 
@@ -218,32 +297,59 @@ TcpResequenceBuffer::SetTcp (TcpSocketBase *tcp)
 void
 TcpResequenceBuffer::Stop (void)
 {
-  // After the hasStopped flag turned into true, it would never activate the
-  // periodical check event again to prepare for the destruction
+  // After the hasStopped flag turned into true, it would never arm the
+  // deadline event again to prepare for the destruction
   m_hasStopped = true;
-  m_checkEvent.Cancel ();
+  m_deadlineEvent.Cancel ();
   m_tcp = NULL;
 }
 
 bool
-TcpResequenceBuffer::PutInTheInOrderQueue (const TcpResequenceBufferElement &element)
+TcpResequenceBuffer::GetSlot (SequenceNumber32 seq, uint32_t &slot) const
 {
-  if (m_nextSeq == SequenceNumber32 (0) // For the fist packet
-        || m_nextSeq == element.m_seq)
+  int32_t offset = seq - m_firstSeq;
+  if (offset < 0 || offset % m_segmentSize != 0)
   {
-    m_inOrderQueue.push_back (element);
-    m_size += element.m_dataSize;
-    m_nextSeq = TcpResequenceBuffer::CalculateNextSeq (element);
-    if (m_nextSeq == SequenceNumber32 (0))
-    {
-      m_firstSeq = element.m_seq;
-    }
-    return true;
+    return false;
   }
-  else
+  uint32_t index = offset / m_segmentSize;
+  if (index >= m_slots)
   {
     return false;
   }
+  slot = (m_headSlot + index) % m_slots;
+  return true;
+}
+
+bool
+TcpResequenceBuffer::IsOccupied (uint32_t slot) const
+{
+  return (m_occupancy[slot >> 5] >> (slot & 31)) & 1;
+}
+
+void
+TcpResequenceBuffer::SetOccupied (uint32_t slot)
+{
+  m_occupancy[slot >> 5] |= (1u << (slot & 31));
+}
+
+void
+TcpResequenceBuffer::ClearOccupied (uint32_t slot)
+{
+  m_occupancy[slot >> 5] &= ~(1u << (slot & 31));
+}
+
+void
+TcpResequenceBuffer::PutInTheInOrderQueue (uint32_t slot, const TcpResequenceBufferElement &element)
+{
+  if (&m_window[slot] != &element)
+  {
+    m_window[slot] = element;
+  }
+  TcpResequenceBuffer::SetOccupied (slot);
+  m_inOrderCount++;
+  m_size += element.m_dataSize;
+  m_nextSeq = TcpResequenceBuffer::CalculateNextSeq (element);
 }
 
 SequenceNumber32
@@ -258,34 +364,64 @@ TcpResequenceBuffer::CalculateNextSeq (const TcpResequenceBufferElement &element
 }
 
 void
-TcpResequenceBuffer::PeriodicalCheck ()
+TcpResequenceBuffer::ArmDeadline (void)
 {
   if (m_hasStopped)
   {
     return;
   }
 
-  if (Simulator::Now () - m_inOrderQueueTimer > m_inOrderQueueTimerLimit)
+  if (m_inOrderCount == 0 && m_outOrderCount == 0)
   {
-    FlushInOrderQueue (IN_ORDER_TIMEOUT);
-    m_firstSeq = m_nextSeq;
+    NS_LOG_LOGIC ("Turn the deadline timer into idle status");
+    m_deadlineEvent.Cancel ();
+    return;
   }
 
-  if (Simulator::Now () - m_outOrderQueueTimer > m_outOrderQueueTimerLimit)
+  Time deadline = Time::Max ();
+  if (m_inOrderCount > 0)
   {
-    FlushInOrderQueue (OUT_ORDER_TIMEOUT);
-    FlushOutOrderQueue (OUT_ORDER_TIMEOUT);
-    m_firstSeq = m_nextSeq;
+    deadline = m_inOrderQueueTimer + m_inOrderQueueTimerLimit;
+  }
+  if (m_outOrderCount > 0)
+  {
+    deadline = std::min (deadline, m_outOrderQueueTimer + m_outOrderQueueTimerLimit);
   }
+  Time delay = std::max (deadline - Simulator::Now (), Time (0));
 
-  if (!m_inOrderQueue.empty () || !m_outOrderQueue.empty ())
+  if (m_deadlineEvent.IsRunning ())
   {
-    m_checkEvent = Simulator::Schedule (m_periodicalCheckTime, &TcpResequenceBuffer::PeriodicalCheck, this);
+    if (Simulator::GetDelayLeft (m_deadlineEvent) <= delay)
+    {
+      return;
+    }
+    m_deadlineEvent.Cancel ();
   }
-  else
+  m_deadlineEvent = Simulator::Schedule (delay, &TcpResequenceBuffer::DeadlineExpired, this);
+}
+
+void
+TcpResequenceBuffer::DeadlineExpired (void)
+{
+  if (m_hasStopped)
+  {
+    return;
+  }
+
+  if (m_inOrderCount > 0
+      && Simulator::Now () - m_inOrderQueueTimer >= m_inOrderQueueTimerLimit)
   {
-	NS_LOG_LOGIC ("Turn the periodical check into idle status");
+    FlushInOrderQueue (IN_ORDER_TIMEOUT);
+  }
+
+  if (m_outOrderCount > 0
+      && Simulator::Now () - m_outOrderQueueTimer >= m_outOrderQueueTimerLimit)
+  {
+    FlushInOrderQueue (OUT_ORDER_TIMEOUT);
+    FlushOutOrderQueue (OUT_ORDER_TIMEOUT);
   }
+
+  ArmDeadline ();
 }
 
 void
@@ -296,31 +432,44 @@ TcpResequenceBuffer::FlushOneElement (const TcpResequenceBufferElement &element,
     return;
   }
   NS_LOG_INFO ("Flush packet: " << element.m_packet);
-  m_tcpRBFlush (m_traceFlowId, Simulator::Now (), element.m_seq, m_inOrderQueue.size (),
-          m_outOrderQueue.size (), reason);
-  m_tcp->DoForwardUp (element.m_packet, element.m_fromAddress, element.m_toAddress);
+  m_tcpRBFlush (m_traceFlowId, Simulator::Now (), element.m_seq, m_inOrderCount,
+          m_outOrderCount, reason);
+  m_tcp->DoForwardUp (element.m_packet, m_fromAddress, m_toAddress);
 }
 
 void
 TcpResequenceBuffer::FlushInOrderQueue (TcpRBPopReason reason)
 {
   NS_LOG_FUNCTION (this);
-  // Flush the data
-  std::vector<TcpResequenceBufferElement>::iterator itr = m_inOrderQueue.begin ();
 
-  for ( ; itr != m_inOrderQueue.end (); ++itr)
+  if (m_inOrderCount > 0)
   {
-    if (m_hasStopped)
+    // A run ending with a short segment shifts the window off the MSS grid,
+    // the held out of order segments can not be indexed from it any more
+    bool aligned = (m_nextSeq - m_firstSeq) % m_segmentSize == 0;
+
+    // Flush the data
+    uint32_t count = m_inOrderCount;
+    for (uint32_t i = 0; i < count; ++i)
     {
-      break;
+      uint32_t slot = (m_headSlot + i) % m_slots;
+      TcpResequenceBufferElement element = m_window[slot];
+      m_window[slot].m_packet = 0;
+      TcpResequenceBuffer::ClearOccupied (slot);
+      m_inOrderCount--;
+      TcpResequenceBuffer::FlushOneElement (element, reason);
     }
-    TcpResequenceBuffer::FlushOneElement (*itr, reason);
-  }
 
-  m_inOrderQueue.clear ();
+    // Reset variables
+    m_headSlot = (m_headSlot + count) % m_slots;
+    m_firstSeq = m_nextSeq;
+    m_size = 0;
 
-  // Reset variables
-  m_size = 0;
+    if (!aligned && m_outOrderCount > 0)
+    {
+      TcpResequenceBuffer::FlushOutOrderQueue (reason);
+    }
+  }
 
   // Reset timer
   m_inOrderQueueTimer = Simulator::Now ();
@@ -330,17 +479,39 @@ void
 TcpResequenceBuffer::FlushOutOrderQueue (TcpRBPopReason reason)
 {
   NS_LOG_FUNCTION (this);
-  // Flush the data
-  while (!m_outOrderQueue.empty ())
+  NS_ASSERT (m_inOrderCount == 0);
+
+  // Flush the data in sequence order, skipping empty words of the bitmap
+  uint32_t index = 0;
+  while (m_outOrderCount > 0 && index < m_slots)
   {
-    if (m_hasStopped)
+    uint32_t slot = (m_headSlot + index) % m_slots;
+    if ((slot & 31) == 0 && m_occupancy[slot >> 5] == 0)
     {
-      break;
+      index += 32;
+      continue;
     }
-    TcpResequenceBuffer::FlushOneElement (m_outOrderQueue.top (), reason);
-    m_outOrderQueue.pop ();
+    if (TcpResequenceBuffer::IsOccupied (slot))
+    {
+      TcpResequenceBufferElement element = m_window[slot];
+      m_window[slot].m_packet = 0;
+      TcpResequenceBuffer::ClearOccupied (slot);
+      m_outOrderCount--;
+      SequenceNumber32 elementNextSeq = TcpResequenceBuffer::CalculateNextSeq (element);
+      if (m_nextSeq < elementNextSeq)
+      {
+        m_nextSeq = elementNextSeq;
+      }
+      TcpResequenceBuffer::FlushOneElement (element, reason);
+    }
+    ++index;
   }
-  m_outOrderSeqSet.clear ();
+  NS_ASSERT (m_outOrderCount == 0 || m_hasStopped);
+  m_outOrderCount = 0;
+
+  // The window is empty, anchor it on the next expected segment
+  m_firstSeq = m_nextSeq;
+  m_headSlot = 0;
 
   // Reset the timer
   m_outOrderQueueTimer = Simulator::Now ();
@@ -10,8 +10,6 @@
 #include "ns3/traced-value.h"
 
 #include <vector>
-#include <queue>
-#include <set>
 
 namespace ns3
 {
@@ -21,7 +19,8 @@ enum TcpRBPopReason
   IN_ORDER_FULL = 0,
   IN_ORDER_TIMEOUT,
   OUT_ORDER_TIMEOUT,
-  RE_TRANS
+  RE_TRANS,
+  OUT_OF_WINDOW
 };
 
 class TcpSocketBase;
@@ -39,17 +38,26 @@ public:
   uint32_t m_dataSize; // In bytes
 
   Ptr<Packet> m_packet;
-
-  Address m_fromAddress;
-
-  Address m_toAddress;
-
-  friend inline bool operator > (const TcpResequenceBufferElement &l, const TcpResequenceBufferElement &r)
-  {
-    return l.m_seq > r.m_seq;
-  }
 };
 
+/**
+ * \brief Receive side resequencing buffer for packet spraying schemes
+ *
+ * Segments are held in a circular window indexed by (seq - firstSeq) / MSS,
+ * with one occupancy bit per slot. The window holds an in-order run
+ * [firstSeq, nextSeq) that is released as a batch when it grows beyond
+ * SizeLimit or gets older than InOrderQueueTimerLimit, followed by
+ * out-of-order segments that are released when no progress is made for
+ * OutOrderQueueTimerLimit. Both deadlines share a single timer, which is
+ * only scheduled while the buffer holds data.
+ *
+ * Segments that do not fit the window (SYN/FIN, segments not aligned on the
+ * MSS or too far ahead) release everything held and are forwarded right away,
+ * leaving the reassembly to the TcpRxBuffer.
+ *
+ * The MSS is the largest data segment received so far, not the segment size
+ * of the receiving socket, so that the sender may use another one.
+ */
 class TcpResequenceBuffer : public Object
 {
 
@@ -74,10 +82,23 @@ public:
 
 private:
 
-  bool PutInTheInOrderQueue (const TcpResequenceBufferElement &element);
   SequenceNumber32 CalculateNextSeq (const TcpResequenceBufferElement &element);
 
-  void PeriodicalCheck ();
+  /**
+   * \brief Get the window slot of a sequence number
+   * \param seq the sequence number
+   * \param slot the slot index, if any
+   * \returns false if the sequence number cannot be held in the window
+   */
+  bool GetSlot (SequenceNumber32 seq, uint32_t &slot) const;
+  bool IsOccupied (uint32_t slot) const;
+  void SetOccupied (uint32_t slot);
+  void ClearOccupied (uint32_t slot);
+
+  void PutInTheInOrderQueue (uint32_t slot, const TcpResequenceBufferElement &element);
+
+  void ArmDeadline (void);
+  void DeadlineExpired (void);
 
   void FlushOneElement (const TcpResequenceBufferElement &element, TcpRBPopReason reason);
   void FlushInOrderQueue (TcpRBPopReason reason);
@@ -89,28 +110,34 @@ private:
   Time m_inOrderQueueTimerLimit;
   Time m_outOrderQueueTimerLimit;
 
-  Time m_periodicalCheckTime;
+  uint32_t m_windowSize;            //!< Number of segments the window can hold
+  Time m_periodicalCheckTime;       //!< Deprecated, ignored
 
   uint32_t m_traceFlowId;
 
   // Variables
-  uint32_t m_size;
+  uint32_t m_size;                  //!< Bytes in the in order run
   Time m_inOrderQueueTimer;
   Time m_outOrderQueueTimer;
 
-  EventId m_checkEvent;
+  EventId m_deadlineEvent;
   bool m_hasStopped;
+  bool m_hasStarted;                //!< Whether the first data segment has been seen
 
   SequenceNumber32 m_firstSeq;
   SequenceNumber32 m_nextSeq;
 
-  std::vector<TcpResequenceBufferElement> m_inOrderQueue;
+  uint32_t m_segmentSize;           //!< Stride of the window, in bytes
+  uint32_t m_slots;                 //!< m_windowSize rounded up to a multiple of 32
+  uint32_t m_headSlot;              //!< Slot of m_firstSeq
+  uint32_t m_inOrderCount;          //!< Segments in the in order run
+  uint32_t m_outOrderCount;         //!< Segments held beyond m_nextSeq
 
-  std::priority_queue<TcpResequenceBufferElement,
-      std::vector<TcpResequenceBufferElement>,
-      std::greater<TcpResequenceBufferElement> > m_outOrderQueue;
+  std::vector<TcpResequenceBufferElement> m_window; //!< Held segments
+  std::vector<uint32_t> m_occupancy;                //!< One bit per slot
 
-  std::set<SequenceNumber32> m_outOrderSeqSet;
+  Address m_fromAddress;            //!< Peer address of the connection
+  Address m_toAddress;              //!< Local address of the connection
 
   TcpSocketBase *m_tcp;
 
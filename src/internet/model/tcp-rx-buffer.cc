@@ -143,7 +143,8 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   NS_LOG_FUNCTION (this << p << tcph);
 
   uint32_t pktSize = p->GetSize ();
-  SequenceNumber32 headSeq = tcph.GetSequenceNumber ();
+  SequenceNumber32 pktSeq = tcph.GetSequenceNumber ();
+  SequenceNumber32 headSeq = pktSeq;
   SequenceNumber32 tailSeq = headSeq + SequenceNumber32 (pktSize);
   NS_LOG_LOGIC ("Add pkt " << p << " len=" << pktSize << " seq=" << headSeq
                            << ", when NextRxSeq=" << m_nextRxSeq << ", buffsize=" << m_size);
@@ -154,63 +155,93 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
     {
       SequenceNumber32 maxSeq = m_data.begin ()->first + SequenceNumber32 (m_maxBuffer);
       if (maxSeq < tailSeq) tailSeq = maxSeq;
-      if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end () && i->first <= tailSeq)
+  if (headSeq >= tailSeq)
     {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      if (lastByteSeq > headSeq)
+      NS_LOG_LOGIC ("Nothing to buffer");
+      return false; // Nothing to buffer anyway
+    }
+
+  // Find the block the incoming data starts in, or is adjacent to
+  BufIterator i = m_data.upper_bound (headSeq);
+  BufIterator block = m_data.end ();
+  SequenceNumber32 cursor = headSeq; // First byte not yet covered
+  if (i != m_data.begin ())
+    {
+      BufIterator prev = i;
+      --prev;
+      SequenceNumber32 prevTail = prev->first + SequenceNumber32 (prev->second->GetSize ());
+      if (prevTail >= headSeq)
         {
-          if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
-              m_data.erase (i++);
-              continue;
+          if (prevTail >= tailSeq)
+            {
+              NS_LOG_LOGIC ("Nothing to buffer");
+              return false; // Incoming data is fully overlapped
             }
-          if (i->first <= headSeq)
-            { // Incoming head is overlapped
-              headSeq = lastByteSeq;
+          block = prev;
+          cursor = prevTail;
+        }
+    }
+
+  // Fill the holes up to tailSeq, absorbing the blocks met on the way
+  Ptr<Packet> merged = (block != m_data.end ()) ? block->second : Ptr<Packet> (0);
+  uint32_t added = 0;
+  while (i != m_data.end () && i->first <= tailSeq)
+    {
+      if (cursor < i->first)
+        {
+          Ptr<Packet> fragment = p->CreateFragment (cursor - pktSeq, i->first - cursor);
+          added += fragment->GetSize ();
+          if (merged == 0)
+            {
+              merged = fragment;
             }
-          if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-              tailSeq = i->first;
+          else
+            {
+              merged->AddAtEnd (fragment);
             }
         }
-      ++i;
+      merged->AddAtEnd (i->second);
+      cursor = i->first + SequenceNumber32 (i->second->GetSize ());
+      m_data.erase (i++);
     }
-  // We now know how much we are going to store, trim the packet
-  if (headSeq >= tailSeq)
+  if (cursor < tailSeq)
     {
-      NS_LOG_LOGIC ("Nothing to buffer");
-      return false; // Nothing to buffer anyway
+      Ptr<Packet> fragment = p->CreateFragment (cursor - pktSeq, tailSeq - cursor);
+      added += fragment->GetSize ();
+      if (merged == 0)
+        {
+          merged = fragment;
+        }
+      else
+        {
+          merged->AddAtEnd (fragment);
+        }
+    }
+
+  if (block == m_data.end ())
+    {
+      NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
+      m_data[headSeq] = merged;
+      m_lastBlock = headSeq;
     }
   else
     {
-      uint32_t start = headSeq - tcph.GetSequenceNumber ();
-      uint32_t length = tailSeq - headSeq;
-      p = p->CreateFragment (start, length);
-      NS_ASSERT (length == p->GetSize ());
+      m_lastBlock = block->first;
     }
-  // Insert packet into buffer
-  NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
-  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
+  NS_LOG_LOGIC ("Buffered " << added << " bytes into block seqno=" << m_lastBlock
+                            << " len=" << merged->GetSize ());
+
   // Update variables
-  m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  m_size += added;      // Occupancy
+  // Blocks are never adjacent, so only the head block can be in sequence
+  BufIterator head = m_data.begin ();
+  SequenceNumber32 nextRxSeq = m_nextRxSeq;
+  SequenceNumber32 headTail = head->first + SequenceNumber32 (head->second->GetSize ());
+  if (head->first <= nextRxSeq && headTail > nextRxSeq)
     {
-      if (i->first < m_nextRxSeq)
-        {
-          continue;
-        }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+      m_availBytes += headTail - nextRxSeq;
+      m_nextRxSeq = headTail;
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -229,40 +260,61 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return 0;  // No contiguous block to return
   NS_ASSERT (m_data.size ()); // At least we have something to extract
-  Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
-  BufIterator i;
-  while (extractSize)
-    { // Check the buffered data for delivery
-      i = m_data.begin ();
-      NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
-      // Check if we send the whole pkt or just a partial
-      uint32_t pktSize = i->second->GetSize ();
-      if (pktSize <= extractSize)
-        { // Whole packet is extracted
-          outPkt->AddAtEnd (i->second);
-          m_data.erase (i);
-          m_size -= pktSize;
-          m_availBytes -= pktSize;
-          extractSize -= pktSize;
-        }
-      else
-        { // Partial is extracted and done
-          outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
-          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
-          m_data.erase (i);
-          m_size -= extractSize;
-          m_availBytes -= extractSize;
-          extractSize = 0;
+  BufIterator i = m_data.begin ();
+  NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
+  uint32_t pktSize = i->second->GetSize ();
+  NS_ASSERT (pktSize == m_availBytes); // the head block is all the available data
+  Ptr<Packet> outPkt; // The packet that contains all the data to return
+  if (pktSize <= extractSize)
+    { // Whole block is extracted
+      outPkt = i->second;
+    }
+  else
+    { // Partial is extracted, the rest stays at the head
+      outPkt = i->second->CreateFragment (0, extractSize);
+      m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
+    }
+  m_data.erase (i);
+  m_size -= extractSize;
+  m_availBytes -= extractSize;
+  NS_LOG_LOGIC ("Extracted " << outPkt->GetSize ( ) << " bytes, bufsize=" << m_size
+                             << ", num blocks in buffer=" << m_data.size ());
+  return outPkt;
+}
+
+TcpRxBuffer::SackList
+TcpRxBuffer::GetSackList (uint32_t maxBlocks) const
+{
+  NS_LOG_FUNCTION (this << maxBlocks);
+
+  SackList sackList;
+  SequenceNumber32 nextRxSeq = m_nextRxSeq;
+  ConstBufIterator last = m_data.find (m_lastBlock);
+  if (last != m_data.end () && last->first > nextRxSeq && maxBlocks > 0)
+    {
+      sackList.push_back (SackBlock (last->first,
+                                     last->first + SequenceNumber32 (last->second->GetSize ())));
+    }
+  for (ConstBufIterator i = m_data.upper_bound (nextRxSeq);
+       i != m_data.end () && sackList.size () < maxBlocks; ++i)
+    {
+      if (i != last)
+        {
+          sackList.push_back (SackBlock (i->first,
+                                         i->first + SequenceNumber32 (i->second->GetSize ())));
         }
     }
-  if (outPkt->GetSize () == 0)
+  return sackList;
+}
+
+uint32_t
+TcpRxBuffer::GetSackListSize (void) const
+{
+  if (m_data.empty ())
     {
-      NS_LOG_LOGIC ("Nothing extracted.");
       return 0;
     }
-  NS_LOG_LOGIC ("Extracted " << outPkt->GetSize ( ) << " bytes, bufsize=" << m_size
-                             << ", num pkts in buffer=" << m_data.size ());
-  return outPkt;
+  return (m_data.begin ()->first <= m_nextRxSeq) ? m_data.size () - 1 : m_data.size ();
 }
 
 } //namepsace ns3
@@ -22,6 +22,7 @@
 #define TCP_RX_BUFFER_H
 
 #include <map>
+#include <list>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/sequence-number.h"
@@ -36,10 +37,27 @@ class Packet;
  *
  * \brief class for the reordering buffer that keeps the data from lower layer, i.e.
  *        TcpL4Protocol, sent to the application
+ *
+ * Received data is kept as a set of disjoint, non-adjacent intervals of the
+ * sequence space, each one stored as a single packet. A new segment is merged
+ * in place with the intervals it overlaps or touches, so that the number of
+ * entries in the buffer is bounded by the number of holes rather than by the
+ * number of segments received. The interval starting at (or before)
+ * NextRxSequence holds all the data available to the application, and the
+ * remaining intervals are exactly the blocks to be reported in a SACK option.
  */
 class TcpRxBuffer : public Object
 {
 public:
+  /**
+   * \brief A block of contiguous data held in the buffer, as [head, tail)
+   */
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SackBlock;
+  /**
+   * \brief List of out-of-order blocks, most recently updated first
+   */
+  typedef std::list<SackBlock> SackList;
+
   /**
    * \brief Get the type ID.
    * \return the object TypeId
@@ -125,16 +143,37 @@ public:
    */
   Ptr<Packet> Extract (uint32_t maxSize);
 
+  /**
+   * \brief Get the out-of-order blocks held in the buffer
+   *
+   * The list follows RFC 2018: the block containing the most recently
+   * received segment comes first, the others follow in sequence order.
+   * At most maxBlocks entries are returned.
+   *
+   * \param maxBlocks maximum number of blocks to return
+   * \returns the list of blocks beyond NextRxSequence
+   */
+  SackList GetSackList (uint32_t maxBlocks = 4) const;
+
+  /**
+   * \brief Get the number of out-of-order blocks held in the buffer
+   * \returns the number of blocks beyond NextRxSequence
+   */
+  uint32_t GetSackListSize (void) const;
+
 private:
   /// container for data stored in the buffer
   typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  /// const iterator for data stored in the buffer
+  typedef std::map<SequenceNumber32, Ptr<Packet> >::const_iterator ConstBufIterator;
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
-  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  SequenceNumber32 m_lastBlock;              //!< Head of the block updated by the last Add
+  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Disjoint blocks of data, keyed by their head seqnum
 };
 
 } //namepsace ns3
@@ -49,6 +49,8 @@
 #include "tcp-header.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-sack.h"
 #include "rtt-estimator.h"
 #include "ipv4-ecn-tag.h"
 #include "ns3/flow-id-tag.h"
@@ -104,6 +106,14 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("Sack", "Enable or disable the SACK option and SACK based loss recovery",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Rack", "Enable or disable RACK time based loss detection (needs Sack)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_rackEnabled),
+                   MakeBooleanChecker ())
     .AddAttribute ("MinRto",
                    "Minimum retransmit timeout value",
                    TimeValue (Seconds (1.0)), // RFC 6298 says min RTO=1 sec, but Linux uses 200ms.
@@ -223,6 +233,11 @@ TcpSocketBase::GetTypeId (void)
                      "Receive tcp packet from IP protocol",
                      MakeTraceSourceAccessor (&TcpSocketBase::m_rxTrace),
                      "ns3::TcpSocketBase::TcpTxRxTracedCallback")
+    .AddTraceSource ("EcnMarkedFraction",
+                     "Fraction of the bytes acknowledged with ECE, "
+                     "at the end of each observation window",
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_markedFractionTrace),
+                     "ns3::TcpSocketBase::MarkedFractionTracedCallback")
   ;
   return tid;
 }
@@ -273,6 +288,17 @@ TcpSocketState::TcpSocketState (void)
 {
 }
 
+TcpEcnAccounting::TcpEcnAccounting ()
+  : m_ackedBytes (0),
+    m_withEce (false),
+    m_windowAcked (0),
+    m_windowMarked (0),
+    m_windowEnd (0),
+    m_windowEnded (false),
+    m_markedFraction (0)
+{
+}
+
 TcpSocketState::TcpSocketState (const TcpSocketState &other)
   : Object (other),
     m_cWnd (other.m_cWnd),
@@ -344,6 +370,14 @@ TcpSocketBase::TcpSocketBase (void)
     m_sndWindShift (0),
     m_timestampEnabled (true),
     m_timestampToEcho (0),
+    m_sackEnabled (false),
+    m_rackEnabled (false),
+    m_rackXmitTs (Seconds (0.0)),
+    m_rackEndSeq (0),
+    m_rackRtt (Seconds (0.0)),
+    m_rackMinRtt (Time::Max ()),
+    m_rackReoWndMult (1),
+    m_rackReoWndPersist (0),
     m_sendPendingDataEvent (),
     m_recover (0), // Set to the initial sequence number
     m_retxThresh (3),
@@ -453,6 +487,14 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_sndWindShift (sock.m_sndWindShift),
     m_timestampEnabled (sock.m_timestampEnabled),
     m_timestampToEcho (sock.m_timestampToEcho),
+    m_sackEnabled (sock.m_sackEnabled),
+    m_rackEnabled (sock.m_rackEnabled),
+    m_rackXmitTs (Seconds (0.0)),
+    m_rackEndSeq (0),
+    m_rackRtt (Seconds (0.0)),
+    m_rackMinRtt (Time::Max ()),
+    m_rackReoWndMult (1),
+    m_rackReoWndPersist (0),
     m_recover (sock.m_recover),
     m_retxThresh (sock.m_retxThresh),
     m_limitedTx (sock.m_limitedTx),
@@ -1392,6 +1434,11 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
           m_timestampEnabled = false;
         }
 
+      if (!tcpHeader.HasOption (TcpOption::SACKPERMITTED))
+        {
+          m_sackEnabled = false;
+        }
+
       // Initialize cWnd and ssThresh
       m_tcb->m_cWnd = GetInitialCwnd () * GetSegSize ();
       m_tcb->m_ssThresh = GetInitialSSThresh ();
@@ -1639,6 +1686,8 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
   {
     withECE = true;
   }
+  m_tcb->m_ecn.m_ackedBytes = bytesAcked;
+  m_tcb->m_ecn.m_withEce = withECE;
 
   // XXX TLB Support
   if (m_TLBEnabled && m_TLBSendSide)
@@ -1652,7 +1701,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         Ptr<Ipv4TLB> ipv4TLB = m_node->GetObject<Ipv4TLB> ();
         m_pathAcked = tcpTLBTag.GetPath ();
         // std::cout << this << " Path acked: " << m_pathAcked << std::endl;
-        ipv4TLB->FlowRecv (flowId, m_pathAcked, m_endPoint->GetPeerAddress (), bytesAcked, withECE, tcpTLBTag.GetTime ());
+        ipv4TLB->FlowRecv (flowId, m_pathAcked, m_endPoint->GetPeerAddress (), m_tcb->m_ecn.m_ackedBytes, m_tcb->m_ecn.m_withEce, tcpTLBTag.GetTime ());
     }
   }
 
@@ -1669,9 +1718,13 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
     }
   }
 
-  if (ackNumber == m_txBuffer->HeadSequence ()
-      && ackNumber < m_nextTxSequence
-      && packet->GetSize () == 0)
+  if (m_sackEnabled)
+    {
+      ReceivedSackAck (packet, tcpHeader, segsAcked, withECE);
+    }
+  else if (ackNumber == m_txBuffer->HeadSequence ()
+           && ackNumber < m_nextTxSequence
+           && packet->GetSize () == 0)
     {
       // There is a DupAck
       ++m_dupAckCount;
@@ -1729,13 +1782,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
 
       // Artificially call PktsAcked. After all, one segment has been ACKed.
-      m_congestionControl->PktsAcked (m_tcb, 1, m_lastRtt, withECE, m_highTxMark, ackNumber);
-
-      // XXX FlowBender
-      if (m_flowBenderEnabled)
-      {
-        m_flowBender->ReceivedPacket (m_highTxMark, ackNumber, m_tcb->m_segmentSize, withECE);
-      }
+      NotifyPktsAcked (1, ackNumber);
 
     }
   else if (ackNumber == m_txBuffer->HeadSequence ()
@@ -1771,12 +1818,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 
       if (m_tcb->m_congState == TcpSocketState::CA_OPEN)
         {
-            m_congestionControl->PktsAcked (m_tcb, segsAcked, m_lastRtt, withECE, m_highTxMark, ackNumber);
-            // XXX FlowBender
-            if (m_flowBenderEnabled)
-            {
-              m_flowBender->ReceivedPacket (m_highTxMark, ackNumber, m_tcb->m_segmentSize * segsAcked, withECE);
-            }
+            NotifyPktsAcked (segsAcked, ackNumber);
         }
       // XXX After the CWR has been acked, the CA_CWR exits
       else if (m_tcb->m_congState == TcpSocketState::CA_CWR)
@@ -1790,12 +1832,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
           m_dupAckCount = 0;
           m_retransOut = 0;
 
-          m_congestionControl->PktsAcked(m_tcb, segsAcked, m_lastRtt, withECE, m_highTxMark, ackNumber);
-          // XXX FlowBender
-          if (m_flowBenderEnabled)
-          {
-              m_flowBender->ReceivedPacket (m_highTxMark, ackNumber, m_tcb->m_segmentSize * segsAcked, withECE);
-          }
+          NotifyPktsAcked (segsAcked, ackNumber);
 
         }
       else if (m_tcb->m_congState == TcpSocketState::CA_DISORDER)
@@ -1803,12 +1840,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
           // The network reorder packets. Linux changes the counting lost
           // packet algorithm from FACK to NewReno. We simply go back in Open.
           m_tcb->m_congState = TcpSocketState::CA_OPEN;
-          m_congestionControl->PktsAcked (m_tcb, segsAcked, m_lastRtt, withECE, m_highTxMark, ackNumber);
-          // XXX FlowBender
-          if (m_flowBenderEnabled)
-          {
-              m_flowBender->ReceivedPacket (m_highTxMark, ackNumber, m_tcb->m_segmentSize * segsAcked, withECE);
-          }
+          NotifyPktsAcked (segsAcked, ackNumber);
 
           m_dupAckCount = 0;
           m_retransOut = 0;
@@ -1861,12 +1893,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
                * previously lost and now successfully received. All others have
                * been processed when they come under the form of dupACKs
                */
-              m_congestionControl->PktsAcked (m_tcb, 1, m_lastRtt, withECE, m_highTxMark, ackNumber);
-              // XXX FlowBender
-              if (m_flowBenderEnabled)
-              {
-                  m_flowBender->ReceivedPacket (m_highTxMark, ackNumber, m_tcb->m_segmentSize, withECE);
-              }
+              NotifyPktsAcked (1, ackNumber);
 
               NS_LOG_INFO ("Partial ACK for seq " << ackNumber <<
                            " in fast recovery: cwnd set to " << m_tcb->m_cWnd <<
@@ -1886,12 +1913,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
                * been processed when they come under the form of dupACKs,
                * except the (maybe) new ACKs which come from a new window
                */
-              m_congestionControl->PktsAcked (m_tcb, segsAcked, m_lastRtt, withECE, m_highTxMark, ackNumber);
-              // XXX FlowBender
-              if (m_flowBenderEnabled)
-              {
-                m_flowBender->ReceivedPacket (m_highTxMark, ackNumber, m_tcb->m_segmentSize * segsAcked, withECE);
-              }
+              NotifyPktsAcked (segsAcked, ackNumber);
 
               newSegsAcked = (ackNumber - m_recover) / m_tcb->m_segmentSize;
               m_tcb->m_congState = TcpSocketState::CA_OPEN;
@@ -1905,12 +1927,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         {
           // Go back in OPEN state
           m_isFirstPartialAck = true;
-          m_congestionControl->PktsAcked (m_tcb, segsAcked, m_lastRtt, withECE, m_highTxMark, ackNumber);
-          // XXX FlowBender
-          if (m_flowBenderEnabled)
-          {
-            m_flowBender->ReceivedPacket (m_highTxMark, ackNumber, m_tcb->m_segmentSize * segsAcked, withECE);
-          }
+          NotifyPktsAcked (segsAcked, ackNumber);
 
           m_dupAckCount = 0;
           m_retransOut = 0;
@@ -1953,6 +1970,233 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
     }
 }
 
+/* Process an ACK when SACK has been negotiated: the scoreboard in the Tx
+ * buffer drives the loss recovery (RFC 6675), possibly with RACK (RFC 8985)
+ * in place of the duplicate ACK threshold. */
+void
+TcpSocketBase::ReceivedSackAck (Ptr<Packet> packet, const TcpHeader& tcpHeader,
+                                uint32_t segsAcked, bool withECE)
+{
+  NS_LOG_FUNCTION (this << tcpHeader);
+
+  SequenceNumber32 ackNumber = tcpHeader.GetAckNumber ();
+  TcpOptionSack::SackList sackList;
+  if (tcpHeader.HasOption (TcpOption::SACK))
+    {
+      Ptr<const TcpOptionSack> sack = DynamicCast<const TcpOptionSack> (tcpHeader.GetOption (TcpOption::SACK));
+      sackList = sack->GetSackList ();
+    }
+
+  TcpTxItem delivered;
+  uint32_t newlySacked = m_txBuffer->UpdateScoreboard (ackNumber, sackList, &delivered);
+  if (m_rackEnabled && delivered.m_size > 0)
+    {
+      RackUpdate (delivered);
+    }
+
+  if (ackNumber == m_txBuffer->HeadSequence ())
+    {
+      if (ackNumber < m_nextTxSequence && packet->GetSize () == 0)
+        {
+          // There is a DupAck, the window it opens is accounted in the pipe
+          ++m_dupAckCount;
+          if (m_tcb->m_congState == TcpSocketState::CA_OPEN)
+            {
+              m_tcb->m_congState = TcpSocketState::CA_DISORDER;
+              NS_LOG_DEBUG ("OPEN -> DISORDER");
+            }
+
+          NS_LOG_LOGIC (m_dupAckCount << " dupack, " << newlySacked << " bytes newly SACKed");
+          NotifyPktsAcked (1, ackNumber);
+        }
+    }
+  else
+    { // New ACK, see ReceivedAck for the accounting of segsAcked
+      bool callCongestionControl = true;
+      if (segsAcked > m_dupAckCount)
+        {
+          segsAcked -= m_dupAckCount;
+        }
+      else
+        {
+          segsAcked = 1;
+        }
+      m_dupAckCount = 0;
+
+      if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
+        {
+          callCongestionControl = false;
+          if (ackNumber >= m_recover)
+            {
+              m_tcb->m_cWnd = m_tcb->m_ssThresh.Get ();
+              m_tcb->m_congState = TcpSocketState::CA_OPEN;
+              m_retransOut = 0;
+              NS_LOG_INFO ("Received full ACK for seq " << ackNumber <<
+                           ". Leaving fast recovery with cwnd set to " << m_tcb->m_cWnd);
+              NS_LOG_DEBUG ("RECOVERY -> OPEN");
+            }
+        }
+      else if (m_tcb->m_congState == TcpSocketState::CA_LOSS)
+        {
+          if (ackNumber >= m_recover)
+            {
+              m_tcb->m_congState = TcpSocketState::CA_OPEN;
+              m_retransOut = 0;
+              NS_LOG_DEBUG ("LOSS -> OPEN");
+            }
+        }
+      else if (m_tcb->m_congState == TcpSocketState::CA_CWR)
+        {
+          if (m_tcb->m_sentCWR && ackNumber > m_tcb->m_CWRSentSeq)
+            {
+              NS_LOG_DEBUG ("CA_CWR -> OPEN");
+              m_tcb->m_congState = TcpSocketState::CA_OPEN;
+              m_tcb->m_sentCWR = false;
+            }
+        }
+      else if (m_tcb->m_congState == TcpSocketState::CA_DISORDER
+               && m_txBuffer->GetSackedOut () == 0)
+        {
+          m_tcb->m_congState = TcpSocketState::CA_OPEN;
+          NS_LOG_DEBUG ("DISORDER -> OPEN");
+        }
+
+      NotifyPktsAcked (segsAcked, ackNumber);
+
+      if (callCongestionControl)
+        {
+          m_congestionControl->IncreaseWindow (m_tcb, segsAcked);
+        }
+
+      // Reset the data retransmission count. We got a new ACK!
+      m_dataRetrCount = m_dataRetries;
+      NewAck (ackNumber, true);
+    }
+
+  DetectLoss ();
+  if (m_txBuffer->GetLostOut () > 0
+      && (m_tcb->m_congState == TcpSocketState::CA_OPEN
+          || m_tcb->m_congState == TcpSocketState::CA_DISORDER
+          || m_tcb->m_congState == TcpSocketState::CA_CWR))
+    {
+      EnterSackRecovery ();
+    }
+
+  // Try to send lost segments and new data
+  if (!m_sendPendingDataEvent.IsRunning ())
+    {
+      m_sendPendingDataEvent = Simulator::Schedule (TimeStep (1),
+                                                    &TcpSocketBase::SendPendingData,
+                                                    this, m_connected);
+    }
+}
+
+void
+TcpSocketBase::RackUpdate (const TcpTxItem &item)
+{
+  NS_LOG_FUNCTION (this << item.m_seq);
+
+  Time rtt = Simulator::Now () - item.m_lastSent;
+  if (!item.m_retrans)
+    {
+      m_rackMinRtt = Min (m_rackMinRtt, rtt);
+    }
+  else if (m_rackMinRtt != Time::Max () && rtt < m_rackMinRtt)
+    { // Too quick to be the retransmission: the original was delivered and
+      // the retransmission was spurious, widen the reordering window (up to
+      // 255 steps, as Linux does with reo_wnd_steps)
+      if (m_rackReoWndMult < 0xff)
+        {
+          ++m_rackReoWndMult;
+        }
+      m_rackReoWndPersist = 16;
+      return;
+    }
+
+  m_rackRtt = rtt;
+  if (item.m_lastSent > m_rackXmitTs
+      || (item.m_lastSent == m_rackXmitTs && item.GetEndSequence () > m_rackEndSeq))
+    {
+      m_rackXmitTs = item.m_lastSent;
+      m_rackEndSeq = item.GetEndSequence ();
+    }
+}
+
+uint32_t
+TcpSocketBase::DetectLoss (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_rackEnabled)
+    {
+      return m_txBuffer->MarkLostByDupThresh (m_retxThresh, m_tcb->m_segmentSize);
+    }
+
+  if (m_rackRtt.IsZero ())
+    {
+      return 0; // Nothing delivered yet
+    }
+
+  // Reordering window in quarters of the minimum RTT, capped to the SRTT;
+  // only retransmissions may have been delivered so far
+  Time minRtt = m_rackMinRtt == Time::Max () ? m_rtt->GetEstimate () : m_rackMinRtt;
+  Time reoWnd = Min (minRtt / 4 * m_rackReoWndMult, m_rtt->GetEstimate ());
+  Time timeout;
+  uint32_t lost = m_txBuffer->MarkLostByRack (m_rackXmitTs, m_rackEndSeq, m_rackRtt,
+                                              reoWnd, Simulator::Now (), &timeout);
+  m_rackTimer.Cancel ();
+  if (timeout.IsStrictlyPositive ())
+    {
+      m_rackTimer = Simulator::Schedule (timeout, &TcpSocketBase::RackTimeout, this);
+    }
+
+  NS_LOG_LOGIC ("RACK marked " << lost << " bytes lost, reordering window " << reoWnd);
+  return lost;
+}
+
+void
+TcpSocketBase::RackTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (DetectLoss () == 0)
+    {
+      return;
+    }
+
+  if (m_tcb->m_congState == TcpSocketState::CA_OPEN
+      || m_tcb->m_congState == TcpSocketState::CA_DISORDER
+      || m_tcb->m_congState == TcpSocketState::CA_CWR)
+    {
+      EnterSackRecovery ();
+    }
+  SendPendingData (m_connected);
+}
+
+void
+TcpSocketBase::EnterSackRecovery (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_DEBUG (TcpSocketState::TcpCongStateName[m_tcb->m_congState] <<
+                " -> RECOVERY");
+
+  // RFC 6675: ssthresh = cwnd = FlightSize / 2, no window inflation
+  m_recover = m_highTxMark;
+  m_tcb->m_congState = TcpSocketState::CA_RECOVERY;
+  m_tcb->m_ssThresh = m_congestionControl->GetSsThresh (m_tcb, UnAckDataCount ());
+
+  // Fall back to the initial reordering window after 16 recoveries
+  if (m_rackReoWndPersist > 0 && --m_rackReoWndPersist == 0)
+    {
+      m_rackReoWndMult = 1;
+    }
+  m_tcb->m_cWnd = m_tcb->m_ssThresh.Get ();
+
+  NS_LOG_INFO ("Enter SACK recovery with " << m_txBuffer->GetLostOut () <<
+               " bytes lost. Reset cwnd to " << m_tcb->m_cWnd << ", ssthresh to " <<
+               m_tcb->m_ssThresh << " at fast recovery seqnum " << m_recover);
+}
+
 /* Received a packet upon LISTEN state. */
 void
 TcpSocketBase::ProcessListen (Ptr<Packet> packet, const TcpHeader& tcpHeader,
@@ -3056,6 +3300,10 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
     }
 
   UpdateRttHistory (seq, sz, isRetransmission);
+  if (m_sackEnabled && sz > 0)
+    {
+      m_txBuffer->RecordTransmission (seq, sz, Simulator::Now ());
+    }
 
   // Notify the application of the data being sent unless this is a retransmit
   if (seq + sz > m_highTxMark)
@@ -3109,6 +3357,22 @@ TcpSocketBase::SendPendingData (bool withAck)
       return false; // Is this the right way to handle this condition?
     }
   uint32_t nPacketsSent = 0;
+  if (m_sackEnabled)
+    {
+      // Retransmit the segments deemed lost before any new data (RFC 6675 NextSeg)
+      SequenceNumber32 lostSeq;
+      uint32_t lostSize;
+      while (AvailableWindow () >= m_tcb->m_segmentSize
+             && m_txBuffer->NextLost (&lostSeq, &lostSize))
+        {
+          NS_LOG_LOGIC ("Retransmitting lost segment " << lostSeq);
+          if (SendDataPacket (lostSeq, std::min (lostSize, m_tcb->m_segmentSize), withAck) == 0)
+            {
+              break;
+            }
+          nPacketsSent++;
+        }
+    }
   while (m_txBuffer->SizeFromSequence (m_nextTxSequence))
     {
       uint32_t w = AvailableWindow (); // Get available window size
@@ -3176,7 +3440,13 @@ TcpSocketBase::BytesInFlight ()
   uint32_t duplicatedSize;
   uint32_t bytesInFlight;
 
-  if (m_retransOut > m_dupAckCount)
+  if (m_sackEnabled)
+    {
+      // RFC 6675 pipe: SACKed and lost segments have left the network
+      bytesInFlight = SafeSubtraction (flightSize, m_txBuffer->GetSackedOut () +
+                                       m_txBuffer->GetLostOut ());
+    }
+  else if (m_retransOut > m_dupAckCount)
     {
       duplicatedSize = (m_retransOut - m_dupAckCount)*m_tcb->m_segmentSize;
       bytesInFlight = flightSize + duplicatedSize;
@@ -3211,6 +3481,11 @@ TcpSocketBase::AvailableWindow () const
   uint32_t unack = UnAckDataCount (); // Number of outstanding bytes
   uint32_t win = Window ();           // Number of bytes allowed to be outstanding
 
+  if (m_sackEnabled)
+    { // Only the pipe counts against the window during SACK recovery
+      unack = SafeSubtraction (unack, m_txBuffer->GetSackedOut () + m_txBuffer->GetLostOut ());
+    }
+
   NS_LOG_DEBUG ("UnAckCount=" << unack << ", Win=" << win);
   return (win < unack) ? 0 : (win - unack);
 }
@@ -3610,7 +3885,15 @@ TcpSocketBase::Retransmit ()
       m_tcb->m_cWnd = m_tcb->m_segmentSize;
     }
 
-  m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
+  if (m_sackEnabled)
+    { // Keep what has been SACKed, resend everything else
+      m_txBuffer->MarkAllLost ();
+      m_rackTimer.Cancel ();
+    }
+  else
+    {
+      m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
+    }
   m_dupAckCount = 0;
 
   NS_LOG_DEBUG ("RTO. Reset cwnd to " <<  m_tcb->m_cWnd << ", ssthresh to " <<
@@ -3659,13 +3942,19 @@ TcpSocketBase::DoRetransmit ()
     }
 
   // Retransmit a data packet: Call SendDataPacket
-  uint32_t sz = SendDataPacket (m_txBuffer->HeadSequence (), m_tcb->m_segmentSize, true);
+  SequenceNumber32 seq = m_txBuffer->HeadSequence ();
+  uint32_t size = m_tcb->m_segmentSize;
+  if (m_sackEnabled && m_txBuffer->NextLost (&seq, &size))
+    {
+      size = std::min (size, m_tcb->m_segmentSize);
+    }
+  uint32_t sz = SendDataPacket (seq, size, true);
   ++m_retransOut;
 
   // In case of RTO, advance m_nextTxSequence
-  m_nextTxSequence = std::max (m_nextTxSequence.Get (), m_txBuffer->HeadSequence () + sz);
+  m_nextTxSequence = std::max (m_nextTxSequence.Get (), seq + sz);
 
-  NS_LOG_DEBUG ("retxing seq " << m_txBuffer->HeadSequence ());
+  NS_LOG_DEBUG ("retxing seq " << seq);
 }
 
 void
@@ -3677,6 +3966,7 @@ TcpSocketBase::CancelAllTimers ()
   m_lastAckEvent.Cancel ();
   m_timewaitEvent.Cancel ();
   m_sendPendingDataEvent.Cancel ();
+  m_rackTimer.Cancel ();
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -3865,6 +4155,18 @@ TcpSocketBase::AddOptions (TcpHeader& header)
     {
       AddOptionTimestamp (header);
     }
+
+  if (m_sackEnabled)
+    {
+      if (header.GetFlags () & TcpHeader::SYN)
+        {
+          header.AppendOption (CreateObject<TcpOptionSackPermitted> ());
+        }
+      else if (m_rxBuffer->GetSackListSize () > 0)
+        {
+          AddOptionSack (header);
+        }
+    }
 }
 
 void
@@ -3964,6 +4266,26 @@ TcpSocketBase::AddOptionTimestamp (TcpHeader& header)
                option->GetTimestamp () << " echo=" << m_timestampToEcho);
 }
 
+void
+TcpSocketBase::AddOptionSack (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+
+  uint32_t room = header.GetMaxOptionLength () - header.GetOptionLength ();
+  if (room < TcpOptionSack::GetSizeForBlocks (1))
+    {
+      return;
+    }
+  uint32_t maxBlocks = (room - TcpOptionSack::GetSizeForBlocks (0)) / 8;
+
+  Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack> ();
+  option->SetSackList (m_rxBuffer->GetSackList (maxBlocks));
+
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK with " <<
+               option->GetNumSackBlocks () << " blocks");
+}
+
 void TcpSocketBase::UpdateWindowSize (const TcpHeader &header)
 {
   NS_LOG_FUNCTION (this << header);
@@ -4052,6 +4374,37 @@ TcpSocketBase::GetResequenceBuffer (void) const
   return m_resequenceBuffer;
 }
 
+void
+TcpSocketBase::NotifyPktsAcked (uint32_t segsAcked, SequenceNumber32 ackNumber)
+{
+  NS_LOG_FUNCTION (this << segsAcked << ackNumber);
+  TcpEcnAccounting &ecn = m_tcb->m_ecn;
+  uint32_t bytes = segsAcked * m_tcb->m_segmentSize;
+  ecn.m_windowAcked += bytes;
+  if (ecn.m_withEce)
+    {
+      ecn.m_windowMarked += bytes;
+    }
+  ecn.m_windowEnded = ackNumber >= ecn.m_windowEnd;
+  if (ecn.m_windowEnded)
+    {
+      ecn.m_windowEnd = m_highTxMark;
+      ecn.m_markedFraction = ecn.m_windowAcked == 0 ? 0.0
+        : static_cast<double> (ecn.m_windowMarked) / ecn.m_windowAcked;
+      NS_LOG_LOGIC ("Window ended, marked " << ecn.m_windowMarked << " of " << ecn.m_windowAcked << " bytes");
+      ecn.m_windowAcked = 0;
+      ecn.m_windowMarked = 0;
+      m_markedFractionTrace (ecn.m_markedFraction);
+    }
+
+  m_congestionControl->PktsAcked (m_tcb, segsAcked, m_lastRtt, ecn.m_withEce, m_highTxMark, ackNumber);
+  // XXX FlowBender
+  if (m_flowBenderEnabled && ecn.m_windowEnded)
+    {
+      m_flowBender->WindowEnded (ecn.m_markedFraction);
+    }
+}
+
 void
 TcpSocketBase::UpdateCwnd (uint32_t oldValue, uint32_t newValue)
 {
@@ -82,6 +82,30 @@ public:
 /// Container for RttHistory objects
 typedef std::deque<RttHistory> RttHistory_t;
 
+/**
+ * \ingroup tcp
+ *
+ * \brief ECN accounting of the bytes acknowledged on a connection
+ *
+ * The socket updates it once per ACK, before calling the congestion
+ * control, and DCTCP, FlowBender and TLB read it instead of counting the
+ * acknowledged and marked bytes themselves.  An observation window lasts
+ * about one round trip time: it ends with the first ACK covering the
+ * highest sequence sent when the window started.
+ */
+struct TcpEcnAccounting
+{
+  TcpEcnAccounting ();
+
+  uint32_t m_ackedBytes;        //!< Bytes acknowledged by the last ACK
+  bool m_withEce;               //!< Whether the last ACK carried ECE
+  uint32_t m_windowAcked;       //!< Bytes acknowledged in the current window
+  uint32_t m_windowMarked;      //!< Bytes acknowledged with ECE in the current window
+  SequenceNumber32 m_windowEnd; //!< The window ends when this sequence is acknowledged
+  bool m_windowEnded;           //!< Whether the last ACK ended a window
+  double m_markedFraction;      //!< Fraction of marked bytes in the last window
+};
+
 /**
  * \brief Data structure that records the congestion state of a connection
  *
@@ -171,6 +195,8 @@ public:
 
   TracedValue<TcpCongState_t> m_congState;    //!< State in the Congestion state machine
 
+  TcpEcnAccounting       m_ecn;             //!< ECN accounting of the acknowledged bytes
+
   /**
    * \brief Get cwnd in segments rather than bytes
    *
@@ -253,6 +279,25 @@ public:
  *
  * The algorithm is implemented in the ReceivedAck method.
  *
+ * Selective acknowledgments
+ * --------------------------
+ *
+ * When the "Sack" attribute is set on both ends, the SACK option (RFC 2018)
+ * is negotiated on the SYN exchange. The receiver then reports the blocks held
+ * by its TcpRxBuffer, and the sender keeps a scoreboard of SACKed and lost
+ * segments in its TcpTxBuffer. Loss recovery follows RFC 6675: the pipe
+ * replaces the outstanding data in the window check, lost segments are
+ * retransmitted before new data, and the cWnd is not inflated.
+ *
+ * Segments are deemed lost either through the duplicate ACK threshold
+ * ("ReTxThreshold", RFC 6675 IsLost) or, when the "Rack" attribute is set,
+ * by the time based RACK algorithm (RFC 8985): a segment is lost once a
+ * segment sent after it has been delivered and it has been outstanding for
+ * more than the RTT plus a reordering window. The window starts at a quarter
+ * of the minimum RTT and grows by as much each time a retransmission turns
+ * out to be spurious, which lets RACK tolerate the reordering introduced by
+ * per-packet load balancing.
+ *
  */
 class TcpSocketBase : public TcpSocket
 {
@@ -421,6 +466,14 @@ public:
   typedef void (* TcpTxRxTracedCallback)(const Ptr<const Packet> packet, const TcpHeader& header,
                                          const Ptr<const TcpSocketBase> socket);
 
+  /**
+   * TracedCallback signature for the ECN marked fraction.
+   *
+   * \param [in] fraction The fraction of the bytes acknowledged with ECE
+   *             in the observation window which just ended.
+   */
+  typedef void (* MarkedFractionTracedCallback)(double fraction);
+
 protected:
   // Implementing ns3::TcpSocket -- Attribute get/set
   // inherited, no need to doc
@@ -794,6 +847,48 @@ protected:
    */
   virtual void ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader);
 
+  /**
+   * \brief Process an ACK on a connection with SACK (RFC 6675 recovery)
+   * \param packet the packet
+   * \param tcpHeader the packet's TCP header
+   * \param segsAcked the number of segments acked
+   * \param withECE true if the ACK carries the ECE flag
+   */
+  void ReceivedSackAck (Ptr<Packet> packet, const TcpHeader& tcpHeader,
+                        uint32_t segsAcked, bool withECE);
+
+  /**
+   * \brief Account the segments acknowledged by an ACK in the ECN
+   * accounting, and pass them to the congestion control and FlowBender
+   * \param segsAcked the number of segments acked
+   * \param ackNumber the ACK number
+   */
+  void NotifyPktsAcked (uint32_t segsAcked, SequenceNumber32 ackNumber);
+
+  /**
+   * \brief Update the RACK state with the most recently sent segment
+   * delivered by an ACK
+   * \param item the delivered segment
+   */
+  void RackUpdate (const TcpTxItem &item);
+
+  /**
+   * \brief Mark the lost segments in the scoreboard, through RACK or the
+   * duplicate ACK threshold
+   * \return the number of bytes newly marked as lost
+   */
+  uint32_t DetectLoss (void);
+
+  /**
+   * \brief Expiration of the RACK reordering timer
+   */
+  void RackTimeout (void);
+
+  /**
+   * \brief Enter fast recovery after a loss detected through the scoreboard
+   */
+  void EnterSackRecovery (void);
+
   /**
    * \brief Recv of a data, put into buffer, call L7 to get it if necessary
    * \param packet the packet
@@ -914,6 +1009,15 @@ protected:
    */
   void AddOptionTimestamp (TcpHeader& header);
 
+  /**
+   * \brief Add the SACK option with the blocks held by the Rx buffer
+   *
+   * As many blocks as fit in the remaining option space are added.
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSack (TcpHeader& header);
+
   /**
    * \brief Performs a safe subtraction between a and b (a-b)
    *
@@ -1000,6 +1104,18 @@ protected:
   bool     m_timestampEnabled;    //!< Timestamp option enabled
   uint32_t m_timestampToEcho;     //!< Timestamp to echo
 
+  bool     m_sackEnabled;         //!< SACK option enabled (RFC 2018)
+
+  // RACK loss detection
+  bool     m_rackEnabled;         //!< RACK loss detection enabled (RFC 8985)
+  Time     m_rackXmitTs;          //!< Send time of the most recently delivered segment
+  SequenceNumber32 m_rackEndSeq;  //!< End of the most recently delivered segment
+  Time     m_rackRtt;             //!< RTT of the most recently delivered segment
+  Time     m_rackMinRtt;          //!< Minimum RTT seen on non retransmitted segments
+  uint32_t m_rackReoWndMult;      //!< Reordering window, in quarters of the minimum RTT
+  uint32_t m_rackReoWndPersist;   //!< Recoveries left before resetting m_rackReoWndMult
+  EventId  m_rackTimer;           //!< Reordering timer
+
   EventId m_sendPendingDataEvent; //!< micro-delay event to send pending data
 
   // Fast Retransmit and Recovery
@@ -1058,6 +1174,8 @@ protected:
 
   TracedCallback<Ptr<const Packet>, const TcpHeader&,
                  Ptr<const TcpSocketBase> > m_rxTrace; //!< Trace of received packets
+
+  TracedCallback<double> m_markedFractionTrace; //!< Trace of the ECN marked fraction
 };
 
 /**
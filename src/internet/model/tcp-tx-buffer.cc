@@ -32,6 +32,34 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TcpTxBuffer");
 
+TcpTxItem::TcpTxItem ()
+  : m_seq (0),
+    m_size (0),
+    m_lastSent (Seconds (0.0)),
+    m_retrans (false),
+    m_sacked (false),
+    m_lost (false)
+{
+}
+
+SequenceNumber32
+TcpTxItem::GetEndSequence (void) const
+{
+  return m_seq + SequenceNumber32 (m_size);
+}
+
+/**
+ * \brief Ordering of the scoreboard items by their first sequence number
+ * \param item a scoreboard item
+ * \param seq a sequence number
+ * \return true if the item starts before seq
+ */
+static bool
+TcpTxItemStartsBefore (const TcpTxItem &item, const SequenceNumber32 &seq)
+{
+  return item.m_seq < seq;
+}
+
 NS_OBJECT_ENSURE_REGISTERED (TcpTxBuffer);
 
 TypeId
@@ -57,10 +85,23 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0),
+    m_sackedOut (0), m_lostOut (0),
+    m_lostFrontier (n), m_sackedBelowFrontier (0), m_highSacked (n)
 {
 }
 
+TcpTxBuffer::TcpTxBuffer (const TcpTxBuffer &other)
+  : Object (other),
+    m_firstByteSeq (other.m_firstByteSeq), m_size (other.m_size),
+    m_maxBuffer (other.m_maxBuffer), m_data (other.m_data),
+    m_sackedOut (0), m_lostOut (0),
+    m_lostFrontier (other.m_firstByteSeq), m_sackedBelowFrontier (0),
+    m_highSacked (other.m_firstByteSeq)
+{
+  NS_ASSERT_MSG (other.m_sentList.empty (), "Copy of a buffer with data in flight");
+}
+
 TcpTxBuffer::~TcpTxBuffer (void)
 {
 }
@@ -206,6 +247,8 @@ TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
 {
   NS_LOG_FUNCTION (this << seq);
   m_firstByteSeq = seq;
+  m_lostFrontier = seq;
+  m_highSacked = seq;
 }
 
 void
@@ -251,6 +294,383 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   NS_LOG_LOGIC ("size=" << m_size << " headSeq=" << m_firstByteSeq << " maxBuffer=" << m_maxBuffer
                         <<" numPkts="<< m_data.size ());
   NS_ASSERT (m_firstByteSeq == seq);
+
+  // Drop the acked part of the scoreboard
+  while (!m_sentList.empty () && m_sentList.front ().m_seq < seq)
+    {
+      TcpTxItem &item = m_sentList.front ();
+      uint32_t acked = std::min (item.m_size, static_cast<uint32_t> (seq - item.m_seq));
+      if (item.m_sacked)
+        {
+          m_sackedOut -= acked;
+          if (item.m_seq < m_lostFrontier)
+            {
+              m_sackedBelowFrontier -= acked;
+            }
+        }
+      else if (item.m_lost)
+        {
+          m_lostOut -= acked;
+          m_lost.erase (item.m_seq);
+        }
+      if (acked == item.m_size)
+        {
+          if (!item.m_sacked && !item.m_lost)
+            {
+              m_sendOrder.erase (item.m_sendOrderIt);
+            }
+          m_sentList.pop_front ();
+        }
+      else
+        {
+          item.m_seq += acked;
+          item.m_size -= acked;
+          if (item.m_lost)
+            {
+              m_lost.insert (item.m_seq);
+            }
+        }
+    }
+
+  if (m_lostFrontier < seq)
+    {
+      m_lostFrontier = seq;
+      m_sackedBelowFrontier = 0;
+    }
+  if (m_highSacked < seq)
+    {
+      m_highSacked = seq;
+    }
+  if (m_sentList.empty ())
+    {
+      m_retransmissions.clear ();
+    }
+  else
+    {
+      while (!m_retransmissions.empty () && m_retransmissions.front ().m_seq < seq)
+        {
+          m_retransmissions.pop_front ();
+        }
+    }
+}
+
+void
+TcpTxBuffer::RecordTransmission (const SequenceNumber32& seq, uint32_t size, const Time &now)
+{
+  NS_LOG_FUNCTION (this << seq << size);
+  SequenceNumber32 end = seq + SequenceNumber32 (size);
+  SequenceNumber32 high = m_sentList.empty () ? m_firstByteSeq.Get ()
+                                              : m_sentList.back ().GetEndSequence ();
+
+  if (seq < high)
+    { // Retransmission: flag every recorded segment overlapping the range
+      std::deque<TcpTxItem>::iterator it = std::lower_bound (m_sentList.begin (), m_sentList.end (),
+                                                             seq, TcpTxItemStartsBefore);
+      if (it != m_sentList.begin () && (it == m_sentList.end () || it->m_seq > seq))
+        {
+          --it;
+        }
+      for (; it != m_sentList.end () && it->m_seq < end; ++it)
+        {
+          it->m_lastSent = now;
+          it->m_retrans = true;
+          if (it->m_lost)
+            {
+              it->m_lost = false;
+              m_lostOut -= it->m_size;
+              m_lost.erase (it->m_seq);
+              it->m_sendOrderIt = m_sendOrder.insert (m_sendOrder.end (), &*it);
+            }
+          else if (!it->m_sacked)
+            {
+              m_sendOrder.splice (m_sendOrder.end (), m_sendOrder, it->m_sendOrderIt);
+            }
+          if (!it->m_sacked)
+            {
+              Retransmission rec;
+              rec.m_seq = it->m_seq;
+              rec.m_high = high;
+              rec.m_sent = now;
+              m_retransmissions.push_back (rec);
+            }
+        }
+    }
+
+  if (end > high)
+    {
+      TcpTxItem item;
+      item.m_seq = std::max (seq, high);
+      item.m_size = end - item.m_seq;
+      item.m_lastSent = now;
+      m_sentList.push_back (item);
+      // Elements of a deque do not move when it grows at its ends
+      m_sentList.back ().m_sendOrderIt = m_sendOrder.insert (m_sendOrder.end (), &m_sentList.back ());
+    }
+}
+
+uint32_t
+TcpTxBuffer::UpdateScoreboard (const SequenceNumber32& ack,
+                               const TcpOptionSack::SackList &list,
+                               TcpTxItem *delivered)
+{
+  NS_LOG_FUNCTION (this << ack);
+  NS_ASSERT (delivered != 0);
+  uint32_t newlySacked = 0;
+  delivered->m_size = 0;
+
+  // Segments delivered by the cumulative ACK
+  for (std::deque<TcpTxItem>::const_iterator it = m_sentList.begin ();
+       it != m_sentList.end () && it->GetEndSequence () <= ack; ++it)
+    {
+      if (!it->m_sacked
+          && (delivered->m_size == 0 || it->m_lastSent >= delivered->m_lastSent))
+        {
+          *delivered = *it;
+        }
+    }
+
+  // The blocks repeated from the previous ACK have already been applied:
+  // only the parts of each block outside of them are walked.
+  TcpOptionSack::SackList cache;
+  for (TcpOptionSack::SackList::const_iterator b = list.begin (); b != list.end (); ++b)
+    {
+      if (b->second <= ack || b->second <= b->first)
+        {
+          continue; // D-SACK or malformed block
+        }
+      cache.push_back (*b);
+      SequenceNumber32 from = b->first;
+      while (from < b->second)
+        {
+          SequenceNumber32 to = b->second;
+          bool applied = false;
+          for (TcpOptionSack::SackList::const_iterator c = m_sackCache.begin ();
+               c != m_sackCache.end (); ++c)
+            {
+              if (c->first <= from && from < c->second)
+                {
+                  to = c->second;
+                  applied = true;
+                  break;
+                }
+              if (from < c->first && c->first < to)
+                {
+                  to = c->first;
+                }
+            }
+          if (!applied)
+            {
+              newlySacked += SackRange (*b, from, to, delivered);
+            }
+          from = to;
+        }
+    }
+  m_sackCache = cache;
+
+  NS_LOG_LOGIC ("Newly SACKed " << newlySacked << " sackedOut " << m_sackedOut <<
+                " lostOut " << m_lostOut);
+  return newlySacked;
+}
+
+uint32_t
+TcpTxBuffer::SackRange (const TcpOptionSack::SackBlock &block,
+                        const SequenceNumber32 &from, const SequenceNumber32 &to,
+                        TcpTxItem *delivered)
+{
+  uint32_t newlySacked = 0;
+  std::deque<TcpTxItem>::iterator it = std::lower_bound (m_sentList.begin (), m_sentList.end (),
+                                                         from, TcpTxItemStartsBefore);
+  if (it != m_sentList.begin () && (it - 1)->GetEndSequence () > from)
+    {
+      --it; // Segment straddling the start of the range
+    }
+  for (; it != m_sentList.end () && it->m_seq < to && it->GetEndSequence () <= block.second; ++it)
+    {
+      if (it->m_seq < block.first || it->m_sacked)
+        {
+          continue;
+        }
+      it->m_sacked = true;
+      m_sackedOut += it->m_size;
+      newlySacked += it->m_size;
+      if (it->m_lost)
+        {
+          it->m_lost = false;
+          m_lostOut -= it->m_size;
+          m_lost.erase (it->m_seq);
+        }
+      else
+        {
+          m_sendOrder.erase (it->m_sendOrderIt);
+        }
+      if (it->m_seq < m_lostFrontier)
+        {
+          m_sackedBelowFrontier += it->m_size;
+        }
+      if (it->GetEndSequence () > m_highSacked)
+        {
+          m_highSacked = it->GetEndSequence ();
+        }
+      if (delivered->m_size == 0 || it->m_lastSent > delivered->m_lastSent
+          || (it->m_lastSent == delivered->m_lastSent
+              && it->GetEndSequence () > delivered->GetEndSequence ()))
+        {
+          *delivered = *it;
+        }
+    }
+  return newlySacked;
+}
+
+void
+TcpTxBuffer::MarkLost (TcpTxItem &item)
+{
+  NS_ASSERT (!item.m_sacked && !item.m_lost);
+  item.m_lost = true;
+  m_lostOut += item.m_size;
+  m_lost.insert (item.m_seq);
+  m_sendOrder.erase (item.m_sendOrderIt);
+}
+
+std::deque<TcpTxItem>::iterator
+TcpTxBuffer::FindItem (const SequenceNumber32 &seq)
+{
+  std::deque<TcpTxItem>::iterator it = std::lower_bound (m_sentList.begin (), m_sentList.end (),
+                                                         seq, TcpTxItemStartsBefore);
+  if (it != m_sentList.end () && it->m_seq != seq)
+    {
+      return m_sentList.end ();
+    }
+  return it;
+}
+
+uint32_t
+TcpTxBuffer::MarkLostByDupThresh (uint32_t dupThresh, uint32_t segSize)
+{
+  NS_LOG_FUNCTION (this << dupThresh << segSize);
+  uint32_t newlyLost = 0;
+  if (m_sackedOut == 0)
+    {
+      return 0;
+    }
+
+  // The SACKed bytes above a segment only grow until it is acked, so the
+  // segments below the frontier need not be examined again.
+  uint32_t threshold = (dupThresh - 1) * segSize;
+  std::deque<TcpTxItem>::iterator it = std::lower_bound (m_sentList.begin (), m_sentList.end (),
+                                                         m_lostFrontier, TcpTxItemStartsBefore);
+  for (; it != m_sentList.end (); ++it)
+    {
+      if (it->m_sacked)
+        {
+          m_sackedBelowFrontier += it->m_size;
+        }
+      else if (m_sackedOut - m_sackedBelowFrontier > threshold)
+        {
+          if (!it->m_lost && !it->m_retrans)
+            {
+              MarkLost (*it);
+              newlyLost += it->m_size;
+            }
+        }
+      else
+        {
+          break;
+        }
+      m_lostFrontier = it->GetEndSequence ();
+    }
+
+  // A retransmission is lost when a segment sent after it is SACKed beyond
+  // the threshold; those are the ones above everything sent before it.
+  while (!m_retransmissions.empty ()
+         && m_highSacked > m_retransmissions.front ().m_high + SequenceNumber32 (threshold))
+    {
+      const Retransmission &rec = m_retransmissions.front ();
+      std::deque<TcpTxItem>::iterator item = FindItem (rec.m_seq);
+      if (item != m_sentList.end () && item->m_retrans && !item->m_sacked && !item->m_lost
+          && item->m_lastSent == rec.m_sent)
+        {
+          NS_LOG_LOGIC ("Retransmission of " << rec.m_seq << " lost");
+          MarkLost (*item);
+          newlyLost += item->m_size;
+        }
+      m_retransmissions.pop_front ();
+    }
+  return newlyLost;
+}
+
+uint32_t
+TcpTxBuffer::MarkLostByRack (const Time &xmitTs, const SequenceNumber32& endSeq,
+                             const Time &rtt, const Time &reoWnd, const Time &now,
+                             Time *timeout)
+{
+  NS_LOG_FUNCTION (this << xmitTs << endSeq << rtt << reoWnd);
+  NS_ASSERT (timeout != 0);
+  uint32_t newlyLost = 0;
+  *timeout = Seconds (0.0);
+
+  // Oldest send first: the walk stops at the first segment not yet expired
+  std::list<TcpTxItem *>::iterator it = m_sendOrder.begin ();
+  while (it != m_sendOrder.end ())
+    {
+      TcpTxItem *item = *it++;
+      if (item->m_lastSent > xmitTs)
+        {
+          break; // Not sent before the most recently delivered segment
+        }
+      if (item->m_lastSent == xmitTs && item->GetEndSequence () >= endSeq)
+        {
+          continue;
+        }
+      Time remaining = item->m_lastSent + rtt + reoWnd - now;
+      if (remaining.IsStrictlyPositive ())
+        {
+          *timeout = remaining;
+          break;
+        }
+      MarkLost (*item);
+      newlyLost += item->m_size;
+    }
+  return newlyLost;
+}
+
+void
+TcpTxBuffer::MarkAllLost (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::list<TcpTxItem *>::iterator it = m_sendOrder.begin (); it != m_sendOrder.end (); ++it)
+    {
+      (*it)->m_lost = true;
+      m_lostOut += (*it)->m_size;
+      m_lost.insert ((*it)->m_seq);
+    }
+  m_sendOrder.clear ();
+}
+
+bool
+TcpTxBuffer::NextLost (SequenceNumber32 *seq, uint32_t *size) const
+{
+  if (m_lost.empty ())
+    {
+      return false;
+    }
+  *seq = *m_lost.begin ();
+  std::deque<TcpTxItem>::const_iterator it = std::lower_bound (m_sentList.begin (), m_sentList.end (),
+                                                               *seq, TcpTxItemStartsBefore);
+  NS_ASSERT (it != m_sentList.end () && it->m_seq == *seq && it->m_lost);
+  *size = it->m_size;
+  return true;
+}
+
+uint32_t
+TcpTxBuffer::GetSackedOut (void) const
+{
+  return m_sackedOut;
+}
+
+uint32_t
+TcpTxBuffer::GetLostOut (void) const
+{
+  return m_lostOut;
 }
 
 } // namepsace ns3
@@ -22,20 +22,71 @@
 #define TCP_TX_BUFFER_H
 
 #include <list>
+#include <deque>
+#include <set>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/tcp-option-sack.h"
 
 namespace ns3 {
 class Packet;
 
+/**
+ * \ingroup tcp
+ *
+ * \brief Transmission state of a segment sent and not yet cumulatively acked
+ *
+ * Items are kept by TcpTxBuffer in sequence order and form the SACK
+ * scoreboard: they record what the receiver has selectively acknowledged,
+ * what has been deemed lost and when each segment was last sent.
+ */
+class TcpTxItem
+{
+public:
+  TcpTxItem ();
+
+  /**
+   * \brief Get the sequence number following the segment
+   * \return the right edge of the segment
+   */
+  SequenceNumber32 GetEndSequence (void) const;
+
+  SequenceNumber32 m_seq; //!< Sequence number of the first byte
+  uint32_t m_size;        //!< Number of bytes
+  Time m_lastSent;        //!< Time of the last (re)transmission
+  bool m_retrans;         //!< Has been retransmitted at least once
+  bool m_sacked;          //!< Has been selectively acknowledged
+  bool m_lost;            //!< Deemed lost and not retransmitted since
+  /// Position in the send order list of the buffer, while neither SACKed nor lost
+  std::list<TcpTxItem *>::iterator m_sendOrderIt;
+};
+
 /**
  * \ingroup tcp
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * The SACK scoreboard keeps, besides the items in sequence order, indexes
+ * which bound the work of each ACK by what it changes rather than by the
+ * number of segments in flight:
+ *
+ * - the segments neither SACKed nor lost, in the order they were last sent,
+ *   which RACK walks from the oldest one;
+ * - the lost segments, in sequence order, for NextLost;
+ * - a frontier below which the \RFC{6675} rule has already marked the lost
+ *   segments, which only moves forward as the SACKed bytes above it grow;
+ * - the retransmissions, in the order they were sent, with the highest
+ *   sequence number sent before each of them;
+ * - the SACK blocks of the previous ACK, whose segments are not visited
+ *   again.
+ *
+ * The indexes point to the items, so the scoreboard is not copied along
+ * with the buffer: sockets are forked before sending any data.
  */
 class TcpTxBuffer : public Object
 {
@@ -50,6 +101,11 @@ public:
    * \param n initial Sequence number to be transmitted
    */
   TcpTxBuffer (uint32_t n = 0);
+  /**
+   * \brief Copy constructor, for a buffer with an empty scoreboard
+   * \param other the buffer to copy
+   */
+  TcpTxBuffer (const TcpTxBuffer &other);
   virtual ~TcpTxBuffer (void);
 
   // Accessors
@@ -127,7 +183,127 @@ public:
    */
   void DiscardUpTo (const SequenceNumber32& seq);
 
+  // SACK scoreboard
+
+  /**
+   * \brief Record the (re)transmission of the range [seq, seq+size)
+   *
+   * Segments past the highest one recorded are appended to the scoreboard;
+   * already recorded segments are flagged as retransmitted.
+   *
+   * \param seq first sequence number sent
+   * \param size number of bytes sent
+   * \param now time of the transmission
+   */
+  void RecordTransmission (const SequenceNumber32& seq, uint32_t size, const Time &now);
+
+  /**
+   * \brief Update the scoreboard with the information carried by an ACK
+   *
+   * Segments entirely covered by a SACK block are marked as SACKed.
+   * Cumulatively acked segments stay in the scoreboard until DiscardUpTo.
+   *
+   * \param ack the cumulative acknowledgment number
+   * \param list the SACK blocks of the ACK
+   * \param delivered set to the most recently sent segment newly delivered by
+   * this ACK (cumulatively or selectively); its size is 0 if there is none
+   * \return the number of newly SACKed bytes
+   */
+  uint32_t UpdateScoreboard (const SequenceNumber32& ack,
+                             const TcpOptionSack::SackList &list,
+                             TcpTxItem *delivered);
+
+  /**
+   * \brief Mark as lost the segments with more than (dupThresh - 1) * segSize
+   * SACKed bytes above them (\RFC{6675} IsLost)
+   *
+   * A retransmission is lost when a segment ending more than
+   * (dupThresh - 1) * segSize bytes above the highest sequence number sent
+   * before it is SACKed.
+   *
+   * \param dupThresh the duplicate ACK threshold, which should not change
+   * \param segSize the segment size
+   * \return the number of bytes newly marked as lost
+   */
+  uint32_t MarkLostByDupThresh (uint32_t dupThresh, uint32_t segSize);
+
+  /**
+   * \brief Mark as lost the segments sent before the most recently delivered
+   * one, and for longer than rtt + reoWnd (\RFC{8985} RACK)
+   * \param xmitTs send time of the most recently delivered segment
+   * \param endSeq end sequence of the most recently delivered segment
+   * \param rtt RTT measured on the most recently delivered segment
+   * \param reoWnd the reordering window
+   * \param now current time
+   * \param timeout set to the time left before the next segment could be
+   * marked lost, or zero if there is none
+   * \return the number of bytes newly marked as lost
+   */
+  uint32_t MarkLostByRack (const Time &xmitTs, const SequenceNumber32& endSeq,
+                           const Time &rtt, const Time &reoWnd, const Time &now,
+                           Time *timeout);
+
+  /**
+   * \brief Mark as lost all the outstanding segments not SACKed (on RTO)
+   */
+  void MarkAllLost (void);
+
+  /**
+   * \brief Get the first segment deemed lost and not yet retransmitted
+   * \param seq set to the first sequence number of the segment
+   * \param size set to the size of the segment
+   * \return true if such a segment exists
+   */
+  bool NextLost (SequenceNumber32 *seq, uint32_t *size) const;
+
+  /**
+   * \brief Get the number of outstanding bytes SACKed by the receiver
+   * \return the SACKed bytes
+   */
+  uint32_t GetSackedOut (void) const;
+
+  /**
+   * \brief Get the number of outstanding bytes lost and not retransmitted
+   * \return the lost bytes
+   */
+  uint32_t GetLostOut (void) const;
+
 private:
+  /**
+   * \brief A retransmission, for the detection of its loss
+   */
+  struct Retransmission
+  {
+    SequenceNumber32 m_seq;  //!< First sequence number of the segment
+    SequenceNumber32 m_high; //!< Highest sequence number sent before it
+    Time m_sent;             //!< Time of the retransmission
+  };
+
+  /**
+   * \brief Mark as SACKed the segments of a SACK block starting in a range
+   * \param block the SACK block
+   * \param from the start of the range
+   * \param to the end of the range
+   * \param delivered the most recently sent segment delivered, updated
+   * \return the number of newly SACKed bytes
+   */
+  uint32_t SackRange (const TcpOptionSack::SackBlock &block,
+                      const SequenceNumber32 &from, const SequenceNumber32 &to,
+                      TcpTxItem *delivered);
+
+  /**
+   * \brief Mark a segment neither SACKed nor lost as lost
+   * \param item the segment
+   */
+  void MarkLost (TcpTxItem &item);
+
+  /**
+   * \brief Find the item starting at a sequence number
+   * \param seq the sequence number
+   * \return the item, or m_sentList.end ()
+   */
+  std::deque<TcpTxItem>::iterator FindItem (const SequenceNumber32 &seq);
+
   /// container for data stored in the buffer
   typedef std::list<Ptr<Packet> >::iterator BufIterator;
 
@@ -135,6 +311,18 @@ private:
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
   std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+
+  std::deque<TcpTxItem> m_sentList;             //!< SACK scoreboard, in sequence order
+  uint32_t m_sackedOut;                         //!< Bytes of m_sentList SACKed
+  uint32_t m_lostOut;                           //!< Bytes of m_sentList lost and not retransmitted
+
+  std::list<TcpTxItem *> m_sendOrder;           //!< Items neither SACKed nor lost, in send order
+  std::set<SequenceNumber32> m_lost;            //!< First sequence number of the lost items
+  SequenceNumber32 m_lostFrontier;              //!< Items below it were examined by the RFC 6675 rule
+  uint32_t m_sackedBelowFrontier;               //!< SACKed bytes below m_lostFrontier
+  SequenceNumber32 m_highSacked;                //!< Highest SACKed sequence number
+  std::deque<Retransmission> m_retransmissions; //!< Retransmissions, in send order
+  TcpOptionSack::SackList m_sackCache;          //!< SACK blocks of the previous ACK
 };
 
 } // namepsace ns3
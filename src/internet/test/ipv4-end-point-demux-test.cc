@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-interface.h"
+#include "../model/ipv4-end-point-demux.h"
+#include "../model/ipv4-end-point.h"
+#include "ns3/log.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemuxTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the hashed demux keeps the most-specific-match
+ * semantics, including for endpoints whose peer is set after allocation.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Look up a packet and return the single matching endpoint
+   * \param demux the demux
+   * \param daddr destination address
+   * \param dport destination port
+   * \param saddr source address
+   * \param sport source port
+   * \returns the endpoint, or 0 if there is not exactly one match
+   */
+  Ipv4EndPoint *LookupOne (Ipv4EndPointDemux &demux,
+                           Ipv4Address daddr, uint16_t dport,
+                           Ipv4Address saddr, uint16_t sport);
+
+  Ptr<Ipv4Interface> m_interface; //!< Incoming interface
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Ipv4EndPointDemux test")
+{
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemuxTestCase::LookupOne (Ipv4EndPointDemux &demux,
+                                      Ipv4Address daddr, uint16_t dport,
+                                      Ipv4Address saddr, uint16_t sport)
+{
+  Ipv4EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, m_interface);
+  if (endPoints.size () != 1)
+    {
+      return 0;
+    }
+  return endPoints.front ();
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun ()
+{
+  m_interface = CreateObject<Ipv4Interface> ();
+  Ipv4EndPointDemux demux;
+  Ipv4Address local ("10.0.0.1");
+  Ipv4Address peer1 ("10.0.1.1");
+  Ipv4Address peer2 ("10.0.1.2");
+
+  Ipv4EndPoint *listener = demux.Allocate (80);
+  NS_TEST_ASSERT_MSG_NE (listener, 0, "Listener should be allocated");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (80), 0, "Port already bound");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (80), true, "Port in use");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (81), false, "Port not in use");
+
+  // Connections forked from the listener share its port
+  Ipv4EndPoint *conn1 = demux.Allocate (local, 80, peer1, 1000);
+  Ipv4EndPoint *conn2 = demux.Allocate (local, 80, peer2, 1000);
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (local, 80, peer1, 1000), 0, "Duplicate four-tuple");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupLocal (local, 80), true, "Address/port used by a connection");
+
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer1, 1000), conn1, "Full match expected");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 1000), conn2, "Full match expected");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 1001), listener, "Wildcard match expected");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 81, peer1, 1000, m_interface).size (), 0, "No endpoint on port");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer1, 1000), conn1, "Exact match expected");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer1, 1001), listener, "Generic match expected");
+
+  // An endpoint connected after allocation is re-hashed
+  Ipv4EndPoint *client = demux.Allocate ();
+  uint16_t clientPort = client->GetLocalPort ();
+  client->SetLocalAddress (local);
+  client->SetPeer (peer1, 80);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, clientPort, peer1, 80), client, "Re-hashed endpoint expected");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, clientPort, peer2, 80, m_interface).size (), 0, "Peer does not match");
+
+  // Disabled and removed endpoints are not returned
+  conn1->SetRxEnabled (false);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer1, 1000), listener, "Disabled endpoint skipped");
+  demux.DeAllocate (conn1);
+  demux.DeAllocate (listener);
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer1, 1000, m_interface).size (), 0, "Endpoints removed");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 1000), conn2, "Remaining connection expected");
+  demux.DeAllocate (conn2);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), false, "Port released");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().size (), 1, "Only the client is left");
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoTeardown ()
+{
+  m_interface = 0;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4EndPointDemux TestSuite
+ */
+class Ipv4EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  Ipv4EndPointDemuxTestSuite ()
+    : TestSuite ("ipv4-end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+  }
+};
+
+static Ipv4EndPointDemuxTestSuite g_ipv4EndPointDemuxTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-general-test.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/tcp-dctcp.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpEcnAccountingTest");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief A receiver socket which echoes ECE on all of its ACKs.
+ */
+class TcpSocketEceReceiver : public TcpSocketMsgBase
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpSocketEceReceiver () : TcpSocketMsgBase ()
+  {
+  }
+
+  /**
+   * \brief Copy constructor.
+   * \param other The object to copy from.
+   */
+  TcpSocketEceReceiver (const TcpSocketEceReceiver &other) : TcpSocketMsgBase (other)
+  {
+  }
+
+protected:
+  virtual Ptr<TcpSocketBase> Fork ();
+  virtual void SendEmptyPacket (uint8_t flags);
+};
+
+NS_OBJECT_ENSURE_REGISTERED (TcpSocketEceReceiver);
+
+TypeId
+TcpSocketEceReceiver::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpSocketEceReceiver")
+    .SetParent<TcpSocketMsgBase> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpSocketEceReceiver> ()
+  ;
+  return tid;
+}
+
+Ptr<TcpSocketBase>
+TcpSocketEceReceiver::Fork (void)
+{
+  return CopyObject<TcpSocketEceReceiver> (this);
+}
+
+void
+TcpSocketEceReceiver::SendEmptyPacket (uint8_t flags)
+{
+  if (flags == TcpHeader::ACK)
+    {
+      flags |= TcpHeader::ECE;
+    }
+  TcpSocketMsgBase::SendEmptyPacket (flags);
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the marked fraction the sender computes once per window.
+ *
+ * With a receiver echoing ECE on every ACK, every window is fully marked;
+ * without, no byte is marked.
+ */
+class TcpEcnAccountingTestCase : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor.
+   * \param desc The test description.
+   * \param marked Whether the receiver marks all of its ACKs.
+   */
+  TcpEcnAccountingTestCase (const std::string &desc, bool marked);
+
+protected:
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual void FinalChecks ();
+
+  /**
+   * \brief Record the marked fraction of a window.
+   * \param fraction The marked fraction.
+   */
+  void MarkedFraction (double fraction);
+
+private:
+  bool m_marked;               //!< Whether the receiver marks its ACKs
+  uint32_t m_windows;          //!< Windows ended
+  uint32_t m_wrongFractions;   //!< Windows with an unexpected fraction
+};
+
+TcpEcnAccountingTestCase::TcpEcnAccountingTestCase (const std::string &desc, bool marked)
+  : TcpGeneralTest (desc),
+    m_marked (marked),
+    m_windows (0),
+    m_wrongFractions (0)
+{
+}
+
+void
+TcpEcnAccountingTestCase::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (50);
+  SetAppPktSize (500);
+  SetCongestionControl (TcpDCTCP::GetTypeId ());
+}
+
+void
+TcpEcnAccountingTestCase::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  GetSenderSocket ()->TraceConnectWithoutContext ("EcnMarkedFraction",
+                                                  MakeCallback (&TcpEcnAccountingTestCase::MarkedFraction, this));
+}
+
+void
+TcpEcnAccountingTestCase::MarkedFraction (double fraction)
+{
+  NS_LOG_FUNCTION (this << fraction);
+  m_windows++;
+  if (fraction != (m_marked ? 1.0 : 0.0))
+    {
+      m_wrongFractions++;
+    }
+}
+
+Ptr<TcpSocketMsgBase>
+TcpEcnAccountingTestCase::CreateReceiverSocket (Ptr<Node> node)
+{
+  if (m_marked)
+    {
+      return CreateSocket (node, TcpSocketEceReceiver::GetTypeId (), m_congControlTypeId);
+    }
+  return TcpGeneralTest::CreateReceiverSocket (node);
+}
+
+void
+TcpEcnAccountingTestCase::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_GT (m_windows, 1, "Several observation windows should have ended");
+  NS_TEST_ASSERT_MSG_EQ (m_wrongFractions, 0, "Wrong marked fraction");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for the ECN accounting of TcpSocketBase
+ */
+static class TcpEcnAccountingTestSuite : public TestSuite
+{
+public:
+  TcpEcnAccountingTestSuite ()
+    : TestSuite ("tcp-ecn-accounting", UNIT)
+  {
+    AddTestCase (new TcpEcnAccountingTestCase ("Check the marked fraction without marks", false), TestCase::QUICK);
+    AddTestCase (new TcpEcnAccountingTestCase ("Check the marked fraction with all ACKs marked", true), TestCase::QUICK);
+  }
+
+} g_tcpEcnAccountingTestSuite;
+
+} // namespace ns3
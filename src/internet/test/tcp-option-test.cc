@@ -22,6 +22,7 @@
 #include "ns3/tcp-option.h"
 #include "ns3/private/tcp-option-winscale.h"
 #include "ns3/private/tcp-option-ts.h"
+#include "ns3/tcp-option-sack.h"
 
 #include <string.h>
 
@@ -164,6 +165,75 @@ TcpOptionTSTestCase::DoTeardown ()
 {
 }
 
+class TcpOptionSackTestCase : public TestCase
+{
+public:
+  TcpOptionSackTestCase (std::string name, uint32_t blocks);
+
+  void TestSerialize ();
+  void TestDeserialize ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  TcpOptionSack::SackList m_sackList;
+  Buffer m_buffer;
+};
+
+
+TcpOptionSackTestCase::TcpOptionSackTestCase (std::string name, uint32_t blocks)
+  : TestCase (name)
+{
+  for (uint32_t i = 0; i < blocks; ++i)
+    {
+      // The last block wraps around the sequence space
+      SequenceNumber32 left (0xffffff00 - 1000 * i);
+      m_sackList.push_back (TcpOptionSack::SackBlock (left, left + SequenceNumber32 (536)));
+    }
+}
+
+void
+TcpOptionSackTestCase::DoRun ()
+{
+  TestSerialize ();
+  TestDeserialize ();
+}
+
+void
+TcpOptionSackTestCase::TestSerialize ()
+{
+  TcpOptionSack opt;
+
+  opt.SetSackList (m_sackList);
+  NS_TEST_EXPECT_MSG_EQ (opt.GetNumSackBlocks (), m_sackList.size (), "Blocks aren't saved correctly");
+  NS_TEST_EXPECT_MSG_EQ (opt.GetSerializedSize (), 2 + 8 * m_sackList.size (), "Wrong option size");
+
+  m_buffer.AddAtStart (opt.GetSerializedSize ());
+
+  opt.Serialize (m_buffer.Begin ());
+}
+
+void
+TcpOptionSackTestCase::TestDeserialize ()
+{
+  TcpOptionSack opt;
+
+  Buffer::Iterator start = m_buffer.Begin ();
+  uint8_t kind = start.PeekU8 ();
+
+  NS_TEST_EXPECT_MSG_EQ (kind, TcpOption::SACK, "Different kind found");
+
+  opt.Deserialize (start);
+
+  NS_TEST_EXPECT_MSG_EQ ((opt.GetSackList () == m_sackList), true, "Different blocks found");
+}
+
+void
+TcpOptionSackTestCase::DoTeardown ()
+{
+}
+
 static class TcpOptionTestSuite : public TestSuite
 {
 public:
@@ -176,6 +246,10 @@ public:
                                               "scale value", i), TestCase::QUICK);
       }
     AddTestCase (new TcpOptionTSTestCase ("Testing serialization of random values for timestamp"), TestCase::QUICK);
+    for (uint32_t i = 1; i <= 4; ++i)
+      {
+        AddTestCase (new TcpOptionSackTestCase ("Testing serialization of SACK blocks", i), TestCase::QUICK);
+      }
   }
 
 } g_TcpOptionTestSuite;
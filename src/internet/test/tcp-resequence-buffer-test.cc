@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-resequence-buffer.h"
+#include "ns3/tcp-header.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+#include <vector>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpResequenceBufferTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Socket recording the segments released by its resequence buffer
+ */
+class TcpResequenceBufferTestSocket : public TcpSocketBase
+{
+public:
+  std::vector<SequenceNumber32> m_seqs;  //!< Sequence numbers forwarded up
+  std::vector<Time> m_times;             //!< Time they were forwarded up
+
+protected:
+  virtual void DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
+                            const Address &toAddress)
+  {
+    TcpHeader tcpHeader;
+    packet->PeekHeader (tcpHeader);
+    m_seqs.push_back (tcpHeader.GetSequenceNumber ());
+    m_times.push_back (Simulator::Now ());
+  }
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the release order and timing of the resequence buffer
+ */
+class TcpResequenceBufferTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param segmentSize segment size of the receiving socket, the sender
+   * always sends segments of 100 bytes
+   */
+  TcpResequenceBufferTestCase (uint32_t segmentSize);
+
+private:
+  /**
+   * \param segmentSize segment size of the receiving socket
+   * \returns the name of the test case
+   */
+  static std::string Name (uint32_t segmentSize);
+
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Hand a data segment to the resequence buffer
+   * \param seq sequence number of the segment
+   */
+  void Receive (uint32_t seq);
+
+  uint32_t m_segmentSize;                      //!< Segment size of the socket
+  Ptr<TcpResequenceBufferTestSocket> m_socket; //!< Receiving socket
+  Ptr<TcpResequenceBuffer> m_buffer;           //!< Buffer under test
+};
+
+TcpResequenceBufferTestCase::TcpResequenceBufferTestCase (uint32_t segmentSize)
+  : TestCase (Name (segmentSize)),
+    m_segmentSize (segmentSize)
+{
+}
+
+std::string
+TcpResequenceBufferTestCase::Name (uint32_t segmentSize)
+{
+  std::ostringstream oss;
+  oss << "TcpResequenceBuffer test, receiver segment size " << segmentSize;
+  return oss.str ();
+}
+
+void
+TcpResequenceBufferTestCase::Receive (uint32_t seq)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  TcpHeader tcpHeader;
+  tcpHeader.SetSequenceNumber (SequenceNumber32 (seq));
+  tcpHeader.SetFlags (TcpHeader::ACK);
+  p->AddHeader (tcpHeader);
+  m_buffer->BufferPacket (p, Address (), Address ());
+}
+
+void
+TcpResequenceBufferTestCase::DoRun ()
+{
+  m_socket = CreateObject<TcpResequenceBufferTestSocket> ();
+  m_socket->SetAttribute ("SegmentSize", UintegerValue (m_segmentSize));
+  m_buffer = CreateObject<TcpResequenceBuffer> ();
+  m_buffer->SetAttribute ("WindowSize", UintegerValue (40));
+  // Still accepted, for the existing scripts
+  m_buffer->SetAttribute ("PeriodicalCheckTime", TimeValue (MicroSeconds (5)));
+  m_buffer->SetTcp (PeekPointer (m_socket));
+
+  // An in order run with a hole filled in, released at the in order deadline
+  Simulator::Schedule (MicroSeconds (0), &TcpResequenceBufferTestCase::Receive, this, 1);
+  Simulator::Schedule (MicroSeconds (1), &TcpResequenceBufferTestCase::Receive, this, 201);
+  Simulator::Schedule (MicroSeconds (2), &TcpResequenceBufferTestCase::Receive, this, 101);
+  // A segment past a hole, released at the out of order deadline
+  Simulator::Schedule (MicroSeconds (100), &TcpResequenceBufferTestCase::Receive, this, 401);
+  // The late segment is passed through immediately
+  Simulator::Schedule (MicroSeconds (200), &TcpResequenceBufferTestCase::Receive, this, 301);
+  // A duplicate of a released segment is passed through as well
+  Simulator::Schedule (MicroSeconds (300), &TcpResequenceBufferTestCase::Receive, this, 101);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_socket->m_seqs.size (), 6, "All the segments should be released");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_seqs[0], SequenceNumber32 (1), "Wrong release order");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_seqs[1], SequenceNumber32 (101), "Wrong release order");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_seqs[2], SequenceNumber32 (201), "Wrong release order");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_times[2], MicroSeconds (20), "In order run released at its deadline");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_seqs[3], SequenceNumber32 (401), "Wrong release order");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_times[3], MicroSeconds (150), "Out of order segment released at its deadline");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_seqs[4], SequenceNumber32 (301), "Wrong release order");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_times[4], MicroSeconds (200), "Late segment should not be held");
+  NS_TEST_EXPECT_MSG_EQ (m_socket->m_times[5], MicroSeconds (300), "Old segment should not be held");
+
+  UintegerValue windowSize;
+  m_buffer->GetAttribute ("WindowSize", windowSize);
+  NS_TEST_EXPECT_MSG_EQ (windowSize.Get (), 40, "The WindowSize attribute should not be changed");
+
+  m_buffer->Stop ();
+  Simulator::Destroy ();
+}
+
+void
+TcpResequenceBufferTestCase::DoTeardown ()
+{
+  m_buffer = 0;
+  m_socket = 0;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpResequenceBuffer TestSuite
+ */
+class TcpResequenceBufferTestSuite : public TestSuite
+{
+public:
+  TcpResequenceBufferTestSuite ()
+    : TestSuite ("tcp-resequence-buffer", UNIT)
+  {
+    AddTestCase (new TcpResequenceBufferTestCase (100), TestCase::QUICK);
+    AddTestCase (new TcpResequenceBufferTestCase (1000), TestCase::QUICK);
+  }
+};
+
+static TcpResequenceBufferTestSuite g_tcpResequenceBufferTestSuite; //!< Static variable for test initialization
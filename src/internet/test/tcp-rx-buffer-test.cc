@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/packet.h"
+#include "ns3/log.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpRxBufferTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that out-of-order segments are merged into blocks, that SACK
+ * blocks are reported in RFC 2018 order and that in-order data is extracted
+ * as a single packet.
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  TcpRxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Add a segment of the given size and sequence number
+   * \param rxBuf the buffer
+   * \param seq sequence number of the first byte
+   * \param size number of bytes
+   * \returns the result of TcpRxBuffer::Add
+   */
+  bool AddSegment (Ptr<TcpRxBuffer> rxBuf, uint32_t seq, uint32_t size);
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase ()
+  : TestCase ("TcpRxBuffer test")
+{
+}
+
+bool
+TcpRxBufferTestCase::AddSegment (Ptr<TcpRxBuffer> rxBuf, uint32_t seq, uint32_t size)
+{
+  TcpHeader h;
+  h.SetSequenceNumber (SequenceNumber32 (seq));
+  return rxBuf->Add (Create<Packet> (size), h);
+}
+
+void
+TcpRxBufferTestCase::DoRun ()
+{
+  Ptr<TcpRxBuffer> rxBuf = CreateObject<TcpRxBuffer> (1);
+  rxBuf->SetMaxBufferSize (100000);
+  TcpRxBuffer::SackList sackList;
+
+  // Out of order: [501,1001) then [1501,2001)
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, 501, 500), true, "Segment should be buffered");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, 1501, 500), true, "Segment should be buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->NextRxSequence (), SequenceNumber32 (1), "Hole at the head");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->Available (), 0, "Nothing in sequence yet");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->Size (), 1000, "Two segments buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->GetSackListSize (), 2, "Two blocks expected");
+
+  sackList = rxBuf->GetSackList ();
+  NS_TEST_ASSERT_MSG_EQ (sackList.front ().first, SequenceNumber32 (1501), "Latest block first");
+  NS_TEST_ASSERT_MSG_EQ (sackList.back ().first, SequenceNumber32 (501), "Older block last");
+
+  // Adjacent segment is merged in place, duplicate is refused
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, 1001, 300), true, "Segment should be merged");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, 601, 200), false, "Duplicate should be refused");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->GetSackListSize (), 2, "Blocks should not be split");
+  sackList = rxBuf->GetSackList ();
+  NS_TEST_ASSERT_MSG_EQ (sackList.front ().first, SequenceNumber32 (501), "Merged block first");
+  NS_TEST_ASSERT_MSG_EQ (sackList.front ().second, SequenceNumber32 (1301), "Merged block tail");
+
+  // Overlapping segment bridges the two blocks
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, 1201, 400), true, "Segment should bridge the blocks");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->GetSackListSize (), 1, "Blocks should be merged");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->Size (), 1500, "Only new bytes are accounted");
+
+  // Fill the head hole, all data becomes available
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, 1, 500), true, "Segment should fill the hole");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->NextRxSequence (), SequenceNumber32 (2001), "All data in sequence");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->Available (), 2000, "All data available");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->GetSackListSize (), 0, "No block beyond NextRxSequence");
+
+  // Partial then full extraction
+  Ptr<Packet> p = rxBuf->Extract (700);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 700, "Partial extraction");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->Available (), 1300, "Remaining data available");
+  p = rxBuf->Extract (10000);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 1300, "In-order data extracted as one packet");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->Size (), 0, "Buffer should be empty");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->Extract (10000), 0, "Nothing left to extract");
+
+  // Old data is ignored
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (rxBuf, 1801, 200), false, "Old data should be refused");
+}
+
+void
+TcpRxBufferTestCase::DoTeardown ()
+{
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpRxBuffer TestSuite
+ */
+class TcpRxBufferTestSuite : public TestSuite
+{
+public:
+  TcpRxBufferTestSuite ()
+    : TestSuite ("tcp-rx-buffer", UNIT)
+  {
+    AddTestCase (new TcpRxBufferTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpRxBufferTestSuite g_tcpRxBufferTestSuite; //!< Static variable for test initialization
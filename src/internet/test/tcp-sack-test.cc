@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-general-test.h"
+#include "tcp-error-model.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpSackTest");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the SACK based loss recovery of TcpSocketBase.
+ *
+ * Some segments are dropped on their way to the receiver, possibly more
+ * than once; the sender should recover them from the SACK scoreboard,
+ * with the duplicate ACK threshold or with RACK, and without waiting for
+ * its retransmission timer.
+ */
+class TcpSackTestCase : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor.
+   * \param desc The test description.
+   * \param rack Whether RACK detects the losses.
+   * \param initialCwnd The initial congestion window, in segments.
+   * \param toDrop The sequence numbers to drop, in the order of their transmissions.
+   * \param rtos The number of expected retransmission timeouts.
+   */
+  TcpSackTestCase (const std::string &desc, bool rack, uint32_t initialCwnd,
+                   const std::vector<uint32_t> &toDrop, uint32_t rtos);
+
+protected:
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual void CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                               const TcpSocketState::TcpCongState_t newValue);
+  virtual void ProcessedAck (const Ptr<const TcpSocketState> tcb,
+                             const TcpHeader& h, SocketWho who);
+  virtual void RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void FinalChecks ();
+
+private:
+  bool m_rack;                    //!< Whether RACK detects the losses
+  uint32_t m_initialCwnd;         //!< Initial congestion window, in segments
+  std::vector<uint32_t> m_toDrop; //!< Sequence numbers to drop
+  uint32_t m_expectedRtos;        //!< Expected retransmission timeouts
+  uint32_t m_rtos;                //!< Retransmission timeouts
+  uint32_t m_recoveries;          //!< Entries in the recovery state
+  SequenceNumber32 m_highestAck;  //!< Highest ACK received by the sender
+};
+
+TcpSackTestCase::TcpSackTestCase (const std::string &desc, bool rack, uint32_t initialCwnd,
+                                  const std::vector<uint32_t> &toDrop, uint32_t rtos)
+  : TcpGeneralTest (desc),
+    m_rack (rack),
+    m_initialCwnd (initialCwnd),
+    m_toDrop (toDrop),
+    m_expectedRtos (rtos),
+    m_rtos (0),
+    m_recoveries (0),
+    m_highestAck (0)
+{
+}
+
+void
+TcpSackTestCase::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (100);
+}
+
+void
+TcpSackTestCase::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, m_initialCwnd);
+}
+
+Ptr<ErrorModel>
+TcpSackTestCase::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  for (std::vector<uint32_t>::const_iterator it = m_toDrop.begin (); it != m_toDrop.end (); ++it)
+    {
+      errorModel->AddSeqToKill (SequenceNumber32 (*it));
+    }
+  return errorModel;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackTestCase::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("MinRto", TimeValue (Seconds (10.0)));
+  socket->SetAttribute ("Sack", BooleanValue (true));
+  socket->SetAttribute ("Rack", BooleanValue (m_rack));
+  return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackTestCase::CreateReceiverSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (true));
+  return socket;
+}
+
+void
+TcpSackTestCase::CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                                 const TcpSocketState::TcpCongState_t newValue)
+{
+  NS_LOG_FUNCTION (this << oldValue << newValue);
+  if (newValue == TcpSocketState::CA_RECOVERY)
+    {
+      m_recoveries++;
+    }
+}
+
+void
+TcpSackTestCase::ProcessedAck (const Ptr<const TcpSocketState> tcb,
+                               const TcpHeader& h, SocketWho who)
+{
+  if (who == SENDER && h.GetAckNumber () > m_highestAck)
+    {
+      m_highestAck = h.GetAckNumber ();
+    }
+}
+
+void
+TcpSackTestCase::RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  NS_LOG_FUNCTION (this << who);
+  if (who == SENDER)
+    {
+      m_rtos++;
+    }
+}
+
+void
+TcpSackTestCase::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_highestAck, SequenceNumber32 (1 + 100 * 500 + 1),
+                         "The data and the FIN should have been acked");
+  NS_TEST_ASSERT_MSG_EQ (m_rtos, m_expectedRtos, "Wrong number of retransmission timeouts");
+  if (m_expectedRtos == 0)
+    {
+      NS_TEST_ASSERT_MSG_GT (m_recoveries, 0, "The losses should have been recovered by SACK");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for the SACK based loss recovery of TcpSocketBase
+ */
+static class TcpSackTestSuite : public TestSuite
+{
+public:
+  TcpSackTestSuite ()
+    : TestSuite ("tcp-sack", UNIT)
+  {
+    std::vector<uint32_t> toDrop;
+    toDrop.push_back (5001);
+    AddTestCase (new TcpSackTestCase ("SACK recovery of a lost segment", false, 10, toDrop, 0),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSackTestCase ("RACK recovery of a lost segment", true, 10, toDrop, 0),
+                 TestCase::QUICK);
+
+    toDrop.push_back (5001);
+    AddTestCase (new TcpSackTestCase ("SACK recovery of a lost retransmission", false, 10, toDrop, 0),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSackTestCase ("RACK recovery of a lost retransmission", true, 10, toDrop, 0),
+                 TestCase::QUICK);
+
+    // Only a retransmission is delivered before the first original segment
+    toDrop.clear ();
+    toDrop.push_back (1);
+    AddTestCase (new TcpSackTestCase ("RACK after the loss of the first segment", true, 1, toDrop, 1),
+                 TestCase::QUICK);
+  }
+
+} g_tcpSackTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#include "ns3/test.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/packet.h"
+#include "ns3/log.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpTxBufferTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the SACK scoreboard of the Tx buffer: SACKed and lost bytes
+ * accounting, RFC 6675 and RACK loss marking, cumulative ACK trimming.
+ */
+class TcpTxBufferScoreboardTestCase : public TestCase
+{
+public:
+  TcpTxBufferScoreboardTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+};
+
+TcpTxBufferScoreboardTestCase::TcpTxBufferScoreboardTestCase ()
+  : TestCase ("TcpTxBuffer SACK scoreboard test")
+{
+}
+
+void
+TcpTxBufferScoreboardTestCase::DoRun ()
+{
+  Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer> ();
+  txBuf->SetMaxBufferSize (100000);
+  txBuf->SetHeadSequence (SequenceNumber32 (1));
+  txBuf->Add (Create<Packet> (1000));
+  txBuf->Add (Create<Packet> (1300));
+
+  // Ten segments of 100 bytes, segment i sent at i ms
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      txBuf->RecordTransmission (SequenceNumber32 (1 + 100 * i), 100, MilliSeconds (i));
+    }
+
+  TcpOptionSack::SackList sackList;
+  TcpTxItem delivered;
+  SequenceNumber32 seq;
+  uint32_t size;
+
+  // Segments 2 and 3 are SACKed
+  sackList.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (201), SequenceNumber32 (401)));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->UpdateScoreboard (SequenceNumber32 (1), sackList, &delivered), 200,
+                         "Two segments newly SACKed");
+  NS_TEST_ASSERT_MSG_EQ (delivered.m_seq, SequenceNumber32 (301), "Most recently sent segment delivered");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetSackedOut (), 200, "Wrong SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->UpdateScoreboard (SequenceNumber32 (1), sackList, &delivered), 0,
+                         "Nothing newly SACKed");
+  NS_TEST_ASSERT_MSG_EQ (delivered.m_size, 0, "Nothing newly delivered");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->MarkLostByDupThresh (3, 100), 0, "Not enough SACKed bytes above");
+
+  // Segment 5 is SACKed: segments 0 and 1 have three segments SACKed above
+  sackList.clear ();
+  sackList.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (501), SequenceNumber32 (601)));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->UpdateScoreboard (SequenceNumber32 (1), sackList, &delivered), 100,
+                         "One segment newly SACKed");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->MarkLostByDupThresh (3, 100), 200, "Two segments lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetLostOut (), 200, "Wrong lost bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->NextLost (&seq, &size), true, "A lost segment exists");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (1), "First lost segment");
+
+  // The retransmission is no longer lost
+  txBuf->RecordTransmission (SequenceNumber32 (1), 100, MilliSeconds (20));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetLostOut (), 100, "Wrong lost bytes after retransmission");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->NextLost (&seq, &size), true, "A lost segment exists");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (101), "Next lost segment");
+
+  // The retransmission is cumulatively acked
+  sackList.clear ();
+  NS_TEST_ASSERT_MSG_EQ (txBuf->UpdateScoreboard (SequenceNumber32 (101), sackList, &delivered), 0,
+                         "Nothing newly SACKed");
+  NS_TEST_ASSERT_MSG_EQ (delivered.m_seq, SequenceNumber32 (1), "Retransmission delivered");
+  NS_TEST_ASSERT_MSG_EQ (delivered.m_retrans, true, "Retransmission delivered");
+  txBuf->DiscardUpTo (SequenceNumber32 (101));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetLostOut (), 100, "Lost bytes kept");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetSackedOut (), 300, "SACKed bytes kept");
+
+  // RACK: segment 4 was sent before segment 5, delivered with an RTT of 10 ms
+  Time timeout;
+  NS_TEST_ASSERT_MSG_EQ (txBuf->MarkLostByRack (MilliSeconds (5), SequenceNumber32 (601), MilliSeconds (10),
+                                                MilliSeconds (1), MilliSeconds (14), &timeout), 0,
+                         "Segment 4 still in the reordering window");
+  NS_TEST_ASSERT_MSG_EQ (timeout, MilliSeconds (1), "Wrong reordering timeout");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->MarkLostByRack (MilliSeconds (5), SequenceNumber32 (601), MilliSeconds (10),
+                                                MilliSeconds (1), MilliSeconds (16), &timeout), 100,
+                         "Segment 4 lost");
+  NS_TEST_ASSERT_MSG_EQ (timeout, Seconds (0), "No timeout left");
+
+  // RTO: everything not SACKed is lost
+  txBuf->MarkAllLost ();
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetLostOut (), 600, "Wrong lost bytes after RTO");
+
+  txBuf->DiscardUpTo (SequenceNumber32 (1001));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetLostOut (), 0, "Scoreboard should be empty");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetSackedOut (), 0, "Scoreboard should be empty");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->NextLost (&seq, &size), false, "Scoreboard should be empty");
+
+  // A lost retransmission is detected once new data sent after it is SACKed
+  for (uint32_t i = 10; i < 20; ++i)
+    {
+      txBuf->RecordTransmission (SequenceNumber32 (1 + 100 * i), 100, MilliSeconds (20 + i));
+    }
+  sackList.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (1101), SequenceNumber32 (1401)));
+  txBuf->UpdateScoreboard (SequenceNumber32 (1001), sackList, &delivered);
+  NS_TEST_ASSERT_MSG_EQ (txBuf->MarkLostByDupThresh (3, 100), 100, "Segment 10 lost");
+  txBuf->RecordTransmission (SequenceNumber32 (1001), 100, MilliSeconds (50));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetLostOut (), 0, "Segment 10 retransmitted");
+  for (uint32_t i = 20; i < 23; ++i)
+    {
+      txBuf->RecordTransmission (SequenceNumber32 (1 + 100 * i), 100, MilliSeconds (31 + i));
+    }
+  sackList.clear ();
+  sackList.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (1101), SequenceNumber32 (2201)));
+  txBuf->UpdateScoreboard (SequenceNumber32 (1001), sackList, &delivered);
+  NS_TEST_ASSERT_MSG_EQ (txBuf->MarkLostByDupThresh (3, 100), 0, "Only two segments SACKed above the retransmission");
+  sackList.clear ();
+  sackList.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (1101), SequenceNumber32 (2301)));
+  txBuf->UpdateScoreboard (SequenceNumber32 (1001), sackList, &delivered);
+  NS_TEST_ASSERT_MSG_EQ (txBuf->MarkLostByDupThresh (3, 100), 100, "Retransmission of segment 10 lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->NextLost (&seq, &size), true, "A lost segment exists");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (1001), "Retransmission of segment 10 lost");
+  NS_TEST_ASSERT_MSG_EQ (size, 100, "Wrong size of the lost segment");
+}
+
+void
+TcpTxBufferScoreboardTestCase::DoTeardown ()
+{
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpTxBuffer TestSuite
+ */
+class TcpTxBufferTestSuite : public TestSuite
+{
+public:
+  TcpTxBufferTestSuite ()
+    : TestSuite ("tcp-tx-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferScoreboardTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpTxBufferTestSuite g_tcpTxBufferTestSuite; //!< Static variable for test initialization
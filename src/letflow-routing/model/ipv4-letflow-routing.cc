@@ -90,6 +90,14 @@ Ipv4LetFlowRouting::SetFlowletTimeout (Time timeout)
   m_flowletTimeout = timeout;
 }
 
+int64_t
+Ipv4LetFlowRouting::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_rng.SetStream (stream);
+  return 1;
+}
+
 Ptr<Ipv4Route>
 Ipv4LetFlowRouting::RouteOutput (Ptr<Packet> packet, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
 {
@@ -174,7 +182,7 @@ Ipv4LetFlowRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, P
   }
 
   // Not hit. Random Select the Port
-  selectedPort = routeEntries[rand () % routeEntries.size ()].port;
+  selectedPort = routeEntries[m_rng.GetInteger (routeEntries.size ())].port;
 
   LetFlowFlowlet flowlet;
 
@@ -10,6 +10,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/counter-rng.h"
 
 namespace ns3 {
 
@@ -53,6 +54,16 @@ public:
 
   void SetFlowletTimeout (Time timeout);
 
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
 private:
   // Flowlet Timeout
   Time m_flowletTimeout;
@@ -65,6 +76,9 @@ private:
 
   // Route table
   std::vector<LetFlowRouteEntry> m_routeEntryList;
+
+  // Used to choose the port of a new flowlet
+  CounterRng m_rng;
 };
 
 }
@@ -0,0 +1,51 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+// Print a binary link stats file written by LinkMonitor::SetOutputFile as
+// comma separated values, one line per sample:
+//
+//   probe,port,time_ns,tx_bytes,tx_utility,dequeue_bytes,dequeue_utility,
+//   packets_in_queue,bytes_in_queue,packets_in_queue_disc,bytes_in_queue_disc
+//
+// ./waf --run "link-stats-dump --file=link-monitor.bin"
+
+#include "ns3/core-module.h"
+#include "ns3/link-stats-file.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string filename = "link-monitor.bin";
+
+  CommandLine cmd;
+  cmd.AddValue ("file", "The link stats file to print", filename);
+  cmd.Parse (argc, argv);
+
+  LinkStatsReader reader;
+  if (!reader.Open (filename))
+    {
+      std::cerr << "Cannot read " << filename << std::endl;
+      return 1;
+    }
+
+  uint32_t probe;
+  uint32_t port;
+  std::vector<LinkProbe::LinkStats> stats;
+  while (reader.ReadChunk (probe, port, stats))
+    {
+      std::string name = reader.GetProbeName (probe);
+      for (std::vector<LinkProbe::LinkStats>::const_iterator it = stats.begin (); it != stats.end (); ++it)
+        {
+          std::cout << name << "," << port << ","
+                    << it->checkTime.GetNanoSeconds () << ","
+                    << it->accumulatedTxBytes << "," << it->txLinkUtility << ","
+                    << it->accumulatedDequeueBytes << "," << it->dequeueLinkUtility << ","
+                    << it->packetsInQueue << "," << it->bytesInQueue << ","
+                    << it->packetsInQueueDisc << "," << it->bytesInQueueDisc << std::endl;
+        }
+    }
+  return 0;
+}
@@ -34,6 +34,7 @@ Ipv4LinkProbe::Ipv4LinkProbe (Ptr<Node> node, Ptr<LinkMonitor> linkMonitor)
   m_ipv4 = m_ipv4 = node->GetObject<Ipv4L3Protocol> ();
 
   // Notice, the interface at 0 is loopback, we simply ignore it
+  Config::Batch batch;
   for (uint32_t interface = 1; interface < m_ipv4->GetNInterfaces (); ++interface)
   {
     m_accumulatedTxBytes[interface] = 0;
@@ -49,30 +50,31 @@ Ipv4LinkProbe::Ipv4LinkProbe (Ptr<Node> node, Ptr<LinkMonitor> linkMonitor)
 
     std::ostringstream oss;
     oss << "/NodeList/" << node->GetId () << "/DeviceList/" << interface << "/TxQueue/Dequeue";
-    Config::ConnectWithoutContext (oss.str (),
+    batch.ConnectWithoutContext (oss.str (),
             MakeCallback (&Ipv4QueueProbe::DequeueLogger, m_queueProbe[interface]));
 
     std::ostringstream oss2;
     oss2 << "/NodeList/" << node->GetId () << "/DeviceList/" << interface << "/TxQueue/PacketsInQueue";
-    Config::ConnectWithoutContext (oss2.str (),
+    batch.ConnectWithoutContext (oss2.str (),
             MakeCallback (&Ipv4QueueProbe::PacketsInQueueLogger, m_queueProbe[interface]));
 
     std::ostringstream oss3;
     oss3 << "/NodeList/" << node->GetId () << "/DeviceList/" << interface << "/TxQueue/BytesInQueue";
-    Config::ConnectWithoutContext (oss3.str (),
+    batch.ConnectWithoutContext (oss3.str (),
             MakeCallback (&Ipv4QueueProbe::BytesInQueueLogger, m_queueProbe[interface]));
 
     std::ostringstream oss4;
     oss4 << "/NodeList/" << node->GetId () << "/$ns3::TrafficControlLayer/RootQueueDiscList/" << interface << "/PacketsInQueue";
-    Config::ConnectWithoutContext (oss4.str (),
+    batch.ConnectWithoutContext (oss4.str (),
             MakeCallback (&Ipv4QueueProbe::PacketsInQueueDiscLogger, m_queueProbe[interface]));
 
     std::ostringstream oss5;
     oss5 << "/NodeList/" << node->GetId () << "/$ns3::TrafficControlLayer/RootQueueDiscList/" << interface << "/BytesInQueue";
-    Config::ConnectWithoutContext (oss5.str (),
+    batch.ConnectWithoutContext (oss5.str (),
             MakeCallback (&Ipv4QueueProbe::BytesInQueueDiscLogger, m_queueProbe[interface]));
 
   }
+  batch.Apply ();
 
   if (!m_ipv4->TraceConnectWithoutContext ("Tx",
               MakeCallback (&Ipv4LinkProbe::TxLogger, this)))
@@ -142,43 +144,26 @@ Ipv4LinkProbe::CheckCurrentStatus ()
     uint64_t lastTxBytes = 0;
     uint64_t lastDequeueBytes = 0;
 
-    std::map<uint32_t, std::vector<struct LinkProbe::LinkStats> >::iterator itr = m_stats.find (interface);
-    if (itr == m_stats.end ())
+    std::map<uint32_t, struct LinkProbe::LinkStats>::iterator itr = m_lastStats.find (interface);
+    if (itr != m_lastStats.end ())
     {
-      struct LinkProbe::LinkStats newStats;
-      newStats.checkTime = Simulator::Now ();
-      newStats.accumulatedTxBytes = m_accumulatedTxBytes[interface];
-      newStats.txLinkUtility =
-          Ipv4LinkProbe::GetLinkUtility (interface, m_accumulatedTxBytes[interface] - lastTxBytes, m_checkTime);
-      newStats.accumulatedDequeueBytes = m_accumulatedDequeueBytes[interface];
-      newStats.dequeueLinkUtility =
-          Ipv4LinkProbe::GetLinkUtility (interface, m_accumulatedDequeueBytes[interface] - lastDequeueBytes, m_checkTime);
-      newStats.packetsInQueue = m_NPacketsInQueue[interface];
-      newStats.bytesInQueue = m_NBytesInQueue[interface];
-      newStats.packetsInQueueDisc = m_NPacketsInQueueDisc[interface];
-      newStats.bytesInQueueDisc = m_NBytesInQueueDisc[interface];
-      std::vector<struct LinkProbe::LinkStats> newVector;
-      newVector.push_back (newStats);
-      m_stats[interface] = newVector;
-    }
-    else
-    {
-      lastTxBytes = (itr->second).back ().accumulatedTxBytes;
-      lastDequeueBytes = (itr->second).back ().accumulatedDequeueBytes;
-      struct LinkProbe::LinkStats newStats;
-      newStats.checkTime = Simulator::Now ();
-      newStats.accumulatedTxBytes = m_accumulatedTxBytes[interface];
-      newStats.txLinkUtility =
-          Ipv4LinkProbe::GetLinkUtility (interface, m_accumulatedTxBytes[interface] - lastTxBytes, m_checkTime);
-      newStats.accumulatedDequeueBytes = m_accumulatedDequeueBytes[interface];
-      newStats.dequeueLinkUtility =
-          Ipv4LinkProbe::GetLinkUtility (interface, m_accumulatedDequeueBytes[interface] - lastDequeueBytes, m_checkTime);
-      newStats.packetsInQueue = m_NPacketsInQueue[interface];
-      newStats.bytesInQueue = m_NBytesInQueue[interface];
-      newStats.packetsInQueueDisc = m_NPacketsInQueueDisc[interface];
-      newStats.bytesInQueueDisc = m_NPacketsInQueueDisc[interface];
-      (itr->second).push_back (newStats);
+      lastTxBytes = (itr->second).accumulatedTxBytes;
+      lastDequeueBytes = (itr->second).accumulatedDequeueBytes;
     }
+
+    struct LinkProbe::LinkStats newStats;
+    newStats.checkTime = Simulator::Now ();
+    newStats.accumulatedTxBytes = m_accumulatedTxBytes[interface];
+    newStats.txLinkUtility =
+        Ipv4LinkProbe::GetLinkUtility (interface, m_accumulatedTxBytes[interface] - lastTxBytes, m_checkTime);
+    newStats.accumulatedDequeueBytes = m_accumulatedDequeueBytes[interface];
+    newStats.dequeueLinkUtility =
+        Ipv4LinkProbe::GetLinkUtility (interface, m_accumulatedDequeueBytes[interface] - lastDequeueBytes, m_checkTime);
+    newStats.packetsInQueue = m_NPacketsInQueue[interface];
+    newStats.bytesInQueue = m_NBytesInQueue[interface];
+    newStats.packetsInQueueDisc = m_NPacketsInQueueDisc[interface];
+    newStats.bytesInQueueDisc = m_NBytesInQueueDisc[interface];
+    RecordStats (interface, newStats);
   }
 
   m_checkEvent = Simulator::Schedule (m_checkTime, &Ipv4LinkProbe::CheckCurrentStatus, this);
@@ -36,6 +36,14 @@ LinkMonitor::AddLinkProbe (Ptr<LinkProbe> probe)
   m_linkProbes.push_back (probe);
 }
 
+void
+LinkMonitor::SetOutputFile (std::string filename, uint32_t chunkSize)
+{
+  m_writer = Create<LinkStatsWriter> (filename, chunkSize);
+  // Write the tail of the samples even if the monitor is never stopped
+  Simulator::ScheduleDestroy (&LinkStatsWriter::Close, m_writer);
+}
+
 void
 LinkMonitor::Start (Time startTime)
 {
@@ -51,6 +59,15 @@ LinkMonitor::Stop (Time stopTime)
 void
 LinkMonitor::DoStart (void)
 {
+  if (m_writer != 0)
+  {
+    for (uint32_t i = 0; i < m_linkProbes.size (); ++i)
+    {
+      m_writer->AddProbe (i, m_linkProbes[i]->GetProbeName ());
+      m_linkProbes[i]->SetWriter (m_writer, i);
+    }
+  }
+
   std::vector<Ptr<LinkProbe> >::iterator itr = m_linkProbes.begin ();
   for ( ; itr != m_linkProbes.end (); ++itr)
   {
@@ -66,6 +83,23 @@ LinkMonitor::DoStop (void)
   {
     (*itr)->Stop ();
   }
+
+  if (m_writer != 0)
+  {
+    m_writer->Flush ();
+  }
+}
+
+void
+LinkMonitor::DoDispose (void)
+{
+  if (m_writer != 0)
+  {
+    m_writer->Close ();
+    m_writer = 0;
+  }
+  m_linkProbes.clear ();
+  Object::DoDispose ();
 }
 
 void
@@ -78,14 +112,14 @@ LinkMonitor::OutputToFile (std::string filename, std::string (*formatFunc)(struc
   for ( ; itr != m_linkProbes.end (); ++itr)
   {
     Ptr<LinkProbe> linkProbe = *itr;
-    std::map<uint32_t, std::vector<struct LinkProbe::LinkStats> > stats = linkProbe->GetLinkStats ();
+    const std::map<uint32_t, std::vector<struct LinkProbe::LinkStats> > &stats = linkProbe->GetLinkStats ();
     os << linkProbe->GetProbeName () << ": (contain: " << stats.size () << " ports)" << std::endl;
-    std::map<uint32_t, std::vector<struct LinkProbe::LinkStats> >::iterator portItr = stats.begin ();
+    std::map<uint32_t, std::vector<struct LinkProbe::LinkStats> >::const_iterator portItr = stats.begin ();
     for ( ; portItr != stats.end (); ++portItr)
     {
       os << "\tPort: " << portItr->first << " (contain " << (portItr->second).size ()  << " entries)"<< std::endl;
       os << "\t\t";
-      std::vector<struct LinkProbe::LinkStats>::iterator timeItr = (portItr->second).begin ();
+      std::vector<struct LinkProbe::LinkStats>::const_iterator timeItr = (portItr->second).begin ();
       for ( ; timeItr != (portItr->second).end (); ++timeItr)
       {
         os << formatFunc (*timeItr) << "\t";
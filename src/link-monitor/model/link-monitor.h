@@ -5,6 +5,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "link-probe.h"
+#include "link-stats-file.h"
 
 #include <vector>
 #include <string>
@@ -29,6 +30,15 @@ public:
 
   void OutputToFile (std::string filename, std::string (*formatFunc)(struct LinkProbe::LinkStats));
 
+  // Stream the samples of all the probes to a binary file while the
+  // simulation runs, instead of keeping them in memory for OutputToFile.
+  // Every port buffers chunkSize samples between two writes.  The file is
+  // read back with LinkStatsReader.
+  void SetOutputFile (std::string filename, uint32_t chunkSize = 1024);
+
+protected:
+  virtual void DoDispose (void);
+
 private:
 
   void DoStart (void);
@@ -37,6 +47,8 @@ private:
 
   std::vector<Ptr<LinkProbe> > m_linkProbes;
 
+  Ptr<LinkStatsWriter> m_writer;
+
 };
 
 }
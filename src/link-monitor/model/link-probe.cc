@@ -3,6 +3,7 @@
 #include "link-probe.h"
 
 #include "link-monitor.h"
+#include "link-stats-file.h"
 #include "ns3/log.h"
 
 namespace ns3 {
@@ -22,16 +23,42 @@ LinkProbe::GetTypeId (void)
 }
 
 LinkProbe::LinkProbe (Ptr<LinkMonitor> linkMonitor)
+  : m_probeIndex (0)
 {
   linkMonitor->AddLinkProbe (this);
 }
 
-std::map<uint32_t, std::vector<struct LinkProbe::LinkStats> >
-LinkProbe::GetLinkStats (void)
+LinkProbe::~LinkProbe ()
+{
+}
+
+const std::map<uint32_t, std::vector<struct LinkProbe::LinkStats> > &
+LinkProbe::GetLinkStats (void) const
 {
   return m_stats;
 }
 
+void
+LinkProbe::SetWriter (Ptr<LinkStatsWriter> writer, uint32_t probeIndex)
+{
+  m_writer = writer;
+  m_probeIndex = probeIndex;
+}
+
+void
+LinkProbe::RecordStats (uint32_t interface, const struct LinkStats &stats)
+{
+  m_lastStats[interface] = stats;
+  if (m_writer != 0)
+  {
+    m_writer->Write (m_probeIndex, interface, stats);
+  }
+  else
+  {
+    m_stats[interface].push_back (stats);
+  }
+}
+
 void
 LinkProbe::SetProbeName (std::string name)
 {
@@ -12,6 +12,7 @@
 namespace ns3 {
 
 class LinkMonitor;
+class LinkStatsWriter;
 
 class LinkProbe : public Object
 {
@@ -47,7 +48,13 @@ public:
 
   LinkProbe (Ptr<LinkMonitor> linkMonitor);
 
-  std::map<uint32_t, std::vector<struct LinkStats> > GetLinkStats (void);
+  virtual ~LinkProbe ();
+
+  // The samples kept in memory, empty when they are streamed to a file
+  const std::map<uint32_t, std::vector<struct LinkStats> > &GetLinkStats (void) const;
+
+  // Stream the samples to a writer instead of keeping them in memory
+  void SetWriter (Ptr<LinkStatsWriter> writer, uint32_t probeIndex);
 
   void SetProbeName (std::string name);
 
@@ -58,12 +65,24 @@ public:
   virtual void Stop () = 0;
 
 protected:
+  // Keep or stream a new sample of an interface
+  void RecordStats (uint32_t interface, const struct LinkStats &stats);
+
+  // map <interface, the last link stats collected>
+  std::map<uint32_t, struct LinkStats> m_lastStats;
+
   // map <interface, list of link stats collected at different time point>
   // The later ones are inserted at the tail of the list
   std::map<uint32_t, std::vector<struct LinkStats> > m_stats;
 
   // Used to help identifying the probe
   std::string m_probeName;
+
+  // Writer the samples are streamed to, if any
+  Ptr<LinkStatsWriter> m_writer;
+
+  // Index of the probe in the file of the writer
+  uint32_t m_probeIndex;
 };
 
 }
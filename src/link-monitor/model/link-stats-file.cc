@@ -0,0 +1,295 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "link-stats-file.h"
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LinkStatsFile");
+
+const uint32_t LinkStatsWriter::VERSION;
+const uint32_t LinkStatsWriter::RECORD_SIZE;
+const uint8_t LinkStatsWriter::PROBE_BLOCK;
+const uint8_t LinkStatsWriter::CHUNK_BLOCK;
+
+static const char LINK_STATS_MAGIC[8] = { 'L', 'I', 'N', 'K', 'S', 'T', 'A', 'T' };
+
+static uint8_t *
+WriteU32 (uint8_t *p, uint32_t v)
+{
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    p[i] = (v >> (8 * i)) & 0xff;
+  }
+  return p + 4;
+}
+
+static uint8_t *
+WriteU64 (uint8_t *p, uint64_t v)
+{
+  for (uint32_t i = 0; i < 8; i++)
+  {
+    p[i] = (v >> (8 * i)) & 0xff;
+  }
+  return p + 8;
+}
+
+static uint8_t *
+WriteDouble (uint8_t *p, double v)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &v, sizeof (bits));
+  return WriteU64 (p, bits);
+}
+
+static const uint8_t *
+ReadU32 (const uint8_t *p, uint32_t &v)
+{
+  v = 0;
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    v |= (uint32_t) p[i] << (8 * i);
+  }
+  return p + 4;
+}
+
+static const uint8_t *
+ReadU64 (const uint8_t *p, uint64_t &v)
+{
+  v = 0;
+  for (uint32_t i = 0; i < 8; i++)
+  {
+    v |= (uint64_t) p[i] << (8 * i);
+  }
+  return p + 8;
+}
+
+static const uint8_t *
+ReadDouble (const uint8_t *p, double &v)
+{
+  uint64_t bits;
+  p = ReadU64 (p, bits);
+  std::memcpy (&v, &bits, sizeof (v));
+  return p;
+}
+
+LinkStatsWriter::LinkStatsWriter (std::string filename, uint32_t chunkSize)
+  : m_os (filename.c_str (), std::ios::out|std::ios::binary|std::ios::trunc),
+    m_chunkSize (chunkSize > 0 ? chunkSize : 1)
+{
+  NS_LOG_FUNCTION (this << filename << chunkSize);
+  NS_ABORT_MSG_UNLESS (m_os.is_open (), "Cannot open link stats file " << filename);
+
+  uint8_t header[16];
+  std::memcpy (header, LINK_STATS_MAGIC, sizeof (LINK_STATS_MAGIC));
+  uint8_t *p = WriteU32 (header + 8, VERSION);
+  WriteU32 (p, RECORD_SIZE);
+  m_os.write ((const char *) header, sizeof (header));
+}
+
+LinkStatsWriter::~LinkStatsWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+LinkStatsWriter::AddProbe (uint32_t probe, std::string name)
+{
+  NS_LOG_FUNCTION (this << probe << name);
+  uint8_t block[9];
+  block[0] = PROBE_BLOCK;
+  uint8_t *p = WriteU32 (block + 1, probe);
+  WriteU32 (p, name.size ());
+  m_os.write ((const char *) block, sizeof (block));
+  m_os.write (name.data (), name.size ());
+}
+
+void
+LinkStatsWriter::Write (uint32_t probe, uint32_t port, const LinkProbe::LinkStats &stats)
+{
+  ChunkMap::iterator chunk = m_chunks.find (std::make_pair (probe, port));
+  if (chunk == m_chunks.end ())
+  {
+    chunk = m_chunks.insert (std::make_pair (std::make_pair (probe, port),
+                                             std::vector<LinkProbe::LinkStats> ())).first;
+    chunk->second.reserve (m_chunkSize);
+  }
+  chunk->second.push_back (stats);
+  if (chunk->second.size () >= m_chunkSize)
+  {
+    WriteChunk (chunk);
+  }
+}
+
+void
+LinkStatsWriter::WriteChunk (ChunkMap::iterator chunk)
+{
+  const std::vector<LinkProbe::LinkStats> &stats = chunk->second;
+  if (stats.empty ())
+  {
+    return;
+  }
+  NS_LOG_LOGIC ("Writing " << stats.size () << " samples of probe " << chunk->first.first
+                << " port " << chunk->first.second);
+
+  m_buffer.resize (13 + stats.size () * RECORD_SIZE);
+  uint8_t *p = &m_buffer[0];
+  *p++ = CHUNK_BLOCK;
+  p = WriteU32 (p, chunk->first.first);
+  p = WriteU32 (p, chunk->first.second);
+  p = WriteU32 (p, stats.size ());
+  for (std::vector<LinkProbe::LinkStats>::const_iterator it = stats.begin (); it != stats.end (); ++it)
+  {
+    p = WriteU64 (p, it->checkTime.GetNanoSeconds ());
+    p = WriteU64 (p, it->accumulatedTxBytes);
+    p = WriteDouble (p, it->txLinkUtility);
+    p = WriteU64 (p, it->accumulatedDequeueBytes);
+    p = WriteDouble (p, it->dequeueLinkUtility);
+    p = WriteU32 (p, it->packetsInQueue);
+    p = WriteU32 (p, it->bytesInQueue);
+    p = WriteU32 (p, it->packetsInQueueDisc);
+    p = WriteU32 (p, it->bytesInQueueDisc);
+  }
+  m_os.write ((const char *) &m_buffer[0], m_buffer.size ());
+  // Keep the capacity, the port fills the chunk again
+  chunk->second.clear ();
+}
+
+void
+LinkStatsWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (ChunkMap::iterator chunk = m_chunks.begin (); chunk != m_chunks.end (); ++chunk)
+  {
+    WriteChunk (chunk);
+  }
+  m_os.flush ();
+}
+
+void
+LinkStatsWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_os.is_open ())
+  {
+    Flush ();
+    m_os.close ();
+  }
+  m_chunks.clear ();
+}
+
+LinkStatsReader::LinkStatsReader ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+LinkStatsReader::Open (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_is.open (filename.c_str (), std::ios::in|std::ios::binary);
+  uint8_t header[16];
+  if (!m_is.read ((char *) header, sizeof (header))
+      || std::memcmp (header, LINK_STATS_MAGIC, sizeof (LINK_STATS_MAGIC)) != 0)
+  {
+    NS_LOG_ERROR (filename << " is not a link stats file");
+    return false;
+  }
+  uint32_t version;
+  uint32_t recordSize;
+  const uint8_t *p = ReadU32 (header + 8, version);
+  ReadU32 (p, recordSize);
+  if (version != LinkStatsWriter::VERSION || recordSize != LinkStatsWriter::RECORD_SIZE)
+  {
+    NS_LOG_ERROR ("Unsupported link stats file version " << version);
+    return false;
+  }
+  return true;
+}
+
+bool
+LinkStatsReader::ReadChunk (uint32_t &probe, uint32_t &port, std::vector<LinkProbe::LinkStats> &stats)
+{
+  uint8_t block[13];
+  while (m_is.read ((char *) block, 9))
+  {
+    uint32_t length;
+    const uint8_t *p = ReadU32 (block + 1, probe);
+    p = ReadU32 (p, length);
+    if (block[0] == LinkStatsWriter::PROBE_BLOCK)
+    {
+      std::string name (length, ' ');
+      if (length > 0 && !m_is.read (&name[0], length))
+      {
+        return false;
+      }
+      m_names[probe] = name;
+      continue;
+    }
+    if (block[0] != LinkStatsWriter::CHUNK_BLOCK || !m_is.read ((char *) block + 9, 4))
+    {
+      NS_LOG_ERROR ("Corrupted link stats file");
+      return false;
+    }
+    port = length;
+    uint32_t count;
+    ReadU32 (block + 9, count);
+
+    m_buffer.resize (count * LinkStatsWriter::RECORD_SIZE);
+    if (count > 0 && !m_is.read ((char *) &m_buffer[0], m_buffer.size ()))
+    {
+      NS_LOG_ERROR ("Truncated link stats file");
+      return false;
+    }
+    stats.resize (count);
+    p = count > 0 ? &m_buffer[0] : 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+      uint64_t checkTime;
+      p = ReadU64 (p, checkTime);
+      stats[i].checkTime = NanoSeconds (checkTime);
+      p = ReadU64 (p, stats[i].accumulatedTxBytes);
+      p = ReadDouble (p, stats[i].txLinkUtility);
+      p = ReadU64 (p, stats[i].accumulatedDequeueBytes);
+      p = ReadDouble (p, stats[i].dequeueLinkUtility);
+      p = ReadU32 (p, stats[i].packetsInQueue);
+      p = ReadU32 (p, stats[i].bytesInQueue);
+      p = ReadU32 (p, stats[i].packetsInQueueDisc);
+      p = ReadU32 (p, stats[i].bytesInQueueDisc);
+    }
+    return true;
+  }
+  return false;
+}
+
+std::map<uint32_t, std::vector<LinkProbe::LinkStats> >
+LinkStatsReader::ReadProbe (uint32_t probe)
+{
+  std::map<uint32_t, std::vector<LinkProbe::LinkStats> > ports;
+  uint32_t chunkProbe;
+  uint32_t port;
+  std::vector<LinkProbe::LinkStats> stats;
+  while (ReadChunk (chunkProbe, port, stats))
+  {
+    if (chunkProbe == probe)
+    {
+      std::vector<LinkProbe::LinkStats> &portStats = ports[port];
+      portStats.insert (portStats.end (), stats.begin (), stats.end ());
+    }
+  }
+  return ports;
+}
+
+std::string
+LinkStatsReader::GetProbeName (uint32_t probe) const
+{
+  std::map<uint32_t, std::string>::const_iterator it = m_names.find (probe);
+  return it == m_names.end () ? std::string () : it->second;
+}
+
+}
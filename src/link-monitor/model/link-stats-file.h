@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef LINK_STATS_FILE_H
+#define LINK_STATS_FILE_H
+
+#include "ns3/simple-ref-count.h"
+#include "link-probe.h"
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Streams the samples of link probes to a binary file.
+ *
+ * Samples are buffered per port and written as a chunk of fixed width
+ * records whenever a port has ChunkSize of them, so the memory used does
+ * not grow with the length of the run.  The file starts with the magic
+ * "LINKSTAT", a version and the size of a record, followed by blocks:
+ *
+ *   - a probe block: type 1, probe index, name length and name
+ *   - a chunk block: type 2, probe index, port, number of records and
+ *     the records
+ *
+ * A record holds the check time in nanoseconds, the accumulated TX bytes,
+ * the TX utility, the accumulated dequeue bytes, the dequeue utility and
+ * the packets and bytes in the device queue and in the queue disc.  All
+ * fields are little endian.  LinkStatsReader reads the file back.
+ */
+class LinkStatsWriter : public SimpleRefCount<LinkStatsWriter>
+{
+public:
+  /**
+   * \param filename the file to write
+   * \param chunkSize the number of samples buffered per port
+   */
+  LinkStatsWriter (std::string filename, uint32_t chunkSize);
+  ~LinkStatsWriter ();
+
+  /**
+   * \brief Declare a probe.
+   * \param probe the probe index used in the chunks
+   * \param name the probe name
+   */
+  void AddProbe (uint32_t probe, std::string name);
+
+  /**
+   * \brief Buffer a sample, writing the chunk of the port if it is full.
+   * \param probe the probe index
+   * \param port the port
+   * \param stats the sample
+   */
+  void Write (uint32_t probe, uint32_t port, const LinkProbe::LinkStats &stats);
+
+  /**
+   * \brief Write all the buffered samples.
+   */
+  void Flush (void);
+
+  /**
+   * \brief Write all the buffered samples and close the file.
+   */
+  void Close (void);
+
+  static const uint32_t VERSION = 1;        //!< File format version
+  static const uint32_t RECORD_SIZE = 56;   //!< Size of a record in bytes
+  static const uint8_t PROBE_BLOCK = 1;     //!< Type of a probe block
+  static const uint8_t CHUNK_BLOCK = 2;     //!< Type of a chunk block
+
+private:
+  typedef std::map<std::pair<uint32_t, uint32_t>, std::vector<LinkProbe::LinkStats> > ChunkMap;
+
+  /**
+   * \brief Write the chunk of a port and empty it.
+   * \param chunk the chunk, keyed by probe index and port
+   */
+  void WriteChunk (ChunkMap::iterator chunk);
+
+  std::ofstream m_os;             //!< Output file
+  uint32_t m_chunkSize;           //!< Samples buffered per port
+  ChunkMap m_chunks;              //!< Buffered samples by probe index and port
+  std::vector<uint8_t> m_buffer;  //!< Serialized chunk
+};
+
+/**
+ * \brief Reads the files written by LinkStatsWriter, one chunk at a time.
+ */
+class LinkStatsReader
+{
+public:
+  LinkStatsReader ();
+
+  /**
+   * \param filename the file to read
+   * \return false if the file cannot be opened or is not a link stats file
+   */
+  bool Open (std::string filename);
+
+  /**
+   * \brief Read the next chunk of samples.
+   * \param probe the probe index of the chunk
+   * \param port the port of the chunk
+   * \param stats the samples of the chunk, in time order
+   * \return false at the end of the file
+   */
+  bool ReadChunk (uint32_t &probe, uint32_t &port, std::vector<LinkProbe::LinkStats> &stats);
+
+  /**
+   * \brief Read all the remaining samples of a probe.
+   * \param probe the probe index
+   * \return the samples of every port, in time order
+   */
+  std::map<uint32_t, std::vector<LinkProbe::LinkStats> > ReadProbe (uint32_t probe);
+
+  /**
+   * \param probe a probe index
+   * \return the name of the probe, empty if it has not been read yet
+   */
+  std::string GetProbeName (uint32_t probe) const;
+
+private:
+  std::ifstream m_is;                         //!< Input file
+  std::map<uint32_t, std::string> m_names;    //!< Probe names read so far
+  std::vector<uint8_t> m_buffer;              //!< Serialized chunk
+};
+
+}
+
+#endif /* LINK_STATS_FILE_H */
@@ -2,6 +2,7 @@
 
 // Include a header file from your module to test.
 #include "ns3/link-monitor.h"
+#include "ns3/link-stats-file.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
@@ -46,6 +47,83 @@ LinkMonitorTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * \brief Write samples with LinkStatsWriter and read them back
+ */
+class LinkStatsFileTestCase : public TestCase
+{
+public:
+  LinkStatsFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LinkStatsFileTestCase::LinkStatsFileTestCase ()
+  : TestCase ("LinkStats binary file round trip")
+{
+}
+
+void
+LinkStatsFileTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("link-stats.bin");
+
+  // Two probes, two ports each, 10 samples per port in chunks of 3
+  Ptr<LinkStatsWriter> writer = Create<LinkStatsWriter> (filename, 3);
+  writer->AddProbe (0, "Leaf 0");
+  writer->AddProbe (1, "Spine 0");
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      for (uint32_t probe = 0; probe < 2; probe++)
+        {
+          for (uint32_t port = 1; port <= 2; port++)
+            {
+              LinkProbe::LinkStats stats;
+              stats.checkTime = MicroSeconds (10 * (i + 1));
+              stats.accumulatedTxBytes = 1000 * i + 100 * probe + port;
+              stats.txLinkUtility = 0.1 * i;
+              stats.accumulatedDequeueBytes = 2000 * i;
+              stats.dequeueLinkUtility = 0.05 * i + port;
+              stats.packetsInQueue = i;
+              stats.bytesInQueue = 1500 * i;
+              stats.packetsInQueueDisc = probe;
+              stats.bytesInQueueDisc = port;
+              writer->Write (probe, port, stats);
+            }
+        }
+    }
+  writer->Close ();
+
+  LinkStatsReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "File should be readable");
+  std::map<uint32_t, std::vector<LinkProbe::LinkStats> > ports = reader.ReadProbe (1);
+  NS_TEST_EXPECT_MSG_EQ (reader.GetProbeName (0), "Leaf 0", "Wrong probe name");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetProbeName (1), "Spine 0", "Wrong probe name");
+  NS_TEST_ASSERT_MSG_EQ (ports.size (), 2, "Both ports should be read");
+  for (uint32_t port = 1; port <= 2; port++)
+    {
+      const std::vector<LinkProbe::LinkStats> &samples = ports[port];
+      NS_TEST_ASSERT_MSG_EQ (samples.size (), 10, "All the samples should be read");
+      for (uint32_t i = 0; i < 10; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (samples[i].checkTime, MicroSeconds (10 * (i + 1)), "Wrong check time");
+          NS_TEST_EXPECT_MSG_EQ (samples[i].accumulatedTxBytes, 1000 * i + 100 + port, "Wrong TX bytes");
+          NS_TEST_EXPECT_MSG_EQ (samples[i].txLinkUtility, 0.1 * i, "Wrong TX utility");
+          NS_TEST_EXPECT_MSG_EQ (samples[i].accumulatedDequeueBytes, 2000 * i, "Wrong dequeue bytes");
+          NS_TEST_EXPECT_MSG_EQ (samples[i].dequeueLinkUtility, 0.05 * i + port, "Wrong dequeue utility");
+          NS_TEST_EXPECT_MSG_EQ (samples[i].packetsInQueue, i, "Wrong packets in queue");
+          NS_TEST_EXPECT_MSG_EQ (samples[i].bytesInQueue, 1500 * i, "Wrong bytes in queue");
+          NS_TEST_EXPECT_MSG_EQ (samples[i].packetsInQueueDisc, 1, "Wrong packets in queue disc");
+          NS_TEST_EXPECT_MSG_EQ (samples[i].bytesInQueueDisc, port, "Wrong bytes in queue disc");
+        }
+    }
+
+  LinkStatsReader badReader;
+  NS_TEST_EXPECT_MSG_EQ (badReader.Open (CreateTempDirFilename ("missing.bin")), false,
+                         "Missing file should not be readable");
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -61,6 +139,7 @@ LinkMonitorTestSuite::LinkMonitorTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new LinkMonitorTestCase1, TestCase::QUICK);
+  AddTestCase (new LinkStatsFileTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -609,6 +609,8 @@ LteHelper::InstallSingleUeDevice (Ptr<Node> n)
   Ptr<LteChunkProcessor> pData = Create<LteChunkProcessor> ();
   pData->AddCallback (MakeCallback (&LteSpectrumPhy::UpdateSinrPerceived, dlPhy));
   dlPhy->AddDataSinrChunkProcessor (pData);
+  // the data SINR is only used to decode the TBs of the UE
+  dlPhy->SetDataSinrForExpectedTbsOnly (true);
 
   if (m_usePdschForCqiGeneration)
     {
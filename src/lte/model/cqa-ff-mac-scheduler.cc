@@ -268,6 +268,7 @@ CqaFfMacScheduler::CqaFfMacScheduler ()
     m_nextRntiUl (0)
 {
   m_amc = CreateObject <LteAmc> ();
+  m_core.SetAmc (m_amc);
   m_cschedSapProvider = new CqaSchedulerMemberCschedSapProvider (this);
   m_schedSapProvider = new CqaSchedulerMemberSchedSapProvider (this);
   m_ffrSapProvider = 0;
@@ -381,15 +382,11 @@ void
 CqaFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
-  std::map <uint16_t,uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
-  if (it == m_uesTxMode.end ())
+  std::map <uint16_t,uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (params.m_rnti);
+  if (it == m_dlHarqCurrentProcessId.end ())
     {
-      m_uesTxMode.insert (std::pair <uint16_t, uint8_t> (params.m_rnti, params.m_transmissionMode));
       // generate HARQ buffers
       m_dlHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (params.m_rnti, 0));
-      DlHarqProcessesStatus_t dlHarqPrcStatus;
-      dlHarqPrcStatus.resize (8,0);
-      m_dlHarqProcessesStatus.insert (std::pair <uint16_t, DlHarqProcessesStatus_t> (params.m_rnti, dlHarqPrcStatus));
       DlHarqProcessesTimer_t dlHarqProcessesTimer;
       dlHarqProcessesTimer.resize (8,0);
       m_dlHarqProcessesTimer.insert (std::pair <uint16_t, DlHarqProcessesTimer_t> (params.m_rnti, dlHarqProcessesTimer));
@@ -409,10 +406,8 @@ CqaFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::Csc
       ulHarqdci.resize (8);
       m_ulHarqProcessesDciBuffer.insert (std::pair <uint16_t, UlHarqProcessesDciBuffer_t> (params.m_rnti, ulHarqdci));
     }
-  else
-    {
-      (*it).second = params.m_transmissionMode;
-    }
+  // the transmission mode is kept, or updated, by m_core
+  m_core.AddUe (params.m_rnti, params.m_transmissionMode);
   return;
 }
 
@@ -554,9 +549,8 @@ CqaFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::Cs
         }
     }
 
-  m_uesTxMode.erase (params.m_rnti);
+  m_core.RemoveUe (params.m_rnti);
   m_dlHarqCurrentProcessId.erase (params.m_rnti);
-  m_dlHarqProcessesStatus.erase  (params.m_rnti);
   m_dlHarqProcessesTimer.erase (params.m_rnti);
   m_dlHarqProcessesDciBuffer.erase  (params.m_rnti);
   m_dlHarqProcessesRlcPduListBuffer.erase  (params.m_rnti);
@@ -673,30 +667,7 @@ CqaFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
-  if (it == m_dlHarqCurrentProcessId.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-    }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
-  uint8_t i = (*it).second;
-  do
-    {
-      i = (i + 1) % HARQ_PROC_NUM;
-    }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
-    {
-      return (true);
-    }
-  else
-    {
-      return (false); // return a not valid harq proc id
-    }
+  return (m_core.IsDlHarqProcessAvailable (rnti));
 }
 
 
@@ -717,21 +688,16 @@ CqaFfMacScheduler::UpdateHarqProcessId (uint16_t rnti)
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
   uint8_t i = (*it).second;
   do
     {
       i = (i + 1) % HARQ_PROC_NUM;
     }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
+  while (m_core.IsDlHarqProcessBusy (rnti, i) && (i != (*it).second));
+  if (!m_core.IsDlHarqProcessBusy (rnti, i))
     {
       (*it).second = i;
-      (*itStat).second.at (i) = 1;
+      m_core.SetDlHarqProcessBusy (rnti, i, true);
     }
   else
     {
@@ -757,12 +723,7 @@ CqaFfMacScheduler::RefreshHarqProcesses ()
               // reset HARQ process
 
               NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
-              if (itStat == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
-                }
-              (*itStat).second.at (i) = 0;
+              m_core.SetDlHarqProcessBusy ((*itTimers).first, i, false);
               (*itTimers).second.at (i) = 0;
             }
           else
@@ -788,6 +749,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
   int rbgSize = GetRbgSize (m_cschedCellConfig.m_dlBandwidth);
   int numberOfRBGs = m_cschedCellConfig.m_dlBandwidth / rbgSize;
+  m_core.SetDlRbgs (numberOfRBGs, rbgSize);
   std::map <uint16_t, std::multimap <uint8_t, qos_rb_and_CQI_assigned_to_lc> > allocationMapPerRntiPerLCId;
   std::map <uint16_t, std::multimap <uint8_t, qos_rb_and_CQI_assigned_to_lc> >::iterator itMap;
   allocationMapPerRntiPerLCId.clear ();
@@ -1017,12 +979,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
             {
               // maximum number of retx reached -> drop process
               NS_LOG_INFO ("Maximum number of retransmissions reached -> drop process");
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
-              if (it == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << m_dlInfoListBuffered.at (i).m_rnti);
-                }
-              (*it).second.at (harqId) = 0;
+              m_core.SetDlHarqProcessBusy (rnti, harqId, false);
               std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
               if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                 {
@@ -1181,12 +1138,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
         {
           // update HARQ process status
           NS_LOG_INFO (this << " HARQ received ACK for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-          std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
-          if (it == m_dlHarqProcessesStatus.end ())
-            {
-              NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-            }
-          (*it).second.at (m_dlInfoListBuffered.at (i).m_harqProcessId) = 0;
+          m_core.SetDlHarqProcessBusy (m_dlInfoListBuffered.at (i).m_rnti, m_dlInfoListBuffered.at (i).m_harqProcessId, false);
           std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
@@ -1294,58 +1246,13 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       UeToAmountOfDataToTransfer.insert (std::pair<LteFlowId_t,int>(flowId,amountOfDataToTransfer));
       UeToAmountOfAssignedResources.insert (std::pair<LteFlowId_t,int>(flowId,0));
 
-      uint8_t sum = 0;
-      for (int i = 0; i < numberOfRBGs; i++)
+      // the sum of the subband CQIs is kept up to date by m_core
+      const FfMacSchedulerCore::Ue *ue = m_core.GetUe ((*itrbr).first.m_rnti);
+      if (ue == 0)
         {
-          std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-          itCqi = m_a30CqiRxed.find ((*itrbr).first.m_rnti);
-          std::map <uint16_t,uint8_t>::iterator itTxMode;
-          itTxMode = m_uesTxMode.find ((*itrbr).first.m_rnti);
-          if (itTxMode == m_uesTxMode.end ())
-            {
-              NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itrbr).first.m_rnti);
-            }
-          int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-          std::vector <uint8_t> sbCqis;
-          if (itCqi == m_a30CqiRxed.end ())
-            {
-              for (uint8_t k = 0; k < nLayer; k++)
-                {
-                  sbCqis.push_back (1);                        // start with lowest value
-                }
-            }
-          else
-            {
-              sbCqis = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-            }
-
-          uint8_t cqi1 = sbCqis.at (0);
-          uint8_t cqi2 = 1;
-          if (sbCqis.size () > 1)
-            {
-              cqi2 = sbCqis.at (1);
-            }
-
-          uint8_t sbCqi;
-          if ((cqi1 > 0)||(cqi2 > 0))               // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-            {
-              for (uint8_t k = 0; k < nLayer; k++)
-                {
-                  if (sbCqis.size () > k)
-                    {
-                      sbCqi = sbCqis.at (k);
-                    }
-                  else
-                    {
-                      // no info on this subband
-                      sbCqi = 0;
-                    }
-                  sum += sbCqi;
-                }
-            }               // end if cqi
-        }        // end of rbgNum
-
-      sbCqiSum.insert (std::pair<uint16_t, uint8_t> ((*itrbr).first.m_rnti, sum));
+          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itrbr).first.m_rnti);
+        }
+      sbCqiSum.insert (std::pair<uint16_t, uint8_t> ((*itrbr).first.m_rnti, ue->m_sbCqiSum));
     }
 
   // availableRBGs - set that contains indexes of available resource block groups
@@ -1408,7 +1315,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
               uint8_t worstCQIAmongRBGsAllocatedForThisUser = 15;
               int numberOfRBGAllocatedForThisUser = 0;
               LogicalChannelConfigListElement_s lc = m_ueLogicalChannelsConfigList.find (flowId)->second;
-              std::map <uint16_t,SbMeasResult_s>::iterator itRntiCQIsMap = m_a30CqiRxed.find (flowId.m_rnti);
+              const FfMacSchedulerCore::Ue *ue = m_core.GetUe (flowId.m_rnti);
 
               std::map <uint16_t, CqasFlowPerf_t>::iterator itStats;
 
@@ -1428,13 +1335,13 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
               if (tbr_weight < 1.0)
                 tbr_weight = 1.0;
 
-              if (itRntiCQIsMap != m_a30CqiRxed.end ())
+              if (ue != 0 && ue->m_sbCqiReported)
                 {
                   for(std::set<int>::iterator it=availableRBGs.begin (); it!=availableRBGs.end (); it++)
                     {
                       try
                         {
-                          int val = (itRntiCQIsMap->second.m_higherLayerSelected.at (*it).m_sbCqi.at (0));
+                          int val = (ue->m_sbMeasResult.m_higherLayerSelected.at (*it).m_sbCqi.at (0));
                           if (val==0)
                             val=1;                                             //if no info, use minimum
                           if (*it == currentRB)
@@ -1606,8 +1513,6 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       double doubleRbgNum = numberOfRBGs;
       double rrRatio = doubleRBgPerRnti/doubleRbgNum;
       m_rnti_per_ratio.insert (std::pair<uint16_t,double>((*itMap).first,rrRatio));
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-      itCqi = m_a30CqiRxed.find ((*itMap).first);
       uint8_t worstCqi = 15;
 
       // assign the worst value of CQI that user experienced on any of its subbands
@@ -1790,24 +1695,11 @@ CqaFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
         }
       else if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::A30 )
         {
-          // subband CQI reporting high layer configured
-          std::map <uint16_t,SbMeasResult_s>::iterator it;
+          // subband CQI reporting high layer configured: the report is
+          // kept by m_core, the timer here
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
-          it = m_a30CqiRxed.find (rnti);
-          if (it == m_a30CqiRxed.end ())
-            {
-              // create the new entry
-              m_a30CqiRxed.insert ( std::pair<uint16_t, SbMeasResult_s > (rnti, params.m_cqiList.at (i).m_sbMeasResult) );
-              m_a30CqiTimers.insert ( std::pair<uint16_t, uint32_t > (rnti, m_cqiTimersThreshold));
-            }
-          else
-            {
-              // update the CQI value and refresh correspondent timer
-              (*it).second = params.m_cqiList.at (i).m_sbMeasResult;
-              std::map <uint16_t,uint32_t>::iterator itTimers;
-              itTimers = m_a30CqiTimers.find (rnti);
-              (*itTimers).second = m_cqiTimersThreshold;
-            }
+          m_a30CqiTimers[rnti] = m_cqiTimersThreshold;
+          m_core.SetSbCqi (rnti, params.m_cqiList.at (i).m_sbMeasResult);
         }
       else
         {
@@ -2500,10 +2392,8 @@ CqaFfMacScheduler::RefreshDlCqiMaps (void)
       if ((*itA30).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
-          NS_ASSERT_MSG (itMap != m_a30CqiRxed.end (), " Does not find CQI report for user " << (*itA30).first);
           NS_LOG_INFO (this << " A30-CQI expired for user " << (*itA30).first);
-          m_a30CqiRxed.erase (itMap);
+          m_core.ResetSbCqi ((*itA30).first);
           std::map <uint16_t,uint32_t>::iterator temp = itA30;
           itA30++;
           m_a30CqiTimers.erase (temp);
@@ -221,6 +221,7 @@ FdTbfqFfMacScheduler::FdTbfqFfMacScheduler ()
     bankSize (0)
 {
   m_amc = CreateObject <LteAmc> ();
+  m_core.SetAmc (m_amc);
   m_cschedSapProvider = new FdTbfqSchedulerMemberCschedSapProvider (this);
   m_schedSapProvider = new FdTbfqSchedulerMemberSchedSapProvider (this);
   m_ffrSapProvider = 0;
@@ -350,15 +351,11 @@ void
 FdTbfqFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
-  std::map <uint16_t,uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
-  if (it == m_uesTxMode.end ())
+  std::map <uint16_t,uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (params.m_rnti);
+  if (it == m_dlHarqCurrentProcessId.end ())
     {
-      m_uesTxMode.insert (std::pair <uint16_t, double> (params.m_rnti, params.m_transmissionMode));
       // generate HARQ buffers
       m_dlHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (params.m_rnti, 0));
-      DlHarqProcessesStatus_t dlHarqPrcStatus;
-      dlHarqPrcStatus.resize (8,0);
-      m_dlHarqProcessesStatus.insert (std::pair <uint16_t, DlHarqProcessesStatus_t> (params.m_rnti, dlHarqPrcStatus));
       DlHarqProcessesTimer_t dlHarqProcessesTimer;
       dlHarqProcessesTimer.resize (8,0);
       m_dlHarqProcessesTimer.insert (std::pair <uint16_t, DlHarqProcessesTimer_t> (params.m_rnti, dlHarqProcessesTimer));
@@ -378,10 +375,8 @@ FdTbfqFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::
       ulHarqdci.resize (8);
       m_ulHarqProcessesDciBuffer.insert (std::pair <uint16_t, UlHarqProcessesDciBuffer_t> (params.m_rnti, ulHarqdci));
     }
-  else
-    {
-      (*it).second = params.m_transmissionMode;
-    }
+  // the transmission mode is kept, or updated, by m_core
+  m_core.AddUe (params.m_rnti, params.m_transmissionMode);
   return;
 }
 
@@ -467,9 +462,8 @@ FdTbfqFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider:
 {
   NS_LOG_FUNCTION (this);
   
-  m_uesTxMode.erase (params.m_rnti);
+  m_core.RemoveUe (params.m_rnti);
   m_dlHarqCurrentProcessId.erase (params.m_rnti);
-  m_dlHarqProcessesStatus.erase  (params.m_rnti);
   m_dlHarqProcessesTimer.erase (params.m_rnti);
   m_dlHarqProcessesDciBuffer.erase  (params.m_rnti);
   m_dlHarqProcessesRlcPduListBuffer.erase  (params.m_rnti);
@@ -586,30 +580,7 @@ FdTbfqFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
-  if (it == m_dlHarqCurrentProcessId.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-    }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
-  uint8_t i = (*it).second;
-  do
-    {
-      i = (i + 1) % HARQ_PROC_NUM;
-    }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
-    {
-      return (true);
-    }
-  else
-    {
-      return (false); // return a not valid harq proc id
-    }
+  return (m_core.IsDlHarqProcessAvailable (rnti));
 }
 
 
@@ -630,21 +601,16 @@ FdTbfqFfMacScheduler::UpdateHarqProcessId (uint16_t rnti)
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
   uint8_t i = (*it).second;
   do
     {
       i = (i + 1) % HARQ_PROC_NUM;
     }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
+  while (m_core.IsDlHarqProcessBusy (rnti, i) && (i != (*it).second));
+  if (!m_core.IsDlHarqProcessBusy (rnti, i))
     {
       (*it).second = i;
-      (*itStat).second.at (i) = 1;
+      m_core.SetDlHarqProcessBusy (rnti, i, true);
     }
   else
     {
@@ -670,12 +636,7 @@ FdTbfqFfMacScheduler::RefreshHarqProcesses ()
               // reset HARQ process
               
               NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
-              if (itStat == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
-                }
-              (*itStat).second.at (i) = 0;
+              m_core.SetDlHarqProcessBusy ((*itTimers).first, i, false);
               (*itTimers).second.at (i) = 0;
             }
           else
@@ -703,6 +664,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
 
   int rbgSize = GetRbgSize (m_cschedCellConfig.m_dlBandwidth);
   int rbgNum = m_cschedCellConfig.m_dlBandwidth / rbgSize;
+  m_core.SetDlRbgs (rbgNum, rbgSize);
   std::map <uint16_t, std::vector <uint16_t> > allocationMap; // RBs map per RNTI
   std::vector <bool> rbgMap;  // global RBGs map
   uint16_t rbgAllocatedNum = 0;
@@ -923,12 +885,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
             {
               // maximum number of retx reached -> drop process
               NS_LOG_INFO ("Maximum number of retransmissions reached -> drop process");
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
-              if (it == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << m_dlInfoListBuffered.at (i).m_rnti);
-                }
-              (*it).second.at (harqId) = 0;
+              m_core.SetDlHarqProcessBusy (rnti, harqId, false);
               std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
               if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                 {
@@ -1087,12 +1044,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
         {
           // update HARQ process status
           NS_LOG_INFO (this << " HARQ received ACK for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-          std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
-          if (it == m_dlHarqProcessesStatus.end ())
-            {
-              NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-            }
-          (*it).second.at (m_dlInfoListBuffered.at (i).m_harqProcessId) = 0;
+          m_core.SetDlHarqProcessBusy (m_dlInfoListBuffered.at (i).m_rnti, m_dlInfoListBuffered.at (i).m_harqProcessId, false);
           std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
@@ -1136,6 +1088,9 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
   std::set <uint16_t> allocatedRnti;   // store UEs which are already assigned RBGs
   std::set <uint8_t> allocatedRbg;  // store RBGs which are already allocated to UE
 
+  // the UEs with data, not allocated for HARQ tx and with a HARQ process available
+  m_core.PrepareDlTti (m_rlcBufferReq, rntiAllocated);
+
   int totalRbg = 0;
   while (totalRbg < rbgNum)
     {
@@ -1146,22 +1101,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
       bool firstRnti = true;
       for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
         {
-          std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-          if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
-            {
-              // UE already allocated for HARQ or without HARQ process available -> drop it
-              if (itRnti != rntiAllocated.end ())
-                {
-                  NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
-                }
-              if (!HarqProcessAvailability ((*it).first))
-                {
-                  NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
-                }
-              continue;
-           }
-          
-          if (LcActivePerFlow ((*it).first) == 0)
+          if (!m_core.IsDlCandidate ((*it).first))
             {
               continue;
             }
@@ -1243,15 +1183,12 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
         {
           totalRbg++;
 
-          std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-          itCqi = m_a30CqiRxed.find ((*itMax).first);
-          std::map <uint16_t,uint8_t>::iterator itTxMode;
-          itTxMode = m_uesTxMode.find ((*itMax).first);
-          if (itTxMode == m_uesTxMode.end ())
+          const FfMacSchedulerCore::Ue *ue = m_core.GetUe ((*itMax).first);
+          if (ue == 0)
             {
-              NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
+              NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itMax).first);
             }
-          int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+          int nLayer = ue->m_nLayers;
 
 	         // find RBG with largest achievableRate
           double achievableRateMax = 0.0;
@@ -1269,53 +1206,13 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
               if ((m_ffrSapProvider->IsDlRbgAvailableForUe (k, (*itMax).first)) == false)
                 continue;
 
-              std::vector <uint8_t> sbCqi;
-              if (itCqi == m_a30CqiRxed.end ())
-                {
-                  for (uint8_t k = 0; k < nLayer; k++)
-                    {
-                      sbCqi.push_back (1);  // start with lowest value
-                    }
-                }
-              else
-                {
-                  sbCqi = (*itCqi).second.m_higherLayerSelected.at (k).m_sbCqi;
-                }
-              uint8_t cqi1 = sbCqi.at (0);
-              uint8_t cqi2 = 1;
-              if (sbCqi.size () > 1)
+              // achievable rate of the RBG, negative if its CQI is out of range
+              double achievableRate = ue->m_dlRbgRate.at (k);
+              if ( achievableRate > achievableRateMax )
                 {
-                  cqi2 = sbCqi.at (1);
+                  achievableRateMax = achievableRate;
+                  rbgIndex = k;
                 }
-          
-              if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-                {
-                  if (LcActivePerFlow ((*itMax).first) > 0)
-                    {
-                      // this UE has data to transmit
-	              double achievableRate = 0.0;
-                      for (uint8_t j = 0; j < nLayer; j++) 
-                        {
-                          uint8_t mcs = 0; 
-                          if (sbCqi.size () > j)
-                            {                       
-                              mcs = m_amc->GetMcsFromCqi (sbCqi.at (j));
-                            }
-                          else
-                            {
-                              // no info on this subband -> worst MCS
-                              mcs = 0;
-                            }
-                          achievableRate += ((m_amc->GetTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001); // = TB size / TTI
-                        }
-
-	              if ( achievableRate > achievableRateMax )
-	      	        {
-	                  achievableRateMax = achievableRate;
-	                  rbgIndex = k;
-	                }
-	              }  // end of LcActivePerFlow
-	            }  // end of cqi
             }  // end of for rbgNum
 
           if ( rbgIndex == rbgNum)  // impossible
@@ -1352,19 +1249,19 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
 
           // calculate tb size
           std::vector <uint8_t> worstCqi (2, 15);
-          if (itCqi != m_a30CqiRxed.end ())
+          if (ue->m_sbCqiReported)
             {
               for (uint16_t k = 0; k < (*itMap).second.size (); k++)
                 {
-                  if ((*itCqi).second.m_higherLayerSelected.size () > (*itMap).second.at (k))
+                  if (ue->m_sbMeasResult.m_higherLayerSelected.size () > (*itMap).second.at (k))
                     {
                       for (uint8_t j = 0; j < nLayer; j++) 
                         {
-                          if ((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.size () > j)
+                          if (ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.size () > j)
                             {
-                              if (((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j)) < worstCqi.at (j))
+                              if ((ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j)) < worstCqi.at (j))
                                 {
-                                  worstCqi.at (j) = ((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j));
+                                  worstCqi.at (j) = (ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j));
                                 }
                             }
                           else
@@ -1450,30 +1347,27 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
           lcActives = (uint16_t)65535; // UINT16_MAX;
         }
       uint16_t RgbPerRnti = (*itMap).second.size ();
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-      itCqi = m_a30CqiRxed.find ((*itMap).first);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
-      itTxMode = m_uesTxMode.find ((*itMap).first);
-      if (itTxMode == m_uesTxMode.end ())
+      const FfMacSchedulerCore::Ue *ue = m_core.GetUe ((*itMap).first);
+      if (ue == 0)
         {
           NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itMap).first);
         }
-      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+      int nLayer = ue->m_nLayers;
       std::vector <uint8_t> worstCqi (2, 15);
-      if (itCqi != m_a30CqiRxed.end ())
+      if (ue->m_sbCqiReported)
         {
           for (uint16_t k = 0; k < (*itMap).second.size (); k++)
             {
-              if ((*itCqi).second.m_higherLayerSelected.size () > (*itMap).second.at (k))
+              if (ue->m_sbMeasResult.m_higherLayerSelected.size () > (*itMap).second.at (k))
                 {
-                  NS_LOG_INFO (this << " RBG " << (*itMap).second.at (k) << " CQI " << (uint16_t)((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (0)) );
+                  NS_LOG_INFO (this << " RBG " << (*itMap).second.at (k) << " CQI " << (uint16_t)(ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (0)) );
                   for (uint8_t j = 0; j < nLayer; j++)
                     {
-                      if ((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.size () > j)
+                      if (ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.size () > j)
                         {
-                          if (((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j)) < worstCqi.at (j))
+                          if ((ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j)) < worstCqi.at (j))
                             {
-                              worstCqi.at (j) = ((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j));
+                              worstCqi.at (j) = (ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j));
                             }
                         }
                       else
@@ -1644,24 +1538,11 @@ FdTbfqFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::S
         }
       else if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::A30 )
         {
-          // subband CQI reporting high layer configured
-          std::map <uint16_t,SbMeasResult_s>::iterator it;
+          // subband CQI reporting high layer configured: the report is
+          // kept by m_core, the timer here
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
-          it = m_a30CqiRxed.find (rnti);
-          if (it == m_a30CqiRxed.end ())
-            {
-              // create the new entry
-              m_a30CqiRxed.insert ( std::pair<uint16_t, SbMeasResult_s > (rnti, params.m_cqiList.at (i).m_sbMeasResult) );
-              m_a30CqiTimers.insert ( std::pair<uint16_t, uint32_t > (rnti, m_cqiTimersThreshold));
-            }
-          else
-            {
-              // update the CQI value and refresh correspondent timer
-              (*it).second = params.m_cqiList.at (i).m_sbMeasResult;
-              std::map <uint16_t,uint32_t>::iterator itTimers;
-              itTimers = m_a30CqiTimers.find (rnti);
-              (*itTimers).second = m_cqiTimersThreshold;
-            }
+          m_a30CqiTimers[rnti] = m_cqiTimersThreshold;
+          m_core.SetSbCqi (rnti, params.m_cqiList.at (i).m_sbMeasResult);
         }
       else
         {
@@ -2329,10 +2210,8 @@ FdTbfqFfMacScheduler::RefreshDlCqiMaps (void)
       if ((*itA30).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
-          NS_ASSERT_MSG (itMap != m_a30CqiRxed.end (), " Does not find CQI report for user " << (*itA30).first);
           NS_LOG_INFO (this << " A30-CQI expired for user " << (*itA30).first);
-          m_a30CqiRxed.erase (itMap);
+          m_core.ResetSbCqi ((*itA30).first);
           std::map <uint16_t,uint32_t>::iterator temp = itA30;
           itA30++;
           m_a30CqiTimers.erase (temp);
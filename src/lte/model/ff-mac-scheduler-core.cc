@@ -0,0 +1,394 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ff-mac-scheduler-core.h"
+#include <ns3/log.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FfMacSchedulerCore");
+
+namespace {
+
+/// Order of the UEs by RNTI, for the binary search of m_ues
+struct UeRntiLess
+{
+  /**
+   * \param ue a UE
+   * \param rnti an RNTI
+   * \return true if the RNTI of the UE is lower
+   */
+  bool operator () (const FfMacSchedulerCore::Ue &ue, uint16_t rnti) const
+  {
+    return ue.m_rnti < rnti;
+  }
+};
+
+} // unnamed namespace
+
+const uint8_t FfMacSchedulerCore::DL_HARQ_PROCESSES;
+
+FfMacSchedulerCore::FfMacSchedulerCore ()
+  : m_rbgNum (0),
+    m_rbgSize (0)
+{
+}
+
+void
+FfMacSchedulerCore::SetAmc (Ptr<LteAmc> amc)
+{
+  m_amc = amc;
+}
+
+void
+FfMacSchedulerCore::SetDlMetricCallback (DlMetricCallback metric)
+{
+  m_dlMetric = metric;
+}
+
+void
+FfMacSchedulerCore::SetDlRbgs (int rbgNum, int rbgSize)
+{
+  if (rbgNum == m_rbgNum && rbgSize == m_rbgSize)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << rbgNum << rbgSize);
+  m_rbgNum = rbgNum;
+  m_rbgSize = rbgSize;
+  for (std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      UpdateRates (*it);
+    }
+}
+
+int
+FfMacSchedulerCore::GetDlRbgNum (void) const
+{
+  return m_rbgNum;
+}
+
+FfMacSchedulerCore::Ue *
+FfMacSchedulerCore::Find (uint16_t rnti)
+{
+  std::vector<Ue>::iterator it = std::lower_bound (m_ues.begin (), m_ues.end (), rnti, UeRntiLess ());
+  if (it == m_ues.end () || it->m_rnti != rnti)
+    {
+      return 0;
+    }
+  return &(*it);
+}
+
+const FfMacSchedulerCore::Ue *
+FfMacSchedulerCore::Find (uint16_t rnti) const
+{
+  std::vector<Ue>::const_iterator it = std::lower_bound (m_ues.begin (), m_ues.end (), rnti, UeRntiLess ());
+  if (it == m_ues.end () || it->m_rnti != rnti)
+    {
+      return 0;
+    }
+  return &(*it);
+}
+
+void
+FfMacSchedulerCore::AddUe (uint16_t rnti, uint8_t txMode)
+{
+  NS_LOG_FUNCTION (this << rnti << (uint16_t) txMode);
+  std::vector<Ue>::iterator it = std::lower_bound (m_ues.begin (), m_ues.end (), rnti, UeRntiLess ());
+  if (it == m_ues.end () || it->m_rnti != rnti)
+    {
+      Ue ue;
+      ue.m_rnti = rnti;
+      ue.m_txMode = txMode;
+      ue.m_nLayers = TransmissionModesLayers::TxMode2LayerNum (txMode);
+      ue.m_dlHarqBusy = 0;
+      ue.m_sbCqiReported = false;
+      ue.m_sbCqiSum = 0;
+      ue.m_dlActiveLcs = 0;
+      ue.m_dlCandidate = false;
+      it = m_ues.insert (it, ue);
+    }
+  else if (it->m_txMode != txMode)
+    {
+      it->m_txMode = txMode;
+      it->m_nLayers = TransmissionModesLayers::TxMode2LayerNum (txMode);
+    }
+  else
+    {
+      return;
+    }
+  UpdateRates (*it);
+}
+
+void
+FfMacSchedulerCore::RemoveUe (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  std::vector<Ue>::iterator it = std::lower_bound (m_ues.begin (), m_ues.end (), rnti, UeRntiLess ());
+  if (it != m_ues.end () && it->m_rnti == rnti)
+    {
+      m_ues.erase (it);
+    }
+}
+
+const FfMacSchedulerCore::Ue *
+FfMacSchedulerCore::GetUe (uint16_t rnti) const
+{
+  return Find (rnti);
+}
+
+void
+FfMacSchedulerCore::SetSbCqi (uint16_t rnti, const SbMeasResult_s &sbMeasResult)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  Ue *ue = Find (rnti);
+  if (ue == 0)
+    {
+      NS_LOG_LOGIC (this << " A30-CQI of unknown UE " << rnti);
+      return;
+    }
+  ue->m_sbCqiReported = true;
+  ue->m_sbMeasResult = sbMeasResult;
+  UpdateRates (*ue);
+}
+
+void
+FfMacSchedulerCore::ResetSbCqi (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  Ue *ue = Find (rnti);
+  if (ue == 0 || !ue->m_sbCqiReported)
+    {
+      return;
+    }
+  ue->m_sbCqiReported = false;
+  ue->m_sbMeasResult.m_higherLayerSelected.clear ();
+  UpdateRates (*ue);
+}
+
+void
+FfMacSchedulerCore::UpdateRates (Ue &ue)
+{
+  NS_LOG_FUNCTION (this << ue.m_rnti);
+  uint8_t nLayers = ue.m_nLayers;
+  ue.m_sbCqi.assign (m_rbgNum * nLayers, 0);
+  ue.m_dlRbgRate.assign (m_rbgNum, -1.0);
+  ue.m_sbCqiSum = 0;
+  std::vector<uint8_t> lowest (nLayers, 1);  // start with lowest value
+  for (int i = 0; i < m_rbgNum; i++)
+    {
+      const std::vector<uint8_t> &sbCqis = ue.m_sbCqiReported ? ue.m_sbMeasResult.m_higherLayerSelected.at (i).m_sbCqi : lowest;
+      uint8_t cqi1 = sbCqis.at (0);
+      uint8_t cqi2 = 1;
+      if (sbCqis.size () > 1)
+        {
+          cqi2 = sbCqis.at (1);
+        }
+      if ((cqi1 == 0) && (cqi2 == 0))
+        {
+          // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+          continue;
+        }
+      double achievableRate = 0.0;
+      for (uint8_t k = 0; k < nLayers; k++)
+        {
+          uint8_t mcs = 0;
+          if (sbCqis.size () > k)
+            {
+              ue.m_sbCqi[i * nLayers + k] = sbCqis.at (k);
+              ue.m_sbCqiSum += sbCqis.at (k);
+              mcs = m_amc->GetMcsFromCqi (sbCqis.at (k));
+            }
+          else
+            {
+              // no info on this subband -> worst MCS
+              mcs = 0;
+            }
+          achievableRate += ((m_amc->GetTbSizeFromMcs (mcs, m_rbgSize) / 8) / 0.001);   // = TB size / TTI
+        }
+      ue.m_dlRbgRate[i] = achievableRate;
+    }
+}
+
+void
+FfMacSchedulerCore::SetDlHarqProcessBusy (uint16_t rnti, uint8_t harqId, bool busy)
+{
+  NS_LOG_FUNCTION (this << rnti << (uint16_t) harqId << busy);
+  NS_ASSERT (harqId < DL_HARQ_PROCESSES);
+  Ue *ue = Find (rnti);
+  if (ue == 0)
+    {
+      return;
+    }
+  if (busy)
+    {
+      ue->m_dlHarqBusy |= (1 << harqId);
+    }
+  else
+    {
+      ue->m_dlHarqBusy &= ~(1 << harqId);
+    }
+}
+
+bool
+FfMacSchedulerCore::IsDlHarqProcessBusy (uint16_t rnti, uint8_t harqId) const
+{
+  NS_ASSERT (harqId < DL_HARQ_PROCESSES);
+  const Ue *ue = Find (rnti);
+  if (ue == 0)
+    {
+      NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << rnti);
+    }
+  return (ue->m_dlHarqBusy & (1 << harqId)) != 0;
+}
+
+bool
+FfMacSchedulerCore::IsDlHarqProcessAvailable (uint16_t rnti) const
+{
+  const Ue *ue = Find (rnti);
+  if (ue == 0)
+    {
+      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
+    }
+  return ue->m_dlHarqBusy != 0xff;
+}
+
+void
+FfMacSchedulerCore::PrepareDlTti (const std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> &rlcBufferReq,
+                                  const std::set <uint16_t> &rntiAllocated)
+{
+  NS_LOG_FUNCTION (this);
+  // both the UEs and the LCs are sorted by RNTI
+  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::const_iterator itLc = rlcBufferReq.begin ();
+  for (std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      it->m_dlActiveLcs = 0;
+      while (itLc != rlcBufferReq.end () && itLc->first.m_rnti < it->m_rnti)
+        {
+          ++itLc;
+        }
+      for (; itLc != rlcBufferReq.end () && itLc->first.m_rnti == it->m_rnti; ++itLc)
+        {
+          if ((itLc->second.m_rlcTransmissionQueueSize > 0)
+              || (itLc->second.m_rlcRetransmissionQueueSize > 0)
+              || (itLc->second.m_rlcStatusPduSize > 0))
+            {
+              it->m_dlActiveLcs++;
+            }
+        }
+      it->m_dlCandidate = false;
+      if (rntiAllocated.find (it->m_rnti) != rntiAllocated.end ())
+        {
+          NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << it->m_rnti);
+        }
+      else if (it->m_dlHarqBusy == 0xff)
+        {
+          NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << it->m_rnti);
+        }
+      else
+        {
+          it->m_dlCandidate = it->m_dlActiveLcs > 0;
+        }
+    }
+}
+
+bool
+FfMacSchedulerCore::IsDlCandidate (uint16_t rnti) const
+{
+  const Ue *ue = Find (rnti);
+  return ue != 0 && ue->m_dlCandidate;
+}
+
+void
+FfMacSchedulerCore::SetDlCandidate (uint16_t rnti, bool candidate)
+{
+  Ue *ue = Find (rnti);
+  if (ue != 0)
+    {
+      ue->m_dlCandidate = candidate;
+    }
+}
+
+void
+FfMacSchedulerCore::ComputeDlMetrics (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (!m_dlMetric.IsNull (), "No DL metric callback");
+  m_dlMetrics.assign (m_ues.size () * m_rbgNum, 0.0);
+  m_dlBest.assign (m_rbgNum, m_ues.size ());
+  for (uint32_t u = 0; u < m_ues.size (); u++)
+    {
+      if (!m_ues[u].m_dlCandidate)
+        {
+          continue;
+        }
+      double *metrics = &m_dlMetrics[u * m_rbgNum];
+      m_dlMetric (m_ues[u], metrics);
+      for (int rbg = 0; rbg < m_rbgNum; rbg++)
+        {
+          // the UEs are in RNTI order: the first one wins the ties
+          if (metrics[rbg] > 0
+              && (m_dlBest[rbg] == m_ues.size () || metrics[rbg] > m_dlMetrics[m_dlBest[rbg] * m_rbgNum + rbg]))
+            {
+              m_dlBest[rbg] = u;
+            }
+        }
+    }
+}
+
+uint16_t
+FfMacSchedulerCore::SelectDlUe (int rbg, LteFfrSapProvider *ffr)
+{
+  NS_LOG_FUNCTION (this << rbg);
+  NS_ASSERT (rbg < m_rbgNum);
+  NS_ASSERT (m_dlMetrics.size () == m_ues.size () * m_rbgNum);
+  uint32_t best = m_dlBest[rbg];
+  if (best == m_ues.size ())
+    {
+      return 0;
+    }
+  if (ffr->IsDlRbgAvailableForUe (rbg, m_ues[best].m_rnti))
+    {
+      NS_LOG_LOGIC (this << " RBG " << rbg << " RNTI " << m_ues[best].m_rnti << " metric " << m_dlMetrics[best * m_rbgNum + rbg]);
+      return m_ues[best].m_rnti;
+    }
+  // the best candidate is not allowed to use the RBG: try the others in metric order
+  m_heap.clear ();
+  for (uint32_t u = 0; u < m_ues.size (); u++)
+    {
+      double metric = m_dlMetrics[u * m_rbgNum + rbg];
+      if (metric > 0 && u != best)
+        {
+          m_heap.push_back (Candidate (metric, m_ues[u].m_rnti));
+        }
+    }
+  std::make_heap (m_heap.begin (), m_heap.end (), CandidateLess ());
+  while (!m_heap.empty ())
+    {
+      Candidate best = m_heap.front ();
+      if (ffr->IsDlRbgAvailableForUe (rbg, best.second))
+        {
+          NS_LOG_LOGIC (this << " RBG " << rbg << " RNTI " << best.second << " metric " << best.first);
+          return best.second;
+        }
+      std::pop_heap (m_heap.begin (), m_heap.end (), CandidateLess ());
+      m_heap.pop_back ();
+    }
+  return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,275 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_SCHEDULER_CORE_H
+#define FF_MAC_SCHEDULER_CORE_H
+
+#include <ns3/lte-common.h>
+#include <ns3/ff-mac-common.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <ns3/lte-amc.h>
+#include <ns3/lte-ffr-sap.h>
+#include <ns3/callback.h>
+#include <vector>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace ns3 {
+
+/**
+ * \ingroup ff-api
+ * \brief The DL state of the UEs of a cell, shared by the FF MAC schedulers
+ *
+ * The schedulers used to derive, for every RBG of every TTI, the rate
+ * each UE could achieve from its last A30 CQI report, and to look up the
+ * HARQ processes and the RLC buffers of the UE in maps.  This class keeps
+ * this state in a table of UEs sorted by RNTI, updated when the state
+ * changes rather than when it is read.  It is the only copy of the
+ * transmission mode, of the last A30 CQI report and of the status of the
+ * DL HARQ processes of the UEs, which the schedulers read from GetUe and
+ * IsDlHarqProcessBusy:
+ *
+ * - the achievable rate of each RBG of a UE is computed when its A30 CQI
+ *   report is received or expires, or when its transmission mode changes;
+ * - the busy DL HARQ processes of a UE are a bitmask, updated whenever the
+ *   scheduler changes the status of one of them;
+ * - the UEs which may be given RBGs in a TTI (the candidates) are found
+ *   once per TTI, by PrepareDlTti.
+ *
+ * The scheduling policy is plugged in by the DL metric callback, which
+ * gives the metric of each RBG for a candidate UE.  ComputeDlMetrics keeps
+ * the best candidate of each RBG while it fills the metrics, so that
+ * SelectDlUe only has to check it against the FFR restrictions; the other
+ * candidates of the RBG are sorted in a heap only if the FFR algorithm
+ * rejects it.  Ties are broken in favour of the lowest RNTI, so that the
+ * allocation is the same as the one of a loop over the UEs in RNTI order.
+ */
+class FfMacSchedulerCore
+{
+public:
+  /// The number of DL HARQ processes of a UE
+  static const uint8_t DL_HARQ_PROCESSES = 8;
+
+  /**
+   * \brief The DL state of a UE
+   */
+  struct Ue
+  {
+    uint16_t m_rnti;                    ///< RNTI
+    uint8_t m_txMode;                   ///< transmission mode
+    uint8_t m_nLayers;                  ///< number of layers of the transmission mode
+    uint8_t m_dlHarqBusy;               ///< bitmask of the busy DL HARQ processes
+    bool m_sbCqiReported;               ///< whether an A30 CQI report is available
+    SbMeasResult_s m_sbMeasResult;      ///< the last A30 CQI report
+    /**
+     * The subband CQI of each RBG and layer, m_nLayers per RBG, 0 if not
+     * reported.  Without A30 report, the lowest CQI (1) is assumed.
+     */
+    std::vector<uint8_t> m_sbCqi;
+    /**
+     * The rate (bytes/s) achievable on each RBG, or a negative value if
+     * the CQI of the RBG is out of range
+     */
+    std::vector<double> m_dlRbgRate;
+    /// the sum of the subband CQIs of all RBGs and layers, as used by the CoItA metrics
+    uint8_t m_sbCqiSum;
+    uint16_t m_dlActiveLcs;             ///< number of LCs with data, in the current TTI
+    bool m_dlCandidate;                 ///< whether the UE may be given RBGs in the current TTI
+  };
+
+  /**
+   * The DL metric callback: fill the metric of each RBG, given as an
+   * array of GetDlRbgNum () values, for a candidate UE.  Only the RBGs
+   * whose metric is positive may be allocated to the UE.
+   */
+  typedef Callback<void, const Ue &, double *> DlMetricCallback;
+
+  FfMacSchedulerCore ();
+
+  /**
+   * \param amc the AMC module used to compute the achievable rates
+   */
+  void SetAmc (Ptr<LteAmc> amc);
+
+  /**
+   * \param metric the DL metric callback of the scheduling policy
+   */
+  void SetDlMetricCallback (DlMetricCallback metric);
+
+  /**
+   * Set the RBGs of the DL bandwidth.  The achievable rates of all UEs are
+   * computed again if they change.
+   *
+   * \param rbgNum the number of RBGs
+   * \param rbgSize the number of RBs of an RBG
+   */
+  void SetDlRbgs (int rbgNum, int rbgSize);
+
+  /// \return the number of RBGs
+  int GetDlRbgNum (void) const;
+
+  /**
+   * Add a UE, with all its DL HARQ processes idle, or update its
+   * transmission mode if it is already known.
+   *
+   * \param rnti the RNTI
+   * \param txMode the transmission mode
+   */
+  void AddUe (uint16_t rnti, uint8_t txMode);
+
+  /// \param rnti the RNTI of the UE to remove
+  void RemoveUe (uint16_t rnti);
+
+  /**
+   * \param rnti the RNTI
+   * \return the state of the UE, or 0 if the UE is unknown
+   */
+  const Ue * GetUe (uint16_t rnti) const;
+
+  /**
+   * Record the A30 CQI report of a UE.
+   *
+   * \param rnti the RNTI
+   * \param sbMeasResult the subband CQI report
+   */
+  void SetSbCqi (uint16_t rnti, const SbMeasResult_s &sbMeasResult);
+
+  /**
+   * Forget the A30 CQI report of a UE, when it expires.
+   *
+   * \param rnti the RNTI
+   */
+  void ResetSbCqi (uint16_t rnti);
+
+  /**
+   * Record the status change of a DL HARQ process.
+   *
+   * \param rnti the RNTI
+   * \param harqId the HARQ process id
+   * \param busy whether the process is busy, that is its status is not 0
+   */
+  void SetDlHarqProcessBusy (uint16_t rnti, uint8_t harqId, bool busy);
+
+  /**
+   * \param rnti the RNTI
+   * \param harqId the HARQ process id
+   * \return whether the DL HARQ process is busy
+   */
+  bool IsDlHarqProcessBusy (uint16_t rnti, uint8_t harqId) const;
+
+  /**
+   * \param rnti the RNTI
+   * \return whether the UE has an idle DL HARQ process
+   */
+  bool IsDlHarqProcessAvailable (uint16_t rnti) const;
+
+  /**
+   * Find the candidates of a TTI: the UEs which have an idle DL HARQ
+   * process and an LC with data, and are not already allocated for a
+   * HARQ retransmission.
+   *
+   * \param rlcBufferReq the RLC buffer status of the LCs
+   * \param rntiAllocated the UEs allocated for HARQ retransmissions
+   */
+  void PrepareDlTti (const std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> &rlcBufferReq,
+                     const std::set <uint16_t> &rntiAllocated);
+
+  /**
+   * \param rnti the RNTI
+   * \return whether the UE is a candidate of the current TTI
+   */
+  bool IsDlCandidate (uint16_t rnti) const;
+
+  /**
+   * Restrict the candidates of the current TTI, for a policy which selects
+   * a subset of them first.
+   *
+   * \param rnti the RNTI
+   * \param candidate whether the UE remains a candidate
+   */
+  void SetDlCandidate (uint16_t rnti, bool candidate);
+
+  /**
+   * Compute the metrics of all the RBGs for the candidates of the
+   * current TTI, by the DL metric callback, and the best candidate of each
+   * RBG.  They must be computed again if the candidates change.
+   */
+  void ComputeDlMetrics (void);
+
+  /**
+   * Select the UE with the highest positive metric for an RBG.
+   *
+   * \param rbg the RBG
+   * \param ffr the FFR SAP, checked for the candidates in metric order
+   * \return the RNTI of the selected UE, or 0 if none
+   */
+  uint16_t SelectDlUe (int rbg, LteFfrSapProvider *ffr);
+
+private:
+  /**
+   * \param rnti the RNTI
+   * \return the UE, or 0 if unknown
+   */
+  Ue * Find (uint16_t rnti);
+  /**
+   * \param rnti the RNTI
+   * \return the UE, or 0 if unknown
+   */
+  const Ue * Find (uint16_t rnti) const;
+  /**
+   * Compute the subband CQIs and the achievable rates of a UE, from its
+   * A30 CQI report and transmission mode.
+   *
+   * \param ue the UE
+   */
+  void UpdateRates (Ue &ue);
+
+  /// A candidate of an RBG: the metric and the RNTI
+  typedef std::pair<double, uint16_t> Candidate;
+
+  /**
+   * \brief The order of the candidates in the heap: highest metric first,
+   * then lowest RNTI.
+   */
+  struct CandidateLess
+  {
+    /**
+     * \param a a candidate
+     * \param b a candidate
+     * \return true if a comes after b
+     */
+    bool operator () (const Candidate &a, const Candidate &b) const
+    {
+      return a.first < b.first || (a.first == b.first && a.second > b.second);
+    }
+  };
+
+  Ptr<LteAmc> m_amc;                    ///< AMC module
+  DlMetricCallback m_dlMetric;          ///< DL metric of the scheduling policy
+  int m_rbgNum;                         ///< number of RBGs
+  int m_rbgSize;                        ///< number of RBs of an RBG
+  std::vector<Ue> m_ues;                ///< the UEs, sorted by RNTI
+  /// the metrics of the candidates, m_rbgNum per UE of m_ues
+  std::vector<double> m_dlMetrics;
+  /// the index in m_ues of the best candidate of each RBG, or m_ues.size () if none
+  std::vector<uint32_t> m_dlBest;
+  std::vector<Candidate> m_heap;        ///< candidates of the RBG being selected
+};
+
+} // namespace ns3
+
+#endif /* FF_MAC_SCHEDULER_CORE_H */
@@ -50,20 +50,39 @@ void
 LteChunkProcessor::Start ()
 {
   NS_LOG_FUNCTION (this);
-  m_sumValues = 0;
+  if (m_sumValues != 0)
+    {
+      // keep the storage for the next calculation
+      (*m_sumValues) = 0.0;
+    }
   m_totDuration = MicroSeconds (0);
 }
 
+void
+LteChunkProcessor::PrepareSum (const SpectrumValue& value)
+{
+  if (m_sumValues == 0 || m_sumValues->GetSpectrumModel () != value.GetSpectrumModel ())
+    {
+      m_sumValues = Create<SpectrumValue> (value.GetSpectrumModel ());
+    }
+}
+
 
 void
 LteChunkProcessor::EvaluateChunk (const SpectrumValue& sinr, Time duration)
 {
   NS_LOG_FUNCTION (this << sinr << duration);
-  if (m_sumValues == 0)
-    {
-      m_sumValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
-    }
-  (*m_sumValues) += sinr * duration.GetSeconds ();
+  PrepareSum (sinr);
+  m_sumValues->AddScaled (sinr, duration.GetSeconds ());
+  m_totDuration += duration;
+}
+
+void
+LteChunkProcessor::EvaluateChunks (const SpectrumValue& sum, Time duration)
+{
+  NS_LOG_FUNCTION (this << sum << duration);
+  PrepareSum (sum);
+  (*m_sumValues) += sum;
   m_totDuration += duration;
 }
 
@@ -73,10 +92,19 @@ LteChunkProcessor::End ()
   NS_LOG_FUNCTION (this);
   if (m_totDuration.GetSeconds () > 0)
     {
+      if (m_average == 0)
+        {
+          m_average = m_sumValues->Copy ();
+        }
+      else
+        {
+          (*m_average) = (*m_sumValues);
+        }
+      (*m_average) /= m_totDuration.GetSeconds ();
       std::vector<LteChunkProcessorCallback>::iterator it;
       for (it = m_lteChunkProcessorCallbacks.begin (); it != m_lteChunkProcessorCallbacks.end (); it++)
         {
-          (*it)((*m_sumValues) / m_totDuration.GetSeconds ());
+          (*it)(*m_average);
         }
     }
   else
@@ -72,6 +72,15 @@ public:
     */
   virtual void EvaluateChunk (const SpectrumValue& sinr, Time duration);
 
+  /**
+    * \brief Collect the sum of several chunks
+    *
+    * \param sum the sum of the values of the chunks, each multiplied by
+    * the duration of its chunk
+    * \param duration the total duration of the chunks
+    */
+  virtual void EvaluateChunks (const SpectrumValue& sum, Time duration);
+
   /**
     * \brief Finish calculation and inform interested objects about calculated value
     *
@@ -82,7 +91,15 @@ public:
   virtual void End ();
 
 private:
+  /**
+   * \brief Allocate m_sumValues if it is not allocated yet, or if its
+   * SpectrumModel differs from the one of the given value.
+   * \param value the value to be summed
+   */
+  void PrepareSum (const SpectrumValue& value);
+
   Ptr<SpectrumValue> m_sumValues;
+  Ptr<SpectrumValue> m_average; ///< the value passed to the callbacks, kept to reuse its storage
   Time m_totDuration;
 
   std::vector<LteChunkProcessorCallback> m_lteChunkProcessorCallbacks;
@@ -32,6 +32,7 @@ NS_LOG_COMPONENT_DEFINE ("LteInterference");
 
 LteInterference::LteInterference ()
   : m_receiving (false),
+    m_sinrEnabled (true),
     m_lastSignalId (0),
     m_lastSignalIdBeforeReset (0)
 {
@@ -75,21 +76,26 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
   if (m_receiving == false)
     {
       NS_LOG_LOGIC ("first signal");
-      m_rxSignal = rxPsd->Copy ();
-      m_lastChangeTime = Now ();
-      m_receiving = true;
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
-        {
-          (*it)->Start ();
-        }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
+      Ptr<const SpectrumModel> model = rxPsd->GetSpectrumModel ();
+      if (m_rxSignal == 0 || m_rxSignal->GetSpectrumModel () != model)
         {
-          (*it)->Start ();
+          m_rxSignal = rxPsd->Copy ();
+          m_rsPowerSum = SpectrumValue (model);
+          m_interfSum = SpectrumValue (model);
+          m_sinrSum = SpectrumValue (model);
         }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
+      else
         {
-          (*it)->Start (); 
+          // reuse the storage of the previous RX attempt
+          *m_rxSignal = *rxPsd;
+          m_rsPowerSum = 0.0;
+          m_interfSum = 0.0;
+          m_sinrSum = 0.0;
         }
+      m_chunksDuration = Seconds (0);
+      m_sinrEnabled = true;
+      m_lastChangeTime = Now ();
+      m_receiving = true;
     }
   else
     {
@@ -115,18 +121,40 @@ LteInterference::EndRx ()
     {
       ConditionallyEvaluateChunk ();
       m_receiving = false;
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
+      EndChunkProcessors (m_rsPowerChunkProcessorList, m_rsPowerSum);
+      EndChunkProcessors (m_interfChunkProcessorList, m_interfSum);
+      if (m_sinrEnabled)
         {
-          (*it)->End ();
+          EndChunkProcessors (m_sinrChunkProcessorList, m_sinrSum);
         }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
+      else
         {
-          (*it)->End ();
+          NS_LOG_LOGIC (this << " SINR not evaluated for this RX");
         }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
+    }
+}
+
+void
+LteInterference::EndChunkProcessors (const std::vector<Ptr<LteChunkProcessor> > &processors, const SpectrumValue &sum)
+{
+  for (std::vector<Ptr<LteChunkProcessor> >::const_iterator it = processors.begin (); it != processors.end (); ++it)
+    {
+      (*it)->Start ();
+      if (m_chunksDuration > Seconds (0))
         {
-          (*it)->End (); 
+          (*it)->EvaluateChunks (sum, m_chunksDuration);
         }
+      (*it)->End ();
+    }
+}
+
+void
+LteInterference::DisableSinrForCurrentRx ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_receiving)
+    {
+      m_sinrEnabled = false;
     }
 }
 
@@ -188,22 +216,40 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-
-      SpectrumValue sinr = (*m_rxSignal) / interf;
       Time duration = Now () - m_lastChangeTime;
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
-        {
-          (*it)->EvaluateChunk (sinr, duration);
-        }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
-        {
-          (*it)->EvaluateChunk (interf, duration);
-        }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
+      double dt = duration.GetSeconds ();
+      bool rsPower = !m_rsPowerChunkProcessorList.empty ();
+      bool interf = !m_interfChunkProcessorList.empty ();
+      bool sinr = m_sinrEnabled && !m_sinrChunkProcessorList.empty ();
+      NS_ASSERT (m_allSignals->GetSpectrumModel () == m_rxSignal->GetSpectrumModel ());
+      NS_ASSERT (m_noise->GetSpectrumModel () == m_rxSignal->GetSpectrumModel ());
+      size_t n = m_rxSignal->GetSpectrumModel ()->GetNumBands ();
+      if (n > 0)
         {
-          (*it)->EvaluateChunk (*m_rxSignal, duration);
+          const double *s = &(*m_rxSignal->ConstValuesBegin ());
+          const double *a = &(*m_allSignals->ConstValuesBegin ());
+          const double *w = &(*m_noise->ConstValuesBegin ());
+          double *rsPowerSum = &(*m_rsPowerSum.ValuesBegin ());
+          double *interfSum = &(*m_interfSum.ValuesBegin ());
+          double *sinrSum = &(*m_sinrSum.ValuesBegin ());
+          for (size_t i = 0; i < n; ++i)
+            {
+              double in = a[i] - s[i] + w[i];
+              if (rsPower)
+                {
+                  rsPowerSum[i] += s[i] * dt;
+                }
+              if (interf)
+                {
+                  interfSum[i] += in * dt;
+                }
+              if (sinr)
+                {
+                  sinrSum[i] += (s[i] / in) * dt;
+                }
+            }
         }
+      m_chunksDuration += duration;
       m_lastChangeTime = Now ();
     }
 }
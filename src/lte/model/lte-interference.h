@@ -27,7 +27,7 @@
 #include <ns3/nstime.h>
 #include <ns3/spectrum-value.h>
 
-#include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -42,6 +42,10 @@ class LteChunkProcessor;
  * This class implements a gaussian interference model, i.e., all
  * incoming signals are added to the total interference.
  *
+ * The power, interference and SINR of each chunk of an RX attempt are
+ * accumulated, weighted by the duration of the chunk, in buffers kept
+ * across RX attempts, in a single pass over the resource blocks.  The
+ * chunk processors are given the sums once, when the RX attempt ends.
  */
 class LteInterference : public Object
 {
@@ -114,8 +118,28 @@ public:
    */
   void SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd);
 
+  /**
+   * Do not evaluate the SINR of the RX attempt in progress, e.g.,
+   * because it carries no data for the receiver.  The SINR chunk
+   * processors are not notified at the end of this RX attempt, while
+   * the power and interference chunk processors still are.  The SINR
+   * is evaluated again from the next RX attempt.
+   */
+  void DisableSinrForCurrentRx ();
+
 private:
+  /**
+   * Accumulate the chunk since the last change, weighted by its
+   * duration, into the sums of the current RX attempt.
+   */
   void ConditionallyEvaluateChunk ();
+  /**
+   * Notify the processors of the sum accumulated over the RX attempt.
+   *
+   * \param processors the chunk processors to notify
+   * \param sum the sum of the chunks weighted by their duration
+   */
+  void EndChunkProcessors (const std::vector<Ptr<LteChunkProcessor> > &processors, const SpectrumValue &sum);
   void DoAddSignal  (Ptr<const SpectrumValue> spd);
   void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId);
 
@@ -135,6 +159,12 @@ private:
 
   Ptr<const SpectrumValue> m_noise;
 
+  SpectrumValue m_rsPowerSum; ///< sum of the RX signal of the chunks times their duration
+  SpectrumValue m_interfSum;  ///< sum of the interference plus noise of the chunks times their duration
+  SpectrumValue m_sinrSum;    ///< sum of the SINR of the chunks times their duration
+  Time m_chunksDuration;      ///< total duration of the chunks of the RX attempt
+  bool m_sinrEnabled;         ///< whether the SINR of the RX attempt is evaluated
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
@@ -143,15 +173,15 @@ private:
 
   /** all the processor instances that need to be notified whenever
   a new interference chunk is calculated */
-  std::list<Ptr<LteChunkProcessor> > m_rsPowerChunkProcessorList;
+  std::vector<Ptr<LteChunkProcessor> > m_rsPowerChunkProcessorList;
 
   /** all the processor instances that need to be notified whenever
       a new SINR chunk is calculated */
-  std::list<Ptr<LteChunkProcessor> > m_sinrChunkProcessorList;
+  std::vector<Ptr<LteChunkProcessor> > m_sinrChunkProcessorList;
 
   /** all the processor instances that need to be notified whenever
       a new interference chunk is calculated */
-  std::list<Ptr<LteChunkProcessor> > m_interfChunkProcessorList;
+  std::vector<Ptr<LteChunkProcessor> > m_interfChunkProcessorList;
 
 
 };
@@ -114,6 +114,7 @@ NS_OBJECT_ENSURE_REGISTERED (LteSpectrumPhy);
 LteSpectrumPhy::LteSpectrumPhy ()
   : m_state (IDLE),
     m_cellId (0),
+  m_dataSinrForExpectedTbsOnly (false),
   m_transmissionMode (0),
   m_layersNum (1)
 {
@@ -719,6 +720,11 @@ LteSpectrumPhy::StartRxData (Ptr<LteSpectrumSignalParametersDataFrame> params)
                 {
                   m_rxPacketBurstList.push_back (params->packetBurst);
                   m_interferenceData->StartRx (params->psd);
+                  if (m_dataSinrForExpectedTbsOnly && m_expectedTbs.empty ())
+                    {
+                      NS_LOG_LOGIC (this << " no expected TB, data SINR not evaluated");
+                      m_interferenceData->DisableSinrForCurrentRx ();
+                    }
                   
                   m_phyRxStartTrace (params->packetBurst);
                 }
@@ -1208,6 +1214,13 @@ LteSpectrumPhy::AddDataSinrChunkProcessor (Ptr<LteChunkProcessor> p)
   m_interferenceData->AddSinrChunkProcessor (p);
 }
 
+void
+LteSpectrumPhy::SetDataSinrForExpectedTbsOnly (bool enabled)
+{
+  NS_LOG_FUNCTION (this << enabled);
+  m_dataSinrForExpectedTbsOnly = enabled;
+}
+
 void
 LteSpectrumPhy::AddInterferenceCtrlChunkProcessor (Ptr<LteChunkProcessor> p)
 {
@@ -347,6 +347,16 @@ public:
   */
   void AddDataSinrChunkProcessor (Ptr<LteChunkProcessor> p);
 
+  /**
+  * When enabled, the data SINR chunk processors are only notified of
+  * the data frames carrying a TB expected by this PHY, so that a UE does
+  * not evaluate the SINR of the subframes in which it is not scheduled.
+  * Disabled by default.
+  *
+  * \param enabled whether the data SINR is only evaluated for expected TBs
+  */
+  void SetDataSinrForExpectedTbsOnly (bool enabled);
+
   /**
   *  LteChunkProcessor devoted to evaluate interference + noise power
   *  in control symbols of the subframe
@@ -475,6 +485,7 @@ private:
   Ptr<UniformRandomVariable> m_random;
   bool m_dataErrorModelEnabled; // when true (default) the phy error model is enabled
   bool m_ctrlErrorModelEnabled; // when true (default) the phy error model is enabled for DL ctrl frame
+  bool m_dataSinrForExpectedTbsOnly; // when true the data SINR is not evaluated without expected TBs
   
   uint8_t m_transmissionMode; // for UEs: store the transmission mode
   uint8_t m_layersNum;
@@ -220,6 +220,8 @@ PfFfMacScheduler::PfFfMacScheduler ()
     m_nextRntiUl (0)
 {
   m_amc = CreateObject <LteAmc> ();
+  m_core.SetAmc (m_amc);
+  m_core.SetDlMetricCallback (MakeCallback (&PfFfMacScheduler::GetDlMetrics, this));
   m_cschedSapProvider = new PfSchedulerMemberCschedSapProvider (this);
   m_schedSapProvider = new PfSchedulerMemberSchedSapProvider (this);
   m_ffrSapProvider = 0;
@@ -328,15 +330,11 @@ void
 PfFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
-  std::map <uint16_t,uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
-  if (it == m_uesTxMode.end ())
+  std::map <uint16_t,uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (params.m_rnti);
+  if (it == m_dlHarqCurrentProcessId.end ())
     {
-      m_uesTxMode.insert (std::pair <uint16_t, double> (params.m_rnti, params.m_transmissionMode));
       // generate HARQ buffers
       m_dlHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (params.m_rnti, 0));
-      DlHarqProcessesStatus_t dlHarqPrcStatus;
-      dlHarqPrcStatus.resize (8,0);
-      m_dlHarqProcessesStatus.insert (std::pair <uint16_t, DlHarqProcessesStatus_t> (params.m_rnti, dlHarqPrcStatus));
       DlHarqProcessesTimer_t dlHarqProcessesTimer;
       dlHarqProcessesTimer.resize (8,0);
       m_dlHarqProcessesTimer.insert (std::pair <uint16_t, DlHarqProcessesTimer_t> (params.m_rnti, dlHarqProcessesTimer));
@@ -356,10 +354,8 @@ PfFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::Csch
       ulHarqdci.resize (8);
       m_ulHarqProcessesDciBuffer.insert (std::pair <uint16_t, UlHarqProcessesDciBuffer_t> (params.m_rnti, ulHarqdci));
     }
-  else
-    {
-      (*it).second = params.m_transmissionMode;
-    }
+  // the transmission mode is kept, or updated, by m_core
+  m_core.AddUe (params.m_rnti, params.m_transmissionMode);
   return;
 }
 
@@ -423,9 +419,8 @@ PfFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::Csc
 {
   NS_LOG_FUNCTION (this);
 
-  m_uesTxMode.erase (params.m_rnti);
+  m_core.RemoveUe (params.m_rnti);
   m_dlHarqCurrentProcessId.erase (params.m_rnti);
-  m_dlHarqProcessesStatus.erase  (params.m_rnti);
   m_dlHarqProcessesTimer.erase (params.m_rnti);
   m_dlHarqProcessesDciBuffer.erase  (params.m_rnti);
   m_dlHarqProcessesRlcPduListBuffer.erase  (params.m_rnti);
@@ -542,30 +537,7 @@ PfFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
-  if (it == m_dlHarqCurrentProcessId.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-    }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
-  uint8_t i = (*it).second;
-  do
-    {
-      i = (i + 1) % HARQ_PROC_NUM;
-    }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
-    {
-      return (true);
-    }
-  else
-    {
-      return (false); // return a not valid harq proc id
-    }
+  return (m_core.IsDlHarqProcessAvailable (rnti));
 }
 
 
@@ -586,21 +558,16 @@ PfFfMacScheduler::UpdateHarqProcessId (uint16_t rnti)
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
   uint8_t i = (*it).second;
   do
     {
       i = (i + 1) % HARQ_PROC_NUM;
     }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
+  while (m_core.IsDlHarqProcessBusy (rnti, i) && (i != (*it).second));
+  if (!m_core.IsDlHarqProcessBusy (rnti, i))
     {
       (*it).second = i;
-      (*itStat).second.at (i) = 1;
+      m_core.SetDlHarqProcessBusy (rnti, i, true);
     }
   else
     {
@@ -626,12 +593,7 @@ PfFfMacScheduler::RefreshHarqProcesses ()
               // reset HARQ process
 
               NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
-              if (itStat == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
-                }
-              (*itStat).second.at (i) = 0;
+              m_core.SetDlHarqProcessBusy ((*itTimers).first, i, false);
               (*itTimers).second.at (i) = 0;
             }
           else
@@ -644,6 +606,24 @@ PfFfMacScheduler::RefreshHarqProcesses ()
 }
 
 
+void
+PfFfMacScheduler::GetDlMetrics (const FfMacSchedulerCore::Ue &ue, double *metrics)
+{
+  std::map <uint16_t, pfsFlowPerf_t>::iterator it = m_flowStatsDl.find (ue.m_rnti);
+  if (it == m_flowStatsDl.end ())
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < ue.m_dlRbgRate.size (); i++)
+    {
+      if (ue.m_dlRbgRate[i] >= 0) // otherwise, the CQI is out of range
+        {
+          metrics[i] = ue.m_dlRbgRate[i] / (*it).second.lastAveragedThroughput;
+        }
+    }
+}
+
+
 void
 PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::SchedDlTriggerReqParameters& params)
 {
@@ -659,6 +639,7 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
 
   int rbgSize = GetRbgSize (m_cschedCellConfig.m_dlBandwidth);
   int rbgNum = m_cschedCellConfig.m_dlBandwidth / rbgSize;
+  m_core.SetDlRbgs (rbgNum, rbgSize);
   std::map <uint16_t, std::vector <uint16_t> > allocationMap; // RBs map per RNTI
   std::vector <bool> rbgMap;  // global RBGs map
   uint16_t rbgAllocatedNum = 0;
@@ -880,12 +861,7 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
             {
               // maximum number of retx reached -> drop process
               NS_LOG_INFO ("Maximum number of retransmissions reached -> drop process");
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
-              if (it == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << m_dlInfoListBuffered.at (i).m_rnti);
-                }
-              (*it).second.at (harqId) = 0;
+              m_core.SetDlHarqProcessBusy (rnti, harqId, false);
               std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
               if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                 {
@@ -1044,12 +1020,7 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
         {
           // update HARQ process status
           NS_LOG_INFO (this << " HARQ received ACK for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-          std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
-          if (it == m_dlHarqProcessesStatus.end ())
-            {
-              NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-            }
-          (*it).second.at (m_dlInfoListBuffered.at (i).m_harqProcessId) = 0;
+          m_core.SetDlHarqProcessBusy (m_dlInfoListBuffered.at (i).m_rnti, m_dlInfoListBuffered.at (i).m_harqProcessId, false);
           std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
@@ -1076,95 +1047,18 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
 
 
 
+  // the PF metric of each UE does not change during the TTI: compute it
+  // once for the UEs which may be allocated, and select the best one of
+  // each RBG from them
+  m_core.PrepareDlTti (m_rlcBufferReq, rntiAllocated);
+  m_core.ComputeDlMetrics ();
   for (int i = 0; i < rbgNum; i++)
     {
       NS_LOG_INFO (this << " ALLOCATION for RBG " << i << " of " << rbgNum);
       if (rbgMap.at (i) == false)
         {
-          std::map <uint16_t, pfsFlowPerf_t>::iterator it;
-          std::map <uint16_t, pfsFlowPerf_t>::iterator itMax = m_flowStatsDl.end ();
-          double rcqiMax = 0.0;
-          for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
-            {
-              if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, (*it).first)) == false)
-                continue;
-
-              std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-              if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
-                {
-                  // UE already allocated for HARQ or without HARQ process available -> drop it
-                  if (itRnti != rntiAllocated.end ())
-                    {
-                      NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
-                    }
-                  if (!HarqProcessAvailability ((*it).first))
-                    {
-                      NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
-                    }
-                  continue;
-                }
-              std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-              itCqi = m_a30CqiRxed.find ((*it).first);
-              std::map <uint16_t,uint8_t>::iterator itTxMode;
-              itTxMode = m_uesTxMode.find ((*it).first);
-              if (itTxMode == m_uesTxMode.end ())
-                {
-                  NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                }
-              int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-              std::vector <uint8_t> sbCqi;
-              if (itCqi == m_a30CqiRxed.end ())
-                {
-                  for (uint8_t k = 0; k < nLayer; k++)
-                    {
-                      sbCqi.push_back (1);  // start with lowest value
-                    }
-                }
-              else
-                {
-                  sbCqi = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                }
-              uint8_t cqi1 = sbCqi.at (0);
-              uint8_t cqi2 = 1;
-              if (sbCqi.size () > 1)
-                {
-                  cqi2 = sbCqi.at (1);
-                }
-
-              if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-                {
-                  if (LcActivePerFlow ((*it).first) > 0)
-                    {
-                      // this UE has data to transmit
-                      double achievableRate = 0.0;
-                      uint8_t mcs = 0;
-                      for (uint8_t k = 0; k < nLayer; k++)
-                        {
-                          if (sbCqi.size () > k)
-                            {
-                              mcs = m_amc->GetMcsFromCqi (sbCqi.at (k));
-                            }
-                          else
-                            {
-                              // no info on this subband -> worst MCS
-                              mcs = 0;
-                            }
-                          achievableRate += ((m_amc->GetTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001);   // = TB size / TTI
-                        }
-
-                      double rcqi = achievableRate / (*it).second.lastAveragedThroughput;
-                      NS_LOG_INFO (this << " RNTI " << (*it).first << " MCS " << (uint32_t)mcs << " achievableRate " << achievableRate << " avgThr " << (*it).second.lastAveragedThroughput << " RCQI " << rcqi);
-
-                      if (rcqi > rcqiMax)
-                        {
-                          rcqiMax = rcqi;
-                          itMax = it;
-                        }
-                    }
-                }   // end if cqi
-            } // end for m_rlcBufferReq
-
-          if (itMax == m_flowStatsDl.end ())
+          uint16_t rntiMax = m_core.SelectDlUe (i, m_ffrSapProvider);
+          if (rntiMax == 0)
             {
               // no UE available for this RB
               NS_LOG_INFO (this << " any UE found");
@@ -1173,19 +1067,19 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
             {
               rbgMap.at (i) = true;
               std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
-              itMap = allocationMap.find ((*itMax).first);
+              itMap = allocationMap.find (rntiMax);
               if (itMap == allocationMap.end ())
                 {
                   // insert new element
                   std::vector <uint16_t> tempMap;
                   tempMap.push_back (i);
-                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > ((*itMax).first, tempMap));
+                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > (rntiMax, tempMap));
                 }
               else
                 {
                   (*itMap).second.push_back (i);
                 }
-              NS_LOG_INFO (this << " UE assigned " << (*itMax).first);
+              NS_LOG_INFO (this << " UE assigned " << rntiMax);
             }
         } // end for RBG free
     } // end for RBGs
@@ -1218,30 +1112,27 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
           lcActives = (uint16_t)65535; // UINT16_MAX;
         }
       uint16_t RgbPerRnti = (*itMap).second.size ();
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-      itCqi = m_a30CqiRxed.find ((*itMap).first);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
-      itTxMode = m_uesTxMode.find ((*itMap).first);
-      if (itTxMode == m_uesTxMode.end ())
+      const FfMacSchedulerCore::Ue *ue = m_core.GetUe ((*itMap).first);
+      if (ue == 0)
         {
           NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itMap).first);
         }
-      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+      int nLayer = ue->m_nLayers;
       std::vector <uint8_t> worstCqi (2, 15);
-      if (itCqi != m_a30CqiRxed.end ())
+      if (ue->m_sbCqiReported)
         {
           for (uint16_t k = 0; k < (*itMap).second.size (); k++)
             {
-              if ((*itCqi).second.m_higherLayerSelected.size () > (*itMap).second.at (k))
+              if (ue->m_sbMeasResult.m_higherLayerSelected.size () > (*itMap).second.at (k))
                 {
-                  NS_LOG_INFO (this << " RBG " << (*itMap).second.at (k) << " CQI " << (uint16_t)((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (0)) );
+                  NS_LOG_INFO (this << " RBG " << (*itMap).second.at (k) << " CQI " << (uint16_t)(ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (0)) );
                   for (uint8_t j = 0; j < nLayer; j++)
                     {
-                      if ((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.size () > j)
+                      if (ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.size () > j)
                         {
-                          if (((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j)) < worstCqi.at (j))
+                          if ((ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j)) < worstCqi.at (j))
                             {
-                              worstCqi.at (j) = ((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j));
+                              worstCqi.at (j) = (ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j));
                             }
                         }
                       else
@@ -1439,24 +1330,11 @@ PfFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sched
         }
       else if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::A30 )
         {
-          // subband CQI reporting high layer configured
-          std::map <uint16_t,SbMeasResult_s>::iterator it;
+          // subband CQI reporting high layer configured: the report is
+          // kept by m_core, the timer here
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
-          it = m_a30CqiRxed.find (rnti);
-          if (it == m_a30CqiRxed.end ())
-            {
-              // create the new entry
-              m_a30CqiRxed.insert ( std::pair<uint16_t, SbMeasResult_s > (rnti, params.m_cqiList.at (i).m_sbMeasResult) );
-              m_a30CqiTimers.insert ( std::pair<uint16_t, uint32_t > (rnti, m_cqiTimersThreshold));
-            }
-          else
-            {
-              // update the CQI value and refresh correspondent timer
-              (*it).second = params.m_cqiList.at (i).m_sbMeasResult;
-              std::map <uint16_t,uint32_t>::iterator itTimers;
-              itTimers = m_a30CqiTimers.find (rnti);
-              (*itTimers).second = m_cqiTimersThreshold;
-            }
+          m_a30CqiTimers[rnti] = m_cqiTimersThreshold;
+          m_core.SetSbCqi (rnti, params.m_cqiList.at (i).m_sbMeasResult);
         }
       else
         {
@@ -2151,10 +2029,8 @@ PfFfMacScheduler::RefreshDlCqiMaps (void)
       if ((*itA30).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
-          NS_ASSERT_MSG (itMap != m_a30CqiRxed.end (), " Does not find CQI report for user " << (*itA30).first);
           NS_LOG_INFO (this << " A30-CQI expired for user " << (*itA30).first);
-          m_a30CqiRxed.erase (itMap);
+          m_core.ResetSbCqi ((*itA30).first);
           std::map <uint16_t,uint32_t>::iterator temp = itA30;
           itA30++;
           m_a30CqiTimers.erase (temp);
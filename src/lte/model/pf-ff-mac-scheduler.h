@@ -30,6 +30,7 @@
 #include <ns3/nstime.h>
 #include <ns3/lte-amc.h>
 #include <ns3/lte-ffr-sap.h>
+#include <ns3/ff-mac-scheduler-core.h>
 
 // value for SINR outside the range defined by FF-API, used to indicate that there
 // is no CQI for this element
@@ -180,8 +181,22 @@ private:
   */
   void RefreshHarqProcesses ();
 
+  /**
+  * \brief The PF metric of the RBGs for a UE: the achievable rate
+  * over the average throughput
+  *
+  * \param ue the state of the UE
+  * \param metrics the metric of each RBG
+  */
+  void GetDlMetrics (const FfMacSchedulerCore::Ue &ue, double *metrics);
+
   Ptr<LteAmc> m_amc;
 
+  /*
+  * DL state of the UEs, shared with the other schedulers
+  */
+  FfMacSchedulerCore m_core;
+
   /*
    * Vectors of UE's LC info
   */
@@ -209,11 +224,7 @@ private:
   std::map <uint16_t,uint32_t> m_p10CqiTimers;
 
   /*
-  * Map of UE's DL CQI A30 received
-  */
-  std::map <uint16_t,SbMeasResult_s> m_a30CqiRxed;
-  /*
-  * Map of UE's timers on DL CQI A30 received
+  * Map of UE's timers on DL CQI A30 received (the reports are kept by m_core)
   */
   std::map <uint16_t,uint32_t> m_a30CqiTimers;
 
@@ -257,18 +268,13 @@ private:
 
   uint32_t m_cqiTimersThreshold; // # of TTIs for which a CQI canbe considered valid
 
-  std::map <uint16_t,uint8_t> m_uesTxMode; // txMode of the UEs
-
   // HARQ attributes
   /**
   * m_harqOn when false inhibit te HARQ mechanisms (by default active)
   */
   bool m_harqOn;
   std::map <uint16_t, uint8_t> m_dlHarqCurrentProcessId;
-  //HARQ status
-  // 0: process Id available
-  // x>0: process Id equal to `x` trasmission count
-  std::map <uint16_t, DlHarqProcessesStatus_t> m_dlHarqProcessesStatus;
+  // the DL HARQ status is kept by m_core
   std::map <uint16_t, DlHarqProcessesTimer_t> m_dlHarqProcessesTimer;
   std::map <uint16_t, DlHarqProcessesDciBuffer_t> m_dlHarqProcessesDciBuffer;
   std::map <uint16_t, DlHarqRlcPduListBuffer_t> m_dlHarqProcessesRlcPduListBuffer;
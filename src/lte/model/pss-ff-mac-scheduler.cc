@@ -223,6 +223,8 @@ PssFfMacScheduler::PssFfMacScheduler ()
     m_nextRntiUl (0)
 {
   m_amc = CreateObject <LteAmc> ();
+  m_core.SetAmc (m_amc);
+  m_core.SetDlMetricCallback (MakeCallback (&PssFfMacScheduler::GetDlMetrics, this));
   m_cschedSapProvider = new PssSchedulerMemberCschedSapProvider (this);
   m_schedSapProvider = new PssSchedulerMemberSchedSapProvider (this);
   m_ffrSapProvider = 0;
@@ -341,15 +343,11 @@ void
 PssFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
 {
   NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
-  std::map <uint16_t,uint8_t>::iterator it = m_uesTxMode.find (params.m_rnti);
-  if (it == m_uesTxMode.end ())
+  std::map <uint16_t,uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (params.m_rnti);
+  if (it == m_dlHarqCurrentProcessId.end ())
     {
-      m_uesTxMode.insert (std::pair <uint16_t, double> (params.m_rnti, params.m_transmissionMode));
       // generate HARQ buffers
       m_dlHarqCurrentProcessId.insert (std::pair <uint16_t,uint8_t > (params.m_rnti, 0));
-      DlHarqProcessesStatus_t dlHarqPrcStatus;
-      dlHarqPrcStatus.resize (8,0);
-      m_dlHarqProcessesStatus.insert (std::pair <uint16_t, DlHarqProcessesStatus_t> (params.m_rnti, dlHarqPrcStatus));
       DlHarqProcessesTimer_t dlHarqProcessesTimer;
       dlHarqProcessesTimer.resize (8,0);
       m_dlHarqProcessesTimer.insert (std::pair <uint16_t, DlHarqProcessesTimer_t> (params.m_rnti, dlHarqProcessesTimer));
@@ -369,10 +367,8 @@ PssFfMacScheduler::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::Csc
       ulHarqdci.resize (8);
       m_ulHarqProcessesDciBuffer.insert (std::pair <uint16_t, UlHarqProcessesDciBuffer_t> (params.m_rnti, ulHarqdci));
     }
-  else
-    {
-      (*it).second = params.m_transmissionMode;
-    }
+  // the transmission mode is kept, or updated, by m_core
+  m_core.AddUe (params.m_rnti, params.m_transmissionMode);
   return;
 }
 
@@ -451,9 +447,8 @@ PssFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::Cs
 {
   NS_LOG_FUNCTION (this);
   
-  m_uesTxMode.erase (params.m_rnti);
+  m_core.RemoveUe (params.m_rnti);
   m_dlHarqCurrentProcessId.erase (params.m_rnti);
-  m_dlHarqProcessesStatus.erase  (params.m_rnti);
   m_dlHarqProcessesTimer.erase (params.m_rnti);
   m_dlHarqProcessesDciBuffer.erase  (params.m_rnti);
   m_dlHarqProcessesRlcPduListBuffer.erase  (params.m_rnti);
@@ -570,30 +565,7 @@ PssFfMacScheduler::HarqProcessAvailability (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
 
-  std::map <uint16_t, uint8_t>::iterator it = m_dlHarqCurrentProcessId.find (rnti);
-  if (it == m_dlHarqCurrentProcessId.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
-    }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
-  uint8_t i = (*it).second;
-  do
-    {
-      i = (i + 1) % HARQ_PROC_NUM;
-    }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
-    {
-      return (true);
-    }
-  else
-    {
-      return (false); // return a not valid harq proc id
-    }
+  return (m_core.IsDlHarqProcessAvailable (rnti));
 }
 
 
@@ -614,21 +586,16 @@ PssFfMacScheduler::UpdateHarqProcessId (uint16_t rnti)
     {
       NS_FATAL_ERROR ("No Process Id found for this RNTI " << rnti);
     }
-  std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find (rnti);
-  if (itStat == m_dlHarqProcessesStatus.end ())
-    {
-      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
-    }
   uint8_t i = (*it).second;
   do
     {
       i = (i + 1) % HARQ_PROC_NUM;
     }
-  while ( ((*itStat).second.at (i) != 0)&&(i != (*it).second));
-  if ((*itStat).second.at (i) == 0)
+  while (m_core.IsDlHarqProcessBusy (rnti, i) && (i != (*it).second));
+  if (!m_core.IsDlHarqProcessBusy (rnti, i))
     {
       (*it).second = i;
-      (*itStat).second.at (i) = 1;
+      m_core.SetDlHarqProcessBusy (rnti, i, true);
     }
   else
     {
@@ -654,12 +621,7 @@ PssFfMacScheduler::RefreshHarqProcesses ()
               // reset HARQ process
               
               NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << (*itTimers).first);
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator itStat = m_dlHarqProcessesStatus.find ((*itTimers).first);
-              if (itStat == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_FATAL_ERROR ("No Process Id Status found for this RNTI " << (*itTimers).first);
-                }
-              (*itStat).second.at (i) = 0;
+              m_core.SetDlHarqProcessBusy ((*itTimers).first, i, false);
               (*itTimers).second.at (i) = 0;
             }
           else
@@ -672,6 +634,52 @@ PssFfMacScheduler::RefreshHarqProcesses ()
 }
 
 
+void
+PssFfMacScheduler::GetDlMetrics (const FfMacSchedulerCore::Ue &ue, double *metrics)
+{
+  std::map <uint16_t, pssFlowPerf_t>::iterator it = m_flowStatsDl.find (ue.m_rnti);
+  if (it == m_flowStatsDl.end ())
+    {
+      return;
+    }
+  // calculate PF weigth
+  double weight = (*it).second.targetThroughput / (*it).second.lastAveragedThroughput;
+  if (weight < 1.0)
+    weight = 1.0;
+
+  for (uint32_t i = 0; i < ue.m_dlRbgRate.size (); i++)
+    {
+      // a negative rate means "out of range" CQI
+      if (m_fdSchedulerType.compare ("CoItA") == 0)
+        {
+          // Carrier over Interference to Average (CoItA)
+          double colMetric = 0.0;
+          if (ue.m_dlRbgRate[i] >= 0)
+            {
+              for (uint8_t k = 0; k < ue.m_nLayers; k++)
+                {
+                  colMetric += (double)ue.m_sbCqi[i * ue.m_nLayers + k] / (double)ue.m_sbCqiSum;
+                }
+            }
+          if (colMetric != 0)
+            metrics[i] = weight * colMetric;
+          else
+            metrics[i] = 1;
+        }
+      else if (m_fdSchedulerType.compare ("PFsch") == 0)
+        {
+          // Proportional Fair scheduled (PFsch)
+          double schMetric = 0.0;
+          if (ue.m_dlRbgRate[i] >= 0)
+            {
+              schMetric = ue.m_dlRbgRate[i] / (*it).second.secondLastAveragedThroughput;
+            }
+          metrics[i] = weight * schMetric;
+        }
+    }
+}
+
+
 void
 PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::SchedDlTriggerReqParameters& params)
 {
@@ -687,6 +695,7 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
   int rbgSize = GetRbgSize (m_cschedCellConfig.m_dlBandwidth);
   int rbgNum = m_cschedCellConfig.m_dlBandwidth / rbgSize;
+  m_core.SetDlRbgs (rbgNum, rbgSize);
   std::map <uint16_t, std::vector <uint16_t> > allocationMap; // RBs map per RNTI
   std::vector <bool> rbgMap;  // global RBGs map
   uint16_t rbgAllocatedNum = 0;
@@ -907,12 +916,7 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
             {
               // maximum number of retx reached -> drop process
               NS_LOG_INFO ("Maximum number of retransmissions reached -> drop process");
-              std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (rnti);
-              if (it == m_dlHarqProcessesStatus.end ())
-                {
-                  NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << m_dlInfoListBuffered.at (i).m_rnti);
-                }
-              (*it).second.at (harqId) = 0;
+              m_core.SetDlHarqProcessBusy (rnti, harqId, false);
               std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (rnti);
               if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
                 {
@@ -1071,12 +1075,7 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
         {
           // update HARQ process status
           NS_LOG_INFO (this << " HARQ received ACK for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-          std::map <uint16_t, DlHarqProcessesStatus_t>::iterator it = m_dlHarqProcessesStatus.find (m_dlInfoListBuffered.at (i).m_rnti);
-          if (it == m_dlHarqProcessesStatus.end ())
-            {
-              NS_FATAL_ERROR ("No info find in HARQ buffer for UE " << m_dlInfoListBuffered.at (i).m_rnti);
-            }
-          (*it).second.at (m_dlInfoListBuffered.at (i).m_harqProcessId) = 0;
+          m_core.SetDlHarqProcessBusy (m_dlInfoListBuffered.at (i).m_rnti, m_dlInfoListBuffered.at (i).m_harqProcessId, false);
           std::map <uint16_t, DlHarqRlcPduListBuffer_t>::iterator itRlcPdu =  m_dlHarqProcessesRlcPduListBuffer.find (m_dlInfoListBuffered.at (i).m_rnti);
           if (itRlcPdu == m_dlHarqProcessesRlcPduListBuffer.end ())
             {
@@ -1105,11 +1104,13 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
   std::map <uint16_t, pssFlowPerf_t>::iterator it;
   std::map <uint16_t, pssFlowPerf_t> tdUeSet; // the result of TD scheduler
 
-  // schedulability check
+  // schedulability check: data in RLC buffer, not allocated for HARQ tx
+  // and HARQ process available
+  m_core.PrepareDlTti (m_rlcBufferReq, rntiAllocated);
   std::map <uint16_t, pssFlowPerf_t> ueSet;
   for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
     {
-      if( LcActivePerFlow ((*it).first) > 0 )
+      if (m_core.IsDlCandidate ((*it).first))
         {
           ueSet.insert(std::pair <uint16_t, pssFlowPerf_t> ((*it).first, (*it).second));
         }
@@ -1123,21 +1124,6 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
       std::vector <std::pair<double,uint16_t> > ueSet2;
       for (it = ueSet.begin (); it != ueSet.end (); it++)
         {
-          std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-          if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
-            {
-              // UE already allocated for HARQ or without HARQ process available -> drop it
-              if (itRnti != rntiAllocated.end ())
-              {
-                NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
-              }
-              if (!HarqProcessAvailability ((*it).first))
-              {
-                NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
-              }
-              continue;
-            }
-    
           double metric = 0.0;
           if ((*it).second.lastAveragedThroughput < (*it).second.targetThroughput )
             {
@@ -1150,13 +1136,12 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
               // calculate TD PF metric
               std::map <uint16_t,uint8_t>::iterator itCqi;
               itCqi = m_p10CqiRxed.find ((*it).first);
-              std::map <uint16_t,uint8_t>::iterator itTxMode;
-              itTxMode = m_uesTxMode.find ((*it).first);
-              if (itTxMode == m_uesTxMode.end())
+              const FfMacSchedulerCore::Ue *ue = m_core.GetUe ((*it).first);
+              if (ue == 0)
                 {
                   NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
                 }
-              int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+              int nLayer = ue->m_nLayers;
               uint8_t wbCqi = 0;
               if (itCqi == m_p10CqiRxed.end())
                 {
@@ -1169,7 +1154,7 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
     
               if (wbCqi > 0)
                 {
-                  if (LcActivePerFlow ((*it).first) > 0)
+                  if (ue->m_dlActiveLcs > 0)
                     {
                       // this UE has data to transmit
                       double achievableRate = 0.0;
@@ -1235,253 +1220,29 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
            } // end of m_flowStatsDl
         
         
-          if ( m_fdSchedulerType.compare("CoItA") == 0)
+          // FD scheduler: the CoItA or PFsch metric (see GetDlMetrics) of
+          // the UEs selected by the TD scheduler
+          for (it = ueSet.begin (); it != ueSet.end (); it++)
             {
-              // FD scheduler: Carrier over Interference to Average (CoItA)
-              std::map < uint16_t, uint8_t > sbCqiSum;
-              for (it = tdUeSet.begin (); it != tdUeSet.end (); it++)
-                {
-                  uint8_t sum = 0;
-                  for (int i = 0; i < rbgNum; i++)
-                    {
-                      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-                      itCqi = m_a30CqiRxed.find ((*it).first);
-                      std::map <uint16_t,uint8_t>::iterator itTxMode;
-                      itTxMode = m_uesTxMode.find ((*it).first);
-                      if (itTxMode == m_uesTxMode.end ())
-                        {
-                          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                        }
-                      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-                      std::vector <uint8_t> sbCqis;
-                      if (itCqi == m_a30CqiRxed.end ())
-                        {
-                          for (uint8_t k = 0; k < nLayer; k++)
-                            {
-                              sbCqis.push_back (1);  // start with lowest value
-                            }
-                        }
-                      else
-                        {
-                          sbCqis = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                        }
-        
-                      uint8_t cqi1 = sbCqis.at (0);
-                      uint8_t cqi2 = 1;
-                      if (sbCqis.size () > 1)
-                        {
-                          cqi2 = sbCqis.at (1);
-                        }
-            
-                      uint8_t sbCqi;
-                      if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-                        {
-                          for (uint8_t k = 0; k < nLayer; k++) 
-                            {
-                              if (sbCqis.size () > k)
-                                {                       
-           	                  sbCqi = sbCqis.at(k);
-                                }
-                              else
-                                {
-                                  // no info on this subband 
-                                  sbCqi = 0;
-                                }
-                              sum += sbCqi;
-                            }
-                        }   // end if cqi
-                    }// end of rbgNum
-              
-                  sbCqiSum.insert (std::pair<uint16_t, uint8_t> ((*it).first, sum));
-                }// end tdUeSet
-        
-              for (int i = 0; i < rbgNum; i++)
-                {
-                  if (rbgMap.at (i) == true)
-                    continue;
-
-                  std::map <uint16_t, pssFlowPerf_t>::iterator itMax = tdUeSet.end ();
-                  double metricMax = 0.0;
-                  for (it = tdUeSet.begin (); it != tdUeSet.end (); it++)
-                    {
-                      if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, (*it).first)) == false)
-                        continue;
-
-                      // calculate PF weigth 
-                      double weight = (*it).second.targetThroughput / (*it).second.lastAveragedThroughput;
-                      if (weight < 1.0)
-                        weight = 1.0;
-        
-                      std::map < uint16_t, uint8_t>::iterator itSbCqiSum;
-                      itSbCqiSum = sbCqiSum.find((*it).first);
-        
-                      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-                      itCqi = m_a30CqiRxed.find ((*it).first);
-                      std::map <uint16_t,uint8_t>::iterator itTxMode;
-                      itTxMode = m_uesTxMode.find ((*it).first);
-                      if (itTxMode == m_uesTxMode.end())
-                        {
-                          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                        }
-                      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-                      std::vector <uint8_t> sbCqis;
-                      if (itCqi == m_a30CqiRxed.end ())
-                        {
-                          for (uint8_t k = 0; k < nLayer; k++)
-                            {
-                              sbCqis.push_back (1);  // start with lowest value
-                            }
-                        }
-                      else
-                        {
-                          sbCqis = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                        }
-        
-                      uint8_t cqi1 = sbCqis.at( 0);
-                      uint8_t cqi2 = 1;
-                      if (sbCqis.size () > 1)
-                        {
-                          cqi2 = sbCqis.at(1);
-                        }
-            
-                      uint8_t sbCqi;
-                      double colMetric = 0.0;
-                      if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-                        {
-                          for (uint8_t k = 0; k < nLayer; k++) 
-                            {
-                              if (sbCqis.size () > k)
-                                {                       
-                                  sbCqi = sbCqis.at(k);
-                                }
-                              else
-                                {
-                                  // no info on this subband 
-                                  sbCqi = 0;
-                                }
-                              colMetric += (double)sbCqi / (double)(*itSbCqiSum).second;
-           	                } 
-                        }   // end if cqi
-        
-                      double metric = 0.0;
-                      if (colMetric != 0)
-                        metric= weight * colMetric;
-                      else
-                        metric = 1;
-        
-                      if (metric > metricMax )
-                        {
-                          metricMax = metric;
-                          itMax = it;
-                        }
-                    } // end of tdUeSet
-
-                  if (itMax == tdUeSet.end ())
-                    {
-                      // no UE available for downlink
-                    }
-                  else
-                    {
-                      allocationMap[(*itMax).first].push_back (i);
-                      rbgMap.at (i) = true;
-                    }
-                }// end of rbgNum
-        
-            }// end of CoIta
-        
-        
-          if ( m_fdSchedulerType.compare("PFsch") == 0)
+              m_core.SetDlCandidate ((*it).first, tdUeSet.find ((*it).first) != tdUeSet.end ());
+            }
+          m_core.ComputeDlMetrics ();
+          for (int i = 0; i < rbgNum; i++)
             {
-              // FD scheduler: Proportional Fair scheduled (PFsch)
-              for (int i = 0; i < rbgNum; i++)
-                {
-                  if (rbgMap.at (i) == true)
-                    continue;
-
-                  std::map <uint16_t, pssFlowPerf_t>::iterator itMax = tdUeSet.end ();
-                  double metricMax = 0.0;
-                  for (it = tdUeSet.begin (); it != tdUeSet.end (); it++)
-                    {
-                      if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, (*it).first)) == false)
-                        continue;
-                      // calculate PF weigth 
-                      double weight = (*it).second.targetThroughput / (*it).second.lastAveragedThroughput;
-                      if (weight < 1.0)
-                        weight = 1.0;
-        
-                      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-                      itCqi = m_a30CqiRxed.find ((*it).first);
-                      std::map <uint16_t,uint8_t>::iterator itTxMode;
-                      itTxMode = m_uesTxMode.find ((*it).first);
-                      if (itTxMode == m_uesTxMode.end())
-                        {
-                          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                        }
-                      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-                      std::vector <uint8_t> sbCqis;
-                      if (itCqi == m_a30CqiRxed.end ())
-                        {
-                          for (uint8_t k = 0; k < nLayer; k++)
-                            {
-                              sbCqis.push_back (1);  // start with lowest value
-                            }
-                        }
-                      else
-                        {
-                          sbCqis = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                        }
-        
-                      uint8_t cqi1 = sbCqis.at(0);
-                      uint8_t cqi2 = 1;
-                      if (sbCqis.size () > 1)
-                        {
-                          cqi2 = sbCqis.at(1);
-                        }
-                
-                      double schMetric = 0.0;
-                      if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-                        {
-                          double achievableRate = 0.0;
-                          for (uint8_t k = 0; k < nLayer; k++) 
-                            {
-                              uint8_t mcs = 0;
-                              if (sbCqis.size () > k)
-                                {                       
-                                  mcs = m_amc->GetMcsFromCqi (sbCqis.at (k));
-                                }
-                              else
-                                {
-                                  // no info on this subband  -> worst MCS
-                                  mcs = 0;
-                                }
-                              achievableRate += ((m_amc->GetTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001); // = TB size / TTI
-            	  	    }
-                          schMetric = achievableRate / (*it).second.secondLastAveragedThroughput;
-                        }   // end if cqi
-         
-                      double metric = 0.0;
-                      metric= weight * schMetric;
-         
-                      if (metric > metricMax )
-                        {
-                          metricMax = metric;
-                          itMax = it;
-                        }
-                    } // end of tdUeSet
+              if (rbgMap.at (i) == true)
+                continue;
 
-                  if (itMax == tdUeSet.end ())
-                    {
-                      // no UE available for downlink 
-                    }
-                  else
-                    {
-                      allocationMap[(*itMax).first].push_back (i);
-                      rbgMap.at (i) = true;
-                    }
-         
-                }// end of rbgNum
-        
-            } // end of PFsch
+              uint16_t rntiMax = m_core.SelectDlUe (i, m_ffrSapProvider);
+              if (rntiMax == 0)
+                {
+                  // no UE available for downlink
+                }
+              else
+                {
+                  allocationMap[rntiMax].push_back (i);
+                  rbgMap.at (i) = true;
+                }
+            }// end of rbgNum
 
         } // end if ueSet1 || ueSet2
     
@@ -1517,30 +1278,27 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
           lcActives = (uint16_t)65535; // UINT16_MAX;
         }
       uint16_t RgbPerRnti = (*itMap).second.size ();
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-      itCqi = m_a30CqiRxed.find ((*itMap).first);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
-      itTxMode = m_uesTxMode.find ((*itMap).first);
-      if (itTxMode == m_uesTxMode.end ())
+      const FfMacSchedulerCore::Ue *ue = m_core.GetUe ((*itMap).first);
+      if (ue == 0)
         {
           NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itMap).first);
         }
-      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+      int nLayer = ue->m_nLayers;
       std::vector <uint8_t> worstCqi (2, 15);
-      if (itCqi != m_a30CqiRxed.end ())
+      if (ue->m_sbCqiReported)
         {
           for (uint16_t k = 0; k < (*itMap).second.size (); k++)
             {
-              if ((*itCqi).second.m_higherLayerSelected.size () > (*itMap).second.at (k))
+              if (ue->m_sbMeasResult.m_higherLayerSelected.size () > (*itMap).second.at (k))
                 {
-                  NS_LOG_INFO (this << " RBG " << (*itMap).second.at (k) << " CQI " << (uint16_t)((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (0)) );
+                  NS_LOG_INFO (this << " RBG " << (*itMap).second.at (k) << " CQI " << (uint16_t)(ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (0)) );
                   for (uint8_t j = 0; j < nLayer; j++)
                     {
-                      if ((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.size () > j)
+                      if (ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.size () > j)
                         {
-                          if (((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j)) < worstCqi.at (j))
+                          if ((ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j)) < worstCqi.at (j))
                             {
-                              worstCqi.at (j) = ((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j));
+                              worstCqi.at (j) = (ue->m_sbMeasResult.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j));
                             }
                         }
                       else
@@ -1744,24 +1502,11 @@ PssFfMacScheduler::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::Sche
         }
       else if ( params.m_cqiList.at (i).m_cqiType == CqiListElement_s::A30 )
         {
-          // subband CQI reporting high layer configured
-          std::map <uint16_t,SbMeasResult_s>::iterator it;
+          // subband CQI reporting high layer configured: the report is
+          // kept by m_core, the timer here
           uint16_t rnti = params.m_cqiList.at (i).m_rnti;
-          it = m_a30CqiRxed.find (rnti);
-          if (it == m_a30CqiRxed.end ())
-            {
-              // create the new entry
-              m_a30CqiRxed.insert ( std::pair<uint16_t, SbMeasResult_s > (rnti, params.m_cqiList.at (i).m_sbMeasResult) );
-              m_a30CqiTimers.insert ( std::pair<uint16_t, uint32_t > (rnti, m_cqiTimersThreshold));
-            }
-          else
-            {
-              // update the CQI value and refresh correspondent timer
-              (*it).second = params.m_cqiList.at (i).m_sbMeasResult;
-              std::map <uint16_t,uint32_t>::iterator itTimers;
-              itTimers = m_a30CqiTimers.find (rnti);
-              (*itTimers).second = m_cqiTimersThreshold;
-            }
+          m_a30CqiTimers[rnti] = m_cqiTimersThreshold;
+          m_core.SetSbCqi (rnti, params.m_cqiList.at (i).m_sbMeasResult);
         }
       else
         {
@@ -2429,10 +2174,8 @@ PssFfMacScheduler::RefreshDlCqiMaps (void)
       if ((*itA30).second == 0)
         {
           // delete correspondent entries
-          std::map <uint16_t,SbMeasResult_s>::iterator itMap = m_a30CqiRxed.find ((*itA30).first);
-          NS_ASSERT_MSG (itMap != m_a30CqiRxed.end (), " Does not find CQI report for user " << (*itA30).first);
           NS_LOG_INFO (this << " A30-CQI expired for user " << (*itA30).first);
-          m_a30CqiRxed.erase (itMap);
+          m_core.ResetSbCqi ((*itA30).first);
           std::map <uint16_t,uint32_t>::iterator temp = itA30;
           itA30++;
           m_a30CqiTimers.erase (temp);
@@ -31,6 +31,7 @@
 #include <ns3/nstime.h>
 #include <ns3/lte-amc.h>
 #include <ns3/lte-ffr-sap.h>
+#include <ns3/ff-mac-scheduler-core.h>
 
 // value for SINR outside the range defined by FF-API, used to indicate that there
 // is no CQI for this element
@@ -189,8 +190,22 @@ private:
   */
   void RefreshHarqProcesses ();
 
+  /**
+  * \brief The FD metric of the RBGs for a UE selected by the TD scheduler,
+  * CoItA or PFsch according to the FD scheduler type
+  *
+  * \param ue the state of the UE
+  * \param metrics the metric of each RBG
+  */
+  void GetDlMetrics (const FfMacSchedulerCore::Ue &ue, double *metrics);
+
   Ptr<LteAmc> m_amc;
 
+  /*
+  * DL state of the UEs, shared with the other schedulers
+  */
+  FfMacSchedulerCore m_core;
+
   /*
    * Vectors of UE's LC info
   */
@@ -218,11 +233,7 @@ private:
   std::map <uint16_t,uint32_t> m_p10CqiTimers;
 
   /*
-  * Map of UE's DL CQI A30 received
-  */
-  std::map <uint16_t,SbMeasResult_s> m_a30CqiRxed;
-  /*
-  * Map of UE's timers on DL CQI A30 received
+  * Map of UE's timers on DL CQI A30 received (the reports are kept by m_core)
   */
   std::map <uint16_t,uint32_t> m_a30CqiTimers;
 
@@ -266,8 +277,6 @@ private:
 
   uint32_t m_cqiTimersThreshold; // # of TTIs for which a CQI canbe considered valid
 
-  std::map <uint16_t,uint8_t> m_uesTxMode; // txMode of the UEs
-
   std::string m_fdSchedulerType;
 
   uint32_t m_nMux; // TD scheduler selects nMux UEs and transfer them to FD scheduler
@@ -278,10 +287,7 @@ private:
   */
   bool m_harqOn;
   std::map <uint16_t, uint8_t> m_dlHarqCurrentProcessId;
-  //HARQ status
-  // 0: process Id available
-  // x>0: process Id equal to `x` trasmission count
-  std::map <uint16_t, DlHarqProcessesStatus_t> m_dlHarqProcessesStatus;
+  // the DL HARQ status is kept by m_core
   std::map <uint16_t, DlHarqProcessesTimer_t> m_dlHarqProcessesTimer;
   std::map <uint16_t, DlHarqProcessesDciBuffer_t> m_dlHarqProcessesDciBuffer;
   std::map <uint16_t, DlHarqRlcPduListBuffer_t> m_dlHarqProcessesRlcPduListBuffer;
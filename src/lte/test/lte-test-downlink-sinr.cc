@@ -141,6 +141,29 @@ LteDownlinkDataSinrTestCase::DoRun (void)
   chunkProcessor->AddCallback (MakeCallback (&LteSpectrumValueCatcher::ReportValue, &actualSinrCatcher));
   dlPhy->AddDataSinrChunkProcessor (chunkProcessor);
 
+  Ptr<LteChunkProcessor> interfProcessor = Create<LteChunkProcessor> ();
+  LteSpectrumValueCatcher actualInterfCatcher;
+  interfProcessor->AddCallback (MakeCallback (&LteSpectrumValueCatcher::ReportValue, &actualInterfCatcher));
+  dlPhy->AddInterferenceDataChunkProcessor (interfProcessor);
+
+  /**
+   * A second receiving LteSpectrumPhy, in the same cell, which expects
+   * no TB and hence does not evaluate the data SINR
+   */
+  Ptr<LteSpectrumPhy> idlePhy = CreateObject<LteSpectrumPhy> ();
+  idlePhy->SetCellId (cellId);
+  idlePhy->SetDataSinrForExpectedTbsOnly (true);
+
+  Ptr<LteChunkProcessor> idleSinrProcessor = Create<LteChunkProcessor> ();
+  LteSpectrumValueCatcher idleSinrCatcher;
+  idleSinrProcessor->AddCallback (MakeCallback (&LteSpectrumValueCatcher::ReportValue, &idleSinrCatcher));
+  idlePhy->AddDataSinrChunkProcessor (idleSinrProcessor);
+
+  Ptr<LteChunkProcessor> idleInterfProcessor = Create<LteChunkProcessor> ();
+  LteSpectrumValueCatcher idleInterfCatcher;
+  idleInterfProcessor->AddCallback (MakeCallback (&LteSpectrumValueCatcher::ReportValue, &idleInterfCatcher));
+  idlePhy->AddInterferenceDataChunkProcessor (idleInterfProcessor);
+
   /**
    * Generate several calls to LteSpectrumPhy::StartRx corresponding to 
    * several signals. One will be the signal of interest, i.e., the
@@ -213,6 +236,7 @@ LteDownlinkDataSinrTestCase::DoRun (void)
   Time di4 = Seconds (0.1);
 
   dlPhy->SetNoisePowerSpectralDensity (noisePsd);
+  idlePhy->SetNoisePowerSpectralDensity (noisePsd);
 
   /**
    * Schedule the reception of the data signal plus the interference signals
@@ -226,6 +250,7 @@ LteDownlinkDataSinrTestCase::DoRun (void)
   sp1->packetBurst = packetBursts[0];
   sp1->cellId = pbCellId[0];
   Simulator::Schedule (ts, &LteSpectrumPhy::StartRx, dlPhy, sp1);
+  Simulator::Schedule (ts, &LteSpectrumPhy::StartRx, idlePhy, sp1);
 
 
   Ptr<LteSpectrumSignalParametersDataFrame> ip1 = Create<LteSpectrumSignalParametersDataFrame> ();
@@ -235,6 +260,7 @@ LteDownlinkDataSinrTestCase::DoRun (void)
   ip1->packetBurst = packetBursts[1];
   ip1->cellId = pbCellId[1];
   Simulator::Schedule (ti1, &LteSpectrumPhy::StartRx, dlPhy, ip1);
+  Simulator::Schedule (ti1, &LteSpectrumPhy::StartRx, idlePhy, ip1);
 
   Ptr<LteSpectrumSignalParametersDataFrame> ip2 = Create<LteSpectrumSignalParametersDataFrame> ();
   ip2->psd = i2;
@@ -243,6 +269,7 @@ LteDownlinkDataSinrTestCase::DoRun (void)
   ip2->packetBurst = packetBursts[2];
   ip2->cellId = pbCellId[2];
   Simulator::Schedule (ti2, &LteSpectrumPhy::StartRx, dlPhy, ip2);
+  Simulator::Schedule (ti2, &LteSpectrumPhy::StartRx, idlePhy, ip2);
 
   Ptr<LteSpectrumSignalParametersDataFrame> ip3 = Create<LteSpectrumSignalParametersDataFrame> ();
   ip3->psd = i3;
@@ -251,6 +278,7 @@ LteDownlinkDataSinrTestCase::DoRun (void)
   ip3->packetBurst = packetBursts[3];
   ip3->cellId = pbCellId[3];
   Simulator::Schedule (ti3, &LteSpectrumPhy::StartRx, dlPhy, ip3);
+  Simulator::Schedule (ti3, &LteSpectrumPhy::StartRx, idlePhy, ip3);
 
   Ptr<LteSpectrumSignalParametersDataFrame> ip4 = Create<LteSpectrumSignalParametersDataFrame> ();
   ip4->psd = i4;
@@ -259,6 +287,7 @@ LteDownlinkDataSinrTestCase::DoRun (void)
   ip4->packetBurst = packetBursts[4];
   ip4->cellId = pbCellId[4];
   Simulator::Schedule (ti4, &LteSpectrumPhy::StartRx, dlPhy, ip4);
+  Simulator::Schedule (ti4, &LteSpectrumPhy::StartRx, idlePhy, ip4);
 
   Simulator::Stop (Seconds (5.0));
   Simulator::Run ();
@@ -267,7 +296,12 @@ LteDownlinkDataSinrTestCase::DoRun (void)
   NS_LOG_INFO ("Data Frame - Calculated SINR: " << *(actualSinrCatcher.GetValue ()));
  
   NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL(*(actualSinrCatcher.GetValue ()), *m_expectedSinr, 0.0000001, "Data Frame - Wrong SINR !");
+
+  NS_TEST_ASSERT_MSG_EQ (idleSinrCatcher.GetValue (), 0, "Data Frame - SINR evaluated without expected TB");
+  NS_TEST_ASSERT_MSG_NE (idleInterfCatcher.GetValue (), 0, "Data Frame - interference not evaluated without expected TB");
+  NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL(*(idleInterfCatcher.GetValue ()), *(actualInterfCatcher.GetValue ()), 0.0, "Data Frame - Wrong interference without expected TB !");
   dlPhy->Dispose ();
+  idlePhy->Dispose ();
   Simulator::Destroy ();
 }
 
@@ -52,6 +52,7 @@ void
 PacketMetadata::Enable (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+#ifndef NS3_PACKET_METADATA_DISABLE
   NS_ASSERT_MSG (!m_metadataSkipped,
                  "Error: attempting to enable the packet metadata "
                  "subsystem too late in the simulation, which is not allowed.\n"
@@ -60,6 +61,7 @@ PacketMetadata::Enable (void)
                  "to call ns3::PacketMetadata::Enable () near the beginning of"
                  " the program, before any packets are sent.");
   m_enable = true;
+#endif /* NS3_PACKET_METADATA_DISABLE */
 }
 
 void 
@@ -133,6 +135,11 @@ bool
 PacketMetadata::IsStateOk (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_data == 0)
+    {
+      // The metadata is compiled out
+      return m_head == 0xffff && m_tail == 0xffff;
+    }
   bool ok = m_used <= m_data->m_size;
   ok &= IsPointerOk (m_head);
   ok &= IsPointerOk (m_tail);
@@ -408,7 +415,10 @@ PacketMetadata::AddBig (uint32_t next, uint32_t prev,
   NS_LOG_FUNCTION (this << next << prev <<
                    item->next << item->prev << item->typeUid << item->size << item->chunkUid <<
                    extraItem->fragmentStart << extraItem->fragmentEnd << extraItem->packetUid);
-  NS_ASSERT (m_data != 0);
+  if (m_data == 0)
+    {
+      NS_FATAL_ERROR ("Cannot add a metadata item: the packet metadata is compiled out");
+    }
   uint32_t typeUid = ((item->typeUid & 0x1) == 0x1) ? item->typeUid : item->typeUid+1;
   NS_ASSERT (m_used != prev && m_used != next);
 
@@ -656,6 +666,11 @@ PacketMetadata::AddHeader (const Header &header, uint32_t size)
 {
   NS_LOG_FUNCTION (this << &header << size);
   NS_ASSERT (IsStateOk ());
+  if (!m_enable)
+    {
+      m_metadataSkipped = true;
+      return;
+    }
   uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   DoAddHeader (uid, size);
   NS_ASSERT (IsStateOk ());
@@ -683,7 +698,6 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
 void 
 PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
 {
-  uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &header << size);
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
@@ -691,6 +705,7 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t read = ReadItems (m_head, &item, &extraItem);
@@ -731,7 +746,6 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
 void 
 PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
 {
-  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &trailer << size);
   NS_ASSERT (IsStateOk ());
   if (!m_enable)
@@ -739,6 +753,7 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   struct PacketMetadata::SmallItem item;
   item.next = 0xffff;
   item.prev = m_tail;
@@ -753,7 +768,6 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
 void 
 PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
 {
-  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &trailer << size);
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
@@ -761,6 +775,7 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t read = ReadItems (m_tail, &item, &extraItem);
@@ -1289,6 +1304,11 @@ PacketMetadata::Deserialize (const uint8_t* buffer, uint32_t size)
 
   buffer = ReadFromRawU64 (m_packetUid, start, buffer, size);
   desSize -= 8;
+  if (m_data == 0)
+    {
+      // The metadata is compiled out: only the uid is kept
+      return 1;
+    }
 
   struct PacketMetadata::SmallItem item = {0};
   struct PacketMetadata::ExtraItem extraItem = {0};
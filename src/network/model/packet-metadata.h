@@ -68,6 +68,10 @@ class Trailer;
  * of entries which can be stored in this linked list but it is
  * quite unlikely to hit this limit in practice.
  *
+ * When NS3_PACKET_METADATA_DISABLE is defined, as in the fastsim build
+ * profile, the metadata is compiled out: the packets do not allocate
+ * nor share any metadata storage, and Enable has no effect.
+ *
  * Each item of the linked list is a variable-sized byte buffer
  * made of a number of fields. Some of these fields are stored
  * as fixed-size 32 bit integers, others as fixed-size 16 bit 
@@ -153,10 +157,14 @@ private:
 
   /**
    * \brief Enable the packet metadata
+   *
+   * No effect if the metadata is compiled out.
    */
   static void Enable (void);
   /**
    * \brief Enable the packet metadata checking
+   *
+   * No effect if the metadata is compiled out.
    */
   static void EnableChecking (void);
 
@@ -686,6 +694,36 @@ public:
 
 namespace ns3 {
 
+#ifdef NS3_PACKET_METADATA_DISABLE
+
+PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
+  : m_data (0),
+    m_head (0xffff),
+    m_tail (0xffff),
+    m_used (0),
+    m_packetUid (uid)
+{
+}
+PacketMetadata::PacketMetadata (PacketMetadata const &o)
+  : m_data (0),
+    m_head (0xffff),
+    m_tail (0xffff),
+    m_used (0),
+    m_packetUid (o.m_packetUid)
+{
+}
+PacketMetadata &
+PacketMetadata::operator = (PacketMetadata const& o)
+{
+  m_packetUid = o.m_packetUid;
+  return *this;
+}
+PacketMetadata::~PacketMetadata ()
+{
+}
+
+#else /* NS3_PACKET_METADATA_DISABLE */
+
 PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
   : m_data (PacketMetadata::Create (10)),
     m_head (0xffff),
@@ -742,6 +780,8 @@ PacketMetadata::~PacketMetadata ()
     }
 }
 
+#endif /* NS3_PACKET_METADATA_DISABLE */
+
 } // namespace ns3
 
 
@@ -29,6 +29,17 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
 uint32_t Packet::m_globalUid = 0;
+bool Packet::m_enableLazyHeaders = false;
+
+Packet::LazyHeader::LazyHeader (Ptr<const LazyHeader> next, uint32_t size)
+  : m_next (next),
+    m_size (size)
+{
+}
+
+Packet::LazyHeader::~LazyHeader ()
+{
+}
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -138,7 +149,9 @@ Packet::Packet ()
      * global UID
      */
     m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_lazyHeaders (0),
+    m_lazySize (0)
 {
   m_globalUid++;
 }
@@ -147,7 +160,9 @@ Packet::Packet (const Packet &o)
   : m_buffer (o.m_buffer),
     m_byteTagList (o.m_byteTagList),
     m_packetTagList (o.m_packetTagList),
-    m_metadata (o.m_metadata)
+    m_metadata (o.m_metadata),
+    m_lazyHeaders (o.m_lazyHeaders),
+    m_lazySize (o.m_lazySize)
 {
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy ()
     : m_nixVector = 0;
@@ -164,6 +179,8 @@ Packet::operator = (const Packet &o)
   m_byteTagList = o.m_byteTagList;
   m_packetTagList = o.m_packetTagList;
   m_metadata = o.m_metadata;
+  m_lazyHeaders = o.m_lazyHeaders;
+  m_lazySize = o.m_lazySize;
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy () 
     : m_nixVector = 0;
   return *this;
@@ -180,7 +197,9 @@ Packet::Packet (uint32_t size)
      * global UID
      */
     m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_lazyHeaders (0),
+    m_lazySize (0)
 {
   m_globalUid++;
 }
@@ -189,7 +208,9 @@ Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
     m_byteTagList (),
     m_packetTagList (),
     m_metadata (0,0),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_lazyHeaders (0),
+    m_lazySize (0)
 {
   NS_ASSERT (magic);
   Deserialize (buffer, size);
@@ -206,7 +227,9 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * global UID
      */
     m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_lazyHeaders (0),
+    m_lazySize (0)
 {
   m_globalUid++;
   m_buffer.AddAtStart (size);
@@ -220,7 +243,9 @@ Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList,
     m_byteTagList (byteTagList),
     m_packetTagList (packetTagList),
     m_metadata (metadata),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_lazyHeaders (0),
+    m_lazySize (0)
 {
 }
 
@@ -228,6 +253,7 @@ Ptr<Packet>
 Packet::CreateFragment (uint32_t start, uint32_t length) const
 {
   NS_LOG_FUNCTION (this << start << length);
+  SerializeLazyHeaders ();
   Buffer buffer = m_buffer.CreateFragment (start, length);
   ByteTagList byteTagList = m_byteTagList;
   byteTagList.Adjust (-start);
@@ -253,11 +279,24 @@ Packet::GetNixVector (void) const
   return m_nixVector;
 } 
 
+void
+Packet::DoSerializeLazyHeaders (Ptr<const LazyHeader> header)
+{
+  NS_LOG_FUNCTION (this);
+  // the last pending header is the first one added
+  if (header->m_next != 0)
+    {
+      DoSerializeLazyHeaders (header->m_next);
+    }
+  AddHeader (header->GetHeader ());
+}
+
 void
 Packet::AddHeader (const Header &header)
 {
   uint32_t size = header.GetSerializedSize ();
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+  SerializeLazyHeaders ();
   m_buffer.AddAtStart (size);
   m_byteTagList.Adjust (size);
   m_byteTagList.AddAtStart (size);
@@ -267,6 +306,17 @@ Packet::AddHeader (const Header &header)
 uint32_t
 Packet::RemoveHeader (Header &header)
 {
+  if (m_lazyHeaders != 0 && m_lazyHeaders->CopyTo (header))
+    {
+      uint32_t size = m_lazyHeaders->m_size;
+      NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+      // keep the next header alive while the first one is released
+      Ptr<const LazyHeader> next = m_lazyHeaders->m_next;
+      m_lazyHeaders = next;
+      m_lazySize -= size;
+      return size;
+    }
+  SerializeLazyHeaders ();
   uint32_t deserialized = header.Deserialize (m_buffer.Begin ());
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
   m_buffer.RemoveAtStart (deserialized);
@@ -277,6 +327,12 @@ Packet::RemoveHeader (Header &header)
 uint32_t
 Packet::PeekHeader (Header &header) const
 {
+  if (m_lazyHeaders != 0 && m_lazyHeaders->CopyTo (header))
+    {
+      NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << m_lazyHeaders->m_size);
+      return m_lazyHeaders->m_size;
+    }
+  SerializeLazyHeaders ();
   uint32_t deserialized = header.Deserialize (m_buffer.Begin ());
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
   return deserialized;
@@ -286,6 +342,7 @@ Packet::AddTrailer (const Trailer &trailer)
 {
   uint32_t size = trailer.GetSerializedSize ();
   NS_LOG_FUNCTION (this << trailer.GetInstanceTypeId ().GetName () << size);
+  SerializeLazyHeaders ();
   m_byteTagList.AddAtEnd (GetSize ());
   m_buffer.AddAtEnd (size);
   Buffer::Iterator end = m_buffer.End ();
@@ -295,6 +352,7 @@ Packet::AddTrailer (const Trailer &trailer)
 uint32_t
 Packet::RemoveTrailer (Trailer &trailer)
 {
+  SerializeLazyHeaders ();
   uint32_t deserialized = trailer.Deserialize (m_buffer.End ());
   NS_LOG_FUNCTION (this << trailer.GetInstanceTypeId ().GetName () << deserialized);
   m_buffer.RemoveAtEnd (deserialized);
@@ -304,6 +362,7 @@ Packet::RemoveTrailer (Trailer &trailer)
 uint32_t
 Packet::PeekTrailer (Trailer &trailer)
 {
+  SerializeLazyHeaders ();
   uint32_t deserialized = trailer.Deserialize (m_buffer.End ());
   NS_LOG_FUNCTION (this << trailer.GetInstanceTypeId ().GetName () << deserialized);
   return deserialized;
@@ -313,6 +372,8 @@ void
 Packet::AddAtEnd (Ptr<const Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet << packet->GetSize ());
+  SerializeLazyHeaders ();
+  packet->SerializeLazyHeaders ();
   m_byteTagList.AddAtEnd (GetSize ());
   ByteTagList copy = packet->m_byteTagList;
   copy.AddAtStart (0);
@@ -325,6 +386,7 @@ void
 Packet::AddPaddingAtEnd (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  SerializeLazyHeaders ();
   m_byteTagList.AddAtEnd (GetSize ());
   m_buffer.AddAtEnd (size);
   m_metadata.AddPaddingAtEnd (size);
@@ -333,6 +395,7 @@ void
 Packet::RemoveAtEnd (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  SerializeLazyHeaders ();
   m_buffer.RemoveAtEnd (size);
   m_metadata.RemoveAtEnd (size);
 }
@@ -340,6 +403,7 @@ void
 Packet::RemoveAtStart (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  SerializeLazyHeaders ();
   m_buffer.RemoveAtStart (size);
   m_byteTagList.Adjust (-size);
   m_metadata.RemoveAtStart (size);
@@ -355,12 +419,14 @@ Packet::RemoveAllByteTags (void)
 uint32_t 
 Packet::CopyData (uint8_t *buffer, uint32_t size) const
 {
+  SerializeLazyHeaders ();
   return m_buffer.CopyData (buffer, size);
 }
 
 void
 Packet::CopyData (std::ostream *os, uint32_t size) const
 {
+  SerializeLazyHeaders ();
   return m_buffer.CopyData (os, size);
 }
 
@@ -411,6 +477,7 @@ Packet::ToString() const
 void 
 Packet::Print (std::ostream &os) const
 {
+  SerializeLazyHeaders ();
   PacketMetadata::ItemIterator i = m_metadata.BeginItem (m_buffer);
   while (i.HasNext ())
     {
@@ -528,6 +595,7 @@ Packet::Print (std::ostream &os) const
 PacketMetadata::ItemIterator 
 Packet::BeginItem (void) const
 {
+  SerializeLazyHeaders ();
   return m_metadata.BeginItem (m_buffer);
 }
 
@@ -545,8 +613,23 @@ Packet::EnableChecking (void)
   PacketMetadata::EnableChecking ();
 }
 
+void
+Packet::EnableLazyHeaders (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enableLazyHeaders = true;
+}
+
+void
+Packet::DisableLazyHeaders (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enableLazyHeaders = false;
+}
+
 uint32_t Packet::GetSerializedSize (void) const
 {
+  SerializeLazyHeaders ();
   uint32_t size = 0;
 
   if (m_nixVector)
@@ -590,6 +673,7 @@ uint32_t Packet::GetSerializedSize (void) const
 uint32_t 
 Packet::Serialize (uint8_t* buffer, uint32_t maxSize) const
 {
+  SerializeLazyHeaders ();
   uint32_t* p = reinterpret_cast<uint32_t *> (buffer);
   uint32_t size = 0;
 
@@ -791,6 +875,7 @@ void
 Packet::AddByteTag (const Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ().GetName () << tag.GetSerializedSize ());
+  SerializeLazyHeaders ();
   ByteTagList *list = const_cast<ByteTagList *> (&m_byteTagList);
   TagBuffer buffer = list->Add (tag.GetInstanceTypeId (), tag.GetSerializedSize (), 
                                 0,
@@ -800,6 +885,7 @@ Packet::AddByteTag (const Tag &tag) const
 ByteTagIterator 
 Packet::GetByteTagIterator (void) const
 {
+  SerializeLazyHeaders ();
   return ByteTagIterator (m_byteTagList.Begin (0, GetSize ()));
 }
 
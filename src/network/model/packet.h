@@ -34,6 +34,7 @@
 #include "ns3/assert.h"
 #include "ns3/ptr.h"
 #include "ns3/deprecated.h"
+#include <typeinfo>
 
 namespace ns3 {
 
@@ -309,10 +310,30 @@ public:
    * \param header a reference to the header to add to this packet.
    */
   void AddHeader (const Header & header);
+  /**
+   * \brief Add header to this packet, serializing it only when needed.
+   *
+   * If lazy headers are enabled, a copy of the header is kept in front
+   * of the packet bytes instead of being serialized.  RemoveHeader and
+   * PeekHeader with a header of the very same type return that copy
+   * without any serialization; every other operation which needs the
+   * packet bytes (CopyData, Print, trailers, byte tags, fragments...)
+   * serializes the pending headers first, with AddHeader.  Otherwise,
+   * this method is the same as AddHeader.
+   *
+   * The header type must be copyable and must deserialize its own
+   * serialization to an equal value.
+   *
+   * \param header a reference to the header to add to this packet.
+   * \sa EnableLazyHeaders
+   */
+  template <typename T>
+  void AddLazyHeader (const T &header);
   /**
    * \brief Deserialize and remove the header from the internal buffer.
    *
-   * This method invokes Header::Deserialize.
+   * This method invokes Header::Deserialize, unless the header was
+   * added with AddLazyHeader and not serialized yet.
    *
    * \param header a reference to the header to remove from the internal buffer.
    * \returns the number of bytes removed from the packet.
@@ -501,6 +522,23 @@ public:
    * errors will be detected and will abort the program.
    */
   static void EnableChecking (void);
+  /**
+   * \brief Enable the lazy serialization of the headers added
+   * with AddLazyHeader.
+   *
+   * This is meant for the forwarding path of large simulations, where
+   * the IPv4 and link headers are added by a node and removed by the
+   * next one: their serialization is skipped unless the packet bytes
+   * are inspected in between, for example by a pcap trace.
+   */
+  static void EnableLazyHeaders (void);
+  /**
+   * \brief Disable the lazy serialization of the headers, which
+   * is the default.
+   *
+   * The headers already pending in existing packets are unaffected.
+   */
+  static void DisableLazyHeaders (void);
 
   /**
    * \brief Returns number of bytes required for packet
@@ -713,6 +751,86 @@ private:
 
   uint32_t Deserialize (uint8_t const*buffer, uint32_t size);
 
+  /**
+   * \brief A header added with AddLazyHeader and not serialized yet.
+   *
+   * The pending headers form a stack whose top is the first header
+   * of the packet.  The stack entries are never modified, so the
+   * copies of a packet share them.
+   */
+  class LazyHeader : public SimpleRefCount<LazyHeader>
+  {
+  public:
+    /**
+     * \brief Constructor
+     * \param next the next header of the packet, if not serialized yet
+     * \param size the serialized size of the header
+     */
+    LazyHeader (Ptr<const LazyHeader> next, uint32_t size);
+    virtual ~LazyHeader ();
+    /**
+     * \returns the pending header
+     */
+    virtual const Header &GetHeader (void) const = 0;
+    /**
+     * \brief Copy the pending header if it has the type of the argument
+     * \param header the header to fill
+     * \returns true if the header was copied
+     */
+    virtual bool CopyTo (Header &header) const = 0;
+
+    Ptr<const LazyHeader> m_next; //!< the next pending header
+    uint32_t m_size;              //!< the serialized size of the header
+  };
+
+  /**
+   * \brief A pending header of type T.
+   */
+  template <typename T>
+  class LazyHeaderImpl : public LazyHeader
+  {
+  public:
+    /**
+     * \brief Constructor
+     * \param next the next header of the packet, if not serialized yet
+     * \param header the header
+     */
+    LazyHeaderImpl (Ptr<const LazyHeader> next, const T &header)
+      : LazyHeader (next, header.GetSerializedSize ()),
+        m_header (header)
+    {
+    }
+    virtual const Header &GetHeader (void) const
+    {
+      return m_header;
+    }
+    virtual bool CopyTo (Header &header) const
+    {
+      if (typeid (header) != typeid (T))
+        {
+          return false;
+        }
+      static_cast<T &> (header) = m_header;
+      return true;
+    }
+
+  private:
+    T m_header; //!< the header
+  };
+
+  /**
+   * \brief Serialize the pending lazy headers, if any.
+   *
+   * This only changes the representation of the packet, hence it
+   * is const.
+   */
+  inline void SerializeLazyHeaders (void) const;
+  /**
+   * \brief Serialize the given pending header and the ones behind it.
+   * \param header the first pending header to serialize
+   */
+  void DoSerializeLazyHeaders (Ptr<const LazyHeader> header);
+
   Buffer m_buffer;                //!< the packet buffer (it's actual contents)
   ByteTagList m_byteTagList;      //!< the ByteTag list
   PacketTagList m_packetTagList;  //!< the packet's Tag list
@@ -721,7 +839,11 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+  Ptr<const LazyHeader> m_lazyHeaders; //!< the headers not serialized yet
+  uint32_t m_lazySize;                 //!< the size of the headers not serialized yet
+
   static uint32_t m_globalUid; //!< Global counter of packets Uid
+  static bool m_enableLazyHeaders; //!< Enable the lazy headers
 };
 
 /**
@@ -761,6 +883,7 @@ std::ostream& operator<< (std::ostream& os, const Packet &packet);
  *   - ns3::Packet::FindFirstMatchingByteTag
  *   - ns3::Packet::RemoveAllByteTags
  *   - ns3::Packet::RemoveHeader
+ *   - ns3::Packet::AddLazyHeader
  *   - ns3::Packet::RemoveTrailer
  *   - ns3::Packet::CreateFragment
  *   - ns3::Packet::RemoveAtStart
@@ -785,7 +908,33 @@ namespace ns3 {
 uint32_t 
 Packet::GetSize (void) const
 {
-  return m_buffer.GetSize ();
+  return m_buffer.GetSize () + m_lazySize;
+}
+
+template <typename T>
+void
+Packet::AddLazyHeader (const T &header)
+{
+  if (!m_enableLazyHeaders)
+    {
+      AddHeader (header);
+      return;
+    }
+  m_lazyHeaders = Create<LazyHeaderImpl<T> > (m_lazyHeaders, header);
+  m_lazySize += m_lazyHeaders->m_size;
+}
+
+void
+Packet::SerializeLazyHeaders (void) const
+{
+  if (m_lazyHeaders != 0)
+    {
+      Ptr<const LazyHeader> headers = m_lazyHeaders;
+      Packet *self = const_cast<Packet *> (this);
+      self->m_lazyHeaders = 0;
+      self->m_lazySize = 0;
+      self->DoSerializeLazyHeaders (headers);
+    }
 }
 
 } // namespace ns3
@@ -832,7 +832,11 @@ public:
 PacketMetadataTestSuite::PacketMetadataTestSuite ()
   : TestSuite ("packet-metadata", UNIT)
 {
+  // Nothing to test when the metadata is compiled out, as in the
+  // fastsim build profile
+#ifndef NS3_PACKET_METADATA_DISABLE
   AddTestCase (new PacketMetadataTest, TestCase::QUICK);
+#endif /* NS3_PACKET_METADATA_DISABLE */
 }
 
 PacketMetadataTestSuite g_packetMetadataTest;
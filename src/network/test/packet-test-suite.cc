@@ -24,6 +24,7 @@
 #include <limits>     // std:numeric_limits
 #include <string>
 #include <cstdarg>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <ctime>
@@ -184,6 +185,48 @@ public:
 
 };
 
+class ALazyTestHeader : public Header
+{
+public:
+  ALazyTestHeader () : Header (), m_value (0) {}
+  ALazyTestHeader (uint16_t value) : Header (), m_value (value) {}
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("anon::ALazyTestHeader")
+      .SetParent<Header> ()
+      .SetGroupName ("Network")
+      .HideFromDocumentation ()
+      .AddConstructor<ALazyTestHeader> ()
+      ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const {
+    return GetTypeId ();
+  }
+  virtual uint32_t GetSerializedSize (void) const {
+    return 2;
+  }
+  virtual void Serialize (Buffer::Iterator iter) const {
+    m_serializations++;
+    iter.WriteHtonU16 (m_value);
+  }
+  virtual uint32_t Deserialize (Buffer::Iterator iter) {
+    m_value = iter.ReadNtohU16 ();
+    return 2;
+  }
+  virtual void Print (std::ostream &os) const {
+    os << m_value;
+  }
+  uint16_t m_value;
+  static uint32_t m_serializations;
+};
+
+uint32_t ALazyTestHeader::m_serializations = 0;
+
 class ATestTrailerBase : public Trailer
 {
 public:
@@ -557,6 +600,27 @@ PacketTest::DoRun (void)
     CHECK (tmp, 1, E (25, 0, 50));
   }
 
+  /* Test more than 64KB of byte tags, e.g., a long TCP reassembly buffer. */
+  {
+    Ptr<Packet> tmp = Create<Packet> (0);
+    for (uint32_t i = 0; i < 5000; i++)
+      {
+        Ptr<Packet> segment = Create<Packet> (10);
+        segment->AddByteTag (ATestTag<20> ());
+        tmp->AddAtEnd (segment);
+      }
+    uint32_t n = 0;
+    ByteTagIterator i = tmp->GetByteTagIterator ();
+    while (i.HasNext ())
+      {
+        ByteTagIterator::Item item = i.Next ();
+        NS_TEST_EXPECT_MSG_EQ (item.GetStart (), n * 10, "wrong byte tag start");
+        NS_TEST_EXPECT_MSG_EQ (item.GetEnd (), n * 10 + 10, "wrong byte tag end");
+        n++;
+      }
+    NS_TEST_EXPECT_MSG_EQ (n, 5000, "wrong number of byte tags");
+  }
+
   /* Test AddPaddingAtEnd. */
   {
     Ptr<Packet> tmp = Create<Packet> (0);
@@ -582,6 +646,74 @@ PacketTest::DoRun (void)
     tmp->AddPaddingAtEnd (50);
     CHECK (tmp, 1, E (25, 0, 50));
   }
+
+  /* Test the lazy headers. */
+  {
+    Packet::EnableLazyHeaders ();
+    ALazyTestHeader::m_serializations = 0;
+    Ptr<Packet> tmp = Create<Packet> (10);
+    tmp->AddByteTag (ATestTag<1> ());
+    tmp->AddLazyHeader (ATestHeader<3> ());
+    tmp->AddLazyHeader (ALazyTestHeader (7));
+    NS_TEST_EXPECT_MSG_EQ (tmp->GetSize (), 15, "wrong size with lazy headers");
+    Ptr<Packet> copy = tmp->Copy ();
+
+    // the pending headers are returned without being serialized
+    ALazyTestHeader lazy;
+    NS_TEST_EXPECT_MSG_EQ (tmp->PeekHeader (lazy), 2, "wrong peeked size");
+    NS_TEST_EXPECT_MSG_EQ (lazy.m_value, 7, "wrong peeked header");
+    lazy.m_value = 0;
+    NS_TEST_EXPECT_MSG_EQ (tmp->RemoveHeader (lazy), 2, "wrong removed size");
+    NS_TEST_EXPECT_MSG_EQ (lazy.m_value, 7, "wrong removed header");
+    NS_TEST_EXPECT_MSG_EQ (tmp->GetSize (), 13, "wrong size after the removal");
+    ATestHeader<3> three;
+    NS_TEST_EXPECT_MSG_EQ (tmp->RemoveHeader (three), 3, "wrong removed size");
+    NS_TEST_EXPECT_MSG_EQ (ALazyTestHeader::m_serializations, 0, "a lazy header was serialized");
+    CHECK (tmp, 1, E (1, 0, 10));
+
+    // reading the bytes serializes the pending headers, as AddHeader would
+    Ptr<Packet> eager = Create<Packet> (10);
+    eager->AddByteTag (ATestTag<1> ());
+    eager->AddHeader (ATestHeader<3> ());
+    eager->AddHeader (ALazyTestHeader (7));
+    uint8_t lazyBytes[15];
+    uint8_t eagerBytes[15];
+    NS_TEST_EXPECT_MSG_EQ (copy->CopyData (lazyBytes, 15), 15, "wrong copied size");
+    eager->CopyData (eagerBytes, 15);
+    NS_TEST_EXPECT_MSG_EQ (std::memcmp (lazyBytes, eagerBytes, 15), 0, "wrong serialization");
+    NS_TEST_EXPECT_MSG_EQ (ALazyTestHeader::m_serializations, 2, "the lazy header should be serialized");
+    CHECK (copy, 1, E (1, 5, 15));
+    lazy.m_value = 0;
+    copy->RemoveHeader (lazy);
+    NS_TEST_EXPECT_MSG_EQ (lazy.m_value, 7, "wrong deserialized header");
+
+    // a header of another type serializes the pending headers first
+    copy->AddLazyHeader (ALazyTestHeader (8));
+    three.m_error = false;
+    copy->AddLazyHeader (three);
+    NS_TEST_EXPECT_MSG_EQ (copy->PeekHeader (lazy), 2, "wrong peeked size");
+    NS_TEST_EXPECT_MSG_EQ (lazy.m_value, 0x0303, "wrong peeked bytes");
+    NS_TEST_EXPECT_MSG_EQ (copy->GetSize (), 18, "wrong size after the serialization");
+    NS_TEST_EXPECT_MSG_EQ (copy->RemoveHeader (three), 3, "wrong removed size");
+    NS_TEST_EXPECT_MSG_EQ (three.m_error, false, "wrong deserialized bytes");
+    copy->RemoveHeader (lazy);
+    NS_TEST_EXPECT_MSG_EQ (lazy.m_value, 8, "wrong deserialized header");
+
+    // the pending headers of a packet nobody else holds are released one by one
+    Ptr<Packet> alone = Create<Packet> (10);
+    alone->AddLazyHeader (ALazyTestHeader (1));
+    alone->AddLazyHeader (ALazyTestHeader (2));
+    alone->RemoveHeader (lazy);
+    NS_TEST_EXPECT_MSG_EQ (lazy.m_value, 2, "wrong removed header");
+    alone->RemoveHeader (lazy);
+    NS_TEST_EXPECT_MSG_EQ (lazy.m_value, 1, "wrong removed header");
+    NS_TEST_EXPECT_MSG_EQ (alone->GetSize (), 10, "wrong size after the removals");
+    Packet::DisableLazyHeaders ();
+
+    // without lazy headers, AddLazyHeader is AddHeader
+    tmp->AddLazyHeader (ALazyTestHeader (9));
+    NS_TEST_EXPECT_MSG_EQ (ALazyTestHeader::m_serializations, 4, "the header should be serialized");
+  }
 }
 //--------------------------------------
 class PacketTagListTest : public TestCase
@@ -24,6 +24,7 @@
 #include "ns3/error-model.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/pointer.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
@@ -67,6 +68,13 @@ PointToPointNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&PointToPointNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("LazyTransmitComplete",
+                   "Only schedule the end of a transmission when a packet "
+                   "is waiting for it, so that a packet sent on an idle "
+                   "link costs a single event",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PointToPointNetDevice::m_lazyTxComplete),
+                   MakeBooleanChecker ())
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -175,6 +183,7 @@ PointToPointNetDevice::GetTypeId (void)
 PointToPointNetDevice::PointToPointNetDevice () 
   :
     m_txMachineState (READY),
+    m_lazyTxComplete (false),
     m_channel (0),
     m_linkUp (false),
     m_currentPkt (0)
@@ -193,7 +202,7 @@ PointToPointNetDevice::AddHeader (Ptr<Packet> p, uint16_t protocolNumber)
   NS_LOG_FUNCTION (this << p << protocolNumber);
   PppHeader ppp;
   ppp.SetProtocol (EtherToPpp (protocolNumber));
-  p->AddHeader (ppp);
+  p->AddLazyHeader (ppp);
 }
 
 bool
@@ -220,6 +229,7 @@ void
 PointToPointNetDevice::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_txCompleteEvent.Cancel ();
   m_node = 0;
   m_channel = 0;
   m_receiveErrorModel = 0;
@@ -262,8 +272,12 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
   Time txCompleteTime = txTime + m_tInterframeGap;
 
-  NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
-  Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+  m_txCompleteTime = Simulator::Now () + txCompleteTime;
+  if (!m_lazyTxComplete || !m_queue->IsEmpty () || !m_phyTxEndTrace.IsEmpty ())
+    {
+      NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
+      m_txCompleteEvent = Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+    }
 
   bool result = m_channel->TransmitStart (p, this, txTime);
   if (result == false)
@@ -325,6 +339,19 @@ PointToPointNetDevice::TransmitComplete (void)
   TransmitStart (p);
 }
 
+void
+PointToPointNetDevice::ScheduleTransmitComplete (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_txMachineState == BUSY);
+  if (!m_txCompleteEvent.IsRunning ())
+    {
+      NS_LOG_LOGIC ("Schedule TransmitCompleteEvent at " << m_txCompleteTime.GetSeconds () << "sec");
+      m_txCompleteEvent = Simulator::Schedule (m_txCompleteTime - Simulator::Now (),
+                                               &PointToPointNetDevice::TransmitComplete, this);
+    }
+}
+
 bool
 PointToPointNetDevice::Attach (Ptr<PointToPointChannel> ch)
 {
@@ -384,9 +411,13 @@ PointToPointNetDevice::Receive (Ptr<Packet> packet)
 
       //
       // Trace sinks will expect complete packets, not packets without some of the
-      // headers.
+      // headers.  Only pay for the copy if a sink is connected.
       //
-      Ptr<Packet> originalPacket = packet->Copy ();
+      Ptr<Packet> originalPacket;
+      if (!m_macRxTrace.IsEmpty () || !m_macPromiscRxTrace.IsEmpty ())
+        {
+          originalPacket = packet->Copy ();
+        }
 
       //
       // Strip off the point-to-point protocol header and forward this packet
@@ -398,11 +429,17 @@ PointToPointNetDevice::Receive (Ptr<Packet> packet)
 
       if (!m_promiscCallback.IsNull ())
         {
-          m_macPromiscRxTrace (originalPacket);
+          if (!m_macPromiscRxTrace.IsEmpty ())
+            {
+              m_macPromiscRxTrace (originalPacket);
+            }
           m_promiscCallback (this, packet, protocol, GetRemote (), GetAddress (), NetDevice::PACKET_HOST);
         }
 
-      m_macRxTrace (originalPacket);
+      if (!m_macRxTrace.IsEmpty ())
+        {
+          m_macRxTrace (originalPacket);
+        }
       m_rxCallback (this, packet, protocol, GetRemote ());
     }
 }
@@ -568,6 +605,18 @@ PointToPointNetDevice::Send (
 
   m_macTxTrace (packet);
 
+  //
+  // With LazyTransmitComplete, the last transmission may have ended
+  // without any event to tell us.
+  //
+  if (m_txMachineState == BUSY && !m_txCompleteEvent.IsRunning ()
+      && Simulator::Now () >= m_txCompleteTime)
+    {
+      NS_LOG_LOGIC ("Transmission ended at " << m_txCompleteTime.GetSeconds () << "sec");
+      m_txMachineState = READY;
+      m_currentPkt = 0;
+    }
+
   //
   // We should enqueue and dequeue the packet to hit the tracing hooks.
   //
@@ -583,6 +632,10 @@ PointToPointNetDevice::Send (
           m_promiscSnifferTrace (packet);
           return TransmitStart (packet);
         }
+      if (m_lazyTxComplete)
+        {
+          ScheduleTransmitComplete ();
+        }
       return true;
     }
 
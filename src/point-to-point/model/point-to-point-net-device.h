@@ -30,6 +30,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
+#include "ns3/event-id.h"
 
 namespace ns3 {
 
@@ -58,6 +59,15 @@ class ErrorModel;
  * Key parameters or objects that can be specified for this device 
  * include a queue, data rate, and interframe transmission gap (the 
  * propagation delay is set in the PointToPointChannel).
+ *
+ * With the LazyTransmitComplete attribute set, the end of a transmission
+ * is only scheduled as an event when a packet is waiting in the device
+ * queue, or when a PhyTxEnd sink is connected.  Otherwise the device
+ * remembers when the wire becomes free and finds out that it is READY
+ * when the next packet is sent.  A packet on a link which is not
+ * backlogged then costs a single event, its reception, while the packets
+ * of a backlogged link are still dequeued, from the device queue and the
+ * queue disc, at the exact time their transmission starts.
  */
 class PointToPointNetDevice : public NetDevice
 {
@@ -277,6 +287,14 @@ private:
    */
   void TransmitComplete (void);
 
+  /**
+   * Schedule the end of the current transmission, if not done yet.
+   *
+   * Only used with LazyTransmitComplete, when a packet is queued behind
+   * the current transmission.
+   */
+  void ScheduleTransmitComplete (void);
+
   /**
    * \brief Make the link up and running
    *
@@ -309,6 +327,22 @@ private:
    */
   Time           m_tInterframeGap;
 
+  /**
+   * Whether the end of a transmission is only scheduled when needed
+   */
+  bool           m_lazyTxComplete;
+
+  /**
+   * The time at which the current transmission, interframe gap included,
+   * is complete
+   */
+  Time           m_txCompleteTime;
+
+  /**
+   * The event ending the current transmission, if scheduled
+   */
+  EventId        m_txCompleteEvent;
+
   /**
    * The PointToPointChannel to which this PointToPointNetDevice has been
    * attached.
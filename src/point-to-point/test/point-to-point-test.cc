@@ -23,6 +23,8 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/boolean.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -98,6 +100,131 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test the LazyTransmitComplete mode of the PointToPointNetDevice
+ *
+ * It sends the same packets, back to back, spaced out and queued behind
+ * a transmission whose end was not scheduled, with and without
+ * LazyTransmitComplete, and checks that they are received at the same
+ * times.
+ */
+class PointToPointLazyTxTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointLazyTxTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send the packets over a link and record their reception times
+   *
+   * \param lazy whether the sending device uses LazyTransmitComplete
+   * \param rxTimes the reception times
+   */
+  void RunLink (bool lazy, std::vector<Time> &rxTimes);
+
+  /**
+   * \brief Send one packet to the device specified
+   *
+   * \param device NetDevice to send to
+   */
+  void SendOnePacket (Ptr<PointToPointNetDevice> device);
+
+  /**
+   * \brief Record the reception of a packet
+   *
+   * \param device the receiving device
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  std::vector<Time> *m_rxTimes; //!< Where to record the reception times
+};
+
+PointToPointLazyTxTest::PointToPointLazyTxTest ()
+  : TestCase ("PointToPoint LazyTransmitComplete"),
+    m_rxTimes (0)
+{
+}
+
+void
+PointToPointLazyTxTest::SendOnePacket (Ptr<PointToPointNetDevice> device)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointLazyTxTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  m_rxTimes->push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointLazyTxTest::RunLink (bool lazy, std::vector<Time> &rxTimes)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (3)));
+  devA->SetAttribute ("LazyTransmitComplete", BooleanValue (lazy));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  m_rxTimes = &rxTimes;
+  devB->SetReceiveCallback (MakeCallback (&PointToPointLazyTxTest::Receive, this));
+
+  // A packet takes about 25ms at the default rate of 32768b/s
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Simulator::Schedule (Seconds (1.0), &PointToPointLazyTxTest::SendOnePacket, this, devA);
+    }
+  Simulator::Schedule (Seconds (1.2), &PointToPointLazyTxTest::SendOnePacket, this, devA);
+  Simulator::Schedule (Seconds (1.21), &PointToPointLazyTxTest::SendOnePacket, this, devA);
+  Simulator::Schedule (Seconds (1.5), &PointToPointLazyTxTest::SendOnePacket, this, devA);
+
+  Simulator::Run ();
+
+  Simulator::Destroy ();
+}
+
+void
+PointToPointLazyTxTest::DoRun (void)
+{
+  std::vector<Time> expected;
+  RunLink (false, expected);
+  std::vector<Time> lazy;
+  RunLink (true, lazy);
+
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 6, "Not all the packets were received");
+  NS_TEST_ASSERT_MSG_EQ (lazy.size (), expected.size (), "Not all the packets were received in lazy mode");
+  for (uint32_t i = 0; i < lazy.size () && i < expected.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (lazy[i], expected[i], "Packet " << i << " received at a different time");
+    }
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -114,6 +241,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointLazyTxTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
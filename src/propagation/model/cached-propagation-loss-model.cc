@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cached-propagation-loss-model.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CachedPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("LossModel",
+                   "The loss model, or the first loss model of the chain, whose received power is cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::m_model),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("PositionTolerance",
+                   "The distance (m) a moving node may move before its received powers are computed "
+                   "again. If zero, the received powers of moving nodes are not cached.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&CachedPropagationLossModel::m_tolerance),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_tolerance (0.0),
+    m_hits (0),
+    m_misses (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  //The callbacks were made from a const this, which they must match to
+  //be disconnected
+  const CachedPropagationLossModel *self = this;
+  for (TrackedMap::iterator it = m_tracked.begin (); it != m_tracked.end (); ++it)
+    {
+      it->second.m_mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                            MakeCallback (&CachedPropagationLossModel::CourseChanged, self));
+    }
+  m_tracked.clear ();
+  m_cache.clear ();
+  m_model = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::SetLossModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  Flush ();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetLossModel (void) const
+{
+  return m_model;
+}
+
+void
+CachedPropagationLossModel::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_cache.clear ();
+}
+
+uint64_t
+CachedPropagationLossModel::GetMisses (void) const
+{
+  return m_misses;
+}
+
+uint64_t
+CachedPropagationLossModel::GetHits (void) const
+{
+  return m_hits;
+}
+
+CachedPropagationLossModel::Tracked &
+CachedPropagationLossModel::Track (Ptr<MobilityModel> mobility) const
+{
+  TrackedMap::iterator it = m_tracked.find (PeekPointer (mobility));
+  if (it != m_tracked.end ())
+    {
+      return it->second;
+    }
+  NS_LOG_LOGIC (this << " tracing the course changes of " << mobility);
+  mobility->TraceConnectWithoutContext ("CourseChange",
+                                        MakeCallback (&CachedPropagationLossModel::CourseChanged, this));
+  Tracked &tracked = m_tracked[PeekPointer (mobility)];
+  tracked.m_mobility = mobility;
+  tracked.m_generation = 0;
+  return tracked;
+}
+
+void
+CachedPropagationLossModel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << mobility);
+  TrackedMap::iterator it = m_tracked.find (PeekPointer (mobility));
+  if (it != m_tracked.end ())
+    {
+      it->second.m_generation++;
+    }
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No loss model to cache");
+  // Get the positions first: some mobility models, such as
+  // WaypointMobilityModel with LazyNotify, only notify their course
+  // changes when their position is computed.
+  Vector positionA = a->GetPosition ();
+  Vector positionB = b->GetPosition ();
+  uint32_t generationA = Track (a).m_generation;
+  uint32_t generationB = Track (b).m_generation;
+  PathKey key;
+  key.m_a = PeekPointer (a);
+  key.m_b = PeekPointer (b);
+  key.m_txPowerDbm = txPowerDbm;
+
+  PathCache::iterator it = m_cache.find (key);
+  if (it != m_cache.end ())
+    {
+      PathEntry &entry = it->second;
+      if (entry.m_generationA == generationA && entry.m_generationB == generationB)
+        {
+          if (entry.m_static
+              || (m_tolerance > 0
+                  && CalculateDistance (positionA, entry.m_positionA) <= m_tolerance
+                  && CalculateDistance (positionB, entry.m_positionB) <= m_tolerance))
+            {
+              m_hits++;
+              return entry.m_rxPowerDbm;
+            }
+        }
+    }
+  else
+    {
+      it = m_cache.insert (std::make_pair (key, PathEntry ())).first;
+    }
+
+  m_misses++;
+  PathEntry &entry = it->second;
+  entry.m_rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+  entry.m_generationA = generationA;
+  entry.m_generationB = generationB;
+  Vector velocityA = a->GetVelocity ();
+  Vector velocityB = b->GetVelocity ();
+  entry.m_static = velocityA.x == 0 && velocityA.y == 0 && velocityA.z == 0
+    && velocityB.x == 0 && velocityB.y == 0 && velocityB.z == 0;
+  entry.m_positionA = positionA;
+  entry.m_positionB = positionB;
+  NS_LOG_LOGIC (this << " computed rxPower=" << entry.m_rxPowerDbm << "dbm, static=" << entry.m_static);
+  return entry.m_rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_model == 0)
+    {
+      return 0;
+    }
+  return m_model->AssignStreams (stream);
+}
+
+} // namespace ns3
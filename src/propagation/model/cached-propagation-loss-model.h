@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/vector.h"
+#include "ns3/sgi-hashmap.h"
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Caches the received power computed by another loss model,
+ * or chain of loss models, for each pair of nodes.
+ *
+ * The received power of a pair of mobility models and a transmit power is
+ * computed by the wrapped model once, and then reused until one of the
+ * two mobility models notifies a course change.  A node with a zero
+ * velocity cannot move without a course change, so the received power
+ * between static nodes is computed once for the whole simulation.  The
+ * received power from or to a moving node is computed again on every
+ * call, unless PositionTolerance is set: it is then reused while both
+ * nodes are within PositionTolerance of the positions it was computed at.
+ * The positions are read on every call, so that the mobility models which
+ * only notify their course changes when their position is read, such as
+ * WaypointMobilityModel with LazyNotify, invalidate the cache as well.
+ *
+ * The cache is only correct for loss models which give the same loss
+ * for the same positions, such as FriisPropagationLossModel,
+ * LogDistancePropagationLossModel or OkumuraHataPropagationLossModel.
+ * Models drawing a random loss on each call, such as
+ * NakagamiPropagationLossModel or JakesPropagationLossModel, must not be
+ * wrapped.  The memory used grows with the number of pairs of nodes
+ * which exchange signals.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the loss model, or the first loss model of the chain,
+   * whose received power is cached
+   */
+  void SetLossModel (Ptr<PropagationLossModel> model);
+
+  /**
+   * \return the loss model whose received power is cached
+   */
+  Ptr<PropagationLossModel> GetLossModel (void) const;
+
+  /**
+   * Forget all the cached received powers.
+   */
+  void Flush (void);
+
+  /**
+   * \return the number of received powers computed by the wrapped model
+   */
+  uint64_t GetMisses (void) const;
+
+  /**
+   * \return the number of received powers found in the cache
+   */
+  uint64_t GetHits (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  CachedPropagationLossModel (const CachedPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  CachedPropagationLossModel & operator = (const CachedPropagationLossModel &);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /**
+   * \brief A mobility model whose course changes are traced.
+   */
+  struct Tracked
+  {
+    Ptr<MobilityModel> m_mobility;  //!< The mobility model
+    uint32_t m_generation;          //!< Number of course changes seen
+  };
+
+  /**
+   * \brief Get the tracked state of a mobility model, starting to trace
+   * its course changes if needed.
+   * \param mobility the mobility model
+   * \return the tracked state
+   */
+  Tracked & Track (Ptr<MobilityModel> mobility) const;
+
+  /**
+   * \brief Invalidate the received powers of a mobility model.
+   * \param mobility the mobility model which changed course
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+
+  /**
+   * \brief The key of a cached received power: the two mobility models,
+   * in order, and the transmit power.
+   */
+  struct PathKey
+  {
+    const MobilityModel *m_a;   //!< Mobility model of the source
+    const MobilityModel *m_b;   //!< Mobility model of the destination
+    double m_txPowerDbm;        //!< Transmit power
+
+    /**
+     * \param other the key to compare with
+     * \return true if the keys are equal
+     */
+    bool operator == (const PathKey &other) const
+    {
+      return m_a == other.m_a && m_b == other.m_b && m_txPowerDbm == other.m_txPowerDbm;
+    }
+  };
+
+  /**
+   * \brief Hash of a PathKey.
+   */
+  struct PathKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator () (const PathKey &key) const
+    {
+      size_t h = reinterpret_cast<size_t> (key.m_a);
+      h = h * 31 + reinterpret_cast<size_t> (key.m_b);
+      return h ^ (h >> 7);
+    }
+  };
+
+  /**
+   * \brief A cached received power.
+   */
+  struct PathEntry
+  {
+    double m_rxPowerDbm;       //!< Received power
+    uint32_t m_generationA;    //!< Course changes of the source when computed
+    uint32_t m_generationB;    //!< Course changes of the destination when computed
+    bool m_static;             //!< Whether both nodes had a zero velocity when computed
+    Vector m_positionA;        //!< Position of the source when computed
+    Vector m_positionB;        //!< Position of the destination when computed
+  };
+
+  /**
+   * \brief Hash of a mobility model pointer.
+   */
+  struct MobilityHash
+  {
+    /**
+     * \param mobility the mobility model
+     * \return the hash of the pointer
+     */
+    size_t operator () (const MobilityModel *mobility) const
+    {
+      size_t h = reinterpret_cast<size_t> (mobility);
+      return h ^ (h >> 7);
+    }
+  };
+
+  /// Cached received powers by path
+  typedef sgi::hash_map<PathKey, PathEntry, PathKeyHash> PathCache;
+  /// Traced mobility models
+  typedef sgi::hash_map<const MobilityModel *, Tracked, MobilityHash> TrackedMap;
+
+  Ptr<PropagationLossModel> m_model;  //!< The loss model whose received power is cached
+  double m_tolerance;                 //!< Distance a node may move before a received power is computed again
+  mutable PathCache m_cache;          //!< Cached received powers
+  mutable TrackedMap m_tracked;       //!< Mobility models whose course changes are traced
+  mutable uint64_t m_hits;            //!< Received powers found in the cache
+  mutable uint64_t m_misses;          //!< Received powers computed
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
@@ -23,6 +23,10 @@
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/waypoint-mobility-model.h"
+#include "ns3/boolean.h"
+#include "ns3/cached-propagation-loss-model.h"
 #include "ns3/simulator.h"
 
 using namespace ns3;
@@ -436,6 +440,91 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (100,0,0));
+  Ptr<ConstantVelocityMobilityModel> c = CreateObject<ConstantVelocityMobilityModel> ();
+  c->SetPosition (Vector (0,0,0));
+  c->SetVelocity (Vector (1,0,0));
+
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<CachedPropagationLossModel> lossModel = CreateObject<CachedPropagationLossModel> ();
+  lossModel->SetLossModel (logDistance);
+
+  double txPwrdBm = 20.0;
+  double tolerance = 1e-6;
+
+  // Static nodes: computed once
+  double resultdBm = lossModel->CalcRxPower (txPwrdBm, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, logDistance->CalcRxPower (txPwrdBm, a, b), tolerance, "Got unexpected rcv power");
+  resultdBm = lossModel->CalcRxPower (txPwrdBm, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, logDistance->CalcRxPower (txPwrdBm, a, b), tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetMisses (), 1, "The received power should be computed once");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetHits (), 1, "The received power should be reused");
+
+  // A different tx power or direction is another path
+  lossModel->CalcRxPower (txPwrdBm + 1, a, b);
+  lossModel->CalcRxPower (txPwrdBm, b, a);
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetMisses (), 3, "Other paths should be computed");
+
+  // A course change invalidates the path
+  b->SetPosition (Vector (200,0,0));
+  resultdBm = lossModel->CalcRxPower (txPwrdBm, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, logDistance->CalcRxPower (txPwrdBm, a, b), tolerance, "Got unexpected rcv power after a course change");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetMisses (), 4, "The course change should invalidate the path");
+
+  // Moving nodes are computed every time, unless within the tolerance
+  lossModel->CalcRxPower (txPwrdBm, a, c);
+  lossModel->CalcRxPower (txPwrdBm, a, c);
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetMisses (), 6, "The paths of moving nodes should not be cached");
+  lossModel->SetAttribute ("PositionTolerance", DoubleValue (10));
+  lossModel->CalcRxPower (txPwrdBm, a, c);
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetMisses (), 6, "The moving node did not move beyond the tolerance");
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+  resultdBm = lossModel->CalcRxPower (txPwrdBm, a, c);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, logDistance->CalcRxPower (txPwrdBm, a, c), tolerance, "Got unexpected rcv power after moving");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetMisses (), 7, "The moving node moved beyond the tolerance");
+  Simulator::Destroy ();
+
+  // A lazy waypoint model only notifies its course changes when asked
+  Ptr<WaypointMobilityModel> d = CreateObject<WaypointMobilityModel> ();
+  d->SetAttribute ("LazyNotify", BooleanValue (true));
+  d->AddWaypoint (Waypoint (Seconds (0), Vector (100,0,0)));
+  d->AddWaypoint (Waypoint (Seconds (1), Vector (100,0,0)));
+  d->AddWaypoint (Waypoint (Seconds (2), Vector (300,0,0)));
+  lossModel->CalcRxPower (txPwrdBm, a, d);
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+  resultdBm = lossModel->CalcRxPower (txPwrdBm, a, d);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, logDistance->CalcRxPower (txPwrdBm, a, d), tolerance, "Got unexpected rcv power after a lazy course change");
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +539,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -131,10 +131,10 @@ SpectrumInterference::ConditionallyEvaluateChunk ()
   NS_LOG_LOGIC ("if condition: " << condition);
   if (condition)
     {
-      SpectrumValue sinr = (*m_rxSignal) / ((*m_allSignals) - (*m_rxSignal) + (*m_noise));
+      ComputeSinr (*m_rxSignal, *m_allSignals, *m_noise, m_interference, m_sinr);
       Time duration = Now () - m_lastChangeTime;
       NS_LOG_LOGIC ("calling m_errorModel->EvaluateChunk (sinr, duration)");
-      m_errorModel->EvaluateChunk (sinr, duration);
+      m_errorModel->EvaluateChunk (m_sinr, duration);
     }
 }
 
@@ -143,6 +143,9 @@ private:
 
   Ptr<const SpectrumValue> m_noise; //!< Noise spectral power density
 
+  SpectrumValue m_interference; //!< Interference plus noise of the last chunk, kept to reuse its storage
+  SpectrumValue m_sinr;         //!< SINR of the last chunk, kept to reuse its storage
+
   Time m_lastChangeTime;     //!< the time of the last change in m_TotalPower
 
   Ptr<SpectrumErrorModel> m_errorModel; //!< Error model
@@ -103,20 +103,24 @@ SpectrumValue::ConstBandsEnd () const
 }
 
 
+/*
+ * The element by element operations below are written as indexed loops
+ * over the raw arrays, with the size checks out of the loops, so that the
+ * compiler can vectorize them (with SSE or AVX, depending on the target
+ * the optimized builds are compiled for).
+ */
+
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  size_t n = m_values.size ();
+  double *v = n ? &m_values[0] : 0;
+  const double *w = n ? &x.m_values[0] : 0;
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
+      v[i] += w[i];
     }
 }
 
@@ -124,12 +128,11 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  size_t n = m_values.size ();
+  double *v = n ? &m_values[0] : 0;
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 += s;
-      ++it1;
+      v[i] += s;
     }
 }
 
@@ -138,17 +141,14 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  size_t n = m_values.size ();
+  double *v = n ? &m_values[0] : 0;
+  const double *w = n ? &x.m_values[0] : 0;
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
+      v[i] -= w[i];
     }
 }
 
@@ -164,17 +164,14 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  size_t n = m_values.size ();
+  double *v = n ? &m_values[0] : 0;
+  const double *w = n ? &x.m_values[0] : 0;
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
+      v[i] *= w[i];
     }
 }
 
@@ -182,12 +179,11 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  size_t n = m_values.size ();
+  double *v = n ? &m_values[0] : 0;
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 *= s;
-      ++it1;
+      v[i] *= s;
     }
 }
 
@@ -197,17 +193,14 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  size_t n = m_values.size ();
+  double *v = n ? &m_values[0] : 0;
+  const double *w = n ? &x.m_values[0] : 0;
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
+      v[i] /= w[i];
     }
 }
 
@@ -216,12 +209,11 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  size_t n = m_values.size ();
+  double *v = n ? &m_values[0] : 0;
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 /= s;
-      ++it1;
+      v[i] /= s;
     }
 }
 
@@ -231,12 +223,58 @@ SpectrumValue::Divide (double s)
 void
 SpectrumValue::ChangeSign ()
 {
-  Values::iterator it1 = m_values.begin ();
+  size_t n = m_values.size ();
+  double *v = n ? &m_values[0] : 0;
+  for (size_t i = 0; i < n; ++i)
+    {
+      v[i] = -v[i];
+    }
+}
 
-  while (it1 != m_values.end ())
+
+void
+SpectrumValue::AddScaled (const SpectrumValue& x, double s)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  size_t n = m_values.size ();
+  double *v = n ? &m_values[0] : 0;
+  const double *w = n ? &x.m_values[0] : 0;
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 = -(*it1);
-      ++it1;
+      v[i] += w[i] * s;
+    }
+}
+
+
+void
+ComputeSinr (const SpectrumValue& signal, const SpectrumValue& allSignals, const SpectrumValue& noise,
+             SpectrumValue& interference, SpectrumValue& sinr)
+{
+  NS_ASSERT (signal.m_spectrumModel == allSignals.m_spectrumModel);
+  NS_ASSERT (signal.m_spectrumModel == noise.m_spectrumModel);
+  if (interference.m_spectrumModel != signal.m_spectrumModel)
+    {
+      interference = SpectrumValue (signal.m_spectrumModel);
+    }
+  if (sinr.m_spectrumModel != signal.m_spectrumModel)
+    {
+      sinr = SpectrumValue (signal.m_spectrumModel);
+    }
+  size_t n = signal.m_values.size ();
+  if (n == 0)
+    {
+      return;
+    }
+  const double *s = &signal.m_values[0];
+  const double *a = &allSignals.m_values[0];
+  const double *w = &noise.m_values[0];
+  double *in = &interference.m_values[0];
+  double *out = &sinr.m_values[0];
+  for (size_t i = 0; i < n; ++i)
+    {
+      in[i] = a[i] - s[i] + w[i];
+      out[i] = s[i] / in[i];
     }
 }
 
@@ -390,16 +428,13 @@ double
 Integral (const SpectrumValue& arg)
 {
   double i = 0;
-  Values::const_iterator vit = arg.ConstValuesBegin ();
+  size_t n = arg.m_values.size ();
+  NS_ASSERT (n == arg.m_spectrumModel->GetNumBands ());
   Bands::const_iterator bit = arg.ConstBandsBegin ();
-  while (vit != arg.ConstValuesEnd ())
+  for (size_t k = 0; k < n; ++k, ++bit)
     {
-      NS_ASSERT (bit != arg.ConstBandsEnd ());
-      i += (*vit) * (bit->fh - bit->fl);
-      ++vit;
-      ++bit;
+      i += arg.m_values[k] * (bit->fh - bit->fl);
     }
-  NS_ASSERT (bit == arg.ConstBandsEnd ());
   return i;
 }
 
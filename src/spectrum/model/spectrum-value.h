@@ -497,6 +497,33 @@ public:
    */
   friend double Integral (const SpectrumValue&  arg);
 
+  /**
+   * Compute the interference and the SINR of a signal in one pass, as
+   * interference = allSignals - signal + noise and
+   * sinr = signal / interference, without the temporaries of the
+   * equivalent expression.  The results are written in the given values,
+   * which are reset to the SpectrumModel of the signal if needed, and
+   * must not be any of the arguments.
+   *
+   * @param signal the power spectral density of the signal
+   * @param allSignals the power spectral density of all the signals received, including the signal
+   * @param noise the power spectral density of the noise
+   * @param interference the interference plus noise
+   * @param sinr the SINR
+   */
+  friend void ComputeSinr (const SpectrumValue& signal, const SpectrumValue& allSignals,
+                           const SpectrumValue& noise, SpectrumValue& interference,
+                           SpectrumValue& sinr);
+
+  /**
+   * Add another value multiplied by a factor, without a temporary:
+   * this is equivalent to *this += x * s.
+   *
+   * @param x the value to add
+   * @param s the factor
+   */
+  void AddScaled (const SpectrumValue& x, double s);
+
   /**
    *
    * @return a Ptr to a copy of this instance
@@ -619,6 +646,9 @@ SpectrumValue Log10 (const SpectrumValue& arg);
 SpectrumValue Log2 (const SpectrumValue& arg);
 SpectrumValue Log (const SpectrumValue& arg);
 double Integral (const SpectrumValue& arg);
+void ComputeSinr (const SpectrumValue& signal, const SpectrumValue& allSignals,
+                  const SpectrumValue& noise, SpectrumValue& interference,
+                  SpectrumValue& sinr);
 
 
 } // namespace ns3
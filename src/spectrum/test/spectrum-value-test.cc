@@ -242,6 +242,16 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
 
+  SpectrumValue tinterf, tsinr;
+  ComputeSinr (v1, v2, v3, tinterf, tsinr);
+  AddTestCase (new SpectrumValueTestCase (tinterf, v2 - v1 + v3, "ComputeSinr (v1, v2, v3) interference"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tsinr, v1 / (v2 - v1 + v3), "ComputeSinr (v1, v2, v3) sinr"), TestCase::QUICK);
+
+  SpectrumValue tv3as = v3;
+  tv3as.AddScaled (v1, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv3as, v3 + v1 * doubleValue, "tv3as.AddScaled (v1, doubleValue)"), TestCase::QUICK);
+
+
 }
 
 
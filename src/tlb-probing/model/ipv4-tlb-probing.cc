@@ -114,6 +114,14 @@ Ipv4TLBProbing::SetNode (Ptr<Node> node)
     m_node = node;
 }
 
+int64_t
+Ipv4TLBProbing::AssignStreams (int64_t stream)
+{
+    NS_LOG_FUNCTION (this << stream);
+    m_rng.SetStream (stream);
+    return 1;
+}
+
 void
 Ipv4TLBProbing::AddBroadCastAddress (Ipv4Address addr)
 {
@@ -316,7 +324,7 @@ Ipv4TLBProbing::DoProbe ()
     {
         for (uint32_t i = 0; i < 10; i++) // Try 8 times
         {
-            uint32_t path = availPaths[rand() % availPaths.size ()];
+            uint32_t path = availPaths[m_rng.GetInteger (availPaths.size ())];
             if (pathSet.find (path) != pathSet.end ())
             {
                 continue;
@@ -8,6 +8,7 @@
 #include "ns3/ipv4-address.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/counter-rng.h"
 
 #include <vector>
 #include <map>
@@ -36,6 +37,16 @@ public:
 
     void SetNode (Ptr<Node> node);
 
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams (int64_t stream);
+
     void AddBroadCastAddress (Ipv4Address addr);
 
     void Init (void);
@@ -87,6 +98,8 @@ private:
 
     Ptr<Node> m_node;
 
+    CounterRng m_rng; // Used to pick the paths probed at random
+
 };
 
 }
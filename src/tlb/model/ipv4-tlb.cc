@@ -387,7 +387,7 @@ Ipv4TLB::GetPath (uint32_t flowId, Ipv4Address saddr, Ipv4Address daddr)
                 /*&& ((static_cast<double> ((flowItr->second).ecnSize) / (flowItr->second).size > m_ecnPortionHigh && Simulator::Now () - (flowItr->second).timeStamp >= m_T) || (flowItr->second).retransmissionSize > m_flowRetransHigh)*/
                 && Simulator::Now() - (flowItr->second).tryChangePath > MicroSeconds (100))
         {
-            if (rand () % RANDOM_BASE < static_cast<int> (RANDOM_BASE - m_pathChangePoss))
+            if (static_cast<int> (m_rng.GetInteger (RANDOM_BASE)) < static_cast<int> (RANDOM_BASE - m_pathChangePoss))
             {
                 (flowItr->second).tryChangePath = Simulator::Now ();
                 return oldPath;
@@ -585,6 +585,14 @@ Ipv4TLB::SetNode (Ptr<Node> node)
     m_node = node;
 }
 
+int64_t
+Ipv4TLB::AssignStreams (int64_t stream)
+{
+    NS_LOG_FUNCTION (this << stream);
+    m_rng.SetStream (stream);
+    return 1;
+}
+
 void
 Ipv4TLB::PacketReceive (uint32_t flowId, uint32_t path, uint32_t destTorId,
                         uint32_t size, bool withECN, Time rtt, bool isProbing)
@@ -663,18 +671,14 @@ Ipv4TLB::UpdateFlowInfo (uint32_t flowId, uint32_t path, uint32_t size, bool wit
 void
 Ipv4TLB::UpdatePathInfo (uint32_t destTor, uint32_t path, uint32_t size, bool withECN, Time rtt)
 {
+    // A single lookup, the path info is updated in place
     std::pair<uint32_t, uint32_t> key = std::make_pair(destTor, path);
-    std::map<std::pair<uint32_t, uint32_t>, TLBPathInfo>::iterator itr = m_pathInfo.find (key);
-
-    TLBPathInfo pathInfo;
-    if (itr == m_pathInfo.end ())
+    std::map<std::pair<uint32_t, uint32_t>, TLBPathInfo>::iterator itr = m_pathInfo.lower_bound (key);
+    if (itr == m_pathInfo.end () || itr->first != key)
     {
-        pathInfo = Ipv4TLB::GetInitPathInfo (path);
-    }
-    else
-    {
-        pathInfo = itr->second;
+        itr = m_pathInfo.insert (itr, std::make_pair (key, Ipv4TLB::GetInitPathInfo (path)));
     }
+    TLBPathInfo &pathInfo = itr->second;
 
     pathInfo.size += size;
     if (withECN)
@@ -712,8 +716,6 @@ Ipv4TLB::UpdatePathInfo (uint32_t destTor, uint32_t path, uint32_t size, bool wi
     }
     */
     // --
-
-    m_pathInfo[key] = pathInfo;
 }
 
 bool
@@ -1048,20 +1050,20 @@ Ipv4TLB::WhereToChange (uint32_t destTor, PathInfo &newPath, bool hasOldPath, ui
         {
             if (minCounter <= m_K)
             {
-                newPath = candidatePaths[rand () % candidatePaths.size ()];
+                newPath = candidatePaths[m_rng.GetInteger (candidatePaths.size ())];
             }
         }
         else if (m_runMode == TLB_RUNMODE_MINRTT)
         {
-            newPath = candidatePaths[rand () % candidatePaths.size ()];
+            newPath = candidatePaths[m_rng.GetInteger (candidatePaths.size ())];
         }
         else if (m_runMode == TLB_RUNMODE_RTT_COUNTER || m_runMode == TLB_RUNMODE_RTT_DRE)
         {
-            newPath = candidatePaths[rand () % candidatePaths.size ()];
+            newPath = candidatePaths[m_rng.GetInteger (candidatePaths.size ())];
         }
         else
         {
-            newPath = candidatePaths[rand () % candidatePaths.size ()];
+            newPath = candidatePaths[m_rng.GetInteger (candidatePaths.size ())];
         }
         NS_LOG_LOGIC ("Find Good Path: " << newPath.pathId);
         return true;
@@ -1169,21 +1171,21 @@ Ipv4TLB::WhereToChange (uint32_t destTor, PathInfo &newPath, bool hasOldPath, ui
         {
             if (minCounter <= m_K)
             {
-                newPath = candidatePaths[rand () % candidatePaths.size ()];
+                newPath = candidatePaths[m_rng.GetInteger (candidatePaths.size ())];
             }
         }
         else if (m_runMode == TLB_RUNMODE_MINRTT)
         {
-            newPath = candidatePaths[rand () % candidatePaths.size ()];
+            newPath = candidatePaths[m_rng.GetInteger (candidatePaths.size ())];
         }
         else if (m_runMode == TLB_RUNMODE_RTT_COUNTER || m_runMode == TLB_RUNMODE_RTT_DRE)
         {
-            newPath = candidatePaths[rand () % candidatePaths.size ()];
+            newPath = candidatePaths[m_rng.GetInteger (candidatePaths.size ())];
         }
 
         else
         {
-            newPath = candidatePaths[rand () % candidatePaths.size ()];
+            newPath = candidatePaths[m_rng.GetInteger (candidatePaths.size ())];
         }
         NS_LOG_LOGIC ("Find Grey Path: " << newPath.pathId);
         return true;
@@ -1237,11 +1239,11 @@ Ipv4TLB::SelectRandomPath (uint32_t destTor)
     struct PathInfo newPath;
     if (!availablePaths.empty ())
     {
-        newPath = availablePaths[rand() % availablePaths.size ()];
+        newPath = availablePaths[m_rng.GetInteger (availablePaths.size ())];
     }
     else
     {
-        uint32_t pathId = (itr->second)[rand() % (itr->second).size ()];
+        uint32_t pathId = (itr->second)[m_rng.GetInteger ((itr->second).size ())];
         newPath = Ipv4TLB::JudgePath (destTor, pathId);
     }
     NS_LOG_LOGIC ("Random selection return path: " << newPath.pathId);
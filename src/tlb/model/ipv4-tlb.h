@@ -8,6 +8,7 @@
 #include "ns3/ipv4-address.h"
 #include "ns3/data-rate.h"
 #include "ns3/event-id.h"
+#include "ns3/counter-rng.h"
 #include "tlb-flow-info.h"
 #include "tlb-path-info.h"
 
@@ -90,6 +91,16 @@ public:
     // Node
     void SetNode (Ptr<Node> node);
 
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams (int64_t stream);
+
     static std::string GetPathType (PathType type);
 
     static std::string GetLogo (void);
@@ -233,6 +244,8 @@ private:
 
     Ptr<Node> m_node;
 
+    CounterRng m_rng; // Used in the random path selection and path changes
+
     std::map<uint32_t, Time> m_pauseTime; // Used in the TCP pause, not mandatory
 
     typedef void (* TLBPathCallback) (uint32_t flowId, uint32_t fromTor,
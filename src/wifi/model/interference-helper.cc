@@ -128,6 +128,12 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
   return (m_time < o.m_time);
 }
 
+InterferenceHelper::NiDelta::NiDelta (double deltaW, Ptr<InterferenceHelper::Event> event)
+  : m_deltaW (deltaW),
+    m_event (event)
+{
+}
+
 
 /****************************************************************
  *       The actual InterferenceHelper
@@ -138,6 +144,9 @@ InterferenceHelper::InterferenceHelper ()
     m_firstPower (0.0),
     m_rxing (false)
 {
+  ResetCursor (m_now);
+  ResetCursor (m_busy);
+  m_busyEnergyW = -1;
 }
 
 InterferenceHelper::~InterferenceHelper ()
@@ -191,22 +200,21 @@ Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
-  Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  AdvanceCursor (m_now, now);
+  /* Adding events only raises the power, so the energy cannot fall
+   * below the threshold before the time found last, and the search
+   * resumes from there.
+   */
+  if (energyW != m_busyEnergyW || m_busy.m_time < now)
     {
-      noiseInterferenceW += i->GetDelta ();
-      end = i->GetTime ();
-      if (end < now)
-        {
-          continue;
-        }
-      if (noiseInterferenceW < energyW)
-        {
-          break;
-        }
+      m_busy = m_now;
+      m_busyEnergyW = energyW;
+    }
+  while (m_busy.m_powerW >= energyW && m_busy.m_next != m_niChanges.end ())
+    {
+      AdvanceCursor (m_busy, m_busy.m_next->first);
     }
+  Time end = m_busy.m_time;
   return end > now ? end - now : MicroSeconds (0);
 }
 
@@ -214,22 +222,69 @@ void
 InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
 {
   Time now = Simulator::Now ();
-  if (!m_rxing)
+  // While receiving, the changes since the start of the reception are
+  // needed to compute its SNIR
+  EraseBefore (m_rxing ? m_rxStart : now);
+  AddNiChangeEvent (event->GetStartTime (), NiDelta (event->GetRxPowerW (), event));
+  AddNiChangeEvent (event->GetEndTime (), NiDelta (-event->GetRxPowerW (), event));
+}
+
+void
+InterferenceHelper::AddNiChangeEvent (Time time, NiDelta delta)
+{
+  NiDeltas::iterator it = m_niChanges.insert (m_niChanges.upper_bound (time), std::make_pair (time, delta));
+  UpdateCursor (m_now, it);
+  UpdateCursor (m_busy, it);
+}
+
+void
+InterferenceHelper::ResetCursor (Cursor &cursor)
+{
+  cursor.m_next = m_niChanges.begin ();
+  cursor.m_time = Time (0);
+  cursor.m_powerW = m_firstPower;
+}
+
+void
+InterferenceHelper::AdvanceCursor (Cursor &cursor, Time moment)
+{
+  NS_ASSERT (moment >= cursor.m_time);
+  while (cursor.m_next != m_niChanges.end () && cursor.m_next->first <= moment)
     {
-      NiChanges::iterator nowIterator = GetPosition (now);
-      for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
-        {
-          m_firstPower += i->GetDelta ();
-        }
-      m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      cursor.m_powerW += cursor.m_next->second.m_deltaW;
+      cursor.m_next++;
     }
-  else
+  cursor.m_time = moment;
+}
+
+void
+InterferenceHelper::UpdateCursor (Cursor &cursor, NiDeltas::iterator it)
+{
+  if (it->first <= cursor.m_time)
+    {
+      cursor.m_powerW += it->second.m_deltaW;
+    }
+  else if (cursor.m_next == m_niChanges.end () || it->first < cursor.m_next->first)
     {
-      AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      cursor.m_next = it;
     }
-  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
+}
 
+void
+InterferenceHelper::EraseBefore (Time moment)
+{
+  // the cursors are then after the NiDeltas erased
+  AdvanceCursor (m_now, Simulator::Now ());
+  if (m_busy.m_time < m_now.m_time)
+    {
+      m_busy = m_now;
+    }
+  NiDeltas::iterator end = m_niChanges.lower_bound (moment);
+  for (NiDeltas::iterator i = m_niChanges.begin (); i != end; i++)
+    {
+      m_firstPower += i->second.m_deltaW;
+    }
+  m_niChanges.erase (m_niChanges.begin (), end);
 }
 
 
@@ -253,15 +308,20 @@ InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event>
 {
   double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  // the changes before the start of the reception were folded into
+  // m_firstPower, so only those at the same time are left before it
+  NiDeltas::const_iterator i = m_niChanges.begin ();
+  while (i != m_niChanges.end () && i->second.m_event != event)
     {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
-        {
-          break;
-        }
-      ni->push_back (*i);
+      noiseInterference += i->second.m_deltaW;
+      i++;
+    }
+  NS_ASSERT_MSG (i != m_niChanges.end (), "the event being received is unknown");
+  ni->push_back (NiChange (event->GetStartTime (), noiseInterference));
+  for (i++; i != m_niChanges.end () && i->second.m_event != event; i++)
+    {
+      ni->push_back (NiChange (i->first, i->second.m_deltaW));
     }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
   ni->push_back (NiChange (event->GetEndTime (), 0));
   return noiseInterference;
 }
@@ -831,18 +891,9 @@ InterferenceHelper::EraseEvents (void)
   m_niChanges.clear ();
   m_rxing = false;
   m_firstPower = 0.0;
-}
-
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::GetPosition (Time moment)
-{
-  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
-}
-
-void
-InterferenceHelper::AddNiChangeEvent (NiChange change)
-{
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  ResetCursor (m_now);
+  ResetCursor (m_busy);
+  m_busyEnergyW = -1;
 }
 
 void
@@ -850,6 +901,7 @@ InterferenceHelper::NotifyRxStart ()
 {
   NS_LOG_FUNCTION (this);
   m_rxing = true;
+  m_rxStart = Simulator::Now ();
 }
 
 void
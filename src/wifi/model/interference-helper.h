@@ -23,7 +23,7 @@
 
 #include <stdint.h>
 #include <vector>
-#include <list>
+#include <map>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -165,6 +165,11 @@ private:
    * \returns the expected amount of time the observed
    *          energy on the medium will be higher than
    *          the requested threshold.
+   *
+   * The duration is zero if the energy is already below the threshold,
+   * even if weaker signals are still on the air.  The power changes at
+   * the same time, such as a signal starting when another one ends, are
+   * summed before the energy is compared with the threshold.
    */
   Time GetEnergyDuration (double energyW);
 
@@ -259,10 +264,36 @@ private:
    * typedef for a vector of NiChanges
    */
   typedef std::vector <NiChange> NiChanges;
+
   /**
-   * typedef for a list of Events
+   * The change of the noise and interference power at the start or
+   * the end of an event.
    */
-  typedef std::list<Ptr<Event> > Events;
+  struct NiDelta
+  {
+    /**
+     * \param deltaW the power change (W)
+     * \param event the event which starts or ends
+     */
+    NiDelta (double deltaW, Ptr<Event> event);
+
+    double m_deltaW;      //!< The power change (W)
+    Ptr<Event> m_event;   //!< The event which starts or ends
+  };
+  /**
+   * typedef for the time-ordered NiDeltas of the events
+   */
+  typedef std::multimap<Time, NiDelta> NiDeltas;
+
+  /**
+   * A position in the NiDeltas with the power summed up to it.
+   */
+  struct Cursor
+  {
+    NiDeltas::iterator m_next;  //!< The first NiDelta after m_time
+    Time m_time;                //!< The time up to which m_powerW is summed
+    double m_powerW;            //!< The power (W) at m_time
+  };
 
   /**
    * Append the given Event.
@@ -326,17 +357,47 @@ private:
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
   /// Experimental: needed for energy duration calculation
-  NiChanges m_niChanges;
-  double m_firstPower;
+  NiDeltas m_niChanges;
+  double m_firstPower;          //!< The power before the first NiDelta
   bool m_rxing;
-  /// Returns an iterator to the first nichange, which is later than moment
-  NiChanges::iterator GetPosition (Time moment);
+  Time m_rxStart;               //!< The start of the event being received
+  Cursor m_now;                 //!< The power at the last time looked at
+  Cursor m_busy;                //!< Where the last GetEnergyDuration stopped
+  double m_busyEnergyW;         //!< The energy threshold of m_busy
+  /**
+   * Add a NiDelta, after those at the same time.
+   *
+   * \param time the time of the change
+   * \param delta the change
+   */
+  void AddNiChangeEvent (Time time, NiDelta delta);
+  /**
+   * Reset a cursor to the start of the NiDeltas.
+   *
+   * \param cursor the cursor
+   */
+  void ResetCursor (Cursor &cursor);
+  /**
+   * Move a cursor to the given moment, summing the NiDeltas up to it.
+   *
+   * \param cursor the cursor
+   * \param moment a moment no earlier than the current cursor time
+   */
+  void AdvanceCursor (Cursor &cursor, Time moment);
+  /**
+   * Account for a NiDelta just added in a cursor.
+   *
+   * \param cursor the cursor
+   * \param it the NiDelta
+   */
+  void UpdateCursor (Cursor &cursor, NiDeltas::iterator it);
   /**
-   * Add NiChange to the list at the appropriate position.
+   * Fold the NiDeltas before the given moment into m_firstPower.
+   * Nothing before the moment can be asked for any more.
    *
-   * \param change
+   * \param moment a moment no later than the current time
    */
-  void AddNiChangeEvent (NiChange change);
+  void EraseBefore (Time moment);
 };
 
 } //namespace ns3
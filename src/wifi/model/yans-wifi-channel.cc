@@ -25,10 +25,16 @@
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/object-factory.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "yans-wifi-channel.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -45,17 +51,41 @@ YansWifiChannel::GetTypeId (void)
     .AddConstructor<YansWifiChannel> ()
     .AddAttribute ("PropagationLossModel", "A pointer to the propagation loss model attached to this channel.",
                    PointerValue (),
-                   MakePointerAccessor (&YansWifiChannel::m_loss),
+                   MakePointerAccessor (&YansWifiChannel::SetPropagationLossModel,
+                                        &YansWifiChannel::GetPropagationLossModel),
                    MakePointerChecker<PropagationLossModel> ())
     .AddAttribute ("PropagationDelayModel", "A pointer to the propagation delay model attached to this channel.",
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("RxPowerCutoff",
+                   "Received power (dBm) below which a transmission is not scheduled for reception. "
+                   "Such a transmission is not added to the interference of the receiver either.",
+                   DoubleValue (-std::numeric_limits<double>::max ()),
+                   MakeDoubleAccessor (&YansWifiChannel::SetRxPowerCutoff,
+                                       &YansWifiChannel::GetRxPowerCutoff),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SpatialIndex",
+                   "Whether to only visit the PHYs within range of the sender, found from a grid "
+                   "of their positions.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_spatialIndex),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxRange",
+                   "The range (m) of the senders when SpatialIndex is set. If zero, the range is the "
+                   "distance at which the propagation loss brings the tx power down to RxPowerCutoff.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_rxPowerCutoff (-std::numeric_limits<double>::max ()),
+    m_cellSize (0.0),
+    m_gridDirty (true),
+    m_gridMaxSpeed (0.0)
 {
 }
 
@@ -65,10 +95,49 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  //The callbacks were made from a const this, which they must match to
+  //be disconnected
+  const YansWifiChannel *self = this;
+  for (std::vector<Ptr<MobilityModel> >::const_iterator i = m_tracked.begin (); i != m_tracked.end (); i++)
+    {
+      (*i)->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&YansWifiChannel::CourseChanged, self));
+    }
+  m_tracked.clear ();
+  m_trackedPhys.clear ();
+  m_grid.clear ();
+  m_cells.clear ();
+  m_gridDirty = true;
+  WifiChannel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
   m_loss = loss;
+  m_ranges.clear ();
+}
+
+Ptr<PropagationLossModel>
+YansWifiChannel::GetPropagationLossModel (void) const
+{
+  return m_loss;
+}
+
+void
+YansWifiChannel::SetRxPowerCutoff (double cutoff)
+{
+  m_rxPowerCutoff = cutoff;
+  m_ranges.clear ();
+}
+
+double
+YansWifiChannel::GetRxPowerCutoff (void) const
+{
+  return m_rxPowerCutoff;
 }
 
 void
@@ -83,20 +152,38 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  double range = GetRange (txPowerDbm);
+  bool indexed = (range < std::numeric_limits<double>::infinity ());
+  std::vector<uint32_t> receivers;
+  if (indexed)
     {
-      if (sender != (*i))
+      FindReceivers (senderMobility, range, receivers);
+    }
+  uint32_t n = indexed ? receivers.size () : m_phyList.size ();
+  for (uint32_t k = 0; k < n; k++)
+    {
+      uint32_t j = indexed ? receivers[k] : k;
+      Ptr<YansWifiPhy> phy = m_phyList[j];
+      if (sender != phy)
         {
           //For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          if (phy->GetChannelNumber () != sender->GetChannelNumber ())
             {
               continue;
             }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+          Ptr<MobilityModel> receiverMobility = phy->GetMobility ()->GetObject<MobilityModel> ();
+          if (indexed && senderMobility->GetDistanceFrom (receiverMobility) > range)
+            {
+              continue;
+            }
           double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+          if (rxPowerDbm < m_rxPowerCutoff)
+            {
+              NS_LOG_DEBUG ("propagation: rxPower=" << rxPowerDbm << "dbm below the cutoff");
+              continue;
+            }
+          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
           Ptr<Packet> copy = packet->Copy ();
@@ -125,6 +212,164 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
     }
 }
 
+double
+YansWifiChannel::GetRange (double txPowerDbm) const
+{
+  if (!m_spatialIndex)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  if (m_maxRange > 0)
+    {
+      return m_maxRange;
+    }
+  if (m_rxPowerCutoff <= -std::numeric_limits<double>::max ())
+    {
+      NS_LOG_WARN ("SpatialIndex needs MaxRange or RxPowerCutoff to be set; all PHYs are visited");
+      return std::numeric_limits<double>::infinity ();
+    }
+  std::map<double, double>::const_iterator it = m_ranges.find (txPowerDbm);
+  if (it != m_ranges.end ())
+    {
+      return it->second;
+    }
+
+  //Double the distance until the received power is below the cutoff,
+  //then bisect.
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0.0, 0.0, 0.0));
+  double inRange = 0.0;
+  double outOfRange = 1.0;
+  double range = std::numeric_limits<double>::infinity ();
+  while (outOfRange < 1e9)
+    {
+      b->SetPosition (Vector (outOfRange, 0.0, 0.0));
+      if (m_loss->CalcRxPower (txPowerDbm, a, b) < m_rxPowerCutoff)
+        {
+          break;
+        }
+      inRange = outOfRange;
+      outOfRange *= 2;
+    }
+  if (outOfRange < 1e9)
+    {
+      while (outOfRange - inRange > 1e-3 * outOfRange)
+        {
+          double middle = (inRange + outOfRange) / 2;
+          b->SetPosition (Vector (middle, 0.0, 0.0));
+          if (m_loss->CalcRxPower (txPowerDbm, a, b) < m_rxPowerCutoff)
+            {
+              outOfRange = middle;
+            }
+          else
+            {
+              inRange = middle;
+            }
+        }
+      range = outOfRange;
+    }
+  NS_LOG_DEBUG ("range for txPower=" << txPowerDbm << "dbm: " << range << "m");
+  m_ranges[txPowerDbm] = range;
+  return range;
+}
+
+void
+YansWifiChannel::BuildGrid (double cellSize) const
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  m_grid.clear ();
+  m_cells.resize (m_phyList.size ());
+  m_cellSize = cellSize;
+  m_gridTime = Simulator::Now ();
+  m_gridMaxSpeed = 0.0;
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+      if (i >= m_tracked.size ())
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&YansWifiChannel::CourseChanged, this));
+          m_tracked.push_back (mobility);
+          m_trackedPhys[PeekPointer (mobility)].push_back (i);
+        }
+      m_cells[i] = GetCell (mobility->GetPosition ());
+      m_grid[m_cells[i]].push_back (i);
+      Vector velocity = mobility->GetVelocity ();
+      double speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+      m_gridMaxSpeed = std::max (m_gridMaxSpeed, speed);
+    }
+  m_gridDirty = false;
+}
+
+YansWifiChannel::Cell
+YansWifiChannel::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+void
+YansWifiChannel::FindReceivers (Ptr<MobilityModel> sender, double range, std::vector<uint32_t> &receivers) const
+{
+  double margin = m_gridMaxSpeed * (Simulator::Now () - m_gridTime).GetSeconds ();
+  if (m_gridDirty || margin > m_cellSize / 2 || range > 2 * m_cellSize)
+    {
+      BuildGrid (range);
+      margin = 0.0;
+    }
+  double radius = range + margin;
+  Vector position = sender->GetPosition ();
+  Cell min = GetCell (Vector (position.x - radius, position.y - radius, 0.0));
+  Cell max = GetCell (Vector (position.x + radius, position.y + radius, 0.0));
+  for (int64_t x = min.first; x <= max.first; x++)
+    {
+      for (int64_t y = min.second; y <= max.second; y++)
+        {
+          Grid::const_iterator cell = m_grid.find (std::make_pair (x, y));
+          if (cell != m_grid.end ())
+            {
+              receivers.insert (receivers.end (), cell->second.begin (), cell->second.end ());
+            }
+        }
+    }
+  //Keep the order of the PHY list, which is the order the receptions
+  //are scheduled in without the grid.
+  std::sort (receivers.begin (), receivers.end ());
+}
+
+void
+YansWifiChannel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  if (m_gridDirty)
+    {
+      return;
+    }
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator phys = m_trackedPhys.find (PeekPointer (mobility));
+  NS_ASSERT (phys != m_trackedPhys.end ());
+  Cell cell = GetCell (mobility->GetPosition ());
+  //The PHY is placed at its current position, so the distance it may
+  //have moved since the grid was built is still bounded by the highest
+  //speed times the age of the grid.
+  Vector velocity = mobility->GetVelocity ();
+  double speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+  m_gridMaxSpeed = std::max (m_gridMaxSpeed, speed);
+  for (std::vector<uint32_t>::const_iterator i = phys->second.begin (); i != phys->second.end (); i++)
+    {
+      if (m_cells[*i] == cell)
+        {
+          continue;
+        }
+      Grid::iterator old = m_grid.find (m_cells[*i]);
+      old->second.erase (std::find (old->second.begin (), old->second.end (), *i));
+      if (old->second.empty ())
+        {
+          m_grid.erase (old);
+        }
+      m_grid[cell].push_back (*i);
+      m_cells[*i] = cell;
+    }
+}
+
 void
 YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const
 {
@@ -147,6 +392,7 @@ void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   m_phyList.push_back (phy);
+  m_gridDirty = true;
 }
 
 int64_t
@@ -22,6 +22,7 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
 #include <stdint.h>
 #include "ns3/packet.h"
 #include "wifi-channel.h"
@@ -30,10 +31,12 @@
 #include "wifi-tx-vector.h"
 #include "yans-wifi-phy.h"
 #include "ns3/nstime.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
 class NetDevice;
+class MobilityModel;
 class PropagationLossModel;
 class PropagationDelayModel;
 
@@ -57,6 +60,29 @@ struct Parameters
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * By default, every transmission is scheduled for reception on every PHY of
+ * the channel, whatever its received power.  In dense deployments, the
+ * RxPowerCutoff attribute drops the receptions below a received power,
+ * which are then not added to the interference of the receiver either: it
+ * should be set well below the energy detection threshold of the PHYs.
+ * With the SpatialIndex attribute, the PHYs are also put in a grid of
+ * their positions, so that only the PHYs in range of the sender are
+ * visited.  The range is MaxRange if set, else the distance at which the
+ * propagation loss model brings the transmit power down to RxPowerCutoff.
+ * This distance is only meaningful for deterministic loss models which
+ * grow with the distance, such as LogDistancePropagationLossModel: with
+ * random or obstacle-dependent losses, MaxRange should be set instead.
+ *
+ * The grid is built when a PHY is added, and a PHY is moved to its new
+ * cell when its mobility model notifies a course change.  In between, the
+ * positions in the grid are extended by the distance the PHYs may have
+ * moved at the highest speed seen since the grid was built, and the grid
+ * is built again once this distance reaches half a cell.
+ *
+ * The derived ranges are computed once per tx power, and computed again
+ * when the loss model or RxPowerCutoff is set.  If the loss model is
+ * reconfigured instead, SetPropagationLossModel must be called again.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -114,6 +140,8 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+protected:
+  virtual void DoDispose (void);
 
 private:
   /**
@@ -134,9 +162,76 @@ private:
    */
   void Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const;
 
+  /**
+   * A cell of the grid, given by its x and y indices.
+   */
+  typedef std::pair<int64_t, int64_t> Cell;
+  /**
+   * A grid of the PHYs, giving the PHY indices in each cell.
+   */
+  typedef std::map<Cell, std::vector<uint32_t> > Grid;
+
+  /**
+   * \param cutoff the received power below which receptions are dropped, in dBm
+   */
+  void SetRxPowerCutoff (double cutoff);
+  /**
+   * \return the received power below which receptions are dropped, in dBm
+   */
+  double GetRxPowerCutoff (void) const;
+  /**
+   * \return the propagation loss model
+   */
+  Ptr<PropagationLossModel> GetPropagationLossModel (void) const;
+
+  /**
+   * \param txPowerDbm the tx power
+   * \return the distance beyond which the PHYs are not visited, or
+   * infinity if all PHYs are
+   */
+  double GetRange (double txPowerDbm) const;
+  /**
+   * Put the PHYs in the grid.
+   *
+   * \param cellSize the size of the cells, in meters
+   */
+  void BuildGrid (double cellSize) const;
+  /**
+   * \param position a position
+   * \return the cell of the grid containing the position
+   */
+  Cell GetCell (const Vector &position) const;
+  /**
+   * Find the PHYs which may be in range of a sender.
+   *
+   * \param sender the mobility model of the sender
+   * \param range the range of the sender
+   * \param receivers the PHY indices found, in increasing order
+   */
+  void FindReceivers (Ptr<MobilityModel> sender, double range, std::vector<uint32_t> &receivers) const;
+  /**
+   * Move the PHYs of a mobility model to their new cell.
+   *
+   * \param mobility the mobility model of the PHY
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_rxPowerCutoff;              //!< Received power below which receptions are dropped, in dBm
+  bool m_spatialIndex;                 //!< Whether only the PHYs in range are visited
+  double m_maxRange;                   //!< Range of the senders, or 0 to derive it from the loss
+
+  mutable std::map<double, double> m_ranges;  //!< Derived range for each tx power
+  mutable Grid m_grid;                 //!< The PHYs by cell
+  mutable double m_cellSize;           //!< Size of the cells of the grid, in meters
+  mutable bool m_gridDirty;            //!< Whether the grid must be built again
+  mutable Time m_gridTime;             //!< When the grid was built
+  mutable double m_gridMaxSpeed;       //!< Highest PHY speed since the grid was built
+  mutable std::vector<Ptr<MobilityModel> > m_tracked;  //!< Mobility models whose course changes are traced
+  mutable std::map<const MobilityModel *, std::vector<uint32_t> > m_trackedPhys;  //!< PHY indices of each traced mobility model
+  mutable std::vector<Cell> m_cells;   //!< Cell of each PHY in the grid
 };
 
 } //namespace ns3
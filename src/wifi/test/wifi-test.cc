@@ -29,6 +29,8 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
 #include "ns3/test.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
@@ -39,6 +41,8 @@
 #include "ns3/packet-socket-server.h"
 #include "ns3/packet-socket-client.h"
 #include "ns3/packet-socket-helper.h"
+#include "ns3/interference-helper.h"
+#include <limits>
 
 using namespace ns3;
 
@@ -618,6 +622,309 @@ Bug730TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (result, true, "packet reception unexpectedly stopped after adapting fragmentation threshold!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the RxPowerCutoff and SpatialIndex attributes of
+ * YansWifiChannel only remove the receptions of the PHYs out of range,
+ * including for PHYs which move into range.
+ *
+ * A sender broadcasts three frames, at 1s, 3s and 19s, to PHYs at 10m,
+ * 100m, 3km and 10km, to a PHY moving from 2km towards the sender at
+ * 100m/s, and to a PHY jumping from 5km to 50m at 10s.  The frames are
+ * received by the PHYs in range whatever the configuration, and not
+ * scheduled at all for the PHYs out of range once the channel has a
+ * cutoff or a range.  The cutoff may be lowered at 15s, which must extend
+ * the derived range for the last frame.
+ */
+class YansWifiChannelRangeTest : public TestCase
+{
+public:
+  YansWifiChannelRangeTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /// The PHYs of the test
+  enum
+  {
+    SENDER, NEAR, MIDDLE, FAR, FARTHEST, MOVING, JUMPING, N_PHYS
+  };
+
+  /**
+   * Run the scenario.
+   * \param cutoff the RxPowerCutoff attribute of the channel, in dBm
+   * \param spatialIndex the SpatialIndex attribute of the channel
+   * \param maxRange the MaxRange attribute of the channel, in m
+   * \param finalCutoff the RxPowerCutoff attribute of the channel from 15s, in dBm
+   */
+  void RunOne (double cutoff, bool spatialIndex, double maxRange, double finalCutoff);
+  void CreateOne (Ptr<MobilityModel> mobility, Ptr<YansWifiChannel> channel, uint32_t index);
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  void Jump (Ptr<MobilityModel> mobility);
+  void SetCutoff (Ptr<YansWifiChannel> channel, double cutoff);
+  void RxBegin (std::string context, Ptr<const Packet> p);
+  void RxDrop (std::string context, Ptr<const Packet> p);
+
+  ObjectFactory m_manager;
+  ObjectFactory m_mac;
+  std::vector<Ptr<WifiNetDevice> > m_devices;
+  uint32_t m_rxBegin[N_PHYS];   ///< receptions started by each PHY
+  uint32_t m_rxCalls[N_PHYS];   ///< receptions scheduled on each PHY
+};
+
+YansWifiChannelRangeTest::YansWifiChannelRangeTest ()
+  : TestCase ("Range of the receptions of YansWifiChannel")
+{
+}
+
+void
+YansWifiChannelRangeTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelRangeTest::Jump (Ptr<MobilityModel> mobility)
+{
+  mobility->SetPosition (Vector (50.0, 0.0, 0.0));
+}
+
+void
+YansWifiChannelRangeTest::SetCutoff (Ptr<YansWifiChannel> channel, double cutoff)
+{
+  channel->SetAttribute ("RxPowerCutoff", DoubleValue (cutoff));
+}
+
+void
+YansWifiChannelRangeTest::RxBegin (std::string context, Ptr<const Packet> p)
+{
+  uint32_t index = atoi (context.c_str ());
+  m_rxBegin[index]++;
+  m_rxCalls[index]++;
+}
+
+void
+YansWifiChannelRangeTest::RxDrop (std::string context, Ptr<const Packet> p)
+{
+  m_rxCalls[atoi (context.c_str ())]++;
+}
+
+void
+YansWifiChannelRangeTest::CreateOne (Ptr<MobilityModel> mobility, Ptr<YansWifiChannel> channel, uint32_t index)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  Ptr<WifiMac> mac = m_mac.Create<WifiMac> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (mobility);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = m_manager.Create<WifiRemoteStationManager> ();
+
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+
+  std::ostringstream context;
+  context << index;
+  phy->TraceConnect ("PhyRxBegin", context.str (), MakeCallback (&YansWifiChannelRangeTest::RxBegin, this));
+  phy->TraceConnect ("PhyRxDrop", context.str (), MakeCallback (&YansWifiChannelRangeTest::RxDrop, this));
+  m_devices.push_back (dev);
+}
+
+void
+YansWifiChannelRangeTest::RunOne (double cutoff, bool spatialIndex, double maxRange, double finalCutoff)
+{
+  m_mac.SetTypeId ("ns3::AdhocWifiMac");
+  m_manager.SetTypeId ("ns3::ConstantRateWifiManager");
+  m_devices.clear ();
+  for (uint32_t i = 0; i < N_PHYS; i++)
+    {
+      m_rxBegin[i] = 0;
+      m_rxCalls[i] = 0;
+    }
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetAttribute ("RxPowerCutoff", DoubleValue (cutoff));
+  channel->SetAttribute ("SpatialIndex", BooleanValue (spatialIndex));
+  channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+
+  double distances[] = { 0.0, 10.0, 100.0, 3000.0, 10000.0 };
+  for (uint32_t i = SENDER; i <= FARTHEST; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (distances[i], 0.0, 0.0));
+      CreateOne (mobility, channel, i);
+    }
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (2000.0, 0.0, 0.0));
+  moving->SetVelocity (Vector (-100.0, 0.0, 0.0));
+  CreateOne (moving, channel, MOVING);
+  Ptr<ConstantPositionMobilityModel> jumping = CreateObject<ConstantPositionMobilityModel> ();
+  jumping->SetPosition (Vector (5000.0, 0.0, 0.0));
+  CreateOne (jumping, channel, JUMPING);
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelRangeTest::SendOnePacket, this, m_devices[SENDER]);
+  Simulator::Schedule (Seconds (3.0), &YansWifiChannelRangeTest::SendOnePacket, this, m_devices[SENDER]);
+  Simulator::Schedule (Seconds (10.0), &YansWifiChannelRangeTest::Jump, this, jumping);
+  Simulator::Schedule (Seconds (15.0), &YansWifiChannelRangeTest::SetCutoff, this, channel, finalCutoff);
+  Simulator::Schedule (Seconds (19.0), &YansWifiChannelRangeTest::SendOnePacket, this, m_devices[SENDER]);
+
+  Simulator::Stop (Seconds (20.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+YansWifiChannelRangeTest::DoRun (void)
+{
+  RunOne (-std::numeric_limits<double>::max (), false, 0.0, -std::numeric_limits<double>::max ());
+  uint32_t rxBegin[N_PHYS];
+  std::copy (m_rxBegin, m_rxBegin + N_PHYS, rxBegin);
+  NS_TEST_ASSERT_MSG_EQ (rxBegin[NEAR], 3, "All frames should be received at 10m");
+  NS_TEST_ASSERT_MSG_EQ (rxBegin[MIDDLE], 3, "All frames should be received at 100m");
+  NS_TEST_ASSERT_MSG_EQ (rxBegin[FAR], 0, "No frame should be received at 3km");
+  NS_TEST_ASSERT_MSG_EQ (rxBegin[MOVING], 1, "Only the last frame should be received by the moving PHY");
+  NS_TEST_ASSERT_MSG_EQ (rxBegin[JUMPING], 1, "Only the last frame should be received by the jumping PHY");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[FARTHEST], 3, "Without cutoff, all frames should reach every PHY");
+
+  //The range of the cutoff with the default log distance loss is 440m
+  RunOne (-110.0, false, 0.0, -110.0);
+  for (uint32_t i = NEAR; i < N_PHYS; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_rxBegin[i], rxBegin[i], "The cutoff changed the receptions of PHY " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[FAR], 0, "No frame should be scheduled at 3km");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[FARTHEST], 0, "No frame should be scheduled at 10km");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[MOVING], 1, "Only the last frame should be scheduled on the moving PHY");
+
+  RunOne (-110.0, true, 0.0, -110.0);
+  for (uint32_t i = NEAR; i < N_PHYS; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_rxBegin[i], rxBegin[i], "The derived range changed the receptions of PHY " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[FAR], 0, "No frame should be scheduled at 3km");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[MOVING], 1, "Only the last frame should be scheduled on the moving PHY");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[JUMPING], 1, "Only the last frame should be scheduled on the jumping PHY");
+
+  RunOne (-std::numeric_limits<double>::max (), true, 500.0, -std::numeric_limits<double>::max ());
+  for (uint32_t i = NEAR; i < N_PHYS; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_rxBegin[i], rxBegin[i], "The maximum range changed the receptions of PHY " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[FARTHEST], 0, "No frame should be scheduled at 10km");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[MOVING], 1, "Only the last frame should be scheduled on the moving PHY");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[JUMPING], 1, "Only the last frame should be scheduled on the jumping PHY");
+
+  //Lowering the cutoff to -200dBm extends the derived range beyond 10km
+  RunOne (-110.0, true, 0.0, -200.0);
+  for (uint32_t i = NEAR; i < N_PHYS; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_rxBegin[i], rxBegin[i], "The new cutoff changed the receptions of PHY " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[FAR], 1, "Only the last frame should be scheduled at 3km");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCalls[FARTHEST], 1, "Only the last frame should be scheduled at 10km");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that InterferenceHelper::GetEnergyDuration gives the time the
+ * power on the medium stays at or above a threshold:
+ *
+ * - zero when the power is already below the threshold, even if a weak
+ *   signal is still on the air;
+ * - the changes at the same time are summed before the power is compared
+ *   with the threshold, so a signal starting when another one ends keeps
+ *   the medium busy.
+ */
+class InterferenceHelperEnergyDurationTest : public TestCase
+{
+public:
+  InterferenceHelperEnergyDurationTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Add a signal starting now.
+   * \param powerW the received power, in W
+   * \param duration the duration of the signal
+   */
+  void AddSignal (double powerW, Time duration);
+  /**
+   * Check the energy duration.
+   * \param energyW the threshold, in W
+   * \param expected the expected duration
+   */
+  void CheckDuration (double energyW, Time expected);
+
+  InterferenceHelper *m_interference; ///< the tested interference helper
+};
+
+InterferenceHelperEnergyDurationTest::InterferenceHelperEnergyDurationTest ()
+  : TestCase ("Energy duration of InterferenceHelper"),
+    m_interference (0)
+{
+}
+
+void
+InterferenceHelperEnergyDurationTest::AddSignal (double powerW, Time duration)
+{
+  m_interference->Add (1000, WifiTxVector (), WIFI_PREAMBLE_LONG, duration, powerW);
+}
+
+void
+InterferenceHelperEnergyDurationTest::CheckDuration (double energyW, Time expected)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference->GetEnergyDuration (energyW), expected,
+                         "Wrong energy duration at " << Simulator::Now ().GetMicroSeconds () << "us");
+}
+
+void
+InterferenceHelperEnergyDurationTest::DoRun (void)
+{
+  // created here rather than with the test case, before the time resolution is set
+  InterferenceHelper interference;
+  m_interference = &interference;
+  double threshold = 1e-10;
+  //A strong signal from 0 to 100us and a weak one from 0 to 300us
+  Simulator::Schedule (MicroSeconds (0), &InterferenceHelperEnergyDurationTest::AddSignal, this,
+                       2e-10, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (0), &InterferenceHelperEnergyDurationTest::AddSignal, this,
+                       0.5e-10, MicroSeconds (300));
+  Simulator::Schedule (MicroSeconds (0), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       threshold, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       threshold, MicroSeconds (50));
+  //Another strong signal from 100 to 200us, starting when the first one ends
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperEnergyDurationTest::AddSignal, this,
+                       2e-10, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       threshold, MicroSeconds (100));
+  //Only the weak signal is left, below the threshold
+  Simulator::Schedule (MicroSeconds (250), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       threshold, MicroSeconds (0));
+  Simulator::Schedule (MicroSeconds (250), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       0.4e-10, MicroSeconds (50));
+  Simulator::Schedule (MicroSeconds (400), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       0.4e-10, MicroSeconds (0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_interference = 0;
+}
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -633,6 +940,8 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
   AddTestCase (new Bug555TestCase, TestCase::QUICK); //Bug 555
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
+  AddTestCase (new YansWifiChannelRangeTest, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperEnergyDurationTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "xpath-compiler.h"
+#include "ns3/ipv4.h"
+#include "ns3/channel.h"
+#include "ns3/node-list.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+#include <deque>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("XPathCompiler");
+
+XPathCompiler::XPathCompiler (uint32_t bitsPerHop)
+  : m_labels (bitsPerHop)
+{
+
+}
+
+Ptr<Node>
+XPathCompiler::GetNeighbor (Ptr<Node> node, uint32_t interface)
+{
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  Ptr<NetDevice> dev = ipv4->GetNetDevice (interface);
+  Ptr<Channel> channel = dev->GetChannel ();
+  if (channel == 0 || channel->GetNDevices () != 2)
+  {
+    return 0;
+  }
+  Ptr<NetDevice> otherDev = channel->GetDevice (channel->GetDevice (0) == dev ? 1 : 0);
+  Ptr<Node> neighbor = otherDev->GetNode ();
+  if (neighbor->GetObject<Ipv4> () == 0)
+  {
+    return 0;
+  }
+  return neighbor;
+}
+
+std::vector<int32_t>
+XPathCompiler::ComputeDistances (Ptr<Node> to) const
+{
+  std::vector<int32_t> distances (NodeList::GetNNodes (), -1);
+  std::deque<Ptr<Node> > queue;
+  distances[to->GetId ()] = 0;
+  queue.push_back (to);
+  while (!queue.empty ())
+  {
+    Ptr<Node> node = queue.front ();
+    queue.pop_front ();
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+    for (uint32_t i = 1; i < ipv4->GetNInterfaces (); i++)
+    {
+      Ptr<Node> neighbor = GetNeighbor (node, i);
+      if (neighbor != 0 && distances[neighbor->GetId ()] < 0)
+      {
+        distances[neighbor->GetId ()] = distances[node->GetId ()] + 1;
+        queue.push_back (neighbor);
+      }
+    }
+  }
+  return distances;
+}
+
+void
+XPathCompiler::Enumerate (Ptr<Node> node, const std::vector<int32_t> &distances,
+                          std::vector<uint32_t> &ports, std::vector<uint32_t> &paths) const
+{
+  if (distances[node->GetId ()] == 0)
+  {
+    uint32_t pathId;
+    bool fits = m_labels.Encode (ports, pathId);
+    NS_ABORT_MSG_UNLESS (fits, "XPath with " << ports.size ()
+                         << " hops does not fit in the path ID, use a different BitsPerHop");
+    paths.push_back (pathId);
+    return;
+  }
+
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  for (uint32_t i = 1; i < ipv4->GetNInterfaces (); i++)
+  {
+    Ptr<Node> neighbor = GetNeighbor (node, i);
+    if (neighbor != 0 && distances[neighbor->GetId ()] == distances[node->GetId ()] - 1)
+    {
+      ports.push_back (i);
+      Enumerate (neighbor, distances, ports, paths);
+      ports.pop_back ();
+    }
+  }
+}
+
+std::vector<uint32_t>
+XPathCompiler::CompilePaths (Ptr<Node> from, Ptr<Node> to) const
+{
+  NS_LOG_FUNCTION (this << from->GetId () << to->GetId ());
+  std::vector<uint32_t> paths;
+  std::vector<int32_t> distances = ComputeDistances (to);
+  if (from != to && distances[from->GetId ()] > 0)
+  {
+    std::vector<uint32_t> ports;
+    Enumerate (from, distances, ports, paths);
+  }
+  NS_LOG_LOGIC ("Compiled " << paths.size () << " paths from node " << from->GetId ()
+                << " to node " << to->GetId ());
+  return paths;
+}
+
+void
+XPathCompiler::Compile (NodeContainer routers)
+{
+  NS_LOG_FUNCTION (this);
+  for (NodeContainer::Iterator to = routers.Begin (); to != routers.End (); ++to)
+  {
+    std::vector<int32_t> distances = ComputeDistances (*to);
+    for (NodeContainer::Iterator from = routers.Begin (); from != routers.End (); ++from)
+    {
+      if (*from == *to || distances[(*from)->GetId ()] <= 0)
+      {
+        continue;
+      }
+      std::vector<uint32_t> &paths = m_paths[std::make_pair ((*from)->GetId (), (*to)->GetId ())];
+      paths.clear ();
+      std::vector<uint32_t> ports;
+      Enumerate (*from, distances, ports, paths);
+    }
+  }
+}
+
+const std::vector<uint32_t> &
+XPathCompiler::GetPaths (Ptr<Node> from, Ptr<Node> to) const
+{
+  static const std::vector<uint32_t> noPaths;
+  PathMap::const_iterator it = m_paths.find (std::make_pair (from->GetId (), to->GetId ()));
+  return it == m_paths.end () ? noPaths : it->second;
+}
+
+std::vector<uint32_t>
+XPathCompiler::Decode (uint32_t pathId) const
+{
+  return m_labels.Decode (pathId);
+}
+
+}
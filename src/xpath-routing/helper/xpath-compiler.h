@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef XPATH_COMPILER_H
+#define XPATH_COMPILER_H
+
+#include "ns3/node-container.h"
+#include "ns3/xpath-label-stack.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup xpath-routing
+ *
+ * \brief Enumerate the shortest paths of a topology and assign them path IDs.
+ *
+ * A path starts at the first router doing XPath forwarding, typically the
+ * leaf of the sender, and ends at the router that delivers the packet with
+ * its regular routing, typically the leaf of the receiver.  Its path ID
+ * stacks the egress interface of every router on the way but the last.
+ * Only links with exactly two devices, such as point to point links,
+ * are followed.
+ *
+ * \code
+ *   XPathCompiler compiler;
+ *   std::vector<uint32_t> paths = compiler.CompilePaths (leaves.Get (0), leaves.Get (1));
+ *   for (uint32_t i = 0; i < paths.size (); i++)
+ *     {
+ *       drbRouting->AddPath (paths[i]);
+ *     }
+ * \endcode
+ */
+class XPathCompiler
+{
+public:
+  /**
+   * \param bitsPerHop the label width, which should match the BitsPerHop
+   * attribute of the Ipv4XPathRouting of the fabric
+   */
+  XPathCompiler (uint32_t bitsPerHop = 0);
+
+  /**
+   * \brief Enumerate the shortest paths between two routers.
+   * \param from the first router of the paths
+   * \param to the last router of the paths
+   * \return the path IDs, ordered by the egress interfaces of the first hops
+   */
+  std::vector<uint32_t> CompilePaths (Ptr<Node> from, Ptr<Node> to) const;
+
+  /**
+   * \brief Compile the paths between every ordered pair of routers.
+   * \param routers the routers, typically the leaves of the fabric
+   */
+  void Compile (NodeContainer routers);
+
+  /**
+   * \param from the first router of the paths
+   * \param to the last router of the paths
+   * \return the path IDs compiled by Compile, empty if there is none
+   */
+  const std::vector<uint32_t> &GetPaths (Ptr<Node> from, Ptr<Node> to) const;
+
+  /**
+   * \param pathId a path ID
+   * \return the egress interfaces it holds, first hop first
+   */
+  std::vector<uint32_t> Decode (uint32_t pathId) const;
+
+private:
+  /**
+   * \brief Hop counts to a router.
+   * \param to the router
+   * \return the hop count of every node to the router, indexed by node ID,
+   * or -1 if the node cannot reach it
+   */
+  std::vector<int32_t> ComputeDistances (Ptr<Node> to) const;
+
+  /**
+   * \brief Depth first enumeration of the paths toward a router.
+   * \param node the current node
+   * \param distances the hop counts to the last router
+   * \param ports the egress interfaces chosen so far
+   * \param paths the compiled path IDs
+   */
+  void Enumerate (Ptr<Node> node, const std::vector<int32_t> &distances,
+                  std::vector<uint32_t> &ports, std::vector<uint32_t> &paths) const;
+
+  /**
+   * \brief Neighbor of a node through one of its interfaces.
+   * \param node the node
+   * \param interface the interface index
+   * \return the node on the other side, or 0 if there is none
+   */
+  static Ptr<Node> GetNeighbor (Ptr<Node> node, uint32_t interface);
+
+  typedef std::map<std::pair<uint32_t, uint32_t>, std::vector<uint32_t> > PathMap;
+
+  XPathLabelStack m_labels; //!< Path ID encoding
+  PathMap m_paths;          //!< Compiled paths by first and last node IDs
+};
+
+}
+
+#endif /* XPATH_COMPILER_H */
@@ -6,6 +6,7 @@
 #include "ns3/channel.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
+#include "ns3/uinteger.h"
 
 namespace ns3 {
 
@@ -14,6 +15,7 @@ NS_LOG_COMPONENT_DEFINE ("Ipv4XPathRouting");
 NS_OBJECT_ENSURE_REGISTERED (Ipv4XPathRouting);
 
 Ipv4XPathRouting::Ipv4XPathRouting ()
+  : m_nextHopsValid (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -29,7 +31,13 @@ Ipv4XPathRouting::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::Ipv4XPathRouting")
       .SetParent<Ipv4RoutingProtocol> ()
       .SetGroupName ("Internet")
-      .AddConstructor<Ipv4XPathRouting> ();
+      .AddConstructor<Ipv4XPathRouting> ()
+      .AddAttribute ("BitsPerHop",
+                     "The label width of the path IDs, 0 for the decimal port + 100 * next port labels",
+                     UintegerValue (0),
+                     MakeUintegerAccessor (&Ipv4XPathRouting::SetBitsPerHop,
+                                           &Ipv4XPathRouting::GetBitsPerHop),
+                     MakeUintegerChecker<uint32_t> (0, 16));
 
   return tid;
 }
@@ -69,7 +77,7 @@ Ipv4XPathRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr
   }
 
   Ipv4XPathTag ipv4XPathTag;
-  bool found = packet->RemovePacketTag (ipv4XPathTag);
+  bool found = packet->PeekPacketTag (ipv4XPathTag);
   if (!found)
   {
     NS_LOG_ERROR (this << " Cannot perform XPath routing without knowing the Path ID");
@@ -82,38 +90,34 @@ Ipv4XPathRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr
   if (pathId == 0)
   {
     NS_LOG_LOGIC (this << " Reaching final hop, XPath will not handle the final hop");
+    packet->RemovePacketTag (ipv4XPathTag);
     ecb (packet, header, Socket::ERROR_NOROUTETOHOST);
     return false;
   }
 
-  uint32_t currentPort = pathId - (pathId / 100) * 100;
-
-  // NS_LOG_LOGIC (this << " Current port is: " << currentPort);
+  if (!m_nextHopsValid)
+  {
+    BuildNextHops ();
+  }
 
-  // std::cout << "Path: " << pathId << ", Current Port: " << currentPort << std::endl;
+  uint32_t currentPort = m_labels.Top (pathId);
 
-  if (currentPort > m_ipv4->GetNInterfaces ())
+  if (currentPort >= m_nextHops.size () || m_nextHops[currentPort] == 0)
   {
     NS_LOG_ERROR (this << " Port number error");
+    packet->RemovePacketTag (ipv4XPathTag);
     ecb (packet, header, Socket::ERROR_NOROUTETOHOST);
     return false;
   }
 
   NS_LOG_LOGIC (this << " Forwarding packet: " << packet << " to port: " << currentPort);
 
-  ipv4XPathTag.SetPathId (pathId / 100);
-  packet->AddPacketTag (ipv4XPathTag);
+  ipv4XPathTag.SetPathId (m_labels.Pop (pathId));
+  packet->ReplacePacketTag (ipv4XPathTag);
 
-  Ptr<NetDevice> dev = m_ipv4->GetNetDevice (currentPort);
-  Ptr<Channel> channel = dev->GetChannel ();
-  uint32_t otherEnd = (channel->GetDevice (0) == dev) ? 1 : 0;
-  Ptr<Node> nextHop = channel->GetDevice (otherEnd)->GetNode ();
-  uint32_t nextIf = channel->GetDevice (otherEnd)->GetIfIndex ();
-  Ipv4Address nextHopAddr = nextHop->GetObject<Ipv4>()->GetAddress (nextIf, 0).GetLocal ();
-  Ptr<Ipv4Route> route = Create<Ipv4Route> ();
-  route->SetOutputDevice (m_ipv4->GetNetDevice (currentPort));
-  route->SetGateway (nextHopAddr);
-  route->SetSource (m_ipv4->GetAddress (currentPort, 0).GetLocal ());
+  // The route is shared by all the packets leaving through the port, the
+  // forwarding path does not keep it past the unicast forward callback
+  Ptr<Ipv4Route> route = m_nextHops[currentPort];
   route->SetDestination (destAddress);
 
   ucb (route, packet, header);
@@ -121,28 +125,76 @@ Ipv4XPathRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr
   return true;
 }
 
+Ptr<Ipv4Route>
+Ipv4XPathRouting::ResolveNextHop (uint32_t interface) const
+{
+  if (interface == 0 || !m_ipv4->IsUp (interface) || m_ipv4->GetNAddresses (interface) == 0)
+  {
+    return 0;
+  }
+
+  Ptr<NetDevice> dev = m_ipv4->GetNetDevice (interface);
+  Ptr<Channel> channel = dev->GetChannel ();
+  if (channel == 0 || channel->GetNDevices () != 2)
+  {
+    return 0;
+  }
+
+  uint32_t otherEnd = (channel->GetDevice (0) == dev) ? 1 : 0;
+  Ptr<NetDevice> otherDev = channel->GetDevice (otherEnd);
+  Ptr<Ipv4> nextHop = otherDev->GetNode ()->GetObject<Ipv4> ();
+  if (nextHop == 0)
+  {
+    return 0;
+  }
+  int32_t nextIf = nextHop->GetInterfaceForDevice (otherDev);
+  if (nextIf < 0 || nextHop->GetNAddresses (nextIf) == 0)
+  {
+    return 0;
+  }
+
+  Ptr<Ipv4Route> route = Create<Ipv4Route> ();
+  route->SetOutputDevice (dev);
+  route->SetGateway (nextHop->GetAddress (nextIf, 0).GetLocal ());
+  route->SetSource (m_ipv4->GetAddress (interface, 0).GetLocal ());
+  return route;
+}
+
 void
-Ipv4XPathRouting::NotifyInterfaceUp (uint32_t interface)
+Ipv4XPathRouting::BuildNextHops (void)
 {
+  NS_LOG_FUNCTION (this);
+  uint32_t nInterfaces = m_ipv4->GetNInterfaces ();
+  m_nextHops.resize (nInterfaces);
+  for (uint32_t i = 0; i < nInterfaces; i++)
+  {
+    m_nextHops[i] = ResolveNextHop (i);
+  }
+  m_nextHopsValid = true;
+}
 
+void
+Ipv4XPathRouting::NotifyInterfaceUp (uint32_t interface)
+{
+  m_nextHopsValid = false;
 }
 
 void
 Ipv4XPathRouting::NotifyInterfaceDown (uint32_t interface)
 {
-
+  m_nextHopsValid = false;
 }
 
 void
 Ipv4XPathRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
-
+  m_nextHopsValid = false;
 }
 
 void
 Ipv4XPathRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
-
+  m_nextHopsValid = false;
 }
 
 void
@@ -156,13 +208,35 @@ Ipv4XPathRouting::SetIpv4 (Ptr<Ipv4> ipv4)
 void
 Ipv4XPathRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
 {
+  std::ostream* os = stream->GetStream ();
+  *os << "Port\tGateway\t\tSource" << std::endl;
+  for (uint32_t i = 1; i < m_ipv4->GetNInterfaces (); i++)
+  {
+    Ptr<Ipv4Route> route = ResolveNextHop (i);
+    if (route != 0)
+    {
+      *os << i << "\t" << route->GetGateway () << "\t" << route->GetSource () << std::endl;
+    }
+  }
+}
+
+void
+Ipv4XPathRouting::SetBitsPerHop (uint32_t bitsPerHop)
+{
+  m_labels.SetBitsPerHop (bitsPerHop);
+}
 
+uint32_t
+Ipv4XPathRouting::GetBitsPerHop (void) const
+{
+  return m_labels.GetBitsPerHop ();
 }
 
 void
 Ipv4XPathRouting::DoDispose (void)
 {
   m_ipv4 = 0;
+  m_nextHops.clear ();
   Ipv4RoutingProtocol::DoDispose ();
 }
 
@@ -3,11 +3,23 @@
 #define IPV4_XPATH_ROUTING_H
 
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/xpath-label-stack.h"
 
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
+/**
+ * \ingroup xpath-routing
+ *
+ * \brief Source routing along the label stack carried by Ipv4XPathTag.
+ *
+ * Every forwarded packet pops the top label of its path ID and leaves
+ * through the interface it names.  The output device, gateway and source
+ * address of every interface are resolved once, the first time a packet
+ * is forwarded after an interface or address change, so forwarding is a
+ * single lookup in a table indexed by the label.
+ */
 class Ipv4XPathRouting : public Ipv4RoutingProtocol
 {
 
@@ -31,12 +43,36 @@ public:
 
   virtual void DoDispose (void);
 
+  /**
+   * \param bitsPerHop the label width of the path IDs, 0 for decimal labels
+   */
+  void SetBitsPerHop (uint32_t bitsPerHop);
+
+  /**
+   * \return the label width of the path IDs, 0 for decimal labels
+   */
+  uint32_t GetBitsPerHop (void) const;
+
 private:
+  /**
+   * \brief Resolve the next hop behind an interface.
+   * \param interface the interface index
+   * \return a route with the output device, gateway and source set, or 0
+   * if the interface is down or not on a point to point link
+   */
+  Ptr<Ipv4Route> ResolveNextHop (uint32_t interface) const;
+
+  /**
+   * \brief Resolve the next hop of every interface.
+   */
+  void BuildNextHops (void);
 
   Ptr<Ipv4> m_ipv4;
+  XPathLabelStack m_labels;                  //!< Path ID encoding
+  std::vector<Ptr<Ipv4Route> > m_nextHops;   //!< Next hop of every interface
+  bool m_nextHopsValid;                      //!< m_nextHops is up to date
 };
 
 }
 
 #endif /* XPATH_ROUTING_H */
-
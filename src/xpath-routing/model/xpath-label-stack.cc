@@ -0,0 +1,70 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "xpath-label-stack.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+const uint32_t XPathLabelStack::DECIMAL_RADIX;
+
+XPathLabelStack::XPathLabelStack (uint32_t bitsPerHop)
+{
+  SetBitsPerHop (bitsPerHop);
+}
+
+void
+XPathLabelStack::SetBitsPerHop (uint32_t bitsPerHop)
+{
+  NS_ASSERT_MSG (bitsPerHop <= 16, "Labels are at most 16 bits wide");
+  m_bitsPerHop = bitsPerHop;
+  m_mask = (1u << bitsPerHop) - 1;
+}
+
+uint32_t
+XPathLabelStack::GetBitsPerHop (void) const
+{
+  return m_bitsPerHop;
+}
+
+uint32_t
+XPathLabelStack::GetMaxPort (void) const
+{
+  return m_bitsPerHop ? m_mask : DECIMAL_RADIX - 1;
+}
+
+bool
+XPathLabelStack::Encode (const std::vector<uint32_t> &ports, uint32_t &pathId) const
+{
+  uint64_t radix = m_bitsPerHop ? (uint64_t) 1 << m_bitsPerHop : DECIMAL_RADIX;
+  uint64_t id = 0;
+  // The first hop ends up in the least significant label
+  for (std::vector<uint32_t>::const_reverse_iterator it = ports.rbegin ();
+       it != ports.rend (); ++it)
+    {
+      if (*it == 0 || *it > GetMaxPort ())
+        {
+          return false;
+        }
+      id = id * radix + *it;
+      if (id > 0xffffffff)
+        {
+          return false;
+        }
+    }
+  pathId = (uint32_t) id;
+  return true;
+}
+
+std::vector<uint32_t>
+XPathLabelStack::Decode (uint32_t pathId) const
+{
+  std::vector<uint32_t> ports;
+  while (pathId != 0)
+    {
+      ports.push_back (Top (pathId));
+      pathId = Pop (pathId);
+    }
+  return ports;
+}
+
+}
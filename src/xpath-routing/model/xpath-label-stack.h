@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef XPATH_LABEL_STACK_H
+#define XPATH_LABEL_STACK_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup xpath-routing
+ *
+ * \brief Packs the egress ports of an XPath into the 32 bit path ID.
+ *
+ * The path ID is a stack of labels, one per hop, with the label of the
+ * first hop in the least significant position.  Every XPath router pops
+ * the top label and forwards the packet through that interface; an empty
+ * stack (a zero path ID) marks the last hop.  Since interface 0 is the
+ * loopback, a zero label never names a real port.
+ *
+ * With a non zero number of bits per hop the labels are bit fields, so
+ * 8 bits give 4 hops of up to 255 ports and 4 bits give 8 hops of up to
+ * 15 ports.  With zero bits per hop the labels are the decimal digit
+ * pairs used by the original scheme (port + 100 * next port), which
+ * allows 99 ports and 4 hops.
+ */
+class XPathLabelStack
+{
+public:
+  /**
+   * \param bitsPerHop the width of a label, 0 for decimal digit pairs
+   */
+  XPathLabelStack (uint32_t bitsPerHop = 0);
+
+  /**
+   * \param bitsPerHop the width of a label, 0 for decimal digit pairs
+   */
+  void SetBitsPerHop (uint32_t bitsPerHop);
+
+  /**
+   * \return the width of a label, 0 for decimal digit pairs
+   */
+  uint32_t GetBitsPerHop (void) const;
+
+  /**
+   * \return the largest port a label can hold
+   */
+  uint32_t GetMaxPort (void) const;
+
+  /**
+   * \brief Pack a list of egress ports, first hop first.
+   * \param ports the egress interface of every hop
+   * \param pathId the resulting path ID
+   * \return false if a port does not fit in a label or the path ID overflows
+   */
+  bool Encode (const std::vector<uint32_t> &ports, uint32_t &pathId) const;
+
+  /**
+   * \param pathId a path ID
+   * \return the egress ports it holds, first hop first
+   */
+  std::vector<uint32_t> Decode (uint32_t pathId) const;
+
+  /**
+   * \param pathId a non zero path ID
+   * \return the egress port of the current hop
+   */
+  uint32_t Top (uint32_t pathId) const
+  {
+    return m_bitsPerHop ? pathId & m_mask : pathId % DECIMAL_RADIX;
+  }
+
+  /**
+   * \param pathId a non zero path ID
+   * \return the path ID the next hop sees
+   */
+  uint32_t Pop (uint32_t pathId) const
+  {
+    return m_bitsPerHop ? pathId >> m_bitsPerHop : pathId / DECIMAL_RADIX;
+  }
+
+private:
+  static const uint32_t DECIMAL_RADIX = 100; //!< Radix of decimal labels
+
+  uint32_t m_bitsPerHop; //!< Label width, 0 for decimal labels
+  uint32_t m_mask;       //!< Mask of the top label
+};
+
+}
+
+#endif /* XPATH_LABEL_STACK_H */
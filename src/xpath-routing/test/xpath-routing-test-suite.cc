@@ -2,6 +2,19 @@
 
 // Include a header file from your module to test.
 #include "ns3/ipv4-xpath-routing.h"
+#include "ns3/ipv4-xpath-routing-helper.h"
+#include "ns3/xpath-compiler.h"
+#include "ns3/xpath-label-stack.h"
+#include "ns3/ipv4-xpath-tag.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-list-routing-helper.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
@@ -46,6 +59,205 @@ XpathRoutingTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * \brief Encode and decode path IDs with decimal and bit packed labels
+ */
+class XPathLabelStackTestCase : public TestCase
+{
+public:
+  XPathLabelStackTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+XPathLabelStackTestCase::XPathLabelStackTestCase ()
+  : TestCase ("XPath label stack encoding")
+{
+}
+
+void
+XPathLabelStackTestCase::DoRun (void)
+{
+  std::vector<uint32_t> ports;
+  ports.push_back (3);
+  ports.push_back (2);
+  uint32_t pathId;
+
+  // Decimal labels keep the original port + 100 * next port layout
+  XPathLabelStack decimal;
+  NS_TEST_ASSERT_MSG_EQ (decimal.Encode (ports, pathId), true, "Path should fit");
+  NS_TEST_EXPECT_MSG_EQ (pathId, 203, "Wrong decimal path ID");
+  NS_TEST_EXPECT_MSG_EQ (decimal.Top (pathId), 3, "Wrong first hop");
+  NS_TEST_EXPECT_MSG_EQ (decimal.Top (decimal.Pop (pathId)), 2, "Wrong second hop");
+  NS_TEST_EXPECT_MSG_EQ (decimal.Pop (decimal.Pop (pathId)), 0, "Stack should be empty");
+
+  XPathLabelStack packed (6);
+  NS_TEST_ASSERT_MSG_EQ (packed.Encode (ports, pathId), true, "Path should fit");
+  NS_TEST_EXPECT_MSG_EQ (pathId, 2 * 64 + 3, "Wrong bit packed path ID");
+  NS_TEST_EXPECT_MSG_EQ (packed.GetMaxPort (), 63, "Wrong largest port");
+
+  // Five hops of 63 ports fit in 6 bit labels, not in decimal ones
+  std::vector<uint32_t> longPorts (5, 63);
+  NS_TEST_ASSERT_MSG_EQ (packed.Encode (longPorts, pathId), true, "Path should fit");
+  std::vector<uint32_t> decoded = packed.Decode (pathId);
+  NS_TEST_EXPECT_MSG_EQ ((decoded == longPorts), true, "Decode should invert Encode");
+  NS_TEST_EXPECT_MSG_EQ (decimal.Encode (longPorts, pathId), false, "Decimal path ID should overflow");
+
+  // Ports past the label width and the loopback are rejected
+  ports.push_back (64);
+  NS_TEST_EXPECT_MSG_EQ (packed.Encode (ports, pathId), false, "Port should not fit");
+  ports.back () = 0;
+  NS_TEST_EXPECT_MSG_EQ (packed.Encode (ports, pathId), false, "Loopback is not a port");
+}
+
+/**
+ * \brief Compile the paths of a two leaf, two spine fabric and forward along them
+ */
+class XPathForwardingTestCase : public TestCase
+{
+public:
+  XPathForwardingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Unicast forward callback of the router under test
+   * \param route the route chosen
+   * \param packet the packet
+   * \param header the IPv4 header
+   */
+  void Forward (Ptr<Ipv4Route> route, Ptr<const Packet> packet, const Ipv4Header &header);
+
+  /**
+   * \brief Error callback of the router under test
+   * \param packet the packet
+   * \param header the IPv4 header
+   * \param sockerr the error
+   */
+  void Error (Ptr<const Packet> packet, const Ipv4Header &header, Socket::SocketErrno sockerr);
+
+  Ptr<Ipv4Route> m_route; //!< Last route chosen
+  bool m_error;           //!< An error was reported
+};
+
+XPathForwardingTestCase::XPathForwardingTestCase ()
+  : TestCase ("XPath path compiler and forwarding"),
+    m_error (false)
+{
+}
+
+void
+XPathForwardingTestCase::Forward (Ptr<Ipv4Route> route, Ptr<const Packet> packet, const Ipv4Header &header)
+{
+  m_route = route;
+}
+
+void
+XPathForwardingTestCase::Error (Ptr<const Packet> packet, const Ipv4Header &header, Socket::SocketErrno sockerr)
+{
+  m_error = true;
+}
+
+void
+XPathForwardingTestCase::DoRun (void)
+{
+  NodeContainer leaves;
+  leaves.Create (2);
+  NodeContainer spines;
+  spines.Create (2);
+
+  Ipv4XPathRoutingHelper xpathRoutingHelper;
+  Ipv4StaticRoutingHelper staticRoutingHelper;
+  Ipv4ListRoutingHelper listRoutingHelper;
+  listRoutingHelper.Add (xpathRoutingHelper, 1);
+  listRoutingHelper.Add (staticRoutingHelper, 0);
+  InternetStackHelper internet;
+  internet.SetRoutingHelper (listRoutingHelper);
+  internet.Install (leaves);
+  internet.Install (spines);
+
+  // Interface 1 + j of each leaf faces spine j, interface 1 + i of each
+  // spine faces leaf i
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.0");
+  std::vector<Ipv4InterfaceContainer> links;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      for (uint32_t j = 0; j < 2; j++)
+        {
+          Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+          NetDeviceContainer devices;
+          Ptr<Node> ends[2] = { leaves.Get (i), spines.Get (j) };
+          for (uint32_t k = 0; k < 2; k++)
+            {
+              Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+              device->SetAddress (Mac48Address::Allocate ());
+              device->SetChannel (channel);
+              ends[k]->AddDevice (device);
+              devices.Add (device);
+            }
+          links.push_back (ipv4.Assign (devices));
+          ipv4.NewNetwork ();
+        }
+    }
+
+  XPathCompiler compiler;
+  std::vector<uint32_t> paths = compiler.CompilePaths (leaves.Get (0), leaves.Get (1));
+  NS_TEST_ASSERT_MSG_EQ (paths.size (), 2, "There should be one path per spine");
+  NS_TEST_EXPECT_MSG_EQ (paths[0], 2 * 100 + 1, "Wrong path through spine 0");
+  NS_TEST_EXPECT_MSG_EQ (paths[1], 2 * 100 + 2, "Wrong path through spine 1");
+
+  compiler.Compile (leaves);
+  NS_TEST_EXPECT_MSG_EQ (compiler.GetPaths (leaves.Get (1), leaves.Get (0)).size (), 2, "Reverse paths should be compiled");
+  NS_TEST_EXPECT_MSG_EQ (compiler.GetPaths (leaves.Get (0), leaves.Get (0)).size (), 0, "No path to self");
+
+  // Leaf 0 forwards along the path through spine 1
+  Ptr<Ipv4> leafIpv4 = leaves.Get (0)->GetObject<Ipv4> ();
+  Ptr<Ipv4XPathRouting> xpathRouting;
+  int16_t priority;
+  xpathRouting = DynamicCast<Ipv4XPathRouting> (DynamicCast<Ipv4ListRouting> (leafIpv4->GetRoutingProtocol ())
+                                                ->GetRoutingProtocol (0, priority));
+  NS_TEST_ASSERT_MSG_NE (xpathRouting, 0, "XPath routing should be installed");
+
+  Ptr<Packet> packet = Create<Packet> (100);
+  Ipv4XPathTag tag;
+  tag.SetPathId (paths[1]);
+  packet->AddPacketTag (tag);
+  Ipv4Header header;
+  header.SetDestination (links[3].GetAddress (0));
+  Ptr<NetDevice> idev = leafIpv4->GetNetDevice (1);
+
+  bool forwarded = xpathRouting->RouteInput (packet, header, idev,
+                                             MakeCallback (&XPathForwardingTestCase::Forward, this),
+                                             Ipv4RoutingProtocol::MulticastForwardCallback (),
+                                             Ipv4RoutingProtocol::LocalDeliverCallback (),
+                                             MakeCallback (&XPathForwardingTestCase::Error, this));
+  NS_TEST_ASSERT_MSG_EQ (forwarded, true, "Packet should be forwarded");
+  NS_TEST_EXPECT_MSG_EQ (m_route->GetOutputDevice (), leafIpv4->GetNetDevice (2), "Wrong output device");
+  NS_TEST_EXPECT_MSG_EQ (m_route->GetGateway (), links[1].GetAddress (1), "Wrong gateway");
+  NS_TEST_EXPECT_MSG_EQ (m_route->GetSource (), links[1].GetAddress (0), "Wrong source");
+  NS_TEST_EXPECT_MSG_EQ (m_route->GetDestination (), links[3].GetAddress (0), "Wrong destination");
+  packet->PeekPacketTag (tag);
+  NS_TEST_EXPECT_MSG_EQ (tag.GetPathId (), 2, "The first label should be popped");
+
+  // The last hop is left to the next routing protocol
+  tag.SetPathId (0);
+  packet->ReplacePacketTag (tag);
+  forwarded = xpathRouting->RouteInput (packet, header, idev,
+                                        MakeCallback (&XPathForwardingTestCase::Forward, this),
+                                        Ipv4RoutingProtocol::MulticastForwardCallback (),
+                                        Ipv4RoutingProtocol::LocalDeliverCallback (),
+                                        MakeCallback (&XPathForwardingTestCase::Error, this));
+  NS_TEST_EXPECT_MSG_EQ (forwarded, false, "Final hop should not be handled");
+  NS_TEST_EXPECT_MSG_EQ (m_error, true, "Final hop should be reported");
+  NS_TEST_EXPECT_MSG_EQ (packet->PeekPacketTag (tag), false, "Tag should be removed at the final hop");
+
+  m_route = 0;
+  Simulator::Destroy ();
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -61,6 +273,8 @@ XpathRoutingTestSuite::XpathRoutingTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new XpathRoutingTestCase1, TestCase::QUICK);
+  AddTestCase (new XPathLabelStackTestCase, TestCase::QUICK);
+  AddTestCase (new XPathForwardingTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,61 @@
+#!/bin/bash
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+
+#
+# Compare the optimized and fastsim build profiles on the large-scale
+# example.  Each profile is configured and built in its own directory,
+# build/optimized and build/fastsim, and large-scale is run with the same
+# seed in both, so that both runs process the same events: the ratio of
+# the wall clock times is the gain in event rate.
+#
+# Usage: utils/bench-fastsim.sh [large-scale arguments]
+#
+# The default arguments run a short simulation of the default 4x4 leaf
+# spine topology.  Extra configure arguments, such as --enable-modules to
+# only build what large-scale needs, can be given in CONFIGURE_ARGS.  The
+# last profile configured stays the active one.
+#
+
+cd `dirname $0`/..
+
+ARGS="$@"
+if [ -z "$ARGS" ]; then
+    ARGS="--randomSeed=1 --load=0.5 --EndTime=0.1 --FlowLaunchEndTime=0.05"
+fi
+
+WAF="./waf"
+if [ -n "$PYTHON" ]; then
+    WAF="$PYTHON ./waf"
+fi
+
+declare -A WALL
+
+for profile in optimized fastsim; do
+    echo "Building the $profile profile in build/$profile"
+    $WAF configure --build-profile=$profile --out=build/$profile \
+        --enable-examples --disable-tests --disable-python $CONFIGURE_ARGS > /dev/null || exit 1
+    $WAF build > /dev/null || exit 1
+
+    echo "Running large-scale $ARGS"
+    start=`date +%s.%N`
+    $WAF --run "large-scale $ARGS" > /dev/null 2>&1 || exit 1
+    end=`date +%s.%N`
+    WALL[$profile]=`echo "$start $end" | awk '{ printf "%.2f", $2 - $1 }'`
+    echo "$profile: ${WALL[$profile]} s"
+done
+
+echo "${WALL[optimized]} ${WALL[fastsim]}" | \
+    awk '{ printf "fastsim event rate gain: %.2fx\n", $1 / $2 }'
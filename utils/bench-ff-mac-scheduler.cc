@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ff-mac-scheduler.h"
+#include "ns3/ff-mac-csched-sap.h"
+#include "ns3/ff-mac-sched-sap.h"
+#include "ns3/lte-fr-no-op-algorithm.h"
+#include <iostream>
+#include <algorithm>
+#include <vector>
+
+using namespace ns3;
+
+/*
+ * Benchmark the DL scheduling of an FF MAC scheduler in a cell with n
+ * UEs, each with a saturated bearer.  The scheduler is driven through its
+ * SAPs as LteEnbMac does: every TTI, the RLC buffers are reported full,
+ * the HARQ processes allocated four TTIs before are acknowledged and the
+ * DL scheduling is triggered; every cqiPeriod TTIs, each UE reports a
+ * random A30 subband CQI.
+ */
+
+static uint64_t g_allocations = 0;
+static uint64_t g_checksum = 0;
+static std::vector<std::vector<DlInfoListElement_s> > g_pendingAcks (4);
+static uint32_t g_tti = 0;
+
+class BenchCschedSapUser : public FfMacCschedSapUser
+{
+public:
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params) {}
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params) {}
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params) {}
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params) {}
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params) {}
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params) {}
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params) {}
+};
+
+class BenchSchedSapUser : public FfMacSchedSapUser
+{
+public:
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    for (uint32_t i = 0; i < params.m_buildDataList.size (); i++)
+      {
+        g_allocations++;
+        g_checksum = g_checksum * 31 + params.m_buildDataList.at (i).m_rnti;
+        g_checksum = g_checksum * 31 + params.m_buildDataList.at (i).m_dci.m_rbBitmap;
+        DlInfoListElement_s ack;
+        ack.m_rnti = params.m_buildDataList.at (i).m_rnti;
+        ack.m_harqProcessId = params.m_buildDataList.at (i).m_dci.m_harqProcess;
+        ack.m_harqStatus.push_back (DlInfoListElement_s::ACK);
+        g_pendingAcks.at (g_tti % 4).push_back (ack);
+      }
+  }
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params) {}
+};
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 100;
+  uint32_t ttis = 1000;
+  uint32_t cqiPeriod = 2;
+  uint32_t bandwidth = 100;
+  std::string scheduler = "ns3::PfFfMacScheduler";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the DL scheduling of an FF MAC scheduler with n saturated UEs");
+  cmd.AddValue ("n", "number of UEs", n);
+  cmd.AddValue ("ttis", "number of TTIs", ttis);
+  cmd.AddValue ("cqiPeriod", "period (TTIs) of the A30 CQI reports", cqiPeriod);
+  cmd.AddValue ("bandwidth", "DL bandwidth (RBs)", bandwidth);
+  cmd.AddValue ("scheduler", "the TypeId of the scheduler", scheduler);
+  cmd.Parse (argc, argv);
+
+  ObjectFactory factory;
+  factory.SetTypeId (scheduler);
+  Ptr<FfMacScheduler> sched = factory.Create<FfMacScheduler> ();
+  Ptr<LteFfrAlgorithm> ffr = CreateObject<LteFrNoOpAlgorithm> ();
+  ffr->SetDlBandwidth (bandwidth);
+  ffr->SetUlBandwidth (bandwidth);
+  sched->SetLteFfrSapProvider (ffr->GetLteFfrSapProvider ());
+  ffr->SetLteFfrSapUser (sched->GetLteFfrSapUser ());
+  BenchCschedSapUser cschedSapUser;
+  BenchSchedSapUser schedSapUser;
+  sched->SetFfMacCschedSapUser (&cschedSapUser);
+  sched->SetFfMacSchedSapUser (&schedSapUser);
+  FfMacCschedSapProvider *csched = sched->GetFfMacCschedSapProvider ();
+  FfMacSchedSapProvider *schedProvider = sched->GetFfMacSchedSapProvider ();
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cell;
+  cell.m_dlBandwidth = bandwidth;
+  cell.m_ulBandwidth = bandwidth;
+  csched->CschedCellConfigReq (cell);
+  int rbgNum = bandwidth / (bandwidth < 11 ? 1 : bandwidth < 27 ? 2 : bandwidth < 64 ? 3 : 4);
+
+  for (uint16_t rnti = 1; rnti <= n; rnti++)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ue;
+      ue.m_rnti = rnti;
+      ue.m_transmissionMode = 0;
+      csched->CschedUeConfigReq (ue);
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lc;
+      lc.m_rnti = rnti;
+      lc.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lcConfig;
+      lcConfig.m_logicalChannelIdentity = 3;
+      lcConfig.m_logicalChannelGroup = 0;
+      lcConfig.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lcConfig.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lcConfig.m_qci = 9;
+      lcConfig.m_eRabMaximulBitrateUl = 0;
+      lcConfig.m_eRabMaximulBitrateDl = 1000000;
+      lcConfig.m_eRabGuaranteedBitrateUl = 0;
+      lcConfig.m_eRabGuaranteedBitrateDl = 1000000;
+      lc.m_logicalChannelConfigList.push_back (lcConfig);
+      csched->CschedLcConfigReq (lc);
+    }
+
+  Ptr<UniformRandomVariable> cqi = CreateObject<UniformRandomVariable> ();
+  SystemWallClockMs time;
+  time.Start ();
+  for (g_tti = 0; g_tti < ttis; g_tti++)
+    {
+      if (g_tti % cqiPeriod == 0)
+        {
+          FfMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiInfo;
+          cqiInfo.m_sfnSf = g_tti;
+          for (uint16_t rnti = 1; rnti <= n; rnti++)
+            {
+              CqiListElement_s report;
+              report.m_rnti = rnti;
+              report.m_ri = 1;
+              report.m_cqiType = CqiListElement_s::A30;
+              report.m_wbCqi.push_back (cqi->GetInteger (1, 15));
+              report.m_wbPmi = 0;
+              for (int i = 0; i < rbgNum; i++)
+                {
+                  HigherLayerSelected_s sb;
+                  sb.m_sbPmi = 0;
+                  sb.m_sbCqi.push_back (cqi->GetInteger (1, 15));
+                  report.m_sbMeasResult.m_higherLayerSelected.push_back (sb);
+                }
+              cqiInfo.m_cqiList.push_back (report);
+            }
+          schedProvider->SchedDlCqiInfoReq (cqiInfo);
+        }
+      for (uint16_t rnti = 1; rnti <= n; rnti++)
+        {
+          FfMacSchedSapProvider::SchedDlRlcBufferReqParameters rlc;
+          rlc.m_rnti = rnti;
+          rlc.m_logicalChannelIdentity = 3;
+          rlc.m_rlcTransmissionQueueSize = 100000;
+          rlc.m_rlcTransmissionQueueHolDelay = 10;
+          rlc.m_rlcRetransmissionQueueSize = 0;
+          rlc.m_rlcRetransmissionHolDelay = 0;
+          rlc.m_rlcStatusPduSize = 0;
+          schedProvider->SchedDlRlcBufferReq (rlc);
+        }
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters trigger;
+      trigger.m_sfnSf = ((0x3FF & (g_tti / 10)) << 4) | (0xF & (g_tti % 10));
+      trigger.m_dlInfoList.swap (g_pendingAcks.at (g_tti % 4));
+      schedProvider->SchedDlTriggerReq (trigger);
+    }
+  uint64_t deltaMs = time.End ();
+
+  double ops = ttis;
+  ops *= 1000;
+  ops /= std::max (deltaMs, (uint64_t) 1);
+  std::cout << "Running bench-ff-mac-scheduler with scheduler=" << scheduler << " n=" << n << std::endl;
+  std::cout << ops << " TTIs/s"
+            << " (" << ttis << " TTIs, " << g_allocations << " allocations, " << deltaMs << " ms elapsed)"
+            << std::endl;
+  // the allocations are the same, whatever the implementation of the scheduler
+  std::cout << "allocation checksum " << g_checksum << std::endl;
+  sched->Dispose ();
+  ffr->Dispose ();
+  return 0;
+}
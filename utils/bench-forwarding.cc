@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/traffic-control-module.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+using namespace ns3;
+
+/*
+ * Benchmark the IPv4 forwarding path: a UDP flow crosses a chain of
+ * point-to-point links, each with a RED queue disc, and every
+ * intermediate node forwards its packets.  Nothing is connected to the
+ * traces, so the run measures the cost of the forwarding itself.
+ */
+
+int main (int argc, char *argv[])
+{
+  uint32_t hops = 8;
+  double duration = 1.0;
+  bool lazy = false;
+  bool lazyHeaders = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the IPv4 forwarding of a UDP flow over a chain of point-to-point links");
+  cmd.AddValue ("hops", "number of links of the chain", hops);
+  cmd.AddValue ("duration", "simulated time (s)", duration);
+  cmd.AddValue ("lazy", "value of PointToPointNetDevice::LazyTransmitComplete", lazy);
+  cmd.AddValue ("lazyHeaders", "enable the lazy serialization of the packet headers", lazyHeaders);
+  cmd.Parse (argc, argv);
+
+  if (lazyHeaders)
+    {
+      Packet::EnableLazyHeaders ();
+    }
+  Config::SetDefault ("ns3::PointToPointNetDevice::LazyTransmitComplete", BooleanValue (lazy));
+
+  NodeContainer nodes;
+  nodes.Create (hops + 1);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1us"));
+  TrafficControlHelper tc;
+  tc.SetRootQueueDisc ("ns3::RedQueueDisc");
+  Ipv4AddressHelper ipv4;
+  Ipv4InterfaceContainer last;
+  for (uint32_t i = 0; i < hops; i++)
+    {
+      NetDeviceContainer devices = p2p.Install (nodes.Get (i), nodes.Get (i + 1));
+      tc.Install (devices);
+      std::ostringstream base;
+      base << "10." << i / 250 << "." << i % 250 << ".0";
+      ipv4.SetBase (base.str ().c_str (), "255.255.255.0");
+      last = ipv4.Assign (devices);
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9));
+  ApplicationContainer sink = sinkHelper.Install (nodes.Get (hops));
+  sink.Start (Seconds (0));
+  OnOffHelper onoff ("ns3::UdpSocketFactory", InetSocketAddress (last.GetAddress (1), 9));
+  onoff.SetConstantRate (DataRate ("5Gbps"), 1400);
+  onoff.Install (nodes.Get (0)).Start (Seconds (0));
+
+  Simulator::Stop (Seconds (duration));
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t deltaMs = time.End ();
+
+  uint64_t packets = DynamicCast<PacketSink> (sink.Get (0))->GetTotalRx () / 1400;
+  double ops = packets * hops;
+  ops *= 1000;
+  ops /= std::max (deltaMs, (uint64_t) 1);
+  std::cout << "Running bench-forwarding with hops=" << hops << " lazy=" << lazy
+            << " lazyHeaders=" << lazyHeaders << std::endl;
+  std::cout << ops << " packet hops/s"
+            << " (" << packets << " packets received, " << deltaMs << " ms elapsed)"
+            << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/interference-helper.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/wifi-phy.h"
+#include <iostream>
+#include <algorithm>
+
+using namespace ns3;
+
+/*
+ * Benchmark the InterferenceHelper of a Wi-Fi receiver in a dense
+ * network: it hears the back-to-back frames of n transmitters, which
+ * overlap each other, and receives the frames of one of them.  Each
+ * frame is added to the helper and checked for CCA as YansWifiPhy does,
+ * and the SNIR of the received frames is computed at the end of their
+ * header and payload.
+ */
+
+static InterferenceHelper g_interference;
+static Ptr<UniformRandomVariable> g_rand;
+static WifiTxVector g_txVector;
+static Time g_frameDuration = MicroSeconds (1000);
+static Time g_headerDuration = MicroSeconds (20);
+static uint64_t g_adds = 0;
+static double g_check = 0;
+
+static void
+EndReceive (Ptr<InterferenceHelper::Event> event)
+{
+  g_check += g_interference.CalculatePlcpPayloadSnrPer (event).snr;
+  g_interference.NotifyRxEnd ();
+}
+
+static void
+EndHeader (Ptr<InterferenceHelper::Event> event)
+{
+  g_check += g_interference.CalculatePlcpHeaderSnrPer (event).snr;
+}
+
+static void
+Transmit (uint32_t transmitter)
+{
+  double rxPowerW = 1e-9 * (1 + transmitter % 7);
+  Ptr<InterferenceHelper::Event> event = g_interference.Add (1000, g_txVector, WIFI_PREAMBLE_LONG,
+                                                             g_frameDuration, rxPowerW);
+  g_adds++;
+  g_check += g_interference.GetEnergyDuration (1e-11).GetSeconds ();
+  if (transmitter == 0)
+    {
+      g_interference.NotifyRxStart ();
+      Simulator::Schedule (g_headerDuration, &EndHeader, event);
+      Simulator::Schedule (g_frameDuration, &EndReceive, event);
+    }
+  // the next frame, after a random backoff
+  Time backoff = MicroSeconds (g_rand->GetInteger (9, 9 * 16));
+  Simulator::Schedule (g_frameDuration + backoff, &Transmit, transmitter);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 100;
+  double duration = 1.0;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the Wi-Fi InterferenceHelper of a receiver hearing n overlapping transmitters");
+  cmd.AddValue ("n", "number of transmitters", n);
+  cmd.AddValue ("duration", "simulated time (s)", duration);
+  cmd.Parse (argc, argv);
+
+  g_rand = CreateObject<UniformRandomVariable> ();
+  g_interference.SetNoiseFigure (5);
+  g_interference.SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  g_txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+  g_txVector.SetChannelWidth (20);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Simulator::Schedule (MicroSeconds (g_rand->GetInteger (0, 1000)), &Transmit, i);
+    }
+  Simulator::Stop (Seconds (duration));
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t deltaMs = time.End ();
+  Simulator::Destroy ();
+
+  double ops = g_adds;
+  ops *= 1000;
+  ops /= std::max (deltaMs, (uint64_t) 1);
+  std::cout << "Running bench-interference with n=" << n << std::endl;
+  std::cout << ops << " frames/s"
+            << " (" << g_adds << " frames, " << deltaMs << " ms elapsed)"
+            << std::endl;
+  if (g_check == 0)
+    {
+      std::cout << std::endl;
+    }
+  return 0;
+}
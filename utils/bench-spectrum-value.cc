@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/spectrum-model.h"
+#include "ns3/spectrum-value.h"
+#include <iostream>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+using namespace ns3;
+
+/*
+ * Benchmark the SpectrumValue operations of the SINR computations, on the
+ * spectrum model of a 20 MHz LTE carrier: 100 resource blocks of 180 kHz.
+ */
+
+static Ptr<SpectrumModel> g_model;   // The 100 RB spectrum model
+static double g_check = 0;           // Keeps the results alive
+
+static void
+Fill (SpectrumValue &v, double base)
+{
+  for (uint32_t i = 0; i < g_model->GetNumBands (); i++)
+    {
+      v[i] = base * (1 + 0.01 * i);
+    }
+}
+
+static void
+benchSinrOperators (uint32_t n)
+{
+  SpectrumValue signal (g_model), all (g_model), noise (g_model);
+  Fill (signal, 1e-13);
+  Fill (all, 3e-13);
+  Fill (noise, 1e-15);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      SpectrumValue interf = all - signal + noise;
+      SpectrumValue sinr = signal / interf;
+      g_check += sinr[i % 100];
+    }
+}
+
+static void
+benchSinrFused (uint32_t n)
+{
+  SpectrumValue signal (g_model), all (g_model), noise (g_model);
+  SpectrumValue interf, sinr;
+  Fill (signal, 1e-13);
+  Fill (all, 3e-13);
+  Fill (noise, 1e-15);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      ComputeSinr (signal, all, noise, interf, sinr);
+      g_check += sinr[i % 100];
+    }
+}
+
+static void
+benchAccumulateOperators (uint32_t n)
+{
+  SpectrumValue sinr (g_model), sum (g_model);
+  Fill (sinr, 10);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += sinr * 1e-4;
+    }
+  g_check += sum[0];
+}
+
+static void
+benchAccumulateFused (uint32_t n)
+{
+  SpectrumValue sinr (g_model), sum (g_model);
+  Fill (sinr, 10);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum.AddScaled (sinr, 1e-4);
+    }
+  g_check += sum[0];
+}
+
+static void
+benchInPlace (uint32_t n)
+{
+  SpectrumValue all (g_model), signal (g_model);
+  Fill (signal, 1e-13);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      all += signal;
+      all -= signal;
+    }
+  g_check += all[0];
+}
+
+static void
+benchIntegral (uint32_t n)
+{
+  SpectrumValue psd (g_model);
+  Fill (psd, 1e-13);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      g_check += Integral (psd);
+    }
+}
+
+static uint64_t
+runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  (*bench) (n);
+  uint64_t deltaMs = time.End ();
+  return deltaMs;
+}
+
+
+static void
+runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      uint64_t delay = runBenchOneIteration (bench, n);
+      minDelay = std::min (minDelay, delay);
+    }
+  double ops = n;
+  ops *= 1000;
+  ops /= std::max (minDelay, (uint64_t) 1);
+  std::cout << ops << " ops/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the SpectrumValue operations on a 100 RB LTE spectrum model");
+  cmd.AddValue ("n", "number of operations", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  std::vector<double> centerFrequencies;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      centerFrequencies.push_back (2110e6 + 90e3 + i * 180e3);
+    }
+  g_model = Create<SpectrumModel> (centerFrequencies);
+
+  std::cout << "Running bench-spectrum-value with n=" << n << std::endl;
+  runBench (&benchSinrOperators, n, minIterations, "SINR with operators: s / (a - s + n)");
+  runBench (&benchSinrFused, n, minIterations, "SINR with ComputeSinr");
+  runBench (&benchAccumulateOperators, n, minIterations, "Accumulate with operators: sum += x * t");
+  runBench (&benchAccumulateFused, n, minIterations, "Accumulate with AddScaled");
+  runBench (&benchInPlace, n, minIterations, "In place += and -=");
+  runBench (&benchIntegral, n, minIterations, "Integral");
+
+  if (g_check == 0)
+    {
+      std::cout << std::endl;
+    }
+  return 0;
+}